@@ -23,7 +23,8 @@ const string make_index_name (const char* fileName, int indexNo)
 void Manager::CreateIndex (const char* fileName,
                            int indexNo,
                            AttrType attrType,
-                           int attrLength)
+                           int attrLength,
+                           int page_size)
 {
   if ((indexNo < 0) ||
       ((attrType == INT) && (attrLength != 4)) ||
@@ -39,18 +40,18 @@ void Manager::CreateIndex (const char* fileName,
   string index_name = make_index_name (fileName, indexNo);
 
   // Create an empty file and open it.
-  this->pfm.CreateFile (index_name);
+  this->pfm.CreateFile (index_name, page_size);
   PF::FileHandle index_file = this->pfm.OpenFile (index_name);
 
   // Add the root page of the index to the empty file.
-  PF::PageHandle root_page = index_file.AllocatePage ();
+  PF::PinnedPage root_page = index_file.PinNewPage ();
   TreePageHdr hdr;
   hdr.num_keys = 0;
   hdr.key_size = attrLength;
   hdr.key_type = attrType;
   hdr.is_root = true;
   hdr.is_leaf = true;
-  TreePage root (root_page.GetData (), hdr);
+  TreePage root (root_page, hdr);
 
   // cleanup
   index_file.DoneWritingTo (root_page);
@@ -83,28 +84,28 @@ IndexHandle::IndexHandle (PF::FileHandle& index_file)
 IndexHandle::IndexHandle (const IndexHandle& other)
   : index_file (other.index_file), uninitialized (false) {}
 
-PF::PageHandle IndexHandle::GetRoot () const
+PF::PinnedPage IndexHandle::GetRoot () const
 {
-  PF::PageHandle page = this->index_file.GetFirstPage ();
-  TreePage node (page.GetData ());
+  PF::PinnedPage page = this->index_file.PinFirstPage ();
+  TreePage node (page);
   while (! node.hdr->is_root) {
     PageNum next_num = page.GetPageNum ();
     this->index_file.UnpinPage (page);
-    page = this->index_file.GetNextPage (next_num);
-    new (&node) TreePage (page.GetData ());
+    page = this->index_file.PinNextPage (next_num);
+    new (&node) TreePage (page);
   }
   return page;
 }
 
-PF::PageHandle IndexHandle::GetFirstLeaf () const
+PF::PinnedPage IndexHandle::GetFirstLeaf () const
 {
-  PF::PageHandle page = this->GetRoot ();
-  TreePage node (page.GetData ());
+  PF::PinnedPage page = this->GetRoot ();
+  TreePage node (page);
   while (! node.hdr->is_leaf) {
     PageNum next_num = node.page_nums [0];
     this->index_file.UnpinPage (page);
-    page = this->index_file.GetPage (next_num);
-    new (&node) TreePage (page.GetData ());
+    page = this->index_file.PinPage (next_num);
+    new (&node) TreePage (page);
   }
   return page;
 }
@@ -113,8 +114,8 @@ void IndexHandle::Insert (const void *data, const RID& rid)
 {
   if (this->uninitialized) throw error::UninitializedIndexHandle ();
 
-  PF::PageHandle root_page = this->GetRoot ();
-  TreePage root (root_page.GetData ());
+  PF::PinnedPage root_page = this->GetRoot ();
+  TreePage root (root_page);
 
   ArrayElem key (root.hdr->key_type,
                  root.hdr->key_size,
@@ -122,17 +123,10 @@ void IndexHandle::Insert (const void *data, const RID& rid)
   // cout << "Insert ";
   // if (root.hdr->key_type == INT) cout << key << " -> ";
   // cout << "(" << rid.page_num << ", " << rid.slot_num << ")" << endl;
-  KeyAndPageNum ret;
-  try {
-    new (&ret) KeyAndPageNum (root.insert (key, rid, this->index_file));
-  }
-  catch (exception& e) {
-    this->index_file.UnpinPage (root_page);
-    throw;
-  }
+  KeyAndPageNum ret = root.insert (key, rid, this->index_file);
   if (ret != NULL) {
     // Root split, need to create a new root.
-    PF::PageHandle new_root_page = this->index_file.AllocatePage ();
+    PF::PinnedPage new_root_page = this->index_file.PinNewPage ();
 
     root.hdr->is_root = false;
 
@@ -143,7 +137,7 @@ void IndexHandle::Insert (const void *data, const RID& rid)
     hdr.key_size = root.hdr->key_size;
     hdr.key_type = root.hdr->key_type;
 
-    TreePage new_root (new_root_page.GetData (), hdr);
+    TreePage new_root (new_root_page, hdr);
     new_root.keys [0] = ret.key;
     new_root.page_nums [0] = root_page.GetPageNum ();
     new_root.page_nums [1] = ret.page_num;
@@ -158,18 +152,12 @@ void IndexHandle::Delete (const void *data, const RID& rid)
 {
   if (this->uninitialized) throw error::UninitializedIndexHandle ();
 
-  PF::PageHandle root_page = this->GetRoot ();
-  TreePage root (root_page.GetData ());
+  PF::PinnedPage root_page = this->GetRoot ();
+  TreePage root (root_page);
   ArrayElem key (root.hdr->key_type,
                  root.hdr->key_size,
                  (char*) data);
-  try {
-    root.Delete (key, rid, this->index_file);
-  }
-  catch (exception& e) {
-    this->index_file.UnpinPage (root_page);
-    throw;
-  }
+  root.Delete (key, rid, this->index_file);
   this->index_file.UnpinPage (root_page);
 }
 
@@ -180,11 +168,9 @@ void IndexHandle::ForcePages () const
   this->index_file.ForcePages ();
 }
 
-TreePage::TreePage (PF::PageHandle& pf_page)
-  : TreePage::TreePage (pf_page.GetData ()) {}
-
-TreePage::TreePage (char* start_of_page, const TreePageHdr& hdr)
+TreePage::TreePage (const PF::PinnedPage& pf_page, const TreePageHdr& hdr)
 {
+  char* start_of_page = pf_page.GetData ();
   this->hdr = (TreePageHdr*) start_of_page;
   this->hdr->num_keys = hdr.num_keys;
   this->hdr->key_size = hdr.key_size;
@@ -192,17 +178,18 @@ TreePage::TreePage (char* start_of_page, const TreePageHdr& hdr)
   this->hdr->is_root = hdr.is_root;
   this->hdr->is_leaf = hdr.is_leaf;
 
-  this->init (start_of_page);
+  this->init (start_of_page, pf_page.GetPageSize ());
   this->page_nums [this->hdr->num_keys] = -1;
 }
 
-TreePage::TreePage (char* start_of_page)
+TreePage::TreePage (const PF::PinnedPage& pf_page)
 {
+  char* start_of_page = pf_page.GetData ();
   this->hdr = (TreePageHdr*) start_of_page;
-  this->init (start_of_page);
+  this->init (start_of_page, pf_page.GetPageSize ());
 }
 
-void TreePage::init (char* start_of_page)
+void TreePage::init (char* start_of_page, int page_size)
 {
   /*
     let there be 2n keys and 2n+1 page numbers. we know:
@@ -213,7 +200,7 @@ void TreePage::init (char* start_of_page)
     2n <= ---------------------------------------
              sizeof key + sizeof pgnum
    */
-  this->max_num_keys = PF::kPageSize - (sizeof (TreePageHdr) + sizeof (PageNum));
+  this->max_num_keys = page_size - (sizeof (TreePageHdr) + sizeof (PageNum));
   this->max_num_keys /= this->hdr->key_size + sizeof (PageNum);
 
   // round to an even number.
@@ -275,19 +262,13 @@ void TreePage::Delete (const ArrayElem& key,
   if (this->hdr->is_leaf) {
     if (i == this->keys.len()) throw error::RIDNoExist ();
     if (key != this->keys [i]) throw error::RIDNoExist ();
-    PF::PageHandle bucket_page = index_file.GetPage (this->page_nums [i]);
+    PF::PinnedPage bucket_page = index_file.PinPage (this->page_nums [i]);
     RIDPage bucket (bucket_page);
-    try {
-      bucket.Delete (rid, index_file);
-    }
-    catch (exception& e) {
-      index_file.UnpinPage(bucket_page);
-      throw;
-    }
+    bucket.Delete (rid, index_file);
     index_file.DoneWritingTo (bucket_page);
   }
   else {
-    PF::PageHandle child_page = index_file.GetPage (this->page_nums [i]);
+    PF::PinnedPage child_page = index_file.PinPage (this->page_nums [i]);
     TreePage child (child_page);
     child.Delete (key, rid, index_file);
     index_file.UnpinPage (child_page);
@@ -308,20 +289,14 @@ KeyAndPageNum TreePage::insert (const ArrayElem& key,
 
     if (i < this->keys.len() && this->keys [i] == key) {
       // We already have that key, just insert into the bucket.
-      PF::PageHandle rid_page = index_file.GetPage (this->page_nums [i]);
+      PF::PinnedPage rid_page = index_file.PinPage (this->page_nums [i]);
       RIDPage bucket (rid_page);
-      try {
-        bucket.insert (rid, index_file);
-      }
-      catch (exception& e) {
-        index_file.UnpinPage (rid_page);
-        throw;
-      }
+      bucket.insert (rid, index_file);
       index_file.DoneWritingTo (rid_page);
     }
     else {
       // We are seeing this key for the first time, we need to create a bucket.
-      PF::PageHandle new_bucket_page = index_file.AllocatePage ();
+      PF::PinnedPage new_bucket_page = index_file.PinNewPage ();
       RIDPage new_bucket (new_bucket_page);
       new_bucket.clear ();
       new_bucket.insert (rid, index_file);
@@ -333,7 +308,7 @@ KeyAndPageNum TreePage::insert (const ArrayElem& key,
       }
       else {
         // This leaf is full, we need to split the leaf.
-        PF::PageHandle new_leaf_page = index_file.AllocatePage ();
+        PF::PinnedPage new_leaf_page = index_file.PinNewPage ();
         this->transferkeys (new_leaf_page, this->max_num_keys / 2);
         TreePage new_leaf (new_leaf_page);
 
@@ -364,7 +339,7 @@ KeyAndPageNum TreePage::insert (const ArrayElem& key,
     for (i = 0; i < this->keys.len(); ++i) {
       if (key <= this->keys [i]) break;
     }
-    PF::PageHandle child_page = index_file.GetPage (this->page_nums [i]);
+    PF::PinnedPage child_page = index_file.PinPage (this->page_nums [i]);
     TreePage child (child_page);
     KeyAndPageNum ret = child.insert (key, rid, index_file);
     if (ret == NULL) {
@@ -384,7 +359,7 @@ KeyAndPageNum TreePage::insert (const ArrayElem& key,
       }
       else {
         // create a sibling,
-        PF::PageHandle sibling_page = index_file.AllocatePage ();
+        PF::PinnedPage sibling_page = index_file.PinNewPage ();
 
         //   does the new key go into the sibling?
         //   if yes, then, we send half - 1 keys to sibling
@@ -445,7 +420,7 @@ ArrayElem TreePage::pop_key ()
   return this->keys.pop ();
 }
 
-void TreePage::transferkeys (PF::PageHandle& sibling_page,
+void TreePage::transferkeys (const PF::PinnedPage& sibling_page,
                              int num_keys_to_transfer)
 {
   assert (this->is_full());
@@ -459,7 +434,7 @@ void TreePage::transferkeys (PF::PageHandle& sibling_page,
   hdr.key_size = this->hdr->key_size;
   hdr.key_type = this->hdr->key_type;
 
-  TreePage sibling (sibling_page.GetData(), hdr);
+  TreePage sibling (sibling_page, hdr);
   int i = this->max_num_keys - num_keys_to_transfer;
   sibling.page_nums.insert (0, this->page_nums[i]);
   for (int j = 0; j < num_keys_to_transfer; ++j) {
@@ -472,7 +447,7 @@ void TreePage::transferkeys (PF::PageHandle& sibling_page,
   }
 }
 
-RIDPage::RIDPage (PF::PageHandle& page_handle)
+RIDPage::RIDPage (const PF::PinnedPage& page_handle)
 {
   /* let the bitmap be n bytes
      there can be at max 8n RIDs
@@ -482,7 +457,8 @@ RIDPage::RIDPage (PF::PageHandle& page_handle)
      n <= ------------------
             8 RIDsize + 1
    */
-  this->max_rid_count = 8 * ((PF::kPageSize - sizeof (RIDPageHdr))
+  int page_size = page_handle.GetPageSize ();
+  this->max_rid_count = 8 * ((page_size - sizeof (RIDPageHdr))
                              / (8 * sizeof (RID) + 1));
 
   char* data = page_handle.GetData ();
@@ -512,14 +488,16 @@ void RIDPage::insert (const RID& rid, PF::FileHandle& index_file)
 {
   // TODO(sujeet): This is very inefficient. Now the free map
   //               is almost useless. Use a hash table maybe?
-  for (int i = 0; i < this->max_rid_count; ++i) {
-    if (this->bitmap.get (i) && this->rids [i] == rid)
+  for (int i = this->bitmap.findNextSet (0);
+       i != -1;
+       i = this->bitmap.findNextSet (i + 1)) {
+    if (this->rids [i] == rid)
       throw error::DuplicateRID();
   }
 
   if (this->is_full()) {
     if (this->hdr->next_page == -1) {
-      PF::PageHandle new_rid_page = index_file.AllocatePage ();
+      PF::PinnedPage new_rid_page = index_file.PinNewPage ();
       RIDPage new_bucket (new_rid_page);
       new_bucket.clear ();
       new_bucket.add (rid);
@@ -527,7 +505,7 @@ void RIDPage::insert (const RID& rid, PF::FileHandle& index_file)
       index_file.DoneWritingTo (new_rid_page);
     }
     else {
-      PF::PageHandle next_page = index_file.GetPage (this->hdr->next_page);
+      PF::PinnedPage next_page = index_file.PinPage (this->hdr->next_page);
       RIDPage next_bucket (next_page);
       next_bucket.insert (rid, index_file);
       index_file.DoneWritingTo (next_page);
@@ -550,14 +528,16 @@ void RIDPage::add (const RID& rid)
 
 void RIDPage::Delete (const RID& rid, PF::FileHandle& index_file)
 {
-  for (int i = 0; i < this->max_rid_count; ++i) {
-    if (this->bitmap.get (i) && this->rids [i] == rid) {
+  for (int i = this->bitmap.findNextSet (0);
+       i != -1;
+       i = this->bitmap.findNextSet (i + 1)) {
+    if (this->rids [i] == rid) {
       this->bitmap.clear (i);
       return;
     }
   }
   if (this->hdr->next_page != -1) {
-    PF::PageHandle next_page = index_file.GetPage (this->hdr->next_page);
+    PF::PinnedPage next_page = index_file.PinPage (this->hdr->next_page);
     RIDPage next_bucket (next_page);
     next_bucket.Delete (rid, index_file);
     index_file.DoneWritingTo (next_page);
@@ -576,7 +556,7 @@ Scan::Scan (const IndexHandle& indexHandle,
 {
   if (indexHandle.uninitialized) throw error::UninitializedIndexHandle ();
 
-  PF::PageHandle leaf_page = indexHandle.GetFirstLeaf ();
+  PF::PinnedPage leaf_page = indexHandle.GetFirstLeaf ();
   TreePage leaf (leaf_page);
 
   this->index_file = indexHandle.index_file;
@@ -588,14 +568,14 @@ Scan::Scan (const IndexHandle& indexHandle,
   // if (value == NULL) cout << "scanning for everything" << endl;
   // else if (leaf.hdr->key_type == INT)
   //   cout << "scanning for " << this->key << endl;
-  this->index_file.UnpinPage (leaf_page);
   this->leaf_page_num = leaf_page.GetPageNum ();
+  this->index_file.UnpinPage (leaf_page);
   this->key_i = -1;
   this->next_key_i ();
   // Now both leaf_page_num and key_i are set.
 
   if (this->leaf_page_num != -1) {
-    leaf_page = this->index_file.GetPage (this->leaf_page_num);
+    leaf_page = this->index_file.PinPage (this->leaf_page_num);
     new (&leaf) TreePage (leaf_page);
     this->bucket_page_num = leaf.page_nums [this->key_i];
     this->rid_i = -1;
@@ -607,7 +587,7 @@ Scan::Scan (const IndexHandle& indexHandle,
 
 void Scan::next_leaf_page_num ()
 {
-  PF::PageHandle leaf_page = this->index_file.GetPage (this->leaf_page_num);
+  PF::PinnedPage leaf_page = this->index_file.PinPage (this->leaf_page_num);
   TreePage leaf (leaf_page);
   this->leaf_page_num = leaf.page_nums [leaf.hdr->num_keys];
   this->index_file.UnpinPage (leaf_page);
@@ -632,7 +612,7 @@ void Scan::next_key_i ()
 {
   this->key_i++;
 
-  PF::PageHandle leaf_page = this->index_file.GetPage (this->leaf_page_num);
+  PF::PinnedPage leaf_page = this->index_file.PinPage (this->leaf_page_num);
   TreePage leaf (leaf_page);
   int max_count = leaf.hdr->num_keys;
 
@@ -650,7 +630,7 @@ void Scan::next_key_i ()
 
 void Scan::next_bucket_page_num ()
 {
-  PF::PageHandle bucket_page = this->index_file.GetPage (this->bucket_page_num);
+  PF::PinnedPage bucket_page = this->index_file.PinPage (this->bucket_page_num);
   RIDPage bucket (bucket_page);
   this->bucket_page_num = bucket.hdr->next_page;
   this->index_file.UnpinPage (bucket_page);
@@ -660,7 +640,7 @@ void Scan::next_bucket_page_num ()
   this->next_key_i ();
   if (this->leaf_page_num == -1) return;
 
-  PF::PageHandle leaf_page = this->index_file.GetPage (this->leaf_page_num);
+  PF::PinnedPage leaf_page = this->index_file.PinPage (this->leaf_page_num);
   TreePage leaf (leaf_page);
   this->bucket_page_num = leaf.page_nums [this->key_i];
   this->index_file.UnpinPage (leaf_page);
@@ -670,16 +650,13 @@ void Scan::next_rid_i ()
 {
   this->rid_i++;
 
-  PF::PageHandle bucket_page = this->index_file.GetPage (this->bucket_page_num);
+  PF::PinnedPage bucket_page = this->index_file.PinPage (this->bucket_page_num);
   RIDPage bucket (bucket_page);
-  int max_count = bucket.max_rid_count;
-  while (this->rid_i < max_count &&
-         not bucket.bitmap.get (this->rid_i)) this->rid_i++;
+  this->rid_i = bucket.bitmap.findNextSet (this->rid_i);
   this->index_file.UnpinPage (bucket_page);
 
-  if (this->rid_i < max_count) return;
+  if (this->rid_i != -1) return;
   
-  this->rid_i = -1;
   this->next_bucket_page_num ();
   if (this->leaf_page_num == -1) return;
   else this->next_rid_i ();
@@ -693,7 +670,7 @@ RID Scan::next ()
     return rid;
   }
   else {
-    PF::PageHandle bucket_page = this->index_file.GetPage (this->bucket_page_num);
+    PF::PinnedPage bucket_page = this->index_file.PinPage (this->bucket_page_num);
     RIDPage bucket (bucket_page);
     RID rid = bucket.rids [this->rid_i];
     this->index_file.UnpinPage (bucket_page);
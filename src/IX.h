@@ -20,8 +20,8 @@ private:
   bool uninitialized;
 
   IndexHandle (PF::FileHandle& index_file);
-  PF::PageHandle GetRoot () const;
-  PF::PageHandle GetFirstLeaf () const;
+  PF::PinnedPage GetRoot () const;
+  PF::PinnedPage GetFirstLeaf () const;
 
 public:
   IndexHandle (): uninitialized (true) {}
@@ -69,7 +69,8 @@ public:
   void CreateIndex (const char* fileName,
                     int indexNo,
                     AttrType attrType,
-                    int attrLength);
+                    int attrLength,
+                    int page_size = MEMORY_PAGE_SIZE);
   void DestroyIndex (const char *fileName, int indexNo);
   IndexHandle OpenIndex (const char *fileName, int indexNo);
   void CloseIndex (IndexHandle &indexHandle);
@@ -119,7 +120,7 @@ private:
             PageNum page_num);
 
   // common code for both constructors.
-  void init (char* start_of_page);
+  void init (char* start_of_page, int page_size);
 
   // ONLY FOR PAGES THAT ARE FULL
   //
@@ -137,16 +138,15 @@ private:
   //    * this page *  | * new page *
   //     k1  k2  k3    |      k4
   //   p1  p2  p3  p4  |    p4  p5
-  void transferkeys (PF::PageHandle& sibling_page,
+  void transferkeys (const PF::PinnedPage& sibling_page,
                      int num_keys_to_transfer);
   void Delete (const ArrayElem& key,
                const RID& rid,
                PF::FileHandle& index_file);
 
 public:
-  TreePage (PF::PageHandle& pf_page);
-  TreePage (char* start_of_page);
-  TreePage (char* start_of_page, const TreePageHdr& hdr);
+  TreePage (const PF::PinnedPage& pf_page);
+  TreePage (const PF::PinnedPage& pf_page, const TreePageHdr& hdr);
 
   // Insert the key and RID in the tree rooted at this page
   // If this node split, return the page number of the newly created
@@ -179,7 +179,7 @@ private:
   void add (const RID& rid);
 
 public:
-  RIDPage (PF::PageHandle& page_handle);
+  RIDPage (const PF::PinnedPage& page_handle);
   void insert (const RID& rid, PF::FileHandle& index_file);
   void Delete (const RID& rid, PF::FileHandle& index_file);
 };
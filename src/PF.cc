@@ -15,6 +15,8 @@
   case PF_PAGEUNPINNED    : throw PageAlreadyPinned (); break;     \
   case PF_EOF             : throw Eof (); break;                   \
   case PF_TOOSMALL        : throw BufferTooSmall (); break;        \
+  case PF_READONLY        : throw ReadOnlyFile (); break;          \
+  case PF_BADPAGESIZE     : throw BadPageSize (); break;           \
                                                                    \
   case PF_NOMEM           : throw NoMemory (); break;              \
   case PF_NOBUF           : throw NoBufferSpace (); break;         \
@@ -38,9 +40,10 @@ using namespace error;
 
 Manager::Manager (PF_Manager& mgr) : manager (&mgr) {}
 
-void Manager::CreateFile (const char *fileName) 
+void Manager::CreateFile (const char *fileName, int pageSize,
+                          bool compressed) 
 {
-  HANDLE_ERROR (this->manager->CreateFile (fileName));
+  HANDLE_ERROR (this->manager->CreateFile (fileName, pageSize, compressed));
 }
 
 void Manager::DestroyFile (const char *fileName)
@@ -48,16 +51,18 @@ void Manager::DestroyFile (const char *fileName)
   HANDLE_ERROR (this->manager->DestroyFile (fileName));
 }
 
-FileHandle Manager::OpenFile (const char *fileName)
+FileHandle Manager::OpenFile (const char *fileName, PF_OpenMode mode)
 {
   FileHandle filehandle;
-  HANDLE_ERROR (this->manager->OpenFile (fileName, filehandle.filehandle));
+  HANDLE_ERROR (this->manager->OpenFile (fileName, filehandle.filehandle,
+                                         mode));
   return filehandle;
 }
 
-void Manager::CreateFile (const std::string& fileName) 
+void Manager::CreateFile (const std::string& fileName, int pageSize,
+                          bool compressed) 
 {
-  this->CreateFile (fileName.c_str ());
+  this->CreateFile (fileName.c_str (), pageSize, compressed);
 }
 
 void Manager::DestroyFile (const std::string& fileName)
@@ -65,9 +70,9 @@ void Manager::DestroyFile (const std::string& fileName)
   this->DestroyFile (fileName.c_str ());
 }
 
-FileHandle Manager::OpenFile (const std::string& fileName)
+FileHandle Manager::OpenFile (const std::string& fileName, PF_OpenMode mode)
 {
-  return this->OpenFile (fileName.c_str ());
+  return this->OpenFile (fileName.c_str (), mode);
 }
 
 void Manager::CloseFile (FileHandle &filehandle)
@@ -75,6 +80,88 @@ void Manager::CloseFile (FileHandle &filehandle)
   HANDLE_ERROR (this->manager->CloseFile (filehandle.filehandle));
 }
 
+void Manager::SetReplacementPolicy (PF_ReplacementPolicy policy)
+{
+  HANDLE_ERROR (this->manager->SetReplacementPolicy (policy));
+}
+
+void Manager::SetReadAhead (int numPages)
+{
+  HANDLE_ERROR (this->manager->SetReadAhead (numPages));
+}
+
+void Manager::SetBackgroundWriter (int numPages)
+{
+  HANDLE_ERROR (this->manager->SetBackgroundWriter (numPages));
+}
+
+void Manager::SetCheckpointInterval (int msecs)
+{
+  HANDLE_ERROR (this->manager->SetCheckpointInterval (msecs));
+}
+
+void Manager::SetDirectIO (bool direct)
+{
+  HANDLE_ERROR (this->manager->SetDirectIO (direct));
+}
+
+void Manager::SetExtentPages (int numPages)
+{
+  HANDLE_ERROR (this->manager->SetExtentPages (numPages));
+}
+
+void Manager::Commit ()
+{
+  HANDLE_ERROR (this->manager->Commit ());
+}
+
+void Manager::SetDurability (PF_Durability mode)
+{
+  HANDLE_ERROR (this->manager->SetDurability (mode));
+}
+
+void Manager::SetGroupCommitWindow (int msecs)
+{
+  HANDLE_ERROR (this->manager->SetGroupCommitWindow (msecs));
+}
+
+void Manager::SetGroupCommitSize (int maxGroup)
+{
+  HANDLE_ERROR (this->manager->SetGroupCommitSize (maxGroup));
+}
+
+void Manager::SaveWarmPages (const std::string& manifestName)
+{
+  HANDLE_ERROR (this->manager->SaveWarmPages (manifestName.c_str ()));
+}
+
+void Manager::LoadWarmPages (const std::string& manifestName)
+{
+  HANDLE_ERROR (this->manager->LoadWarmPages (manifestName.c_str ()));
+}
+
+void Manager::OpenLog (const std::string& logName)
+{
+  HANDLE_ERROR (this->manager->OpenLog (logName.c_str ()));
+}
+
+void Manager::CloseLog ()
+{
+  HANDLE_ERROR (this->manager->CloseLog ());
+}
+
+void Manager::CheckpointLog ()
+{
+  HANDLE_ERROR (this->manager->CheckpointLog ());
+}
+
+long Manager::GetLogSize ()
+{
+  long size;
+  HANDLE_ERROR (this->manager->GetLogSize (size));
+  return size;
+}
+
 FileHandle::FileHandle () {}
 
 FileHandle::FileHandle (const FileHandle &fileHandle)
@@ -88,10 +175,10 @@ FileHandle& FileHandle::operator= (const FileHandle &fileHandle)
 
 FileHandle::~FileHandle () {}
 
-PageHandle FileHandle::GetFirstPage () const
+PageHandle FileHandle::GetFirstPage (ClientHint hint) const
 {
   PageHandle pagehandle;
-  HANDLE_ERROR (this->filehandle.GetFirstPage (*pagehandle.pagehandle));
+  HANDLE_ERROR (this->filehandle.GetFirstPage (*pagehandle.pagehandle, hint));
   return pagehandle;
 }
 
@@ -103,11 +190,12 @@ PageHandle FileHandle::GetLastPage () const
 }
 
 
-PageHandle FileHandle::GetNextPage (PageNum current) const
+PageHandle FileHandle::GetNextPage (PageNum current, ClientHint hint) const
 {
   PageHandle pagehandle;
   HANDLE_ERROR (this->filehandle.GetNextPage (current,
-                                               *pagehandle.pagehandle));
+                                               *pagehandle.pagehandle,
+                                               hint));
   return pagehandle;
 }
  
@@ -119,11 +207,12 @@ PageHandle FileHandle::GetPrevPage (PageNum current) const
   return pagehandle;
 }
 
-PageHandle FileHandle::GetPage (PageNum pageNum) const
+PageHandle FileHandle::GetPage (PageNum pageNum, ClientHint hint) const
 {
   PageHandle pagehandle;
   HANDLE_ERROR (this->filehandle.GetThisPage (pageNum,
-                                               *pagehandle.pagehandle));
+                                               *pagehandle.pagehandle,
+                                               hint));
   return pagehandle;
 }
   
@@ -135,6 +224,34 @@ PageHandle FileHandle::AllocatePage ()
   return pagehandle;
 }
 
+PinnedPage FileHandle::PinFirstPage (ClientHint hint) const
+{
+  PF_PageHandle pagehandle;
+  HANDLE_ERROR (this->filehandle.GetFirstPage (pagehandle, hint));
+  return PinnedPage (&this->filehandle, pagehandle);
+}
+
+PinnedPage FileHandle::PinNextPage (PageNum current, ClientHint hint) const
+{
+  PF_PageHandle pagehandle;
+  HANDLE_ERROR (this->filehandle.GetNextPage (current, pagehandle, hint));
+  return PinnedPage (&this->filehandle, pagehandle);
+}
+
+PinnedPage FileHandle::PinPage (PageNum pageNum, ClientHint hint) const
+{
+  PF_PageHandle pagehandle;
+  HANDLE_ERROR (this->filehandle.GetThisPage (pageNum, pagehandle, hint));
+  return PinnedPage (&this->filehandle, pagehandle);
+}
+
+PinnedPage FileHandle::PinNewPage ()
+{
+  PF_PageHandle pagehandle;
+  HANDLE_ERROR (this->filehandle.AllocatePage (pagehandle));
+  return PinnedPage (&this->filehandle, pagehandle);
+}
+
 void FileHandle::DisposePage (PageNum pageNum)
 {
   HANDLE_ERROR (this->filehandle.DisposePage (pageNum));
@@ -161,11 +278,44 @@ void FileHandle::DoneWritingTo (const PageHandle& page) const
   this->UnpinPage (page.GetPageNum ());
 }
 
+void FileHandle::UnpinPage (PinnedPage& page) const
+{
+  page.Release ();
+}
+
+void FileHandle::DoneWritingTo (PinnedPage& page) const
+{
+  page.MarkDirty ();
+  page.Release ();
+}
+
 void FileHandle::ForcePages (PageNum pageNum) const
 {
   HANDLE_ERROR (this->filehandle.ForcePages (pageNum));
 }
 
+void FileHandle::Shrink ()
+{
+  HANDLE_ERROR (this->filehandle.Shrink ());
+}
+
+void FileHandle::LatchPage (PageNum pageNum, bool exclusive) const
+{
+  HANDLE_ERROR (this->filehandle.LatchPage (pageNum, exclusive));
+}
+
+void FileHandle::UnlatchPage (PageNum pageNum) const
+{
+  HANDLE_ERROR (this->filehandle.UnlatchPage (pageNum));
+}
+
+int FileHandle::GetPageSize () const
+{
+  int pageSize;
+  HANDLE_ERROR (this->filehandle.GetPageSize (pageSize));
+  return pageSize;
+}
+
 PageHandle::PageHandle ()
 {
   this->pagehandle = new PF_PageHandle ();
@@ -200,4 +350,69 @@ PageNum PageHandle::GetPageNum () const
   HANDLE_ERROR (this->pagehandle->GetPageNum (pageNum));
   return pageNum;
 }
+
+int PageHandle::GetPageSize () const
+{
+  int pageSize;
+  HANDLE_ERROR (this->pagehandle->GetPageSize (pageSize));
+  return pageSize;
+}
+
+PinnedPage::PinnedPage ()
+  : filehandle (NULL), page_num (-1), data (NULL), page_size (0),
+    dirty (false) {}
+
+PinnedPage::PinnedPage (const PF_FileHandle* filehandle,
+                        PF_PageHandle& pageHandle)
+  : filehandle (filehandle), dirty (false)
+{
+  // A page handle just filled in by the file handle cannot fail these.
+  pageHandle.GetPageNum (this->page_num);
+  pageHandle.GetData (this->data);
+  pageHandle.GetPageSize (this->page_size);
+}
+
+PinnedPage::PinnedPage (PinnedPage&& other)
+  : filehandle (other.filehandle), page_num (other.page_num),
+    data (other.data), page_size (other.page_size), dirty (other.dirty)
+{
+  other.filehandle = NULL;
+}
+
+PinnedPage& PinnedPage::operator= (PinnedPage&& other)
+{
+  if (this != &other) {
+    this->Unpin ();
+    this->filehandle = other.filehandle;
+    this->page_num = other.page_num;
+    this->data = other.data;
+    this->page_size = other.page_size;
+    this->dirty = other.dirty;
+    other.filehandle = NULL;
+  }
+  return (*this);
+}
+
+PinnedPage::~PinnedPage ()
+{
+  // Nothing can be thrown from here, and the pin is gone either way.
+  this->Unpin ();
+}
+
+int PinnedPage::Unpin ()
+{
+  if (this->filehandle == NULL) return 0;
+
+  int rc = 0;
+  if (this->dirty) rc = this->filehandle->MarkDirty (this->page_num);
+  int unpin_rc = this->filehandle->UnpinPage (this->page_num);
+  this->filehandle = NULL;
+  this->dirty = false;
+  return rc ? rc : unpin_rc;
+}
+
+void PinnedPage::Release ()
+{
+  HANDLE_ERROR (this->Unpin ());
+}
 }
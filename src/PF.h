@@ -22,6 +22,7 @@ namespace PF
 class Manager;
 class FileHandle;
 class PageHandle;
+class PinnedPage;
 
 const int kPageSize = PF_PAGE_SIZE;
 
@@ -33,15 +34,44 @@ public:
   Manager (PF_Manager& mgr);
   ~Manager () {};
 
-  void CreateFile (const char *fileName);
+  void CreateFile (const char *fileName, int pageSize = MEMORY_PAGE_SIZE,
+                   bool compressed = false);
   void DestroyFile (const char *fileName);
-  FileHandle OpenFile (const char *fileName);  
+  FileHandle OpenFile (const char *fileName,
+                       PF_OpenMode mode = PF_READWRITE);
 
-  void CreateFile (const std::string& fileName);
+  void CreateFile (const std::string& fileName,
+                   int pageSize = MEMORY_PAGE_SIZE,
+                   bool compressed = false);
   void DestroyFile (const std::string& fileName);
-  FileHandle OpenFile (const std::string& fileName);
+  FileHandle OpenFile (const std::string& fileName,
+                       PF_OpenMode mode = PF_READWRITE);
 
   void CloseFile (FileHandle &fileHandle);
+
+  void SetReplacementPolicy (PF_ReplacementPolicy policy);
+  void SetReadAhead (int numPages);
+  // Background cleaning of cold pages and periodic checkpoints
+  void SetBackgroundWriter (int numPages);
+  void SetCheckpointInterval (int msecs);
+  // Open files in PF_DIRECT rather than PF_READWRITE mode from now on
+  void SetDirectIO (bool direct);
+  // Grow the files opened from now on by numPages pages at once
+  void SetExtentPages (int numPages);
+  // Make the forced pages durable at the end of a statement
+  void Commit ();
+  void SetDurability (PF_Durability mode);
+  void SetGroupCommitWindow (int msecs);
+  void SetGroupCommitSize (int maxGroup);
+  // Manifest of the resident pages, to warm the buffer up after a restart
+  void SaveWarmPages (const std::string& manifestName);
+  void LoadWarmPages (const std::string& manifestName);
+  // Write-ahead log of the changes, so that Commit only syncs the log;
+  // opening it recovers what an earlier run left in it
+  void OpenLog (const std::string& logName);
+  void CloseLog ();
+  void CheckpointLog ();
+  long GetLogSize ();
 };
 
 class FileHandle 
@@ -55,20 +85,40 @@ public:
   FileHandle& operator= (const FileHandle &fileHandle);
   ~FileHandle ();
 
-  PageHandle GetFirstPage () const;
+  // hint tells the buffer manager how the page is accessed
+  PageHandle GetFirstPage (ClientHint hint = NO_HINT) const;
   PageHandle GetLastPage () const;
 
-  PageHandle GetNextPage (PageNum current) const; 
+  PageHandle GetNextPage (PageNum current, ClientHint hint = NO_HINT) const;
   PageHandle GetPrevPage (PageNum current) const;
-  PageHandle GetPage (PageNum pageNum) const;  
+  PageHandle GetPage (PageNum pageNum, ClientHint hint = NO_HINT) const;
 
   PageHandle AllocatePage ();
+
+  // The same, pinned for the lifetime of a PinnedPage
+  PinnedPage PinFirstPage (ClientHint hint = NO_HINT) const;
+  PinnedPage PinNextPage (PageNum current, ClientHint hint = NO_HINT) const;
+  PinnedPage PinPage (PageNum pageNum, ClientHint hint = NO_HINT) const;
+  PinnedPage PinNewPage ();
+
   void DisposePage (PageNum pageNum);
   void MarkDirty (PageNum pageNum) const;
   void UnpinPage (PageNum pageNum) const;
   void UnpinPage (const PageHandle& page) const;
   void DoneWritingTo (const PageHandle& page) const;
+  void UnpinPage (PinnedPage& page) const;
+  void DoneWritingTo (PinnedPage& page) const;
   void ForcePages (PageNum pageNum = ALL_PAGES) const;
+  // Give the free pages at the end of the file back to the file system
+  void Shrink ();
+
+  // Latch a pinned page shared by several threads while reading it, or
+  // exclusively while changing it
+  void LatchPage (PageNum pageNum, bool exclusive = false) const;
+  void UnlatchPage (PageNum pageNum) const;
+
+  // Bytes of data in each page of the file
+  int GetPageSize () const;
 };
 
 class PageHandle 
@@ -84,6 +134,46 @@ public:
   
   char* GetData() const;
   PageNum GetPageNum () const;
+  // Bytes of data at GetData ()
+  int GetPageSize () const;
+};
+
+// A page pinned in the buffer, held by value.  The page is unpinned, and
+// marked dirty first if MarkDirty was called, when the PinnedPage is
+// released or destroyed, so that no pin outlives its scope, even when an
+// exception is thrown.  A PinnedPage can be moved but not copied, and
+// must not outlive the FileHandle that pinned the page.
+class PinnedPage
+{
+  friend class FileHandle;
+private:
+  const PF_FileHandle* filehandle;   // NULL when no page is pinned
+  PageNum page_num;
+  char* data;
+  int page_size;
+  bool dirty;
+
+  PinnedPage (const PF_FileHandle* filehandle, PF_PageHandle& pageHandle);
+  int Unpin ();
+
+public:
+  PinnedPage ();
+  PinnedPage (PinnedPage&& other);
+  PinnedPage& operator= (PinnedPage&& other);
+  PinnedPage (const PinnedPage&) = delete;
+  PinnedPage& operator= (const PinnedPage&) = delete;
+  ~PinnedPage ();
+
+  char* GetData () const { return this->data; }
+  PageNum GetPageNum () const { return this->page_num; }
+  // Bytes of data at GetData ()
+  int GetPageSize () const { return this->page_size; }
+  bool IsPinned () const { return this->filehandle != NULL; }
+
+  // Have the page written back once unpinned
+  void MarkDirty () { this->dirty = true; }
+  // Unpin the page now
+  void Release ();
 };
 
 
@@ -114,6 +204,8 @@ DECLARE_EXCEPTION (PageAlreadyFree, "Page already free.");
 DECLARE_EXCEPTION (PageAlreadyPinned, "Page already pinned.");
 DECLARE_EXCEPTION (Eof, "End of file.");
 DECLARE_EXCEPTION (BufferTooSmall, "Attempting to resize, buffer too small.");
+DECLARE_EXCEPTION (ReadOnlyFile, "File is opened read only.");
+DECLARE_EXCEPTION (BadPageSize, "Invalid page size.");
 
 DECLARE_EXCEPTION (NoMemory, "No memory.");
 DECLARE_EXCEPTION (NoBufferSpace, "No buffer space.");
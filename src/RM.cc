@@ -1,6 +1,9 @@
 #include <cstring>
 #include <cassert>
 #include <fstream>
+#include <algorithm>
+#include <functional>
+#include <vector>
 
 #include "RM.h"
 
@@ -8,25 +11,47 @@ namespace RM
 {
 
 Record::Record ()
+  : data (NULL) {}
+
+Record::Record (const RecordRef& ref)
+  : data_ (ref.data, ref.data + ref.size), rid (ref.rid)
 {
-  memset (this->data_, 0, PF::kPageSize);
-  this->data = this->data_;
+  this->data = this->data_.empty () ? NULL : this->data_.data ();
 }
 
 Record::Record (const Record& other)
+  : data_ (other.data_), rid (other.rid)
 {
-  memcpy (this->data_, other.data_, PF::kPageSize);
-  this->rid = other.rid;
-  this->data = this->data_;
+  this->data = this->data_.empty () ? NULL : this->data_.data ();
+}
+
+Record::Record (Record&& other)
+  : data_ (std::move (other.data_)), rid (other.rid), data (other.data)
+{
+  other.data = NULL;
 }
 
 Record& Record::operator = (const Record& other)
 {
-  memcpy (this->data_, other.data_, PF::kPageSize);
+  this->data_ = other.data_;
+  this->rid = other.rid;
+  this->data = this->data_.empty () ? NULL : this->data_.data ();
+  return (*this);
+}
+
+Record& Record::operator = (Record&& other)
+{
+  this->data_ = std::move (other.data_);
   this->rid = other.rid;
-  this->data = this->data_;
+  this->data = other.data;
+  other.data = NULL;
   return (*this);
 }
+
+int Record::size () const
+{
+  return this->data_.size ();
+}
   
 bool Record::operator == (const Record& other) const
 {
@@ -90,7 +115,7 @@ int Manager::MakeBlob (const char *relName, const char *fileName)
 
   // Write the input file, page by page.
   for (int i = 0; i < pg_count; ++i) {
-    auto pg = blob_file.AllocatePage ();
+    auto pg = blob_file.PinNewPage ();
     auto data = pg.GetData ();
     int offset = 0;
     if (i == 0) {
@@ -108,31 +133,37 @@ int Manager::MakeBlob (const char *relName, const char *fileName)
   return blob_number;
 }
 
-void Manager::CreateFile (const char* fileName, int record_size)
+void Manager::CreateFile (const char* fileName, int record_size,
+                          int page_size, bool compressed)
 {
   if (fileName == NULL) throw error::BadArgument ();
   if (record_size <= 0) throw error::BadArgument ();
-  if (record_size > PF::kPageSize) throw error::BadArgument ();
+  // A page has to hold at least one record and its bit in the bitmap.
+  int data_size = page_size - (MEMORY_PAGE_SIZE - PF_PAGE_SIZE);
+  if (record_size > data_size - (int) sizeof (PageHdr) - 1)
+    throw error::BadArgument ();
 
   // Create header
-  this->pfm.CreateFile (fileName);
+  this->pfm.CreateFile (fileName, page_size, compressed);
   auto pf_file = this->pfm.OpenFile (fileName);
-  auto pf_hdr_pg = pf_file.AllocatePage ();
-  HeaderPage hdr_pg (pf_hdr_pg);
-  hdr_pg.clear ();
-  hdr_pg.SetRecordSize (record_size);
-
-  // create first page
-  auto pf_first_pg = pf_file.AllocatePage ();
-  Page first_pg (pf_first_pg, record_size);
-  first_pg.clear ();
-
-  // Reference the first page from the header page.
-  hdr_pg.SetFirstPageNum (pf_first_pg.GetPageNum ());
-
-  // Done with both the pages.
-  pf_file.DoneWritingTo (pf_hdr_pg);
-  pf_file.DoneWritingTo (pf_first_pg);
+  {
+    HeaderPage hdr_pg (pf_file.PinNewPage ());
+    hdr_pg.clear ();
+    hdr_pg.SetRecordSize (record_size);
+
+    // create first page
+    Page first_pg (pf_file.PinNewPage (), record_size);
+    first_pg.clear ();
+
+    // Reference the first page from the header page, both as the first
+    // page of the file and as the first one with free slots.
+    hdr_pg.SetFirstPageNum (first_pg.GetPageNum ());
+    hdr_pg.SetFirstFreePageNum (first_pg.GetPageNum ());
+
+    // Done with both the pages.
+    pf_file.DoneWritingTo (hdr_pg.pf_page);
+    pf_file.DoneWritingTo (first_pg.pf_page);
+  }
   this->pfm.CloseFile (pf_file);
 }
 
@@ -143,11 +174,11 @@ void Manager::DestroyFile (const char *fileName)
   this->pfm.DestroyFile (fileName);
 }
 
-FileHandle Manager::OpenFile (const char *fileName)
+FileHandle Manager::OpenFile (const char *fileName, PF_OpenMode mode)
 {
   if (fileName == NULL) throw error::BadArgument ();
 
-  FileHandle fh (this->pfm.OpenFile (fileName));
+  FileHandle fh (this->pfm.OpenFile (fileName, mode));
   return fh;
 }
 
@@ -165,21 +196,25 @@ FileHandle::FileHandle ()
 FileHandle::FileHandle (PF::FileHandle pf_file_handle)
   : pf_file_handle (pf_file_handle)
 {
-  auto pf_header = this->pf_file_handle.GetFirstPage();
-  HeaderPage header (pf_header);
+  HeaderPage header (this->pf_file_handle.PinFirstPage ());
 
   this->record_size = header.GetRecordSize ();
   this->first_page_num = header.GetFirstPageNum ();
+  this->first_free_page_num = header.GetFirstFreePageNum ();
+  // Files made before the free list have a 0 there, page 0 being the
+  // header, and room in their first page.
+  if (this->first_free_page_num == 0)
+    this->first_free_page_num = this->first_page_num;
   this->next_blob_id_available = header.GetNextAvailableBlobId ();
   this->header_modified = false;
 
-  this->pf_file_handle.UnpinPage (pf_header);
+  this->pf_file_handle.UnpinPage (header.pf_page);
 }
 
 Record FileHandle::get (const RID& rid) const
 {
-  auto page = this->GetPage (rid.page_num);
-  auto rec = page.get (rid.slot_num);
+  auto page = this->GetPage (rid.page_num, RANDOM_LOOKUP);
+  Record rec (page.ref (rid.slot_num));
   this->UnpinPage (page);
   return rec;
 }
@@ -188,74 +223,110 @@ RID FileHandle::insert (const char* rec_data)
 {
   if (rec_data == NULL) throw error::BadArgument ();
 
-  // We maintain the invariant that the first page
-  // always has space for a new record.
-  auto page = this->GetFirstPage ();
+  auto page = this->GetFreePage ();
 
   SlotNum slot_num = page.insert (rec_data);
-  RID rid (this->first_page_num, slot_num);
+  RID rid (page.GetPageNum (), slot_num);
   if (page.full()) {
-    this->MakeNewFirstPage ();
+    this->FilledUp (page);
   }
   this->DoneWritingTo (page);
-  this->ForcePages ();
   return rid;
 }
 
-void FileHandle::Delete (const RID& rid)
+vector<RID> FileHandle::insert_batch (const char* recs_data, int num_recs)
 {
-  auto page = this->GetPage (rid.page_num);
-  try {
-    page.Delete (rid.slot_num);
+  if (recs_data == NULL || num_recs < 0) throw error::BadArgument ();
+
+  vector<RID> rids;
+  rids.reserve (num_recs);
+  int i = 0;
+  while (i < num_recs) {
+    // Fill a page up before moving on to the next one.
+    auto page = this->GetFreePage ();
+    while (i < num_recs && not page.full ()) {
+      SlotNum slot_num = page.insert (recs_data + i * this->record_size);
+      rids.push_back (RID (page.GetPageNum (), slot_num));
+      ++i;
+    }
+    if (page.full ()) {
+      this->FilledUp (page);
+    }
+    this->DoneWritingTo (page);
   }
-  catch (exception& e) {
-    this->UnpinPage (page);
-    throw;
+  return rids;
+}
+
+void FileHandle::Delete (const RID& rid)
+{
+  auto page = this->GetPage (rid.page_num, RANDOM_LOOKUP);
+  bool was_full = page.full ();
+  page.Delete (rid.slot_num);
+  if (was_full) {
+    // The page has room again: it goes first in the free list.
+    page.SetNextFreePageNum (this->first_free_page_num);
+    this->first_free_page_num = page.GetPageNum ();
+    this->header_modified = true;
   }
   this->DoneWritingTo (page);
 }
 
 void FileHandle::update (const Record& rec)
 {
-  auto page = this->GetPage (rec.rid.page_num);
-  try {
-    page.update (rec);
-  }
-  catch (exception& e) {
-    this->UnpinPage (page);
-    throw;
-  }
+  auto page = this->GetPage (rec.rid.page_num, RANDOM_LOOKUP);
+  page.update (rec);
   this->DoneWritingTo (page);
 }
 
-Page FileHandle::GetFirstPage () const
+Page FileHandle::GetFirstPage (ClientHint hint) const
 {
-  return this->GetPage (this->first_page_num);
+  return this->GetPage (this->first_page_num, hint);
 }
 
-Page FileHandle::GetPage (PageNum page_num) const
+Page FileHandle::GetPage (PageNum page_num, ClientHint hint) const
 {
-  auto pf_page = this->pf_file_handle.GetPage (page_num);
-  Page page (pf_page, this->record_size);
-  return page;
+  return Page (this->pf_file_handle.PinPage (page_num, hint),
+               this->record_size);
 }
 
 void FileHandle::MakeNewFirstPage ()
 {
-  auto pf_page = this->pf_file_handle.AllocatePage ();
-  Page new_first_page (pf_page, this->record_size);
+  Page new_first_page (this->pf_file_handle.PinNewPage (),
+                       this->record_size);
+  new_first_page.clear ();
   new_first_page.SetNextPageNum (this->first_page_num);
+  new_first_page.SetNextFreePageNum (this->first_free_page_num);
   this->header_modified = true;
   this->first_page_num = new_first_page.GetPageNum ();
+  this->first_free_page_num = new_first_page.GetPageNum ();
   this->DoneWritingTo (new_first_page);
 }
 
-void FileHandle::DoneWritingTo (const Page& page)
+Page FileHandle::GetFreePage ()
+{
+  if (this->first_free_page_num == INVALID) {
+    this->MakeNewFirstPage ();
+  }
+  return this->GetPage (this->first_free_page_num);
+}
+
+void FileHandle::FilledUp (Page& page)
+{
+  // Records only go into the first page of the free list.
+  assert (page.GetPageNum () == this->first_free_page_num);
+
+  // A 0 is left from before the free list, when the field was unused.
+  PageNum next = page.hdr->next_free_page;
+  this->first_free_page_num = (next == 0 ? INVALID : next);
+  this->header_modified = true;
+}
+
+void FileHandle::DoneWritingTo (Page& page)
 {
   this->pf_file_handle.DoneWritingTo (page.pf_page);
 }
 
-void FileHandle::UnpinPage (const Page& page) const
+void FileHandle::UnpinPage (Page& page) const
 {
   this->pf_file_handle.UnpinPage (page.pf_page);
 }
@@ -264,11 +335,11 @@ void FileHandle::UpdateHeader ()
 {
   assert (this->header_modified);
 
-  auto pf_header = this->pf_file_handle.GetFirstPage ();
-  HeaderPage header_page (pf_header);
+  HeaderPage header_page (this->pf_file_handle.PinFirstPage ());
   header_page.SetNextAvailableBlobId (this->next_blob_id_available);
   header_page.SetFirstPageNum (this->first_page_num);
-  this->pf_file_handle.DoneWritingTo (pf_header);
+  header_page.SetFirstFreePageNum (this->first_free_page_num);
+  this->pf_file_handle.DoneWritingTo (header_page.pf_page);
 
   this->header_modified = false;
 }
@@ -278,11 +349,11 @@ bool FileHandle::HasNextPage (const Page& page) const
   return (page.hdr->next_page != INVALID);
 }
 
-Page FileHandle::GetNextPage (const Page& page) const
+Page FileHandle::GetNextPage (const Page& page, ClientHint hint) const
 {
   assert (this->HasNextPage (page));
   
-  return this->GetPage (page.hdr->next_page);
+  return this->GetPage (page.hdr->next_page, hint);
 }
 
 void FileHandle::ForcePages (PageNum pageNum)
@@ -290,12 +361,98 @@ void FileHandle::ForcePages (PageNum pageNum)
   this->pf_file_handle.ForcePages (pageNum);
 }
 
-Page::Page (PF::PageHandle& pf_page, int record_size)
-  : pf_page (pf_page)
+int FileHandle::Compact ()
+{
+  // Find the data pages and count the records.
+  vector<PageNum> page_nums;
+  int num_records = 0;
+  int max_num_records = 0;
+  {
+    auto page = this->GetFirstPage ();
+    while (true) {
+      page_nums.push_back (page.GetPageNum ());
+      num_records += page.hdr->num_records;
+      max_num_records = page.max_num_records;
+      if (not this->HasNextPage (page)) break;
+      page = this->GetNextPage (page);
+    }
+  }
+
+  // The records fit in num_pages pages.  There is always at least one
+  // page to start scans from.
+  int num_pages = max (1, (num_records + max_num_records - 1) /
+                          max_num_records);
+  sort (page_nums.begin (), page_nums.end ());
+
+  // They are the lowest pages among the data pages and the free pages of
+  // the file.  The free pages are those PinNewPage gives, lowest first,
+  // so that the pages the PF layer keeps for itself are never used; the
+  // one given last may not be needed.
+  vector<PageNum> dest_nums;
+  size_t num_kept = 0;
+  while ((int) dest_nums.size () < num_pages) {
+    Page page (this->pf_file_handle.PinNewPage (), this->record_size);
+    PageNum new_num = page.GetPageNum ();
+    while (num_kept < page_nums.size () &&
+           page_nums [num_kept] < new_num &&
+           (int) dest_nums.size () < num_pages)
+      dest_nums.push_back (page_nums [num_kept++]);
+    if ((int) dest_nums.size () < num_pages) {
+      page.clear ();
+      this->DoneWritingTo (page);
+      dest_nums.push_back (new_num);
+    } else {
+      this->UnpinPage (page);
+      this->pf_file_handle.DisposePage (new_num);
+    }
+  }
+
+  // Move the records of the other pages into them, and dispose of the
+  // pages emptied.
+  size_t dest_i = 0;
+  Page dest = this->GetPage (dest_nums [dest_i]);
+  for (size_t i = num_kept; i < page_nums.size (); ++i) {
+    Page src = this->GetPage (page_nums [i]);
+    for (SlotNum slot = src.bitmap.findNextSet (0);
+         slot != -1;
+         slot = src.bitmap.findNextSet (slot + 1)) {
+      while (dest.full ()) {
+        this->DoneWritingTo (dest);
+        dest = this->GetPage (dest_nums [++dest_i]);
+      }
+      dest.insert (src.records + slot * this->record_size);
+    }
+    this->UnpinPage (src);
+    this->pf_file_handle.DisposePage (page_nums [i]);
+  }
+  this->DoneWritingTo (dest);
+
+  // Chain the pages in page order, and list the ones with free slots,
+  // the lowest first.
+  this->first_free_page_num = INVALID;
+  for (int i = num_pages - 1; i >= 0; --i) {
+    auto page = this->GetPage (dest_nums [i]);
+    page.SetNextPageNum (i < num_pages - 1 ? dest_nums [i + 1] : INVALID);
+    if (not page.full ()) {
+      page.SetNextFreePageNum (this->first_free_page_num);
+      this->first_free_page_num = dest_nums [i];
+    }
+    this->DoneWritingTo (page);
+  }
+  this->first_page_num = dest_nums [0];
+  this->header_modified = true;
+  this->UpdateHeader ();
+
+  this->pf_file_handle.Shrink ();
+  return page_nums.size () - num_pages;
+}
+
+Page::Page (PF::PinnedPage&& pf_page, int record_size)
+  : pf_page (std::move (pf_page))
 {
   this->record_size = record_size;
 
-  char* data = pf_page.GetData ();
+  char* data = this->pf_page.GetData ();
 
   this->hdr = (PageHdr*) data;
   data += sizeof (PageHdr);
@@ -307,7 +464,7 @@ Page::Page (PF::PageHandle& pf_page, int record_size)
   //      n  <=  -------------------------
   //               1 + 8 * rec_size
 
-  int available_bytes = PF::kPageSize - sizeof (PageHdr);
+  int available_bytes = this->pf_page.GetPageSize () - sizeof (PageHdr);
   this->max_num_records = (8*available_bytes - 7) / (1 + 8*record_size);
   new (&this->bitmap) Bitmap (this->max_num_records, data);
   data += this->bitmap.num_bytes ();
@@ -324,22 +481,23 @@ void Page::clear ()
 {
   this->hdr->num_records = 0;
   this->hdr->next_page = INVALID;
-  this->hdr->next_blob_id_available = 0;
+  this->hdr->next_free_page = INVALID;
   this->bitmap.clear_all ();
 }
 
 Record Page::get (SlotNum slot_num) const
+{
+  return Record (this->ref (slot_num));
+}
+
+RecordRef Page::ref (SlotNum slot_num) const
 {
   assert (slot_num < this->max_num_records);
   assert (this->bitmap.get (slot_num));
 
-  Record record;
-  record.rid.page_num = this->pf_page.GetPageNum ();
-  record.rid.slot_num = slot_num;
-  memcpy (record.data,
-          this->records + slot_num * this->record_size,
-          this->record_size);
-  return record;
+  return RecordRef (RID (this->pf_page.GetPageNum (), slot_num),
+                    this->records + slot_num * this->record_size,
+                    this->record_size);
 }
 
 SlotNum Page::insert (const char* rec_data)
@@ -381,6 +539,11 @@ void Page::SetNextPageNum (PageNum next_page_num)
   this->hdr->next_page = next_page_num;
 }
 
+void Page::SetNextFreePageNum (PageNum next_free_page_num)
+{
+  this->hdr->next_free_page = next_free_page_num;
+}
+
 bool Page::full () const
 {
   assert (this->hdr->num_records <= this->max_num_records);
@@ -388,12 +551,13 @@ bool Page::full () const
   return this->hdr->num_records == this->max_num_records;
 }
 
-HeaderPage::HeaderPage (PF::PageHandle& pf_page)
-  : pf_page (pf_page) {}
+HeaderPage::HeaderPage (PF::PinnedPage&& pf_page)
+  : pf_page (std::move (pf_page)) {}
 
 void HeaderPage::clear ()
 {
   this->SetFirstPageNum (INVALID);
+  this->SetFirstFreePageNum (INVALID);
 }
 
 void HeaderPage::SetRecordSize (int record_size)
@@ -431,6 +595,20 @@ int HeaderPage::GetNextAvailableBlobId () const
   return *(int*) data;
 }
 
+void HeaderPage::SetFirstFreePageNum (PageNum first_free_page_num)
+{
+  char *data = this->pf_page.GetData ();
+  data += 3 * sizeof (int);            // get past the blob id too.
+  *(PageNum*) data = first_free_page_num;
+}
+
+PageNum HeaderPage::GetFirstFreePageNum () const
+{
+  char *data = this->pf_page.GetData ();
+  data += 3 * sizeof (int);            // get past the blob id too.
+  return *(PageNum*) data;
+}
+
 int HeaderPage::GetRecordSize () const
 {
   return *(int*)(this->pf_page.GetData ());
@@ -443,7 +621,8 @@ void Scan::open (const FileHandle &fileHandle,
                  int         attrLength,
                  int         attrOffset,
                  CompOp      compOp,
-                 const void* value)
+                 const void* value,
+                 ClientHint  pinHint)
 {
   if ((this->scan_underway) ||
       (attrLength < 0) ||
@@ -466,18 +645,18 @@ void Scan::open (const FileHandle &fileHandle,
   this->attr_offset = attrOffset;
   this->comp_op = compOp;
   this->value = value;
+  this->pin_hint = pinHint;
   this->current_slot_num = 0;
-  this->current_page = fileHandle.GetFirstPage ();
-  this->already_unpinned = false;
+  this->current_page = fileHandle.GetFirstPage (pinHint);
   this->scan_underway = true;
 }
 
-bool Scan::satisfy (const Record& rec) const
+bool Scan::satisfy (const char* rec_data) const
 {
   if (this->comp_op == NO_OP) return true;
 
   if (this->attr_type == INT) {
-    int attribute = *(int*)(rec.data + this->attr_offset);
+    int attribute = *(int*)(rec_data + this->attr_offset);
     int value = *(int *) this->value;
     switch (this->comp_op) {
       case LT_OP: return attribute < value;
@@ -490,7 +669,7 @@ bool Scan::satisfy (const Record& rec) const
     }
   }
   else if (this->attr_type == FLOAT) {
-    float attribute = *(float*)(rec.data + this->attr_offset);
+    float attribute = *(float*)(rec_data + this->attr_offset);
     float value = *(float*) this->value;
     switch (this->comp_op) {
       case LT_OP: return attribute < value;
@@ -503,7 +682,7 @@ bool Scan::satisfy (const Record& rec) const
     }
   }
   else {
-    const char* attribute = rec.data + this->attr_offset;
+    const char* attribute = rec_data + this->attr_offset;
     char* value = (char*) this->value;
     switch (this->comp_op) {
       case LT_OP: return strncmp (attribute, value, this->attr_len) < 0;
@@ -519,44 +698,150 @@ bool Scan::satisfy (const Record& rec) const
 
 Record Scan::next ()
 {
-  if (this->current_slot_num == this->current_page.max_num_records) {
-    // We have returned all the records from this page.
+  RecordRef ref = this->next_ref ();
+  if (ref.data == NULL) return end;
+  return Record (ref);
+}
 
-    if (not this->file_handle->HasNextPage (this->current_page)) {
-      // There are no more pages.
-      this->file_handle->UnpinPage (this->current_page);
-      this->already_unpinned = true;
-      return end;
-    }
+// Move on to the next page once the current one has been read.  The
+// last page is unpinned, and false returned, at the end of the file.
+bool Scan::NextPage ()
+{
+  if (not this->current_page.pf_page.IsPinned ()) return false;
+  if (this->current_slot_num < this->current_page.max_num_records)
+    return true;
 
+  if (not this->file_handle->HasNextPage (this->current_page)) {
+    // There are no more pages.
     this->file_handle->UnpinPage (this->current_page);
-    this->current_page = this->file_handle->GetNextPage (this->current_page);
-    this->current_slot_num = 0;
+    return false;
   }
 
-  while (this->current_slot_num < this->current_page.max_num_records) {
-    if (not this->current_page.bitmap.get (this->current_slot_num)) {
-      this->current_slot_num ++;
-      continue;
-    }
-    Record rec = this->current_page.get (this->current_slot_num);
-    if (not this->satisfy (rec)) {
-      this->current_slot_num ++;
-      continue;
+  // Assigning the next page unpins this one.
+  this->current_page = this->file_handle->GetNextPage (this->current_page,
+                                                       this->pin_hint);
+  this->current_slot_num = 0;
+  return true;
+}
+
+RecordRef Scan::next_ref ()
+{
+  while (this->NextPage ()) {
+    // Empty slots are skipped a word of the bitmap at a time.
+    const Bitmap& bitmap = this->current_page.bitmap;
+    SlotNum slot_num;
+    while ((slot_num = bitmap.findNextSet (this->current_slot_num)) != -1) {
+      RecordRef rec = this->current_page.ref (slot_num);
+      this->current_slot_num = slot_num + 1;
+      if (this->satisfy (rec.data)) return rec;
     }
-    else {
-      this->current_slot_num ++;
-      return rec;
+    this->current_slot_num = this->current_page.max_num_records;
+  }
+  return RecordRef ();
+}
+
+bool Scan::next_batch (RecordBatch& batch)
+{
+  batch.slots.clear ();
+  while (this->NextPage ()) {
+    const Page& page = this->current_page;
+    for (SlotNum slot_num = page.bitmap.findNextSet (this->current_slot_num);
+         slot_num != -1;
+         slot_num = page.bitmap.findNextSet (slot_num + 1)) {
+      batch.slots.push_back (slot_num);
     }
+    this->current_slot_num = page.max_num_records;
+
+    batch.page_num = page.GetPageNum ();
+    batch.records = page.records;
+    batch.record_size = page.record_size;
+    this->Select (batch);
+    if (not batch.slots.empty ()) return true;
   }
+  return false;
+}
 
-  return this->next ();
+// Keep the slots whose attribute compares to value as compare says.
+// The test is made on every slot, and only decides how far the next
+// slot is written, so that the loop does not branch on it.
+template <typename T, typename Compare>
+static void keep_if (vector<SlotNum>& slots, const char* records,
+                     int record_size, int offset, T value, Compare compare)
+{
+  size_t kept = 0;
+  for (size_t i = 0; i < slots.size (); ++i) {
+    T attribute = *(const T*)(records + slots [i] * record_size + offset);
+    slots [kept] = slots [i];
+    kept += compare (attribute, value);
+  }
+  slots.resize (kept);
+}
+
+template <typename T>
+static void keep_if (vector<SlotNum>& slots, const char* records,
+                     int record_size, int offset, T value, CompOp comp_op)
+{
+  switch (comp_op) {
+    case LT_OP:
+      keep_if (slots, records, record_size, offset, value, less<T> ());
+      break;
+    case GT_OP:
+      keep_if (slots, records, record_size, offset, value, greater<T> ());
+      break;
+    case EQ_OP:
+      keep_if (slots, records, record_size, offset, value, equal_to<T> ());
+      break;
+    case LE_OP:
+      keep_if (slots, records, record_size, offset, value,
+               less_equal<T> ());
+      break;
+    case GE_OP:
+      keep_if (slots, records, record_size, offset, value,
+               greater_equal<T> ());
+      break;
+    case NE_OP:
+      keep_if (slots, records, record_size, offset, value,
+               not_equal_to<T> ());
+      break;
+    default:
+      break;
+  }
+}
+
+void Scan::Select (RecordBatch& batch) const
+{
+  if (this->comp_op == NO_OP) return;
+
+  if (this->attr_type == INT) {
+    keep_if (batch.slots, batch.records, batch.record_size,
+             this->attr_offset, *(const int*) this->value, this->comp_op);
+  }
+  else if (this->attr_type == FLOAT) {
+    keep_if (batch.slots, batch.records, batch.record_size,
+             this->attr_offset, *(const float*) this->value, this->comp_op);
+  }
+  else {
+    // Each string is compared to the value once, and the positions of
+    // the results are then filtered like ints, against 0.
+    vector<int> order (batch.slots.size ());
+    vector<SlotNum> positions (batch.slots.size ());
+    for (size_t i = 0; i < batch.slots.size (); ++i) {
+      order [i] = strncmp (batch.data (i) + this->attr_offset,
+                           (const char*) this->value, this->attr_len);
+      positions [i] = i;
+    }
+    keep_if (positions, (const char*) order.data (), sizeof (int), 0, 0,
+             this->comp_op);
+    for (size_t i = 0; i < positions.size (); ++i)
+      batch.slots [i] = batch.slots [positions [i]];
+    batch.slots.resize (positions.size ());
+  }
 }
 
 void Scan::close ()
 {
   this->scan_underway = false;
-  if (not this->already_unpinned)
+  if (this->current_page.pf_page.IsPinned ())
     this->file_handle->UnpinPage (this->current_page);
 }
 
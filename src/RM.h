@@ -1,6 +1,8 @@
 #ifndef __RM_H
 #define __RM_H
 
+#include <vector>
+
 #include "PF.h"
 #include "rm_rid.h"
 #include "Array.h"
@@ -18,23 +20,71 @@ struct PageHdr
   int num_records;
   PageNum next_page;
 
-  /* This field is relevant only for header pages */
-  int next_blob_id_available;
+  /* Next page in the list of pages with free slots.  Relevant only
+     while this page is not full */
+  PageNum next_free_page;
+};
+
+
+// A record as it lies in a pinned page frame.  Nothing is copied, so
+// it is only good for as long as the page stays pinned: copy it into a
+// Record to keep it longer.
+struct RecordRef
+{
+  RID rid;
+  const char* data;
+  int size;
+
+  RecordRef () : data (NULL), size (0) {}
+  RecordRef (const RID& rid, const char* data, int size)
+    : rid (rid), data (data), size (size) {}
 };
 
 
+// The records of one page that satisfy a scan's condition.  slots is
+// the selection vector: the qualifying slots, in ascending order.  The
+// records are read in place, so a batch is only good until the scan
+// that filled it moves on or is closed.
+struct RecordBatch
+{
+  PageNum page_num;
+  const char* records;            // the page's first slot
+  int record_size;
+  vector<SlotNum> slots;
+
+  RecordBatch () : page_num (INVALID), records (NULL), record_size (0) {}
+
+  int size () const { return this->slots.size (); }
+  const char* data (int i) const
+  {
+    return this->records + this->slots [i] * this->record_size;
+  }
+  RID rid (int i) const { return RID (this->page_num, this->slots [i]); }
+  RecordRef operator [] (int i) const
+  {
+    return RecordRef (this->rid (i), this->data (i), this->record_size);
+  }
+};
+
+
+// A record holding its own copy of its record_size bytes.
 class Record
 {
 private:
-  char data_ [PF::kPageSize];
+  vector<char> data_;
 
 public:
   RID rid;
   char* data;
 
   Record ();
+  Record (const RecordRef& ref);
   Record (const Record& other);
+  Record (Record&& other);
   Record& operator = (const Record& other);
+  Record& operator = (Record&& other);
+
+  int size () const;
 
   bool operator == (const Record& other) const;
   bool operator != (const Record& other) const;
@@ -48,7 +98,7 @@ class Page
   friend class Manager;
 
 private:
-  PF::PageHandle pf_page;
+  PF::PinnedPage pf_page;
   int record_size;
   int max_num_records;
   PageHdr* hdr;
@@ -57,28 +107,35 @@ private:
   Page () {}
 
 public:
-  Page (PF::PageHandle& pf_page, int record_size);
+  // The page stays pinned as long as the Page holds it
+  Page (PF::PinnedPage&& pf_page, int record_size);
 
   void clear ();
 
   Record get (SlotNum slot_num) const;
+  // Good for as long as the page stays pinned
+  RecordRef ref (SlotNum slot_num) const;
   SlotNum insert (const char* rec_data);
   void Delete (SlotNum slot_num);
   void update (const Record& rec);
 
   PageNum GetPageNum () const;
   void SetNextPageNum (PageNum next_page_num);
+  void SetNextFreePageNum (PageNum next_free_page_num);
   bool full () const;
 };
 
 
 class HeaderPage
 {
+  friend class FileHandle;
+  friend class Manager;
+
 private:
-  PF::PageHandle pf_page;
+  PF::PinnedPage pf_page;
 
 public:
-  HeaderPage (PF::PageHandle& pf_page);
+  HeaderPage (PF::PinnedPage&& pf_page);
 
   void clear ();
 
@@ -89,6 +146,8 @@ public:
   PageNum GetFirstPageNum () const;
   void SetFirstPageNum (PageNum first_page_num);
   void SetNextAvailableBlobId (int next_available_blob_id);
+  PageNum GetFirstFreePageNum () const;
+  void SetFirstFreePageNum (PageNum first_free_page_num);
 };
 
 
@@ -105,28 +164,43 @@ public:
 private:
   bool header_modified;
   PageNum first_page_num;
+  // The pages that are not full are kept in a list, the page a slot was
+  // last freed on first.  Records go into the first of them.
+  PageNum first_free_page_num;
   int next_blob_id_available;
 
+  Page GetFreePage ();
+  void FilledUp (Page& page);
+
 public:
   FileHandle ();
   FileHandle (PF::FileHandle pf_file_handle);
   
   Record get (const RID& rid) const;
   RID insert (const char* rec_data);
+  // Insert num_recs records laid out back to back in recs_data.  Pages
+  // are filled one after the other, each pinned once.
+  vector<RID> insert_batch (const char* recs_data, int num_recs);
   void Delete (const RID& rid);
   void update (const Record& rec);
 
-  Page GetPage (PageNum page_num) const;
-  Page GetFirstPage () const;
+  // hint tells the buffer manager how the page is accessed
+  Page GetPage (PageNum page_num, ClientHint hint = NO_HINT) const;
+  Page GetFirstPage (ClientHint hint = NO_HINT) const;
 
   bool HasNextPage (const Page& page) const;
-  Page GetNextPage (const Page& page) const;
+  Page GetNextPage (const Page& page, ClientHint hint = NO_HINT) const;
 
   void MakeNewFirstPage ();
-  void DoneWritingTo (const Page& page);
-  void UnpinPage (const Page& page) const;
+  void DoneWritingTo (Page& page);
+  void UnpinPage (Page& page) const;
   void UpdateHeader ();
   void ForcePages (PageNum pageNum = ALL_PAGES);
+
+  // Move the records into the first pages of the file, give the pages
+  // emptied back and shrink the file.  Moved records get new RIDs.
+  // Returns the # of pages given back.
+  int Compact ();
 };
 
 
@@ -140,26 +214,37 @@ private:
   int attr_offset;
   CompOp comp_op;
   const void* value;
+  ClientHint pin_hint;
 
   SlotNum current_slot_num;
-  Page current_page;
-  bool already_unpinned;
+  Page current_page;              // unpinned once the scan is over
   bool scan_underway;
 
-  bool satisfy (const Record& rec) const;
+  bool satisfy (const char* rec_data) const;
+  bool NextPage ();
+  void Select (RecordBatch& batch) const;
 
 public:
   static const Record end;
 
-  Scan () : already_unpinned (true), scan_underway (false) {}
+  Scan () : scan_underway (false) {}
   ~Scan () {}
   void open (const FileHandle &fileHandle,
              AttrType    attrType,
              int         attrLength,
              int         attrOffset,
              CompOp      compOp,
-             const void* value);
+             const void* value,
+             ClientHint  pinHint = NO_HINT);
   Record next ();
+  // Like next, without copying the record out of its page.  The
+  // RecordRef is good until the following call to next_ref, next or
+  // close; a default one (NULL data) marks the end of the scan.
+  RecordRef next_ref ();
+  // Fill batch with the qualifying records of the next page that has
+  // any, evaluating the condition over the whole page at once.  Returns
+  // false, with an empty batch, at the end of the scan.
+  bool next_batch (RecordBatch& batch);
   void close ();
 };
 
@@ -175,9 +260,12 @@ public:
   
   int MakeBlob (const char* relName, const char *fileName);
   Blob GetBlob (const char* relName, int blob_id);
-  void CreateFile (const char* fileName, int record_size);
+  void CreateFile (const char* fileName, int record_size,
+                   int page_size = MEMORY_PAGE_SIZE,
+                   bool compressed = false);
   void DestroyFile (const char *fileName);
-  FileHandle OpenFile (const char *fileName);
+  FileHandle OpenFile (const char *fileName,
+                       PF_OpenMode mode = PF_READWRITE);
   void CloseFile (FileHandle &fileHandle);
 };
 
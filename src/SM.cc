@@ -13,6 +13,8 @@
 #include <sstream>
 #include <map>
 #include <cstdlib>
+#include <climits>
+#include <strings.h>
 #include <dlfcn.h>
 #include <unistd.h>
 #include "redbase.h"
@@ -24,6 +26,9 @@
 
 using namespace std;
 
+// # of rows Load parses before inserting them together
+static const int kLoadBatchRows = 4096;
+
 // CSV parsing code from http://www.zedwood.com/article/cpp-csv-parser
 vector<string> csv_read_row(istream &in, char delimiter)
 {
@@ -107,9 +112,12 @@ Attribute::Attribute (const char* table_name,
 
 namespace SM
 {
-Manager::Manager(IX::Manager &ixm, RM::Manager &rmm)
-  : ixm (ixm),
-    rmm (rmm) {}
+Manager::Manager(PF::Manager &pfm, IX::Manager &ixm, RM::Manager &rmm)
+  : pfm (pfm),
+    ixm (ixm),
+    rmm (rmm),
+    page_size (MEMORY_PAGE_SIZE),
+    compress_tables (false) {}
 
 Manager::~Manager()
 {
@@ -123,6 +131,10 @@ void Manager::OpenDb(const char *dbName)
   if (strlen(dbName) > DB_NAME_MAXLEN) throw error::DBNameTooLong ();
   if (chdir(dbName) < 0) throw error::ChdirError ();
 
+  // Redo what the last run committed but did not write back, then log
+  // the changes to the files opened from now on.
+  this->pfm.OpenLog ("wal");
+  this->pfm.LoadWarmPages ("warmpages");
   this->relcat = this->rmm.OpenFile ("relcat");
   this->attrcat = this->rmm.OpenFile ("attrcat");
 }
@@ -131,6 +143,21 @@ void Manager::CloseDb()
 {
   this->rmm.CloseFile (this->relcat);
   this->rmm.CloseFile (this->attrcat);
+  this->pfm.CloseLog ();
+  this->pfm.SaveWarmPages ("warmpages");
+}
+
+void Manager::Commit()
+{
+  this->pfm.Commit ();
+
+  // The catalogs stay open, so write them back, headers included, before
+  // the log they are in is started over.
+  if (this->pfm.GetLogSize () > PF_LOG_CHECKPOINT_SIZE) {
+    this->relcat.ForcePages ();
+    this->attrcat.ForcePages ();
+    this->pfm.CheckpointLog ();
+  }
 }
 
 RM::Record Manager::GetTableMetadata (const char* relName) const
@@ -166,11 +193,11 @@ bool attr_offset_comp (const RM::Record& r1, const RM::Record& r2)
 vector<RM::Record> Manager::GetAttributes (const char* relName) const
 {
   RM::Scan scan;
-  RM::Record rec;
+  RM::RecordRef rec;
   vector<RM::Record> vec;
   scan.open (this->attrcat, STRING, MAXNAME + 1, 0, EQ_OP, relName);
-  while ((rec = scan.next()) != scan.end) {
-    vec.push_back (rec);
+  while ((rec = scan.next_ref ()).data != NULL) {
+    vec.emplace_back (rec);
   }
   sort (vec.begin(), vec.end(), attr_offset_comp);
   return vec;
@@ -203,11 +230,10 @@ void Manager::CreateTable(const char *relName,
   }
   Table tbl (relName, offset, attrCount, 0, 1);
   this->relcat.insert ((const char*)&tbl);
-  this->relcat.ForcePages ();
-  this->attrcat.ForcePages ();
 
   // Create table.
-  this->rmm.CreateFile (relName, offset);
+  this->rmm.CreateFile (relName, offset, this->page_size,
+                        this->compress_tables);
 }
 
 void Manager::DropTable(const char *relName)
@@ -236,8 +262,6 @@ void Manager::DropTable(const char *relName)
   scan.close ();
 
   this->relcat.Delete (table_record.rid);
-  this->relcat.ForcePages ();
-  this->attrcat.ForcePages ();
 }
 
 void Manager::CreateIndex(const char *relName,
@@ -269,23 +293,21 @@ void Manager::CreateIndex(const char *relName,
   this->attrcat.update (attr_meta_rec);
 
   // Create the index file
-  this->ixm.CreateIndex (relName, index_num, attr_meta->type, attr_meta->len);
+  this->ixm.CreateIndex (relName, index_num, attr_meta->type, attr_meta->len,
+                         this->page_size);
   auto index = this->ixm.OpenIndex (relName, index_num);
   auto relation = this->rmm.OpenFile (relName);
 
   RM::Scan scan;
-  RM::Record rec;
+  RM::RecordRef rec;
   // Populace the index
   scan.open (this->relcat, STRING, MAXNAME + 1, 0, EQ_OP, relName);
-  while ((rec = scan.next()) != scan.end) {
+  while ((rec = scan.next_ref ()).data != NULL) {
     index.Insert (rec.data + attr_meta->offset, rec.rid);
   }
 
   this->ixm.CloseIndex (index);
   this->rmm.CloseFile (relation);
-
-  this->relcat.ForcePages ();
-  this->attrcat.ForcePages ();
 }
 
 void Manager::DropIndex(const char *relName,
@@ -311,9 +333,6 @@ void Manager::DropIndex(const char *relName,
 
   // Drop the index.
   this->ixm.DestroyIndex (relName, index_num);
-
-  this->relcat.ForcePages ();
-  this->attrcat.ForcePages ();
 }
 
 void Manager::Delete (const char* relName,
@@ -357,21 +376,24 @@ void Manager::Delete (const char* relName,
       this->ixm.CloseIndex (indexes [attr->index_num]);
     }
   }
-
-  this->relcat.ForcePages ();
-  this->attrcat.ForcePages ();
 }
 
 void Manager::Insert (const char* relName,
                       const char* rec_data)
+{
+  this->Insert (relName, rec_data, 1);
+}
+
+void Manager::Insert (const char* relName,
+                      const char* recs_data,
+                      int num_recs)
 {
   auto table_meta_rec = this->GetTableMetadata (relName);
   if (table_meta_rec == RM::Scan::end)
     throw warn::TableDoesNotExist ();
 
-  auto table_rec = this->GetTableMetadata (relName);
   auto attr_recs = this->GetAttributes (relName);
-  Table* table_meta = (Table *) table_rec.data;
+  Table* table_meta = (Table *) table_meta_rec.data;
 
   map<int, IX::IndexHandle> indexes;
   for (unsigned int i = 0; i < attr_recs.size (); ++i) {
@@ -384,16 +406,16 @@ void Manager::Insert (const char* relName,
 
   auto table = this->rmm.OpenFile (relName);
 
-  RID rid = table.insert (rec_data); // Just to get an RID
-  for (unsigned int i = 0; i < attr_recs.size (); ++i) {
-    Attribute* attr = (Attribute *) attr_recs [i].data;
-    if (attr->index_num != -1) {
-      indexes [attr->index_num].Insert (rec_data + attr->offset, rid);
+  vector<RID> rids = table.insert_batch (recs_data, num_recs);
+  for (int r = 0; r < num_recs; ++r) {
+    const char* rec_data = recs_data + r * table_meta->row_len;
+    for (unsigned int i = 0; i < attr_recs.size (); ++i) {
+      Attribute* attr = (Attribute *) attr_recs [i].data;
+      if (attr->index_num != -1) {
+        indexes [attr->index_num].Insert (rec_data + attr->offset, rids [r]);
+      }
     }
   }
-  auto rec = table.get (rid);
-  memcpy (rec.data, rec_data, table_meta->row_len);
-  table.update (rec);
 
   for (unsigned int i = 0; i < attr_recs.size (); ++i) {
     Attribute* attr = (Attribute *) attr_recs [i].data;
@@ -403,8 +425,6 @@ void Manager::Insert (const char* relName,
   }
 
   this->rmm.CloseFile (table);
-  this->relcat.ForcePages ();
-  this->attrcat.ForcePages ();
 }
 
 void Manager::Insert (const char* relName,
@@ -423,20 +443,10 @@ void Manager::Insert (const char* relName,
   }
   Printer printer (attrs, table_meta->attr_count);
 
-  map<int, IX::IndexHandle> indexes;
-  for (unsigned int i = 0; i < attr_recs.size (); ++i) {
-    Attribute* attr = (Attribute *) attr_recs [i].data;
-    if (attr->index_num != -1) {
-      indexes [attr->index_num] = this->ixm.OpenIndex (relName,
-                                                       attr->index_num);
-    }
-  }
-
-  auto table = this->rmm.OpenFile (relName);
+  // Build the row, then insert and index it like any batch.
   char buf [table_meta->row_len];
-
+  memset (buf, 0, sizeof (buf));
   int blob_number;
-  RID rid = table.insert (buf); // Just to get an RID
   for (unsigned int i = 0; i < attr_recs.size (); ++i) {
     Attribute* attr = (Attribute *) attr_recs [i].data;
     switch (attr->type) {
@@ -447,7 +457,6 @@ void Manager::Insert (const char* relName,
       *(float*)(buf + attr->offset) = *(float*)(values [i]);
       break;
     case STRING:
-      memset (buf + attr->offset, 0, attr->len);
       strncpy (buf + attr->offset, (char*)values [i], attr->len);
       break;
     case BLOB:
@@ -457,28 +466,12 @@ void Manager::Insert (const char* relName,
     case NONE:
       throw error::UnknownAttributeType ();
     }
-    if (attr->index_num != -1) {
-      indexes [attr->index_num].Insert (buf + attr->offset, rid);
-    }
-  }
-  auto rec = table.get (rid);
-  memcpy (rec.data, buf, sizeof (buf));
-  table.update (rec);
-
-  for (unsigned int i = 0; i < attr_recs.size (); ++i) {
-    Attribute* attr = (Attribute *) attr_recs [i].data;
-    if (attr->index_num != -1) {
-      this->ixm.CloseIndex (indexes [attr->index_num]);
-    }
   }
+  this->Insert (relName, buf, 1);
 
   printer.PrintHeader (cout);
   printer.Print (cout, buf);
   printer.PrintFooter (cout);
-
-  this->rmm.CloseFile (table);
-  this->relcat.ForcePages ();
-  this->attrcat.ForcePages ();
 }
 
 void Manager::Load(const char *relName,
@@ -489,26 +482,17 @@ void Manager::Load(const char *relName,
   if (table_meta_rec == RM::Scan::end)
     throw warn::TableDoesNotExist ();
 
-  auto table_rec = this->GetTableMetadata (relName);
   auto attr_recs = this->GetAttributes (relName);
-  Table* table_meta = (Table *) table_rec.data;
-
-  map<int, IX::IndexHandle> indexes;
-  for (unsigned int i = 0; i < attr_recs.size (); ++i) {
-    Attribute* attr = (Attribute *) attr_recs [i].data;
-    if (attr->index_num != -1) {
-      indexes [attr->index_num] = this->ixm.OpenIndex (relName,
-                                                       attr->index_num);
-    }
-  }
+  Table* table_meta = (Table *) table_meta_rec.data;
 
-  auto table = this->rmm.OpenFile (relName);
-  char buf [table_meta->row_len];
+  // Rows are parsed into a batch and inserted a batch at a time.
+  vector<char> batch (kLoadBatchRows * table_meta->row_len);
+  int num_rows = 0;
   ifstream in (fileName);
   if (in.fail ()) throw warn::BadCSVFile ();
   while (in.good ()) {
     vector<string> row = csv_read_row (in, ',');
-    RID rid = table.insert (buf); // Just to get an RID
+    char* buf = batch.data () + num_rows * table_meta->row_len;
     int blob_number;
     for (unsigned int i = 0; i < attr_recs.size (); ++i) {
       Attribute* attr = (Attribute *) attr_recs [i].data;
@@ -530,25 +514,16 @@ void Manager::Load(const char *relName,
       case NONE:
         throw error::UnknownAttributeType ();
       }
-      if (attr->index_num != -1) {
-        indexes [attr->index_num].Insert (buf + attr->offset, rid);
-      }
     }
-    auto rec = table.get (rid);
-    memcpy (rec.data, buf, sizeof (buf));
-    table.update (rec);
+    if (++num_rows == kLoadBatchRows) {
+      this->Insert (relName, batch.data (), num_rows);
+      num_rows = 0;
+    }
   }
   in.close();
 
-  for (unsigned int i = 0; i < attr_recs.size (); ++i) {
-    Attribute* attr = (Attribute *) attr_recs [i].data;
-    if (attr->index_num != -1) {
-      this->ixm.CloseIndex (indexes [attr->index_num]);
-    }
-  }
-  this->rmm.CloseFile (table);
-  this->relcat.ForcePages ();
-  this->attrcat.ForcePages ();
+  if (num_rows > 0)
+    this->Insert (relName, batch.data (), num_rows);
 }
 
 void Manager::LoadLib(const char *libname)
@@ -568,36 +543,199 @@ bool rec_comp (const RM::Record& r1, const RM::Record& r2)
 
 void Manager::Print(const char *relName)
 {
-  Table* table = (Table *) this->GetTableMetadata (relName).data;
+  auto table_rec = this->GetTableMetadata (relName);
+  Table* table = (Table *) table_rec.data;
   DataAttrInfo attrs [table->attr_count];
   auto attr_recs = this->GetAttributes (relName);
   for (unsigned int i = 0; i < attr_recs.size (); ++i) {
     new (attrs + i) DataAttrInfo (*(Attribute *)attr_recs [i].data);
   }
 
+  // Printing only reads, so map the relation instead of pulling it
+  // through the buffer pool.  The catalogs are open, and what changed in
+  // them is only written back at checkpoints.
   RM::Scan scan;
-  RM::Record rec;
-  auto relation = this->rmm.OpenFile (relName);
+  RM::RecordRef rec;
+  bool is_relcat = strcmp (relName, "relcat") == 0;
+  bool is_catalog = is_relcat || strcmp (relName, "attrcat") == 0;
+  RM::FileHandle relation =
+    is_catalog ? (is_relcat ? this->relcat : this->attrcat)
+               : this->rmm.OpenFile (relName, PF_MMAP_READONLY);
   scan.open (relation, INT, sizeof (int), 0, NO_OP, NULL);
 
   Printer printer (attrs, table->attr_count);
   printer.PrintHeader (cout);
 
-  while ((rec = scan.next()) != scan.end) {
+  while ((rec = scan.next_ref ()).data != NULL) {
     printer.Print (cout, rec.data);
   }
 
   printer.PrintFooter (cout);
 
   scan.close ();
-  this->rmm.CloseFile (relation);
+  if (!is_catalog)
+    this->rmm.CloseFile (relation);
+}
+
+void Manager::Compact(const char *relName)
+{
+  auto table_meta_rec = this->GetTableMetadata (relName);
+  if (table_meta_rec == RM::Scan::end)
+    throw warn::TableDoesNotExist ();
+
+  // The catalogs are compacted through the handles kept open.
+  RM::FileHandle table;
+  bool is_relcat = strcmp (relName, "relcat") == 0;
+  bool is_catalog = is_relcat || strcmp (relName, "attrcat") == 0;
+  if (!is_catalog)
+    table = this->rmm.OpenFile (relName);
+  RM::FileHandle& relation =
+    is_catalog ? (is_relcat ? this->relcat : this->attrcat) : table;
+
+  int num_pages = relation.Compact ();
+
+  // The records moved, so the indexes are built again from scratch,
+  // which compacts them too.
+  auto attr_recs = this->GetAttributes (relName);
+  for (unsigned int i = 0; i < attr_recs.size (); ++i) {
+    Attribute* attr = (Attribute *) attr_recs [i].data;
+    if (attr->index_num == -1) continue;
+
+    this->ixm.DestroyIndex (relName, attr->index_num);
+    this->ixm.CreateIndex (relName, attr->index_num, attr->type, attr->len,
+                           this->page_size);
+    auto index = this->ixm.OpenIndex (relName, attr->index_num);
+
+    RM::Scan scan;
+    RM::RecordRef rec;
+    scan.open (relation, INT, sizeof (int), 0, NO_OP, NULL,
+               SEQUENTIAL_SCAN);
+    while ((rec = scan.next_ref ()).data != NULL) {
+      index.Insert (rec.data + attr->offset, rec.rid);
+    }
+    scan.close ();
+
+    this->ixm.CloseIndex (index);
+  }
+
+  if (!is_catalog)
+    this->rmm.CloseFile (table);
+  cout << "Compacted " << relName << ": " << num_pages
+       << " pages given back.\n";
 }
 
 void Manager::Set(const char *paramName, const char *value)
 {
-  cout << "Set\n"
-       << "   paramName=" << paramName << "\n"
-       << "   value    =" << value << "\n";
+  if (strcmp (paramName, "bufferPolicy") == 0) {
+    PF_ReplacementPolicy policy;
+    if (strcasecmp (value, "LRU") == 0) policy = PF_LRU;
+    else if (strcasecmp (value, "CLOCK") == 0) policy = PF_CLOCK;
+    else if (strcasecmp (value, "2Q") == 0) policy = PF_2Q;
+    else if (strcasecmp (value, "LRU-K") == 0) policy = PF_LRUK;
+    else throw warn::BadParameterValue ();
+
+    this->pfm.SetReplacementPolicy (policy);
+    cout << "Buffer replacement policy set to " << value << ".\n";
+  }
+  else if (strcmp (paramName, "readAhead") == 0) {
+    char *end;
+    long pages = strtol (value, &end, 10);
+    if (*value == '\0' || *end != '\0' || pages < 0 || pages > INT_MAX)
+      throw warn::BadParameterValue ();
+
+    this->pfm.SetReadAhead (pages);
+    cout << "Read-ahead window set to " << pages << " pages.\n";
+  }
+  else if (strcmp (paramName, "pageSize") == 0) {
+    char *end;
+    long size = strtol (value, &end, 10);
+    if (*value == '\0' || *end != '\0' || size < MEMORY_PAGE_SIZE ||
+        size > PF_MAX_PAGE_SIZE || (size & (size - 1)) != 0)
+      throw warn::BadParameterValue ();
+
+    this->page_size = size;
+    cout << "New tables and indexes will have " << size
+         << " byte pages.\n";
+  }
+  else if (strcmp (paramName, "compression") == 0) {
+    bool compress;
+    if (strcasecmp (value, "on") == 0) compress = true;
+    else if (strcasecmp (value, "off") == 0) compress = false;
+    else throw warn::BadParameterValue ();
+
+    this->compress_tables = compress;
+    cout << "New tables will store their pages "
+         << (compress ? "compressed" : "uncompressed") << ".\n";
+  }
+  else if (strcmp (paramName, "bgWriter") == 0) {
+    char *end;
+    long pages = strtol (value, &end, 10);
+    if (*value == '\0' || *end != '\0' || pages < 0 || pages > INT_MAX)
+      throw warn::BadParameterValue ();
+
+    this->pfm.SetBackgroundWriter (pages);
+    cout << "Background writer keeps " << pages << " pages clean.\n";
+  }
+  else if (strcmp (paramName, "checkpointInterval") == 0) {
+    char *end;
+    long msecs = strtol (value, &end, 10);
+    if (*value == '\0' || *end != '\0' || msecs < 0 || msecs > INT_MAX)
+      throw warn::BadParameterValue ();
+
+    this->pfm.SetCheckpointInterval (msecs);
+    cout << "Checkpoint interval set to " << msecs << " ms.\n";
+  }
+  else if (strcmp (paramName, "directIO") == 0) {
+    bool direct;
+    if (strcasecmp (value, "on") == 0) direct = true;
+    else if (strcasecmp (value, "off") == 0) direct = false;
+    else throw warn::BadParameterValue ();
+
+    this->pfm.SetDirectIO (direct);
+    cout << "Files opened from now on will use "
+         << (direct ? "direct" : "buffered") << " I/O.\n";
+  }
+  else if (strcmp (paramName, "extentPages") == 0) {
+    char *end;
+    long pages = strtol (value, &end, 10);
+    if (*value == '\0' || *end != '\0' || pages < 0 || pages > INT_MAX)
+      throw warn::BadParameterValue ();
+
+    this->pfm.SetExtentPages (pages);
+    cout << "Files opened from now on will grow by " << pages
+         << " pages at once.\n";
+  }
+  else if (strcmp (paramName, "durability") == 0) {
+    PF_Durability mode;
+    if (strcasecmp (value, "none") == 0) mode = PF_DURABLE_NONE;
+    else if (strcasecmp (value, "statement") == 0) mode = PF_DURABLE_STATEMENT;
+    else if (strcasecmp (value, "group") == 0) mode = PF_DURABLE_GROUP;
+    else throw warn::BadParameterValue ();
+
+    this->pfm.SetDurability (mode);
+    cout << "Durability set to " << value << ".\n";
+  }
+  else if (strcmp (paramName, "groupCommitWindow") == 0) {
+    char *end;
+    long msecs = strtol (value, &end, 10);
+    if (*value == '\0' || *end != '\0' || msecs < 0 || msecs > INT_MAX)
+      throw warn::BadParameterValue ();
+
+    this->pfm.SetGroupCommitWindow (msecs);
+    cout << "Group commit window set to " << msecs << " ms.\n";
+  }
+  else if (strcmp (paramName, "groupCommitSize") == 0) {
+    char *end;
+    long commits = strtol (value, &end, 10);
+    if (*value == '\0' || *end != '\0' || commits < 1 || commits > INT_MAX)
+      throw warn::BadParameterValue ();
+
+    this->pfm.SetGroupCommitSize (commits);
+    cout << "Group commit size set to " << commits << " statements.\n";
+  }
+  else {
+    throw warn::UnknownParameter ();
+  }
 }
 
 void Manager::Help()
@@ -609,19 +747,17 @@ void Manager::Help()
   }
 
   RM::Scan scan;
-  RM::Record rec;
-  auto relation = this->rmm.OpenFile ("relcat");
-  scan.open (relation, STRING, MAXNAME + 1, 0, NO_OP, NULL);
+  RM::RecordRef rec;
+  scan.open (this->relcat, STRING, MAXNAME + 1, 0, NO_OP, NULL);
 
   Printer printer (attrs, 3);
   printer.PrintHeader (cout);
-  while ((rec = scan.next()) != scan.end) {
+  while ((rec = scan.next_ref ()).data != NULL) {
     printer.Print (cout, rec.data);
   }
   printer.PrintFooter (cout);
 
   scan.close ();
-  this->rmm.CloseFile (relation);
 }
 
 void Manager::Help(const char *relName)
@@ -630,7 +766,8 @@ void Manager::Help(const char *relName)
   if (this->GetTableMetadata (relName) == RM::Scan::end)
     throw warn::TableDoesNotExist ();
   
-  Table* table = (Table *) this->GetTableMetadata ("attrcat").data;
+  auto table_rec = this->GetTableMetadata ("attrcat");
+  Table* table = (Table *) table_rec.data;
   DataAttrInfo attrs [table->attr_count];
   auto attr_recs = this->GetAttributes ("attrcat");
   for (unsigned int i = 0; i < attr_recs.size (); ++i) {
@@ -638,18 +775,16 @@ void Manager::Help(const char *relName)
   }
 
   RM::Scan scan;
-  RM::Record rec;
-  auto relation = this->rmm.OpenFile ("attrcat");
-  scan.open (relation, STRING, MAXNAME + 1, 0, EQ_OP, relName);
+  RM::RecordRef rec;
+  scan.open (this->attrcat, STRING, MAXNAME + 1, 0, EQ_OP, relName);
 
   Printer printer (attrs, table->attr_count);
   printer.PrintHeader (cout);
-  while ((rec = scan.next()) != scan.end) {
+  while ((rec = scan.next_ref ()).data != NULL) {
     printer.Print (cout, rec.data);
   }
   printer.PrintFooter (cout);
 
   scan.close ();
-  this->rmm.CloseFile (relation);
 }
 }  // namespace SM
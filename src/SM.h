@@ -60,20 +60,27 @@ class Manager
   friend class QL_Manager;
 
 private:
+  PF::Manager pfm;
   IX::Manager ixm;
   RM::Manager rmm;
   RM::FileHandle relcat;
   RM::FileHandle attrcat;
 
+  // Page size of the files of the tables and indexes created from now on
+  int page_size;
+  // Whether the tables created from now on store their pages compressed
+  bool compress_tables;
+
 public:
   vector<void*> libraries;
 
 public:
-  Manager    (IX::Manager &ixm, RM::Manager &rmm);
+  Manager    (PF::Manager &pfm, IX::Manager &ixm, RM::Manager &rmm);
   ~Manager   ();                             // Destructor
 
   void OpenDb     (const char *dbName);           // Open the database
   void CloseDb    ();                             // close the database
+  void Commit     ();                             // end of a statement
 
   void CreateTable(const char *relName,           // create relation relName
                    int        attrCount,          //   number of attributes
@@ -88,6 +95,9 @@ public:
                    void* values[]);
   void Insert     (const char* relName,
                    const char* rec_data);
+  void Insert     (const char* relName,           // insert num_recs rows
+                   const char* recs_data,         //   stored back to back
+                   int num_recs);
   void Delete     (const char* relName,
                    char* rec_data,
                    RID rid);
@@ -99,6 +109,9 @@ public:
 
   void Print      (const char *relName);          // print relName contents
 
+  void Compact    (const char *relName);          // shrink relName and
+                                                  //   rebuild its indexes
+
   void Set        (const char *paramName,         // set parameter to
                    const char *value);            //   value
 
@@ -144,6 +157,8 @@ DECLARE_WARNING (IndexAlreadyExists, "Index already exists.");
 DECLARE_WARNING (IndexDoesNotExist, "Index desn't exist.");
 DECLARE_WARNING (BadCSVFile, "Error opening CSV file.");
 DECLARE_WARNING (FailedToLoadLibrary, "Error loading .so file.");
+DECLARE_WARNING (UnknownParameter, "Unknown parameter.");
+DECLARE_WARNING (BadParameterValue, "Bad value for parameter.");
 }  // namespace warning
 
 }  // namespace SM
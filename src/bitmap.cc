@@ -5,8 +5,65 @@
 #include <cassert>
 #include <iostream>
 
+// Runs of empty (or full) bits are skipped 256 bits at a time where the
+// CPU has AVX2.  The rest of the tree is not built for it, so only the
+// functions that use it are, and they are picked at run time.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BITMAP_AVX2
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
+#ifdef BITMAP_AVX2
+static bool have_avx2 ()
+{
+  static const bool avx2 = (__builtin_cpu_init (),
+                            __builtin_cpu_supports ("avx2"));
+  return avx2;
+}
+
+// Byte index of the first 32 byte chunk from byte_i on that is not all
+// made of skip bytes, or of the bytes left over after the last chunk.
+__attribute__ ((target ("avx2")))
+static int skip_chunks_avx2 (const unsigned char* map, int byte_i,
+                             int num_bytes, unsigned char skip)
+{
+  const __m256i skipped = _mm256_set1_epi8 ((char) skip);
+  for (; byte_i + 32 <= num_bytes; byte_i += 32) {
+    __m256i chunk = _mm256_loadu_si256 ((const __m256i*) (map + byte_i));
+    __m256i diff = _mm256_xor_si256 (chunk, skipped);
+    if (not _mm256_testz_si256 (diff, diff)) break;
+  }
+  return byte_i;
+}
+
+// # of bits set in the first num_bytes / 32 chunks.  Each nibble is
+// counted with a table lookup, and the counts summed per 64 bits.
+__attribute__ ((target ("avx2")))
+static int count_chunks_avx2 (const unsigned char* map, int num_bytes)
+{
+  const __m256i table = _mm256_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3,
+                                          1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3,
+                                          1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i nibble = _mm256_set1_epi8 (0x0f);
+  __m256i sums = _mm256_setzero_si256 ();
+  for (int byte_i = 0; byte_i + 32 <= num_bytes; byte_i += 32) {
+    __m256i chunk = _mm256_loadu_si256 ((const __m256i*) (map + byte_i));
+    __m256i lo = _mm256_and_si256 (chunk, nibble);
+    __m256i hi = _mm256_and_si256 (_mm256_srli_epi16 (chunk, 4), nibble);
+    __m256i counts = _mm256_add_epi8 (_mm256_shuffle_epi8 (table, lo),
+                                      _mm256_shuffle_epi8 (table, hi));
+    sums = _mm256_add_epi64 (sums,
+                             _mm256_sad_epu8 (counts,
+                                              _mm256_setzero_si256 ()));
+  }
+  return _mm256_extract_epi64 (sums, 0) + _mm256_extract_epi64 (sums, 1) +
+         _mm256_extract_epi64 (sums, 2) + _mm256_extract_epi64 (sums, 3);
+}
+#endif
+
 int Bitmap::num_bytes() const
 {
   return (this->_num_bits + 7) / 8;
@@ -30,8 +87,8 @@ bool Bitmap::get(const int bit_index) const
 {
   assert (bit_index < this->num_bits());
 
-  int byte_i = bit_index / 8;
-  int bit_i = bit_index % 8;
+  int byte_i = bit_index >> 3;
+  int bit_i = bit_index & 7;
   return this->map[byte_i] & (1 << bit_i);
 }
 
@@ -41,8 +98,8 @@ void Bitmap::set(const int bit_index)
   cout << "index : " << bit_index << "\nnum bits : " << this->num_bits() << endl;
   assert (bit_index < this->num_bits());
 
-  int byte_i = bit_index / 8;
-  int bit_i = bit_index % 8;
+  int byte_i = bit_index >> 3;
+  int bit_i = bit_index & 7;
   this->map[byte_i] |= (1 << bit_i);
 }
 
@@ -55,25 +112,80 @@ void Bitmap::clear(const int bit_index)
 {
   assert (bit_index < this->num_bits());
 
-  int byte_i = bit_index / 8;
-  int bit_i = bit_index % 8;
+  int byte_i = bit_index >> 3;
+  int bit_i = bit_index & 7;
   this->map[byte_i] &= ~(1 << bit_i);
 }
 
 int Bitmap::getFirstUnset() const
 {
-  for (int byte_i = 0; byte_i < this->num_bytes(); ++byte_i) {
-    unsigned char byte = this->map[byte_i];
-    if (byte != 0xff) {
-      for (int bit_i = 0; bit_i < 8; ++bit_i) {
-        if (byte % 2 == 0) {
-          return byte_i * 8 + bit_i;
-        }
-        else {
-          byte /= 2;
-        }
-      }
-    }
+  return this->findNextUnset (0);
+}
+
+// The 64 bits from byte_i on, bit i of the map being bit i of the word.
+// Bytes past the end of the map read as 0.
+uint64_t Bitmap::word(const int byte_i) const
+{
+  uint64_t w = 0;
+  int n = this->num_bytes() - byte_i;
+  memcpy (&w, this->map + byte_i, n < 8 ? n : 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  w = __builtin_bswap64 (w);
+#endif
+  return w;
+}
+
+// The first bit at or after from that differs from the bits of skip.
+int Bitmap::findNext(const int from, const uint64_t skip) const
+{
+  int start = from < 0 ? 0 : from;
+  if (start >= this->_num_bits) return -1;
+
+  int byte_i = start >> 3;
+  uint64_t w = (this->word (byte_i) ^ skip) & (~0ULL << (start & 7));
+  while (w == 0) {
+    byte_i += 8;
+#ifdef BITMAP_AVX2
+    if (have_avx2 ())
+      byte_i = skip_chunks_avx2 (this->map, byte_i, this->num_bytes(),
+                                 (unsigned char) skip);
+#endif
+    if (byte_i >= this->num_bytes()) return -1;
+    w = this->word (byte_i) ^ skip;
+  }
+
+  // Bits past _num_bits are not part of the map.
+  int bit_index = byte_i * 8 + __builtin_ctzll (w);
+  return bit_index < this->_num_bits ? bit_index : -1;
+}
+
+int Bitmap::findNextSet(const int from) const
+{
+  return this->findNext (from, 0);
+}
+
+int Bitmap::findNextUnset(const int from) const
+{
+  return this->findNext (from, ~0ULL);
+}
+
+int Bitmap::count() const
+{
+  int full_bytes = this->_num_bits >> 3;
+  int n = 0;
+  int byte_i = 0;
+#ifdef BITMAP_AVX2
+  if (have_avx2 ()) {
+    n = count_chunks_avx2 (this->map, full_bytes);
+    byte_i = full_bytes & ~31;
   }
-  return -1;
+#endif
+  for (; byte_i + 8 <= full_bytes; byte_i += 8)
+    n += __builtin_popcountll (this->word (byte_i));
+  for (; byte_i < full_bytes; ++byte_i)
+    n += __builtin_popcount (this->map [byte_i]);
+  if (this->_num_bits & 7)
+    n += __builtin_popcount (this->map [full_bytes] &
+                             ((1 << (this->_num_bits & 7)) - 1));
+  return n;
 }
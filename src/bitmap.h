@@ -1,11 +1,17 @@
 #ifndef BITMAP_H
 #define BITMAP_H
 
+#include <stdint.h>
+
 class Bitmap
 {
 private:
   int _num_bits;
   unsigned char *map;
+
+  uint64_t word(const int byte_i) const;
+  int findNext(const int from, const uint64_t skip) const;
+
 public:
   Bitmap();
   Bitmap(const int num_bits, unsigned char *map);
@@ -18,6 +24,14 @@ public:
   void clear_all ();
   int num_bits() const;
   int num_bytes() const;
+
+  // The first bit at or after from that is set (unset), -1 if there is
+  // none.  The map is read 64 bits at a time.
+  int findNextSet(const int from) const;
+  int findNextUnset(const int from) const;
+
+  // # of bits set
+  int count() const;
 };
 
 #endif  // BITMAP_H
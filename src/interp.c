@@ -18,6 +18,7 @@
 #include "SM.h"
 #include "ql.h"
 
+extern PF_Manager *pPfm;
 extern SM::Manager *pSmm;
 extern QL_Manager *pQlm;
 
@@ -148,6 +149,11 @@ RC interp(NODE *n)
          pSmm->Print(n->u.PRINT.relname);
          break;
 
+      case N_COMPACT:            /* for Compact() */
+
+         pSmm->Compact(n->u.COMPACT.relname);
+         break;
+
       case N_QUERY:            /* for Query() */
          {
             int       nSelAttrs = 0;
@@ -275,6 +281,10 @@ RC interp(NODE *n)
          break;
    }
 
+   /* make the changes of the statement durable */
+   if (!errval)
+      pSmm->Commit();
+
    return (errval);
 }
 
@@ -638,6 +648,9 @@ static void echo_query(NODE *n)
       case N_PRINT:            /* for Print() */
          printf("print %s;\n", n -> u.PRINT.relname);
          break;
+      case N_COMPACT:            /* for Compact() */
+         printf("compact %s;\n", n -> u.COMPACT.relname);
+         break;
       case N_SET:                                 /* for Set() */
          printf("set %s = \"%s\";\n", n->u.SET.paramName, n->u.SET.string);
          break;
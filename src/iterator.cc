@@ -17,7 +17,7 @@ RelIterator::RelIterator (const char* rel_name,
 
   // Check whether we can use an index scan instead.
   auto attr_recs = this->smm->GetAttributes (rel_name);
-  this->scan.open (this->rel, INT, 4, 0, NO_OP, NULL); return;
+  this->open_scan (); return;
   for (unsigned int i = 0; i < attr_recs.size(); ++i) {
     Attribute *attr = (Attribute *) attr_recs[i].data;
     if (attr->index_num == -1) continue;
@@ -47,6 +47,22 @@ RelIterator::~RelIterator ()
   delete [] this->tuple_buffer;
 }
 
+// The first condition against a constant is handed to the scan, which
+// checks it a page at a time.  The others are checked tuple by tuple.
+void RelIterator::open_scan ()
+{
+  this->batch.slots.clear ();
+  this->batch_i = 0;
+  for (unsigned int i = 0; i < this->conditions.size (); ++i) {
+    const condition& c = this->conditions [i];
+    if (c.has_rhs_attr or c.attr_type == BLOB) continue;
+    this->scan.open (this->rel, c.attr_type, c.attr_len, c.offset1,
+                     c.comp_op, c.value, SEQUENTIAL_SCAN);
+    return;
+  }
+  this->scan.open (this->rel, INT, 4, 0, NO_OP, NULL, SEQUENTIAL_SCAN);
+}
+
 void RelIterator::open () {}
 void RelIterator::close () {}
 
@@ -54,7 +70,7 @@ void RelIterator::reset ()
 {
   if (not using_index_scan) {
     this->scan.close ();
-    this->scan.open (this->rel, INT, 4, 0, NO_OP, NULL);
+    this->open_scan ();
   }
   else {
     delete this->index_scan;
@@ -77,9 +93,15 @@ bool is_long (const Blob& blob)
 
 char* RelIterator::next ()
 {
-  RM::Record rec;
   if (not using_index_scan) {
-    while ((rec = this->scan.next ()) != this->scan.end) {
+    // Conditions are checked on the page itself; only a matching
+    // tuple is copied out.
+    while (true) {
+      if (this->batch_i == this->batch.size ()) {
+        if (not this->scan.next_batch (this->batch)) break;
+        this->batch_i = 0;
+      }
+      RM::RecordRef rec = this->batch [this->batch_i++];
       bool match_found = true;
       for (unsigned int i = 0; i < this->conditions.size (); ++i) {
         if (conditions[i].attr_type != BLOB)
@@ -99,6 +121,7 @@ char* RelIterator::next ()
   }
   else {
     RID rid;
+    RM::Record rec;
     while ((rid = this->index_scan->next ()) != this->index_scan->end) {
       cout << rid.page_num << " " << rid.slot_num << endl;
       bool match_found = true;
@@ -187,7 +210,7 @@ int CompositeIterator::tuple_size () const
   return this->iter1->tuple_size () + this->iter2->tuple_size ();
 }
 
-bool condition::satisfies (char* tuple) const
+bool condition::satisfies (const char* tuple) const
 {
   if (this->attr_type == INT) {
     const int attribute = *(const int*)(tuple + this->offset1);
@@ -226,8 +249,8 @@ bool condition::satisfies (char* tuple) const
     }
   }
   else {
-    char* attribute = tuple + this->offset1;
-    char* value;
+    const char* attribute = tuple + this->offset1;
+    const char* value;
     if (not this->has_rhs_attr)
       value = (char *) this->value;
     else
@@ -18,7 +18,7 @@ struct condition
 
   void* value;
 
-  bool satisfies (char* tuple) const;
+  bool satisfies (const char* tuple) const;
   bool satisfies (char* tuple1, char* tuple2) const;
 };
 
@@ -39,6 +39,8 @@ private:
   char* tuple_buffer;
   RID rid_;
   RM::Scan scan;
+  RM::RecordBatch batch;          // the tuples are read a page at a time
+  int batch_i;
   RM::FileHandle rel;
   RM::Manager* rmm;
 
@@ -54,6 +56,8 @@ private:
   condition index_scan_condition;
   const char* rel_name;
 
+  void open_scan ();
+
 public:
   RelIterator (const char* rel_name,
                const vector<condition>& conditions,
@@ -187,6 +187,18 @@ NODE *print_node(char *relname)
     return n;
 }
 
+/*
+ * compact_node: allocates, initializes, and returns a pointer to a new
+ * compact node having the indicated values.
+ */
+NODE *compact_node(char *relname)
+{
+    NODE *n = newnode(N_COMPACT);
+
+    n -> u.COMPACT.relname = relname;
+    return n;
+}
+
 /*
  * query_node: allocates, initializes, and returns a pointer to a new
  * query node having the indicated values.
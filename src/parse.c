@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.2.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2013 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.0.2"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -61,8 +66,8 @@
 
 
 
-/* Copy the first part of user declarations.  */
-#line 1 "parse.y" /* yacc.c:339  */
+/* First part of user prologue.  */
+#line 1 "parse.y"
 
 /*
  * parser.y: yacc specification for RQL
@@ -132,26 +137,31 @@ SM::Manager *pSmm;          // SM component manager
 QL_Manager *pQlm;          // QL component manager
 
 
-#line 136 "y.tab.c" /* yacc.c:339  */
+#line 141 "y.tab.c"
 
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
 # ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
 #  else
-#   define YY_NULLPTR 0
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* In a future release of Bison, this section will be replaced
-   by #include "y.tab.h".  */
+/* Use api.header.include to #include this header
+   instead of duplicating it here.  */
 #ifndef YY_YY_Y_TAB_H_INCLUDED
 # define YY_YY_Y_TAB_H_INCLUDED
 /* Debug traces.  */
@@ -162,53 +172,63 @@ QL_Manager *pQlm;          // QL component manager
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    RW_CREATE = 258,
-    RW_DROP = 259,
-    RW_TABLE = 260,
-    RW_INDEX = 261,
-    RW_LOAD = 262,
-    RW_LOADLIB = 263,
-    RW_SET = 264,
-    RW_HELP = 265,
-    RW_PRINT = 266,
-    RW_EXIT = 267,
-    RW_SELECT = 268,
-    RW_FROM = 269,
-    RW_WHERE = 270,
-    RW_INSERT = 271,
-    RW_DELETE = 272,
-    RW_UPDATE = 273,
-    RW_AND = 274,
-    RW_INTO = 275,
-    RW_VALUES = 276,
-    T_EQ = 277,
-    T_LT = 278,
-    T_LE = 279,
-    T_GT = 280,
-    T_GE = 281,
-    T_NE = 282,
-    T_EOF = 283,
-    NOTOKEN = 284,
-    RW_RESET = 285,
-    RW_IO = 286,
-    RW_BUFFER = 287,
-    RW_RESIZE = 288,
-    RW_QUERY_PLAN = 289,
-    RW_ON = 290,
-    RW_OFF = 291,
-    T_INT = 292,
-    T_REAL = 293,
-    T_STRING = 294,
-    T_QSTRING = 295,
-    T_SHELL_CMD = 296
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    RW_CREATE = 258,               /* RW_CREATE  */
+    RW_DROP = 259,                 /* RW_DROP  */
+    RW_TABLE = 260,                /* RW_TABLE  */
+    RW_INDEX = 261,                /* RW_INDEX  */
+    RW_LOAD = 262,                 /* RW_LOAD  */
+    RW_LOADLIB = 263,              /* RW_LOADLIB  */
+    RW_SET = 264,                  /* RW_SET  */
+    RW_HELP = 265,                 /* RW_HELP  */
+    RW_PRINT = 266,                /* RW_PRINT  */
+    RW_COMPACT = 267,              /* RW_COMPACT  */
+    RW_EXIT = 268,                 /* RW_EXIT  */
+    RW_SELECT = 269,               /* RW_SELECT  */
+    RW_FROM = 270,                 /* RW_FROM  */
+    RW_WHERE = 271,                /* RW_WHERE  */
+    RW_INSERT = 272,               /* RW_INSERT  */
+    RW_DELETE = 273,               /* RW_DELETE  */
+    RW_UPDATE = 274,               /* RW_UPDATE  */
+    RW_AND = 275,                  /* RW_AND  */
+    RW_INTO = 276,                 /* RW_INTO  */
+    RW_VALUES = 277,               /* RW_VALUES  */
+    T_EQ = 278,                    /* T_EQ  */
+    T_LT = 279,                    /* T_LT  */
+    T_LE = 280,                    /* T_LE  */
+    T_GT = 281,                    /* T_GT  */
+    T_GE = 282,                    /* T_GE  */
+    T_NE = 283,                    /* T_NE  */
+    T_EOF = 284,                   /* T_EOF  */
+    NOTOKEN = 285,                 /* NOTOKEN  */
+    RW_RESET = 286,                /* RW_RESET  */
+    RW_IO = 287,                   /* RW_IO  */
+    RW_BUFFER = 288,               /* RW_BUFFER  */
+    RW_RESIZE = 289,               /* RW_RESIZE  */
+    RW_QUERY_PLAN = 290,           /* RW_QUERY_PLAN  */
+    RW_ON = 291,                   /* RW_ON  */
+    RW_OFF = 292,                  /* RW_OFF  */
+    T_INT = 293,                   /* T_INT  */
+    T_REAL = 294,                  /* T_REAL  */
+    T_STRING = 295,                /* T_STRING  */
+    T_QSTRING = 296,               /* T_QSTRING  */
+    T_SHELL_CMD = 297              /* T_SHELL_CMD  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
 #define RW_CREATE 258
 #define RW_DROP 259
 #define RW_TABLE 260
@@ -218,43 +238,43 @@ extern int yydebug;
 #define RW_SET 264
 #define RW_HELP 265
 #define RW_PRINT 266
-#define RW_EXIT 267
-#define RW_SELECT 268
-#define RW_FROM 269
-#define RW_WHERE 270
-#define RW_INSERT 271
-#define RW_DELETE 272
-#define RW_UPDATE 273
-#define RW_AND 274
-#define RW_INTO 275
-#define RW_VALUES 276
-#define T_EQ 277
-#define T_LT 278
-#define T_LE 279
-#define T_GT 280
-#define T_GE 281
-#define T_NE 282
-#define T_EOF 283
-#define NOTOKEN 284
-#define RW_RESET 285
-#define RW_IO 286
-#define RW_BUFFER 287
-#define RW_RESIZE 288
-#define RW_QUERY_PLAN 289
-#define RW_ON 290
-#define RW_OFF 291
-#define T_INT 292
-#define T_REAL 293
-#define T_STRING 294
-#define T_QSTRING 295
-#define T_SHELL_CMD 296
+#define RW_COMPACT 267
+#define RW_EXIT 268
+#define RW_SELECT 269
+#define RW_FROM 270
+#define RW_WHERE 271
+#define RW_INSERT 272
+#define RW_DELETE 273
+#define RW_UPDATE 274
+#define RW_AND 275
+#define RW_INTO 276
+#define RW_VALUES 277
+#define T_EQ 278
+#define T_LT 279
+#define T_LE 280
+#define T_GT 281
+#define T_GE 282
+#define T_NE 283
+#define T_EOF 284
+#define NOTOKEN 285
+#define RW_RESET 286
+#define RW_IO 287
+#define RW_BUFFER 288
+#define RW_RESIZE 289
+#define RW_QUERY_PLAN 290
+#define RW_ON 291
+#define RW_OFF 292
+#define T_INT 293
+#define T_REAL 294
+#define T_STRING 295
+#define T_QSTRING 296
+#define T_SHELL_CMD 297
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE YYSTYPE;
 union YYSTYPE
 {
-#line 71 "parse.y" /* yacc.c:355  */
+#line 71 "parse.y"
 
     int ival;
     CompOp cval;
@@ -262,8 +282,10 @@ union YYSTYPE
     char *sval;
     NODE *n;
 
-#line 266 "y.tab.c" /* yacc.c:355  */
+#line 286 "y.tab.c"
+
 };
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define YYSTYPE_IS_DECLARED 1
 #endif
@@ -271,40 +293,195 @@ union YYSTYPE
 
 extern YYSTYPE yylval;
 
+
 int yyparse (void);
 
+
 #endif /* !YY_YY_Y_TAB_H_INCLUDED  */
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_RW_CREATE = 3,                  /* RW_CREATE  */
+  YYSYMBOL_RW_DROP = 4,                    /* RW_DROP  */
+  YYSYMBOL_RW_TABLE = 5,                   /* RW_TABLE  */
+  YYSYMBOL_RW_INDEX = 6,                   /* RW_INDEX  */
+  YYSYMBOL_RW_LOAD = 7,                    /* RW_LOAD  */
+  YYSYMBOL_RW_LOADLIB = 8,                 /* RW_LOADLIB  */
+  YYSYMBOL_RW_SET = 9,                     /* RW_SET  */
+  YYSYMBOL_RW_HELP = 10,                   /* RW_HELP  */
+  YYSYMBOL_RW_PRINT = 11,                  /* RW_PRINT  */
+  YYSYMBOL_RW_COMPACT = 12,                /* RW_COMPACT  */
+  YYSYMBOL_RW_EXIT = 13,                   /* RW_EXIT  */
+  YYSYMBOL_RW_SELECT = 14,                 /* RW_SELECT  */
+  YYSYMBOL_RW_FROM = 15,                   /* RW_FROM  */
+  YYSYMBOL_RW_WHERE = 16,                  /* RW_WHERE  */
+  YYSYMBOL_RW_INSERT = 17,                 /* RW_INSERT  */
+  YYSYMBOL_RW_DELETE = 18,                 /* RW_DELETE  */
+  YYSYMBOL_RW_UPDATE = 19,                 /* RW_UPDATE  */
+  YYSYMBOL_RW_AND = 20,                    /* RW_AND  */
+  YYSYMBOL_RW_INTO = 21,                   /* RW_INTO  */
+  YYSYMBOL_RW_VALUES = 22,                 /* RW_VALUES  */
+  YYSYMBOL_T_EQ = 23,                      /* T_EQ  */
+  YYSYMBOL_T_LT = 24,                      /* T_LT  */
+  YYSYMBOL_T_LE = 25,                      /* T_LE  */
+  YYSYMBOL_T_GT = 26,                      /* T_GT  */
+  YYSYMBOL_T_GE = 27,                      /* T_GE  */
+  YYSYMBOL_T_NE = 28,                      /* T_NE  */
+  YYSYMBOL_T_EOF = 29,                     /* T_EOF  */
+  YYSYMBOL_NOTOKEN = 30,                   /* NOTOKEN  */
+  YYSYMBOL_RW_RESET = 31,                  /* RW_RESET  */
+  YYSYMBOL_RW_IO = 32,                     /* RW_IO  */
+  YYSYMBOL_RW_BUFFER = 33,                 /* RW_BUFFER  */
+  YYSYMBOL_RW_RESIZE = 34,                 /* RW_RESIZE  */
+  YYSYMBOL_RW_QUERY_PLAN = 35,             /* RW_QUERY_PLAN  */
+  YYSYMBOL_RW_ON = 36,                     /* RW_ON  */
+  YYSYMBOL_RW_OFF = 37,                    /* RW_OFF  */
+  YYSYMBOL_T_INT = 38,                     /* T_INT  */
+  YYSYMBOL_T_REAL = 39,                    /* T_REAL  */
+  YYSYMBOL_T_STRING = 40,                  /* T_STRING  */
+  YYSYMBOL_T_QSTRING = 41,                 /* T_QSTRING  */
+  YYSYMBOL_T_SHELL_CMD = 42,               /* T_SHELL_CMD  */
+  YYSYMBOL_43_ = 43,                       /* ';'  */
+  YYSYMBOL_44_ = 44,                       /* '('  */
+  YYSYMBOL_45_ = 45,                       /* ')'  */
+  YYSYMBOL_46_ = 46,                       /* ','  */
+  YYSYMBOL_47_ = 47,                       /* '*'  */
+  YYSYMBOL_48_ = 48,                       /* '.'  */
+  YYSYMBOL_YYACCEPT = 49,                  /* $accept  */
+  YYSYMBOL_start = 50,                     /* start  */
+  YYSYMBOL_command = 51,                   /* command  */
+  YYSYMBOL_ddl = 52,                       /* ddl  */
+  YYSYMBOL_dml = 53,                       /* dml  */
+  YYSYMBOL_utility = 54,                   /* utility  */
+  YYSYMBOL_queryplans = 55,                /* queryplans  */
+  YYSYMBOL_buffer = 56,                    /* buffer  */
+  YYSYMBOL_statistics = 57,                /* statistics  */
+  YYSYMBOL_createtable = 58,               /* createtable  */
+  YYSYMBOL_createindex = 59,               /* createindex  */
+  YYSYMBOL_droptable = 60,                 /* droptable  */
+  YYSYMBOL_dropindex = 61,                 /* dropindex  */
+  YYSYMBOL_load = 62,                      /* load  */
+  YYSYMBOL_loadlib = 63,                   /* loadlib  */
+  YYSYMBOL_set = 64,                       /* set  */
+  YYSYMBOL_help = 65,                      /* help  */
+  YYSYMBOL_print = 66,                     /* print  */
+  YYSYMBOL_compact = 67,                   /* compact  */
+  YYSYMBOL_exit = 68,                      /* exit  */
+  YYSYMBOL_query = 69,                     /* query  */
+  YYSYMBOL_insert = 70,                    /* insert  */
+  YYSYMBOL_delete = 71,                    /* delete  */
+  YYSYMBOL_update = 72,                    /* update  */
+  YYSYMBOL_non_mt_attrtype_list = 73,      /* non_mt_attrtype_list  */
+  YYSYMBOL_attrtype = 74,                  /* attrtype  */
+  YYSYMBOL_non_mt_select_clause = 75,      /* non_mt_select_clause  */
+  YYSYMBOL_non_mt_relattr_list = 76,       /* non_mt_relattr_list  */
+  YYSYMBOL_relattr = 77,                   /* relattr  */
+  YYSYMBOL_non_mt_relation_list = 78,      /* non_mt_relation_list  */
+  YYSYMBOL_relation = 79,                  /* relation  */
+  YYSYMBOL_opt_where_clause = 80,          /* opt_where_clause  */
+  YYSYMBOL_non_mt_cond_list = 81,          /* non_mt_cond_list  */
+  YYSYMBOL_condition = 82,                 /* condition  */
+  YYSYMBOL_relattr_or_value = 83,          /* relattr_or_value  */
+  YYSYMBOL_non_mt_value_list = 84,         /* non_mt_value_list  */
+  YYSYMBOL_value = 85,                     /* value  */
+  YYSYMBOL_opt_relname = 86,               /* opt_relname  */
+  YYSYMBOL_op = 87,                        /* op  */
+  YYSYMBOL_nothing = 88                    /* nothing  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
 
-/* Copy the second part of user declarations.  */
 
-#line 281 "y.tab.c" /* yacc.c:358  */
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
 #else
 typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_int16;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef short int yytype_int16;
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -312,15 +489,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -334,47 +524,43 @@ typedef short int yytype_int16;
 # endif
 #endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
-#endif
 
 #ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
-#endif
-
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -387,8 +573,22 @@ typedef short int yytype_int16;
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -453,8 +653,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -463,17 +662,17 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
@@ -486,11 +685,11 @@ union yyalloc
 # define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
     do                                                                  \
       {                                                                 \
-        YYSIZE_T yynewbytes;                                            \
+        YYPTRDIFF_T yynewbytes;                                         \
         YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
         Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / sizeof (*yyptr);                          \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
       }                                                                 \
     while (0)
 
@@ -502,12 +701,12 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
@@ -517,37 +716,40 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  68
+#define YYFINAL  71
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   123
+#define YYLAST   124
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  48
+#define YYNTOKENS  49
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  39
+#define YYNNTS  40
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  82
+#define YYNRULES  84
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  149
+#define YYNSTATES  152
 
-/* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
-   by yylex, with out-of-bounds checking.  */
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   296
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   297
 
-#define YYTRANSLATE(YYX)                                                \
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, without out-of-bounds checking.  */
-static const yytype_uint8 yytranslate[] =
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      43,    44,    46,     2,    45,     2,    47,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    42,
+      44,    45,    47,     2,    46,     2,    48,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    43,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -571,252 +773,256 @@ static const yytype_uint8 yytranslate[] =
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39,    40,    41
+      35,    36,    37,    38,    39,    40,    41,    42
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
-static const yytype_uint16 yyrline[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
-       0,   164,   164,   169,   183,   189,   198,   199,   200,   201,
-     208,   209,   210,   211,   215,   216,   217,   218,   222,   223,
-     224,   225,   226,   227,   228,   229,   230,   234,   240,   251,
-     259,   264,   272,   283,   296,   303,   310,   317,   324,   331,
-     338,   345,   352,   359,   367,   374,   381,   388,   392,   399,
-     403,   410,   417,   418,   425,   429,   436,   440,   447,   451,
-     458,   465,   469,   476,   480,   487,   491,   498,   502,   509,
-     513,   520,   524,   528,   535,   539,   546,   550,   554,   558,
-     562,   566,   572
+       0,   166,   166,   171,   185,   191,   200,   201,   202,   203,
+     210,   211,   212,   213,   217,   218,   219,   220,   224,   225,
+     226,   227,   228,   229,   230,   231,   232,   233,   237,   243,
+     254,   262,   267,   275,   286,   299,   306,   313,   320,   327,
+     334,   341,   348,   355,   362,   369,   377,   384,   391,   398,
+     402,   409,   413,   420,   427,   428,   435,   439,   446,   450,
+     457,   461,   468,   475,   479,   486,   490,   497,   501,   508,
+     512,   519,   523,   530,   534,   538,   545,   549,   556,   560,
+     564,   568,   572,   576,   583
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "RW_CREATE", "RW_DROP", "RW_TABLE",
-  "RW_INDEX", "RW_LOAD", "RW_LOADLIB", "RW_SET", "RW_HELP", "RW_PRINT",
-  "RW_EXIT", "RW_SELECT", "RW_FROM", "RW_WHERE", "RW_INSERT", "RW_DELETE",
-  "RW_UPDATE", "RW_AND", "RW_INTO", "RW_VALUES", "T_EQ", "T_LT", "T_LE",
-  "T_GT", "T_GE", "T_NE", "T_EOF", "NOTOKEN", "RW_RESET", "RW_IO",
-  "RW_BUFFER", "RW_RESIZE", "RW_QUERY_PLAN", "RW_ON", "RW_OFF", "T_INT",
-  "T_REAL", "T_STRING", "T_QSTRING", "T_SHELL_CMD", "';'", "'('", "')'",
-  "','", "'*'", "'.'", "$accept", "start", "command", "ddl", "dml",
-  "utility", "queryplans", "buffer", "statistics", "createtable",
-  "createindex", "droptable", "dropindex", "load", "loadlib", "set",
-  "help", "print", "exit", "query", "insert", "delete", "update",
-  "non_mt_attrtype_list", "attrtype", "non_mt_select_clause",
-  "non_mt_relattr_list", "relattr", "non_mt_relation_list", "relation",
-  "opt_where_clause", "non_mt_cond_list", "condition", "relattr_or_value",
-  "non_mt_value_list", "value", "opt_relname", "op", "nothing", YY_NULLPTR
+  "\"end of file\"", "error", "\"invalid token\"", "RW_CREATE", "RW_DROP",
+  "RW_TABLE", "RW_INDEX", "RW_LOAD", "RW_LOADLIB", "RW_SET", "RW_HELP",
+  "RW_PRINT", "RW_COMPACT", "RW_EXIT", "RW_SELECT", "RW_FROM", "RW_WHERE",
+  "RW_INSERT", "RW_DELETE", "RW_UPDATE", "RW_AND", "RW_INTO", "RW_VALUES",
+  "T_EQ", "T_LT", "T_LE", "T_GT", "T_GE", "T_NE", "T_EOF", "NOTOKEN",
+  "RW_RESET", "RW_IO", "RW_BUFFER", "RW_RESIZE", "RW_QUERY_PLAN", "RW_ON",
+  "RW_OFF", "T_INT", "T_REAL", "T_STRING", "T_QSTRING", "T_SHELL_CMD",
+  "';'", "'('", "')'", "','", "'*'", "'.'", "$accept", "start", "command",
+  "ddl", "dml", "utility", "queryplans", "buffer", "statistics",
+  "createtable", "createindex", "droptable", "dropindex", "load",
+  "loadlib", "set", "help", "print", "compact", "exit", "query", "insert",
+  "delete", "update", "non_mt_attrtype_list", "attrtype",
+  "non_mt_select_clause", "non_mt_relattr_list", "relattr",
+  "non_mt_relation_list", "relation", "opt_where_clause",
+  "non_mt_cond_list", "condition", "relattr_or_value", "non_mt_value_list",
+  "value", "opt_relname", "op", "nothing", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,    59,    40,    41,    44,    42,    46
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF -111
+#define YYPACT_NINF (-113)
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-111)))
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF -83
+#define YYTABLE_NINF (-85)
 
-#define yytable_value_is_error(Yytable_value) \
+#define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int8 yypact[] =
 {
-       8,  -111,    23,    34,   -37,   -33,   -29,    -2,   -26,  -111,
-     -16,    31,    53,     9,  -111,    12,    15,    35,  -111,    69,
-      30,  -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,
-    -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,
-    -111,  -111,    36,    37,    38,    39,    40,  -111,    51,  -111,
-    -111,  -111,  -111,  -111,  -111,    32,  -111,    60,  -111,    41,
-      42,    43,    71,  -111,  -111,    47,  -111,  -111,  -111,  -111,
-      44,    45,  -111,    46,    50,    52,    54,    55,    56,    64,
-      76,    57,  -111,    58,    59,    61,    62,  -111,  -111,  -111,
-      76,    63,  -111,    66,    65,  -111,  -111,   -39,    77,    68,
-      67,    70,    72,    73,  -111,  -111,    55,    28,   -12,    33,
-    -111,    82,    56,    24,  -111,  -111,    58,  -111,  -111,  -111,
-    -111,  -111,  -111,    74,    75,    56,  -111,  -111,  -111,  -111,
-    -111,  -111,    24,    65,    78,  -111,    76,  -111,  -111,  -111,
-      28,    79,  -111,  -111,    76,  -111,  -111,  -111,  -111
+       8,  -113,     2,    42,   -35,    -6,    -2,     1,   -30,     4,
+    -113,   -34,    28,    52,    31,  -113,    -4,    39,    33,  -113,
+      73,    34,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,
+    -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,
+    -113,  -113,  -113,  -113,    35,    36,    38,    40,    30,  -113,
+      56,  -113,  -113,  -113,  -113,  -113,  -113,  -113,    37,  -113,
+      66,  -113,    41,    43,    44,    77,  -113,  -113,    50,  -113,
+    -113,  -113,  -113,    45,    46,  -113,    47,    51,    53,    55,
+      57,    58,    60,    80,    59,  -113,    61,    62,    63,    48,
+    -113,  -113,  -113,    80,    54,  -113,    64,    65,  -113,  -113,
+     -14,    81,    67,    68,    69,    71,    72,  -113,  -113,    57,
+      27,    -8,    32,  -113,    86,    58,    23,  -113,  -113,    61,
+    -113,  -113,  -113,  -113,  -113,  -113,    74,    75,    58,  -113,
+    -113,  -113,  -113,  -113,  -113,    23,    65,    78,  -113,    80,
+    -113,  -113,  -113,    27,    79,  -113,  -113,    80,  -113,  -113,
+    -113,  -113
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
 {
-       0,     4,     0,     0,     0,     0,     0,    82,     0,    43,
-       0,     0,     0,     0,     5,     0,     0,     0,     3,     0,
-       0,     6,     7,     8,    26,    24,    25,    10,    11,    12,
-      13,    18,    19,    21,    22,    23,    20,    14,    15,    16,
-      17,     9,     0,     0,     0,     0,     0,    39,     0,    74,
-      41,    75,    32,    30,    42,    57,    53,     0,    52,    55,
-       0,     0,     0,    33,    29,     0,    27,    28,     1,     2,
-       0,     0,    36,     0,     0,     0,     0,     0,     0,     0,
-      82,     0,    31,     0,     0,     0,     0,    40,    56,    60,
-      82,    59,    54,     0,     0,    46,    62,    57,     0,     0,
-       0,    50,     0,     0,    38,    44,     0,     0,    57,     0,
-      61,    64,     0,     0,    51,    34,     0,    35,    37,    58,
-      72,    73,    71,     0,    70,     0,    80,    76,    77,    78,
-      79,    81,     0,     0,     0,    67,    82,    68,    49,    45,
-       0,     0,    65,    63,    82,    47,    69,    66,    48
+       0,     4,     0,     0,     0,     0,     0,    84,     0,     0,
+      45,     0,     0,     0,     0,     5,     0,     0,     0,     3,
+       0,     0,     6,     7,     8,    27,    25,    26,    10,    11,
+      12,    13,    18,    19,    21,    22,    23,    24,    20,    14,
+      15,    16,    17,     9,     0,     0,     0,     0,     0,    40,
+       0,    76,    42,    77,    33,    31,    43,    44,    59,    55,
+       0,    54,    57,     0,     0,     0,    34,    30,     0,    28,
+      29,     1,     2,     0,     0,    37,     0,     0,     0,     0,
+       0,     0,     0,    84,     0,    32,     0,     0,     0,     0,
+      41,    58,    62,    84,    61,    56,     0,     0,    48,    64,
+      59,     0,     0,     0,    52,     0,     0,    39,    46,     0,
+       0,    59,     0,    63,    66,     0,     0,    53,    35,     0,
+      36,    38,    60,    74,    75,    73,     0,    72,     0,    82,
+      78,    79,    80,    81,    83,     0,     0,     0,    69,    84,
+      70,    51,    47,     0,     0,    67,    65,    84,    49,    71,
+      68,    50
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
-    -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,
-    -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,  -111,
-    -111,  -111,  -111,   -14,  -111,  -111,    25,   -80,    -1,  -111,
-     -90,   -23,  -111,   -20,   -27,  -110,  -111,  -111,    27
+    -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,
+    -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,
+    -113,  -113,  -113,  -113,   -10,  -113,  -113,    29,   -83,     3,
+    -113,   -93,   -25,  -113,   -21,   -23,  -112,  -113,  -113,    24
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    29,    30,    31,    32,    33,    34,    35,    36,    37,
-      38,    39,    40,   100,   101,    57,    58,    59,    90,    91,
-      95,   110,   111,   136,   123,   124,    50,   132,    96
+       0,    20,    21,    22,    23,    24,    25,    26,    27,    28,
+      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,    40,    41,    42,   103,   104,    60,    61,    62,    93,
+      94,    98,   113,   114,   139,   126,   127,    52,   135,    99
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-     105,    98,    46,   137,   112,    52,    53,    47,    76,     1,
-      48,     2,     3,    54,   109,     4,     5,     6,     7,     8,
-       9,    10,   137,    55,    11,    12,    13,    41,    42,    43,
-      56,   125,   134,   135,    51,    76,    14,    49,    15,    44,
-      45,    16,    17,    63,    64,   141,   145,    65,    62,    18,
-     -82,    60,   135,   109,   148,   126,   127,   128,   129,   130,
-     131,   120,   121,    55,   122,   120,   121,    61,   122,    68,
-      66,    67,    69,    75,    77,    70,    71,    72,    73,    76,
-      81,    79,    80,    74,    82,    93,    78,    83,    84,    85,
-      86,    94,    87,    88,    89,    55,    97,    99,   102,   113,
-     103,   133,   138,    92,   108,   119,   104,   114,   106,   107,
-     143,   115,   142,   146,     0,   116,   117,   118,   139,     0,
-     140,     0,   144,   147
+     108,   101,    54,    55,   140,    48,    58,    44,    45,     1,
+      56,     2,     3,    59,   112,     4,     5,     6,     7,     8,
+       9,    10,    11,   140,    43,    12,    13,    14,    66,    67,
+     115,    53,   137,   138,    79,    49,   128,    15,    50,    16,
+      79,    51,    17,    18,    57,   144,   148,    46,    47,    63,
+      19,   -84,   138,   112,   151,   129,   130,   131,   132,   133,
+     134,   123,   124,    58,   125,   123,   124,    64,   125,    69,
+      70,    65,    68,    71,    77,    73,    74,    72,    75,    78,
+      76,    80,    96,    82,    83,    79,    84,    81,    85,    86,
+      87,    88,    89,   107,    90,    91,    97,    92,    58,   100,
+     109,   102,   105,   106,   116,   111,   136,   117,   110,   141,
+      95,   146,   122,   118,   145,   119,   120,   121,     0,   142,
+     149,   143,     0,   147,   150
 };
 
 static const yytype_int16 yycheck[] =
 {
-      90,    81,    39,   113,    43,    31,    32,    40,    47,     1,
-      39,     3,     4,    39,    94,     7,     8,     9,    10,    11,
-      12,    13,   132,    39,    16,    17,    18,     0,     5,     6,
-      46,    43,   112,   113,     7,    47,    28,    39,    30,     5,
-       6,    33,    34,    31,    32,   125,   136,    32,    39,    41,
-      42,    20,   132,   133,   144,    22,    23,    24,    25,    26,
-      27,    37,    38,    39,    40,    37,    38,    14,    40,     0,
-      35,    36,    42,    22,    14,    39,    39,    39,    39,    47,
-       9,    39,    39,    43,    37,    21,    45,    43,    43,    43,
-      40,    15,    40,    39,    39,    39,    39,    39,    39,    22,
-      39,    19,   116,    78,    39,   106,    44,    39,    45,    43,
-     133,    44,   132,   140,    -1,    45,    44,    44,    44,    -1,
-      45,    -1,    44,    44
+      93,    84,    32,    33,   116,    40,    40,     5,     6,     1,
+      40,     3,     4,    47,    97,     7,     8,     9,    10,    11,
+      12,    13,    14,   135,     0,    17,    18,    19,    32,    33,
+      44,     7,   115,   116,    48,    41,    44,    29,    40,    31,
+      48,    40,    34,    35,    40,   128,   139,     5,     6,    21,
+      42,    43,   135,   136,   147,    23,    24,    25,    26,    27,
+      28,    38,    39,    40,    41,    38,    39,    15,    41,    36,
+      37,    40,    33,     0,    44,    40,    40,    43,    40,    23,
+      40,    15,    22,    40,    40,    48,     9,    46,    38,    44,
+      44,    44,    41,    45,    41,    40,    16,    40,    40,    40,
+      46,    40,    40,    40,    23,    40,    20,    40,    44,   119,
+      81,   136,   109,    45,   135,    46,    45,    45,    -1,    45,
+     143,    46,    -1,    45,    45
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
        0,     1,     3,     4,     7,     8,     9,    10,    11,    12,
-      13,    16,    17,    18,    28,    30,    33,    34,    41,    49,
+      13,    14,    17,    18,    19,    29,    31,    34,    35,    42,
       50,    51,    52,    53,    54,    55,    56,    57,    58,    59,
       60,    61,    62,    63,    64,    65,    66,    67,    68,    69,
-      70,    86,     5,     6,     5,     6,    39,    40,    39,    39,
-      84,    86,    31,    32,    39,    39,    46,    73,    74,    75,
-      20,    14,    39,    31,    32,    32,    35,    36,     0,    42,
-      39,    39,    39,    39,    43,    22,    47,    14,    45,    39,
-      39,     9,    37,    43,    43,    43,    40,    40,    39,    39,
-      76,    77,    74,    21,    15,    78,    86,    39,    75,    39,
-      71,    72,    39,    39,    44,    78,    45,    43,    39,    75,
-      79,    80,    43,    22,    39,    44,    45,    44,    44,    76,
-      37,    38,    40,    82,    83,    43,    22,    23,    24,    25,
-      26,    27,    85,    19,    75,    75,    81,    83,    71,    44,
-      45,    75,    81,    79,    44,    78,    82,    44,    78
+      70,    71,    72,    88,     5,     6,     5,     6,    40,    41,
+      40,    40,    86,    88,    32,    33,    40,    40,    40,    47,
+      75,    76,    77,    21,    15,    40,    32,    33,    33,    36,
+      37,     0,    43,    40,    40,    40,    40,    44,    23,    48,
+      15,    46,    40,    40,     9,    38,    44,    44,    44,    41,
+      41,    40,    40,    78,    79,    76,    22,    16,    80,    88,
+      40,    77,    40,    73,    74,    40,    40,    45,    80,    46,
+      44,    40,    77,    81,    82,    44,    23,    40,    45,    46,
+      45,    45,    78,    38,    39,    41,    84,    85,    44,    23,
+      24,    25,    26,    27,    28,    87,    20,    77,    77,    83,
+      85,    73,    45,    46,    77,    83,    81,    45,    80,    84,
+      45,    80
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-       0,    48,    49,    49,    49,    49,    50,    50,    50,    50,
-      51,    51,    51,    51,    52,    52,    52,    52,    53,    53,
-      53,    53,    53,    53,    53,    53,    53,    54,    54,    55,
-      55,    55,    56,    56,    57,    58,    59,    60,    61,    62,
-      63,    64,    65,    66,    67,    68,    69,    70,    70,    71,
-      71,    72,    73,    73,    74,    74,    75,    75,    76,    76,
-      77,    78,    78,    79,    79,    80,    80,    81,    81,    82,
-      82,    83,    83,    83,    84,    84,    85,    85,    85,    85,
-      85,    85,    86
+       0,    49,    50,    50,    50,    50,    51,    51,    51,    51,
+      52,    52,    52,    52,    53,    53,    53,    53,    54,    54,
+      54,    54,    54,    54,    54,    54,    54,    54,    55,    55,
+      56,    56,    56,    57,    57,    58,    59,    60,    61,    62,
+      63,    64,    65,    66,    67,    68,    69,    70,    71,    72,
+      72,    73,    73,    74,    75,    75,    76,    76,    77,    77,
+      78,    78,    79,    80,    80,    81,    81,    82,    82,    83,
+      83,    84,    84,    85,    85,    85,    86,    86,    87,    87,
+      87,    87,    87,    87,    88
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     2,     2,     2,
-       2,     3,     2,     2,     6,     6,     3,     6,     5,     2,
-       4,     2,     2,     1,     5,     7,     4,     7,     8,     3,
-       1,     2,     1,     1,     3,     1,     3,     1,     3,     1,
-       1,     2,     1,     3,     1,     3,     4,     1,     1,     3,
-       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     0
+       1,     1,     1,     1,     1,     1,     1,     1,     2,     2,
+       2,     2,     3,     2,     2,     6,     6,     3,     6,     5,
+       2,     4,     2,     2,     2,     1,     5,     7,     4,     7,
+       8,     3,     1,     2,     1,     1,     3,     1,     3,     1,
+       3,     1,     1,     2,     1,     3,     1,     3,     4,     1,
+       1,     3,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     0
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;                                                  \
-    }                                                           \
-while (0)
-
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 
 /* Enable debugging if requested.  */
@@ -833,55 +1039,52 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value); \
+                  Kind, Value); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
 
 
-/*----------------------------------------.
-| Print this symbol's value on YYOUTPUT.  |
-`----------------------------------------*/
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# endif
-  YYUSE (yytype);
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
-  YYFPRINTF (yyoutput, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -890,7 +1093,7 @@ yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
 `------------------------------------------------------------------*/
 
 static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -913,21 +1116,21 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
 {
-  unsigned long int yylno = yyrline[yyrule];
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
              yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[yyssp[yyi + 1 - yynrhs]],
-                       &(yyvsp[(yyi + 1) - (yynrhs)])
-                                              );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -942,8 +1145,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -966,249 +1169,30 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-static YYSIZE_T
-yystrlen (const char *yystr)
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-        switch (*++yyp)
-          {
-          case '\'':
-          case ',':
-            goto do_not_strip_quotes;
-
-          case '\\':
-            if (*++yyp != '\\')
-              goto do_not_strip_quotes;
-            /* Fall through.  */
-          default:
-            if (yyres)
-              yyres[yyn] = *yyp;
-            yyn++;
-            break;
-
-          case '"':
-            if (yyres)
-              yyres[yyn] = '\0';
-            return yyn;
-          }
-    do_not_strip_quotes: ;
-    }
-
-  if (! yyres)
-    return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
-{
-  YYSIZE_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
-  int yycount = 0;
-
-  /* There are many possibilities here to consider:
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
 
-  {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
-  }
 
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
 
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          yyp++;
-          yyformat++;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
 {
-  YYUSE (yyvaluep);
+  YY_USE (yyvaluep);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-
-
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 /* The semantic value of the lookahead symbol.  */
@@ -1217,6 +1201,8 @@ YYSTYPE yylval;
 int yynerrs;
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1224,43 +1210,36 @@ int yynerrs;
 int
 yyparse (void)
 {
-    int yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
-
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
+    int yyerrstatus = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-    /* The semantic value stack.  */
-    YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    YYSIZE_T yystacksize;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1268,71 +1247,75 @@ yyparse (void)
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
         /* Give user a chance to reallocate the stack.  Use copies of
            these so that the &'s don't force the real ones into
            memory.  */
+        yy_state_t *yyss1 = yyss;
         YYSTYPE *yyvs1 = yyvs;
-        yytype_int16 *yyss1 = yyss;
 
         /* Each stack pointer address is followed by the size of the
            data in use in that stack, in bytes.  This used to be a
            conditional around just the two extra args, but that might
            be undefined if yyoverflow is a macro.  */
         yyoverflow (YY_("memory exhausted"),
-                    &yyss1, yysize * sizeof (*yyssp),
-                    &yyvs1, yysize * sizeof (*yyvsp),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
                     &yystacksize);
-
         yyss = yyss1;
         yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
 
       {
-        yytype_int16 *yyss1 = yyss;
+        yy_state_t *yyss1 = yyss;
         union yyalloc *yyptr =
-          (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
@@ -1340,30 +1323,31 @@ yyparse (void)
           YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-                  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
         YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1374,18 +1358,29 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1413,15 +1408,13 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1436,7 +1429,7 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
@@ -1456,18 +1449,18 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 165 "parse.y" /* yacc.c:1646  */
-    {
+  case 2: /* start: command ';'  */
+#line 167 "parse.y"
+   {
       parse_tree = (yyvsp[-1].n);
       YYACCEPT;
    }
-#line 1466 "y.tab.c" /* yacc.c:1646  */
+#line 1459 "y.tab.c"
     break;
 
-  case 3:
-#line 170 "parse.y" /* yacc.c:1646  */
-    {
+  case 3: /* start: T_SHELL_CMD  */
+#line 172 "parse.y"
+   {
       if (!isatty(0)) {
         cout << ((yyvsp[0].sval)) << "\n";
         cout.flush();
@@ -1480,90 +1473,90 @@ yyreduce:
       parse_tree = NULL;
       YYACCEPT;
    }
-#line 1484 "y.tab.c" /* yacc.c:1646  */
+#line 1477 "y.tab.c"
     break;
 
-  case 4:
-#line 184 "parse.y" /* yacc.c:1646  */
-    {
+  case 4: /* start: error  */
+#line 186 "parse.y"
+   {
       reset_scanner();
       parse_tree = NULL;
       YYACCEPT;
    }
-#line 1494 "y.tab.c" /* yacc.c:1646  */
+#line 1487 "y.tab.c"
     break;
 
-  case 5:
-#line 190 "parse.y" /* yacc.c:1646  */
-    {
+  case 5: /* start: T_EOF  */
+#line 192 "parse.y"
+   {
       parse_tree = NULL;
       bExit = 1;
       YYACCEPT;
    }
-#line 1504 "y.tab.c" /* yacc.c:1646  */
+#line 1497 "y.tab.c"
     break;
 
-  case 9:
-#line 202 "parse.y" /* yacc.c:1646  */
-    {
+  case 9: /* command: nothing  */
+#line 204 "parse.y"
+   {
       (yyval.n) = NULL;
    }
-#line 1512 "y.tab.c" /* yacc.c:1646  */
+#line 1505 "y.tab.c"
     break;
 
-  case 27:
-#line 235 "parse.y" /* yacc.c:1646  */
-    {
+  case 28: /* queryplans: RW_QUERY_PLAN RW_ON  */
+#line 238 "parse.y"
+   {
       bQueryPlans = 1;
       cout << "Query plan display turned on.\n";
       (yyval.n) = NULL;
    }
-#line 1522 "y.tab.c" /* yacc.c:1646  */
+#line 1515 "y.tab.c"
     break;
 
-  case 28:
-#line 241 "parse.y" /* yacc.c:1646  */
-    { 
+  case 29: /* queryplans: RW_QUERY_PLAN RW_OFF  */
+#line 244 "parse.y"
+   { 
       bQueryPlans = 0;
       cout << "Query plan display turned off.\n";
       (yyval.n) = NULL;
    }
-#line 1532 "y.tab.c" /* yacc.c:1646  */
+#line 1525 "y.tab.c"
     break;
 
-  case 29:
-#line 252 "parse.y" /* yacc.c:1646  */
-    {
+  case 30: /* buffer: RW_RESET RW_BUFFER  */
+#line 255 "parse.y"
+   {
       if (pPfm->ClearBuffer())
          cout << "Trouble clearing buffer!  Things may be pinned.\n";
       else 
          cout << "Everything kicked out of Buffer!\n";
       (yyval.n) = NULL;
    }
-#line 1544 "y.tab.c" /* yacc.c:1646  */
+#line 1537 "y.tab.c"
     break;
 
-  case 30:
-#line 260 "parse.y" /* yacc.c:1646  */
-    {
+  case 31: /* buffer: RW_PRINT RW_BUFFER  */
+#line 263 "parse.y"
+   {
       pPfm->PrintBuffer();
       (yyval.n) = NULL;
    }
-#line 1553 "y.tab.c" /* yacc.c:1646  */
+#line 1546 "y.tab.c"
     break;
 
-  case 31:
-#line 265 "parse.y" /* yacc.c:1646  */
-    {
+  case 32: /* buffer: RW_RESIZE RW_BUFFER T_INT  */
+#line 268 "parse.y"
+   {
       pPfm->ResizeBuffer((yyvsp[0].ival));
       (yyval.n) = NULL;
    }
-#line 1562 "y.tab.c" /* yacc.c:1646  */
+#line 1555 "y.tab.c"
     break;
 
-  case 32:
-#line 273 "parse.y" /* yacc.c:1646  */
-    {
+  case 33: /* statistics: RW_PRINT RW_IO  */
+#line 276 "parse.y"
+   {
       #ifdef PF_STATS
          cout << "Statistics\n";
          cout << "----------\n";
@@ -1573,12 +1566,12 @@ yyreduce:
       #endif
       (yyval.n) = NULL;
    }
-#line 1577 "y.tab.c" /* yacc.c:1646  */
+#line 1570 "y.tab.c"
     break;
 
-  case 33:
-#line 284 "parse.y" /* yacc.c:1646  */
-    {
+  case 34: /* statistics: RW_RESET RW_IO  */
+#line 287 "parse.y"
+   {
       #ifdef PF_STATS
          cout << "Statistics reset.\n";
          pStatisticsMgr->Reset();
@@ -1587,388 +1580,397 @@ yyreduce:
       #endif
       (yyval.n) = NULL;
    }
-#line 1591 "y.tab.c" /* yacc.c:1646  */
+#line 1584 "y.tab.c"
     break;
 
-  case 34:
-#line 297 "parse.y" /* yacc.c:1646  */
-    {
+  case 35: /* createtable: RW_CREATE RW_TABLE T_STRING '(' non_mt_attrtype_list ')'  */
+#line 300 "parse.y"
+   {
       (yyval.n) = create_table_node((yyvsp[-3].sval), (yyvsp[-1].n));
    }
-#line 1599 "y.tab.c" /* yacc.c:1646  */
+#line 1592 "y.tab.c"
     break;
 
-  case 35:
-#line 304 "parse.y" /* yacc.c:1646  */
-    {
+  case 36: /* createindex: RW_CREATE RW_INDEX T_STRING '(' T_STRING ')'  */
+#line 307 "parse.y"
+   {
       (yyval.n) = create_index_node((yyvsp[-3].sval), (yyvsp[-1].sval));
    }
-#line 1607 "y.tab.c" /* yacc.c:1646  */
+#line 1600 "y.tab.c"
     break;
 
-  case 36:
-#line 311 "parse.y" /* yacc.c:1646  */
-    {
+  case 37: /* droptable: RW_DROP RW_TABLE T_STRING  */
+#line 314 "parse.y"
+   {
       (yyval.n) = drop_table_node((yyvsp[0].sval));
    }
-#line 1615 "y.tab.c" /* yacc.c:1646  */
+#line 1608 "y.tab.c"
     break;
 
-  case 37:
-#line 318 "parse.y" /* yacc.c:1646  */
-    {
+  case 38: /* dropindex: RW_DROP RW_INDEX T_STRING '(' T_STRING ')'  */
+#line 321 "parse.y"
+   {
       (yyval.n) = drop_index_node((yyvsp[-3].sval), (yyvsp[-1].sval));
    }
-#line 1623 "y.tab.c" /* yacc.c:1646  */
+#line 1616 "y.tab.c"
     break;
 
-  case 38:
-#line 325 "parse.y" /* yacc.c:1646  */
-    {
+  case 39: /* load: RW_LOAD T_STRING '(' T_QSTRING ')'  */
+#line 328 "parse.y"
+   {
       (yyval.n) = load_node((yyvsp[-3].sval), (yyvsp[-1].sval));
    }
-#line 1631 "y.tab.c" /* yacc.c:1646  */
+#line 1624 "y.tab.c"
     break;
 
-  case 39:
-#line 332 "parse.y" /* yacc.c:1646  */
-    {
+  case 40: /* loadlib: RW_LOADLIB T_QSTRING  */
+#line 335 "parse.y"
+   {
       (yyval.n) = loadlib_node((yyvsp[0].sval));
    }
-#line 1639 "y.tab.c" /* yacc.c:1646  */
+#line 1632 "y.tab.c"
     break;
 
-  case 40:
-#line 339 "parse.y" /* yacc.c:1646  */
-    {
+  case 41: /* set: RW_SET T_STRING T_EQ T_QSTRING  */
+#line 342 "parse.y"
+   {
       (yyval.n) = set_node((yyvsp[-2].sval), (yyvsp[0].sval));
    }
-#line 1647 "y.tab.c" /* yacc.c:1646  */
+#line 1640 "y.tab.c"
     break;
 
-  case 41:
-#line 346 "parse.y" /* yacc.c:1646  */
-    {
+  case 42: /* help: RW_HELP opt_relname  */
+#line 349 "parse.y"
+   {
       (yyval.n) = help_node((yyvsp[0].sval));
    }
-#line 1655 "y.tab.c" /* yacc.c:1646  */
+#line 1648 "y.tab.c"
     break;
 
-  case 42:
-#line 353 "parse.y" /* yacc.c:1646  */
-    {
+  case 43: /* print: RW_PRINT T_STRING  */
+#line 356 "parse.y"
+   {
       (yyval.n) = print_node((yyvsp[0].sval));
    }
-#line 1663 "y.tab.c" /* yacc.c:1646  */
+#line 1656 "y.tab.c"
     break;
 
-  case 43:
-#line 360 "parse.y" /* yacc.c:1646  */
-    {
+  case 44: /* compact: RW_COMPACT T_STRING  */
+#line 363 "parse.y"
+   {
+      (yyval.n) = compact_node((yyvsp[0].sval));
+   }
+#line 1664 "y.tab.c"
+    break;
+
+  case 45: /* exit: RW_EXIT  */
+#line 370 "parse.y"
+   {
       (yyval.n) = NULL;
       bExit = 1;
    }
-#line 1672 "y.tab.c" /* yacc.c:1646  */
+#line 1673 "y.tab.c"
     break;
 
-  case 44:
-#line 368 "parse.y" /* yacc.c:1646  */
-    {
+  case 46: /* query: RW_SELECT non_mt_select_clause RW_FROM non_mt_relation_list opt_where_clause  */
+#line 378 "parse.y"
+   {
       (yyval.n) = query_node((yyvsp[-3].n), (yyvsp[-1].n), (yyvsp[0].n));
    }
-#line 1680 "y.tab.c" /* yacc.c:1646  */
+#line 1681 "y.tab.c"
     break;
 
-  case 45:
-#line 375 "parse.y" /* yacc.c:1646  */
-    {
+  case 47: /* insert: RW_INSERT RW_INTO T_STRING RW_VALUES '(' non_mt_value_list ')'  */
+#line 385 "parse.y"
+   {
       (yyval.n) = insert_node((yyvsp[-4].sval), (yyvsp[-1].n));
    }
-#line 1688 "y.tab.c" /* yacc.c:1646  */
+#line 1689 "y.tab.c"
     break;
 
-  case 46:
-#line 382 "parse.y" /* yacc.c:1646  */
-    {
+  case 48: /* delete: RW_DELETE RW_FROM T_STRING opt_where_clause  */
+#line 392 "parse.y"
+   {
       (yyval.n) = delete_node((yyvsp[-1].sval), (yyvsp[0].n));
    }
-#line 1696 "y.tab.c" /* yacc.c:1646  */
+#line 1697 "y.tab.c"
     break;
 
-  case 47:
-#line 389 "parse.y" /* yacc.c:1646  */
-    {
+  case 49: /* update: RW_UPDATE T_STRING RW_SET relattr T_EQ relattr_or_value opt_where_clause  */
+#line 399 "parse.y"
+   {
       (yyval.n) = update_node((yyvsp[-5].sval), (yyvsp[-3].n), (yyvsp[-1].n), (yyvsp[0].n));
    }
-#line 1704 "y.tab.c" /* yacc.c:1646  */
+#line 1705 "y.tab.c"
     break;
 
-  case 48:
-#line 393 "parse.y" /* yacc.c:1646  */
-    {
+  case 50: /* update: RW_UPDATE T_STRING RW_SET T_STRING '(' relattr ')' opt_where_clause  */
+#line 403 "parse.y"
+   {
       (yyval.n) = update_node((yyvsp[-6].sval), (yyvsp[-2].n), (yyvsp[-4].sval), (yyvsp[0].n));
    }
-#line 1712 "y.tab.c" /* yacc.c:1646  */
+#line 1713 "y.tab.c"
     break;
 
-  case 49:
-#line 400 "parse.y" /* yacc.c:1646  */
-    {
+  case 51: /* non_mt_attrtype_list: attrtype ',' non_mt_attrtype_list  */
+#line 410 "parse.y"
+   {
       (yyval.n) = prepend((yyvsp[-2].n), (yyvsp[0].n));
    }
-#line 1720 "y.tab.c" /* yacc.c:1646  */
+#line 1721 "y.tab.c"
     break;
 
-  case 50:
-#line 404 "parse.y" /* yacc.c:1646  */
-    {
+  case 52: /* non_mt_attrtype_list: attrtype  */
+#line 414 "parse.y"
+   {
       (yyval.n) = list_node((yyvsp[0].n));
    }
-#line 1728 "y.tab.c" /* yacc.c:1646  */
+#line 1729 "y.tab.c"
     break;
 
-  case 51:
-#line 411 "parse.y" /* yacc.c:1646  */
+  case 53: /* attrtype: T_STRING T_STRING  */
+#line 421 "parse.y"
     {
       (yyval.n) = attrtype_node((yyvsp[-1].sval), (yyvsp[0].sval));
    }
-#line 1736 "y.tab.c" /* yacc.c:1646  */
+#line 1737 "y.tab.c"
     break;
 
-  case 53:
-#line 419 "parse.y" /* yacc.c:1646  */
-    {
+  case 55: /* non_mt_select_clause: '*'  */
+#line 429 "parse.y"
+   {
        (yyval.n) = list_node(relattr_node(NULL, (char*)"*"));
    }
-#line 1744 "y.tab.c" /* yacc.c:1646  */
+#line 1745 "y.tab.c"
     break;
 
-  case 54:
-#line 426 "parse.y" /* yacc.c:1646  */
-    {
+  case 56: /* non_mt_relattr_list: relattr ',' non_mt_relattr_list  */
+#line 436 "parse.y"
+   {
       (yyval.n) = prepend((yyvsp[-2].n), (yyvsp[0].n));
    }
-#line 1752 "y.tab.c" /* yacc.c:1646  */
+#line 1753 "y.tab.c"
     break;
 
-  case 55:
-#line 430 "parse.y" /* yacc.c:1646  */
-    {
+  case 57: /* non_mt_relattr_list: relattr  */
+#line 440 "parse.y"
+   {
       (yyval.n) = list_node((yyvsp[0].n));
    }
-#line 1760 "y.tab.c" /* yacc.c:1646  */
+#line 1761 "y.tab.c"
     break;
 
-  case 56:
-#line 437 "parse.y" /* yacc.c:1646  */
-    {
+  case 58: /* relattr: T_STRING '.' T_STRING  */
+#line 447 "parse.y"
+   {
       (yyval.n) = relattr_node((yyvsp[-2].sval), (yyvsp[0].sval));
    }
-#line 1768 "y.tab.c" /* yacc.c:1646  */
+#line 1769 "y.tab.c"
     break;
 
-  case 57:
-#line 441 "parse.y" /* yacc.c:1646  */
-    {
+  case 59: /* relattr: T_STRING  */
+#line 451 "parse.y"
+   {
       (yyval.n) = relattr_node(NULL, (yyvsp[0].sval));
    }
-#line 1776 "y.tab.c" /* yacc.c:1646  */
+#line 1777 "y.tab.c"
     break;
 
-  case 58:
-#line 448 "parse.y" /* yacc.c:1646  */
-    {
+  case 60: /* non_mt_relation_list: relation ',' non_mt_relation_list  */
+#line 458 "parse.y"
+   {
       (yyval.n) = prepend((yyvsp[-2].n), (yyvsp[0].n));
    }
-#line 1784 "y.tab.c" /* yacc.c:1646  */
+#line 1785 "y.tab.c"
     break;
 
-  case 59:
-#line 452 "parse.y" /* yacc.c:1646  */
-    {
+  case 61: /* non_mt_relation_list: relation  */
+#line 462 "parse.y"
+   {
       (yyval.n) = list_node((yyvsp[0].n));
    }
-#line 1792 "y.tab.c" /* yacc.c:1646  */
+#line 1793 "y.tab.c"
     break;
 
-  case 60:
-#line 459 "parse.y" /* yacc.c:1646  */
-    {
+  case 62: /* relation: T_STRING  */
+#line 469 "parse.y"
+   {
       (yyval.n) = relation_node((yyvsp[0].sval));
    }
-#line 1800 "y.tab.c" /* yacc.c:1646  */
+#line 1801 "y.tab.c"
     break;
 
-  case 61:
-#line 466 "parse.y" /* yacc.c:1646  */
-    {
+  case 63: /* opt_where_clause: RW_WHERE non_mt_cond_list  */
+#line 476 "parse.y"
+   {
       (yyval.n) = (yyvsp[0].n);
    }
-#line 1808 "y.tab.c" /* yacc.c:1646  */
+#line 1809 "y.tab.c"
     break;
 
-  case 62:
-#line 470 "parse.y" /* yacc.c:1646  */
-    {
+  case 64: /* opt_where_clause: nothing  */
+#line 480 "parse.y"
+   {
       (yyval.n) = NULL;
    }
-#line 1816 "y.tab.c" /* yacc.c:1646  */
+#line 1817 "y.tab.c"
     break;
 
-  case 63:
-#line 477 "parse.y" /* yacc.c:1646  */
-    {
+  case 65: /* non_mt_cond_list: condition RW_AND non_mt_cond_list  */
+#line 487 "parse.y"
+   {
       (yyval.n) = prepend((yyvsp[-2].n), (yyvsp[0].n));
    }
-#line 1824 "y.tab.c" /* yacc.c:1646  */
+#line 1825 "y.tab.c"
     break;
 
-  case 64:
-#line 481 "parse.y" /* yacc.c:1646  */
-    {
+  case 66: /* non_mt_cond_list: condition  */
+#line 491 "parse.y"
+   {
       (yyval.n) = list_node((yyvsp[0].n));
    }
-#line 1832 "y.tab.c" /* yacc.c:1646  */
+#line 1833 "y.tab.c"
     break;
 
-  case 65:
-#line 488 "parse.y" /* yacc.c:1646  */
-    {
+  case 67: /* condition: relattr op relattr_or_value  */
+#line 498 "parse.y"
+   {
       (yyval.n) = condition_node((yyvsp[-2].n), (yyvsp[-1].cval), (yyvsp[0].n));
    }
-#line 1840 "y.tab.c" /* yacc.c:1646  */
+#line 1841 "y.tab.c"
     break;
 
-  case 66:
-#line 492 "parse.y" /* yacc.c:1646  */
-    {
+  case 68: /* condition: T_STRING '(' relattr ')'  */
+#line 502 "parse.y"
+   {
       (yyval.n) = condition_node((yyvsp[-1].n), (yyvsp[-3].sval));
    }
-#line 1848 "y.tab.c" /* yacc.c:1646  */
+#line 1849 "y.tab.c"
     break;
 
-  case 67:
-#line 499 "parse.y" /* yacc.c:1646  */
-    {
+  case 69: /* relattr_or_value: relattr  */
+#line 509 "parse.y"
+   {
       (yyval.n) = relattr_or_value_node((yyvsp[0].n), NULL);
    }
-#line 1856 "y.tab.c" /* yacc.c:1646  */
+#line 1857 "y.tab.c"
     break;
 
-  case 68:
-#line 503 "parse.y" /* yacc.c:1646  */
-    {
+  case 70: /* relattr_or_value: value  */
+#line 513 "parse.y"
+   {
       (yyval.n) = relattr_or_value_node(NULL, (yyvsp[0].n));
    }
-#line 1864 "y.tab.c" /* yacc.c:1646  */
+#line 1865 "y.tab.c"
     break;
 
-  case 69:
-#line 510 "parse.y" /* yacc.c:1646  */
-    {
+  case 71: /* non_mt_value_list: value ',' non_mt_value_list  */
+#line 520 "parse.y"
+   {
       (yyval.n) = prepend((yyvsp[-2].n), (yyvsp[0].n));
    }
-#line 1872 "y.tab.c" /* yacc.c:1646  */
+#line 1873 "y.tab.c"
     break;
 
-  case 70:
-#line 514 "parse.y" /* yacc.c:1646  */
-    {
+  case 72: /* non_mt_value_list: value  */
+#line 524 "parse.y"
+   {
       (yyval.n) = list_node((yyvsp[0].n));
    }
-#line 1880 "y.tab.c" /* yacc.c:1646  */
+#line 1881 "y.tab.c"
     break;
 
-  case 71:
-#line 521 "parse.y" /* yacc.c:1646  */
-    {
+  case 73: /* value: T_QSTRING  */
+#line 531 "parse.y"
+   {
       (yyval.n) = value_node(STRING, (void *) (yyvsp[0].sval));
    }
-#line 1888 "y.tab.c" /* yacc.c:1646  */
+#line 1889 "y.tab.c"
     break;
 
-  case 72:
-#line 525 "parse.y" /* yacc.c:1646  */
-    {
+  case 74: /* value: T_INT  */
+#line 535 "parse.y"
+   {
       (yyval.n) = value_node(INT, (void *)& (yyvsp[0].ival));
    }
-#line 1896 "y.tab.c" /* yacc.c:1646  */
+#line 1897 "y.tab.c"
     break;
 
-  case 73:
-#line 529 "parse.y" /* yacc.c:1646  */
-    {
+  case 75: /* value: T_REAL  */
+#line 539 "parse.y"
+   {
       (yyval.n) = value_node(FLOAT, (void *)& (yyvsp[0].rval));
    }
-#line 1904 "y.tab.c" /* yacc.c:1646  */
+#line 1905 "y.tab.c"
     break;
 
-  case 74:
-#line 536 "parse.y" /* yacc.c:1646  */
-    {
+  case 76: /* opt_relname: T_STRING  */
+#line 546 "parse.y"
+   {
       (yyval.sval) = (yyvsp[0].sval);
    }
-#line 1912 "y.tab.c" /* yacc.c:1646  */
+#line 1913 "y.tab.c"
     break;
 
-  case 75:
-#line 540 "parse.y" /* yacc.c:1646  */
-    {
+  case 77: /* opt_relname: nothing  */
+#line 550 "parse.y"
+   {
       (yyval.sval) = NULL;
    }
-#line 1920 "y.tab.c" /* yacc.c:1646  */
+#line 1921 "y.tab.c"
     break;
 
-  case 76:
-#line 547 "parse.y" /* yacc.c:1646  */
-    {
+  case 78: /* op: T_LT  */
+#line 557 "parse.y"
+   {
       (yyval.cval) = LT_OP;
    }
-#line 1928 "y.tab.c" /* yacc.c:1646  */
+#line 1929 "y.tab.c"
     break;
 
-  case 77:
-#line 551 "parse.y" /* yacc.c:1646  */
-    {
+  case 79: /* op: T_LE  */
+#line 561 "parse.y"
+   {
       (yyval.cval) = LE_OP;
    }
-#line 1936 "y.tab.c" /* yacc.c:1646  */
+#line 1937 "y.tab.c"
     break;
 
-  case 78:
-#line 555 "parse.y" /* yacc.c:1646  */
-    {
+  case 80: /* op: T_GT  */
+#line 565 "parse.y"
+   {
       (yyval.cval) = GT_OP;
    }
-#line 1944 "y.tab.c" /* yacc.c:1646  */
+#line 1945 "y.tab.c"
     break;
 
-  case 79:
-#line 559 "parse.y" /* yacc.c:1646  */
-    {
+  case 81: /* op: T_GE  */
+#line 569 "parse.y"
+   {
       (yyval.cval) = GE_OP;
    }
-#line 1952 "y.tab.c" /* yacc.c:1646  */
+#line 1953 "y.tab.c"
     break;
 
-  case 80:
-#line 563 "parse.y" /* yacc.c:1646  */
-    {
+  case 82: /* op: T_EQ  */
+#line 573 "parse.y"
+   {
       (yyval.cval) = EQ_OP;
    }
-#line 1960 "y.tab.c" /* yacc.c:1646  */
+#line 1961 "y.tab.c"
     break;
 
-  case 81:
-#line 567 "parse.y" /* yacc.c:1646  */
-    {
+  case 83: /* op: T_NE  */
+#line 577 "parse.y"
+   {
       (yyval.cval) = NE_OP;
    }
-#line 1968 "y.tab.c" /* yacc.c:1646  */
+#line 1969 "y.tab.c"
     break;
 
 
-#line 1972 "y.tab.c" /* yacc.c:1646  */
+#line 1973 "y.tab.c"
+
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1982,25 +1984,23 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
   /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
@@ -2011,50 +2011,14 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2083,12 +2047,11 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
-
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2105,13 +2068,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2125,7 +2089,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2137,7 +2101,7 @@ yyerrlab1:
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2148,26 +2112,30 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2183,20 +2151,18 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
+
   return yyresult;
 }
-#line 576 "parse.y" /* yacc.c:1906  */
+
+#line 586 "parse.y"
 
 
 //
@@ -86,6 +86,7 @@ QL_Manager *pQlm;          // QL component manager
       RW_SET
       RW_HELP
       RW_PRINT
+      RW_COMPACT
       RW_EXIT
       RW_SELECT
       RW_FROM
@@ -137,6 +138,7 @@ QL_Manager *pQlm;          // QL component manager
       set
       help
       print
+      compact
       exit
       query
       insert
@@ -225,6 +227,7 @@ utility
    | set
    | help
    | print
+   | compact
    | buffer
    | statistics 
    | queryplans 
@@ -355,6 +358,13 @@ print
    }
    ;
 
+compact
+   : RW_COMPACT T_STRING
+   {
+      $$ = compact_node($2);
+   }
+   ;
+
 exit
    : RW_EXIT
    {
@@ -53,6 +53,7 @@ typedef enum{
     N_SET,
     N_HELP,
     N_PRINT,
+    N_COMPACT,
     N_QUERY,
     N_INSERT,
     N_DELETE,
@@ -125,6 +126,11 @@ typedef struct node{
          char *relname;
       } PRINT;
 
+      /* compact node */
+      struct{
+         char *relname;
+      } COMPACT;
+
       /* QL component nodes */
       /* query node */
       struct{
@@ -217,6 +223,7 @@ NODE *loadlib_node(char *libname);
 NODE *set_node(char *paramName, char *string);
 NODE *help_node(char *relname);
 NODE *print_node(char *relname);
+NODE *compact_node(char *relname);
 NODE *query_node(NODE *relattrlist, NODE *rellist, NODE *conditionlist);
 NODE *insert_node(char *relname, NODE *valuelist);
 NODE *delete_node(char *relname, NODE *conditionlist);
@@ -22,7 +22,7 @@ PF_Manager _pfm;
 PF::Manager pfm (_pfm);
 RM::Manager rmm (pfm);
 IX::Manager ixm (pfm);
-SM::Manager smm (ixm, rmm);
+SM::Manager smm (pfm, ixm, rmm);
 QL_Manager qlm (smm, ixm, rmm);
 
 int main(void)
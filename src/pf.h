@@ -33,6 +33,26 @@ typedef int PageNum;
 #define MEMORY_PAGE_SIZE 4096
 const int PF_PAGE_SIZE = MEMORY_PAGE_SIZE - sizeof(int);
 
+// A file may be created with larger pages: any power of two from
+// MEMORY_PAGE_SIZE to PF_MAX_PAGE_SIZE bytes, its PF_PageHdr included.
+// PF_PAGE_SIZE remains the data size of the default pages.  The file
+// header always takes MEMORY_PAGE_SIZE bytes.
+#define PF_MAX_PAGE_SIZE 65536
+
+// Size of the write-ahead log past which it is worth a checkpoint
+#define PF_LOG_CHECKPOINT_SIZE (4 << 20)
+
+//
+// PF_ReplacementPolicy: how the buffer manager chooses the page to
+// replace when the buffer is full
+//
+enum PF_ReplacementPolicy {
+   PF_LRU,                                      // least recently used
+   PF_CLOCK,                                    // second chance
+   PF_2Q,                                       // 2Q: FIFO + LRU queues
+   PF_LRUK                                      // LRU-K with K = 2
+};
+
 //
 // PF_PageHandle: PF page interface
 //
@@ -50,23 +70,65 @@ public:
    RC GetData     (char *&pData) const;           // Set pData to point to
                                                   // the page contents
    RC GetPageNum  (PageNum &pageNum) const;       // Return the page number
+   RC GetPageSize (int &pageSize) const;          // Return the # of bytes
+                                                  // of page data
 private:
    int  pageNum;                                  // page number
    char *pPageData;                               // pointer to page data
+   int  pageSize;                                 // # of bytes of page data
+};
+
+//
+// PF_OpenMode: how PF_Manager::OpenFile opens a file
+//
+enum PF_OpenMode {
+   PF_READWRITE,      // pages are read into the buffer pool
+   PF_MMAP_READONLY,  // pages are mapped from the file, read only
+   PF_DIRECT          // pages are read into the buffer pool with O_DIRECT,
+                      // bypassing the OS page cache
+};
+
+//
+// PF_Durability: what PF_Manager::Commit does with the forced pages
+//
+enum PF_Durability {
+   PF_DURABLE_NONE,       // nothing, they are only written to the OS
+   PF_DURABLE_STATEMENT,  // fdatasync the files they belong to
+   PF_DURABLE_GROUP       // the same, shared with the Commits that arrive
+                          // within a window
 };
 
 //
 // PF_FileHdr: Header structure for files
 //
 struct PF_FileHdr {
-   int firstFree;     // first free page in the linked list
+   int firstFree;     // first free page in the linked list of the files
+                      // made before bHasBitmap, PF_PAGE_LIST_END since
    int numPages;      // # of pages in the file
+   int pageSize;      // bytes per page, PF_PageHdr included.  0 in the
+                      // files made before page sizes could be chosen,
+                      // which have MEMORY_PAGE_SIZE byte pages
+   int bHasBitmap;    // TRUE if the header is followed by the allocation
+                      // bitmap, FALSE in older files
+   int bBitmapPages;  // TRUE if the allocation bits of the pages past the
+                      // header bitmap are kept in bitmap pages, FALSE in
+                      // older files
+   int numAllocated;  // # of pages the file has disk space for: the pages
+                      // from numPages on are preallocated and unused.  0
+                      // in older files.
+   int bCompressed;   // TRUE if the pages are stored compressed, FALSE in
+                      // older files
+   int mapSector;     // where the page map of a compressed file is
+   int mapPages;      // # of pages in the page map
 };
 
 //
 // PF_FileHandle: PF File interface
 //
 class PF_BufferMgr;
+class PF_AllocBitmap;
+class PF_WarmList;
+class PF_PageMap;
 
 class PF_FileHandle {
    friend class PF_Manager;
@@ -80,12 +142,16 @@ public:
    // Overload =
    PF_FileHandle& operator=(const PF_FileHandle &fileHandle);
 
-   // Get the first page
-   RC GetFirstPage(PF_PageHandle &pageHandle) const;
+   // Get the first page.  hint tells the buffer manager how the page is
+   // being accessed.
+   RC GetFirstPage(PF_PageHandle &pageHandle,
+                   ClientHint hint = NO_HINT) const;
    // Get the next page after current
-   RC GetNextPage (PageNum current, PF_PageHandle &pageHandle) const;
+   RC GetNextPage (PageNum current, PF_PageHandle &pageHandle,
+                   ClientHint hint = NO_HINT) const;
    // Get a specific page
-   RC GetThisPage (PageNum pageNum, PF_PageHandle &pageHandle) const;
+   RC GetThisPage (PageNum pageNum, PF_PageHandle &pageHandle,
+                   ClientHint hint = NO_HINT) const;
    // Get the last page
    RC GetLastPage(PF_PageHandle &pageHandle) const;
    // Get the prev page after current
@@ -96,23 +162,71 @@ public:
    RC MarkDirty   (PageNum pageNum) const;        // Mark page as dirty
    RC UnpinPage   (PageNum pageNum) const;        // Unpin the page
 
+   // Latch a pinned page shared (to read it) or exclusive (to change it)
+   // when the page is shared by several threads, and release the latch
+   RC LatchPage   (PageNum pageNum, int bExclusive = FALSE) const;
+   RC UnlatchPage (PageNum pageNum) const;
+
    // Flush pages from buffer pool.  Will write dirty pages to disk.
    RC FlushPages  () const;
 
    // Force a page or pages to disk (but do not remove from the buffer pool)
    RC ForcePages  (PageNum pageNum=ALL_PAGES) const;
 
+   // Give the free pages at the end of the file back to the file system
+   RC Shrink      ();
+
+   // Return the # of bytes of data in each page of the file
+   RC GetPageSize (int &pageSize) const;
+
 private:
 
    // IsValidPageNum will return TRUE if page number is valid and FALSE
    // otherwise
    int IsValidPageNum (PageNum pageNum) const;
 
+   // Address of a page in the mapping of a PF_MMAP_READONLY file
+   char *MappedPage (PageNum pageNum) const;
+
+   // Write the file header back to the file
+   RC WriteHdr () const;
+
+   // Build the allocation bitmap from the header page read from the file
+   RC ReadAllocBitmap (const char *hdrBuf);
+
+   // Read or write a page straight from or to the file, bypassing the
+   // buffer: the bitmap pages are never in it
+   RC ReadRawPage  (PageNum pageNum, char *pPageBuf) const;
+   RC WriteRawPage (PageNum pageNum, const char *pPageBuf) const;
+
+   // Write the bitmap pages whose bits changed
+   RC WriteBitmapPages () const;
+
+   // Preallocate the next extent of the file
+   RC Extend ();
+
+   // Copy bytes recovered from the write-ahead log into a page
+   RC RecoverPage (PageNum pageNum, int offset, const char *bytes,
+                   int numBytes);
+
    PF_BufferMgr *pBufferMgr;                      // pointer to buffer manager
    PF_FileHdr hdr;                                // file header
    int bFileOpen;                                 // file open flag
    int bHdrChanged;                               // dirty flag for file hdr
    int unixfd;                                    // OS file descriptor
+   char *pMap;                                    // the mapped file in
+                                                  // PF_MMAP_READONLY mode,
+                                                  // NULL otherwise
+   long mapSize;                                  // # of bytes mapped
+   short int *pinCounts;                          // pins of each mapped page
+   PF_AllocBitmap *pAllocBitmap;                  // pages in use, shared by
+                                                  // the copies of the handle
+   int extentPages;                               // # of pages the file
+                                                  // grows by, 0 for one at
+                                                  // a time
+   PF_PageMap *pPageMap;                          // where the pages of a
+                                                  // compressed file are,
+                                                  // NULL otherwise
 };
 
 //
@@ -120,13 +234,16 @@ private:
 //
 class PF_Manager {
 public:
-   PF_Manager    ();                              // Constructor
+   PF_Manager    (PF_ReplacementPolicy policy = PF_LRU); // Constructor
    ~PF_Manager   ();                              // Destructor
-   RC CreateFile    (const char *fileName);       // Create a new file
+   RC CreateFile    (const char *fileName,        // Create a new file
+                     int pageSize = MEMORY_PAGE_SIZE,
+                     int bCompressed = FALSE);
    RC DestroyFile   (const char *fileName);       // Delete a file
 
    // Open and close file methods
-   RC OpenFile      (const char *fileName, PF_FileHandle &fileHandle);
+   RC OpenFile      (const char *fileName, PF_FileHandle &fileHandle,
+                     PF_OpenMode mode = PF_READWRITE);
    RC CloseFile     (PF_FileHandle &fileHandle);
 
    // Three methods that manipulate the buffer manager.  The calls are
@@ -136,6 +253,50 @@ public:
    RC PrintBuffer   ();
    RC ResizeBuffer  (int iNewSize);
 
+   // Switch the buffer replacement policy.  Resident pages stay in the
+   // buffer but their replacement history is lost.
+   RC SetReplacementPolicy (PF_ReplacementPolicy policy);
+
+   // Read up to numPages pages ahead of sequential reads, 0 to disable
+   RC SetReadAhead (int numPages);
+
+   // Have a background thread keep numPages cold pages clean, and take a
+   // checkpoint every msecs milliseconds.  0 disables.
+   RC SetBackgroundWriter   (int numPages);
+   RC SetCheckpointInterval (int msecs);
+
+   // Open the files opened in PF_READWRITE mode from now on in PF_DIRECT
+   // mode instead, or stop doing so
+   RC SetDirectIO   (int bDirect);
+
+   // Grow the files opened from now on by numPages pages at once, 0 to
+   // grow them one page at a time
+   RC SetExtentPages (int numPages);
+
+   // Make the pages forced so far durable, at the end of a statement, as
+   // the durability mode says.  A group commit leader waits up to msecs
+   // for maxGroup Commits in all.
+   RC Commit        ();
+   RC SetDurability (PF_Durability mode);
+   RC SetGroupCommitWindow (int msecs);
+   RC SetGroupCommitSize   (int maxGroup);
+
+   // Log the changes to the files opened for writing from now on in a
+   // write-ahead log, so that Commit only has to sync the log.  OpenLog
+   // first recovers the files from what an earlier run left in the log.
+   // CheckpointLog writes every logged page back and starts the log over,
+   // which is worth doing once it is PF_LOG_CHECKPOINT_SIZE bytes long.
+   RC OpenLog       (const char *logName);
+   RC CloseLog      ();
+   RC CheckpointLog ();
+   RC GetLogSize    (long &size);
+
+   // Write the pages last resident in the buffer to a manifest, and load
+   // a manifest so that the pages it lists are read into the buffer in
+   // the background when their files are opened
+   RC SaveWarmPages (const char *manifestName);
+   RC LoadWarmPages (const char *manifestName);
+
    // Three Methods for manipulating raw memory buffers.  These memory
    // locations are handled by the buffer manager, but are not
    // associated with a particular file.  These should be used if you
@@ -156,7 +317,16 @@ public:
    RC DisposeBlock  (char *buffer);
 
 private:
+   // Bring the files back to the last commit of a write-ahead log
+   RC Recover       (const char *logName);
+
    PF_BufferMgr *pBufferMgr;                      // page-buffer manager
+   int bDirectIO;                                 // PF_READWRITE means
+                                                  // PF_DIRECT
+   int extentPages;                               // # of pages files grow
+                                                  // by
+   PF_WarmList *pWarmList;                        // resident pages of the
+                                                  // closed files
 };
 
 //
@@ -173,7 +343,9 @@ void PF_PrintError(RC rc);
 #define PF_PAGEUNPINNED    (START_PF_WARN + 6) // page already unpinned
 #define PF_EOF             (START_PF_WARN + 7) // end of file
 #define PF_TOOSMALL        (START_PF_WARN + 8) // Resize buffer too small
-#define PF_LASTWARN        PF_TOOSMALL
+#define PF_READONLY        (START_PF_WARN + 9) // file is opened read only
+#define PF_BADPAGESIZE     (START_PF_WARN + 10) // invalid page size
+#define PF_LASTWARN        PF_BADPAGESIZE
 
 #define PF_NOMEM           (START_PF_ERR - 0)  // no memory
 #define PF_NOBUF           (START_PF_ERR - 1)  // no buffer space
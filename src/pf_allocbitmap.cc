@@ -0,0 +1,257 @@
+//
+// File:        pf_allocbitmap.cc
+// Description: PF_AllocBitmap class implementation
+//
+
+#include "pf_allocbitmap.h"
+
+//
+// Resize
+//
+// Desc: Track numPages pages.  Pages that are no longer tracked are
+//       forgotten, the new ones are free.
+// In:   numPages - new number of pages
+//
+void PF_AllocBitmap::Resize(int _numPages)
+{
+   // The run that gets the new end must be stored again
+   MarkStale((numPages < _numPages ? numPages : _numPages) - 1);
+
+   numPages = _numPages;
+   words.resize((numPages + 63) / 64, 0);
+
+   // Keep the bits past numPages clear
+   if (numPages % 64)
+      words.back() &= (1ULL << (numPages % 64)) - 1;
+
+   // Bitmap pages of new runs were never written
+   stale.resize(NumBitmapPages(), TRUE);
+}
+
+//
+// Reserve
+//
+// Desc: Set where the bitmap pages are.  They are all stale until they are
+//       loaded.
+// In:   first - first bitmap page
+//       stride - # of pages per bitmap page, 0 if there are none
+//
+void PF_AllocBitmap::Reserve(PageNum _first, int _stride)
+{
+   first = _first;
+   stride = _stride;
+   stale.assign(NumBitmapPages(), TRUE);
+}
+
+//
+// IsReserved
+//
+// Desc: Tell whether a page is a bitmap page
+// In:   pageNum - a page number
+// Ret:  TRUE or FALSE
+//
+int PF_AllocBitmap::IsReserved(PageNum pageNum) const
+{
+   return (stride > 0 && pageNum >= first && (pageNum - first) % stride == 0);
+}
+
+//
+// NumBitmapPages
+//
+// Desc: Count the bitmap pages of the pages tracked
+// Ret:  # of bitmap pages
+//
+int PF_AllocBitmap::NumBitmapPages() const
+{
+   if (stride == 0 || numPages <= first)
+      return (0);
+   return ((numPages - first + stride - 1) / stride);
+}
+
+//
+// MarkStale
+//
+// Desc: Internal.  Note that the run holding a page changed
+// In:   pageNum - a page number, nothing happens if it is not in a run
+//
+void PF_AllocBitmap::MarkStale(PageNum pageNum)
+{
+   if (stride > 0 && pageNum >= first &&
+         (pageNum - first) / stride < (int)stale.size())
+      stale[(pageNum - first) / stride] = TRUE;
+}
+
+//
+// IsUsed
+//
+// Desc: Tell whether a page is in use
+// In:   pageNum - a page number below the number of pages tracked
+// Ret:  TRUE or FALSE
+//
+int PF_AllocBitmap::IsUsed(PageNum pageNum) const
+{
+   return ((words[pageNum / 64] >> (pageNum % 64)) & 1);
+}
+
+//
+// SetUsed
+//
+// Desc: Mark a page in use
+// In:   pageNum - a page number below the number of pages tracked
+//
+void PF_AllocBitmap::SetUsed(PageNum pageNum)
+{
+   words[pageNum / 64] |= 1ULL << (pageNum % 64);
+   MarkStale(pageNum);
+}
+
+//
+// SetFree
+//
+// Desc: Mark a page free
+// In:   pageNum - a page number below the number of pages tracked
+//
+void PF_AllocBitmap::SetFree(PageNum pageNum)
+{
+   words[pageNum / 64] &= ~(1ULL << (pageNum % 64));
+   MarkStale(pageNum);
+}
+
+//
+// NextUsed
+//
+// Desc: Find the first page in use after pageNum.  Whole words of free
+//       pages are skipped at once.
+// In:   pageNum - page to start after, may be -1
+// Ret:  number of the page, -1 if there is none
+//
+PageNum PF_AllocBitmap::NextUsed(PageNum pageNum) const
+{
+   PageNum next = pageNum + 1;
+   if (next >= numPages)
+      return (-1);
+
+   size_t i = next / 64;
+   unsigned long long word = words[i] & (~0ULL << (next % 64));
+   while (!word) {
+      if (++i == words.size())
+         return (-1);
+      word = words[i];
+   }
+   return (i * 64 + __builtin_ctzll(word));
+}
+
+//
+// PrevUsed
+//
+// Desc: Find the last page in use before pageNum
+// In:   pageNum - page to start before, may be the number of pages
+// Ret:  number of the page, -1 if there is none
+//
+PageNum PF_AllocBitmap::PrevUsed(PageNum pageNum) const
+{
+   PageNum prev = (pageNum > numPages ? numPages : pageNum) - 1;
+   if (prev < 0)
+      return (-1);
+
+   long i = prev / 64;
+   unsigned long long word = words[i] & (~0ULL >> (63 - prev % 64));
+   while (!word) {
+      if (--i < 0)
+         return (-1);
+      word = words[i];
+   }
+   return (i * 64 + 63 - __builtin_clzll(word));
+}
+
+//
+// FirstFree
+//
+// Desc: Find the free page with the lowest number.  Bitmap pages are
+//       skipped.
+// Ret:  number of the page, -1 if every page is in use
+//
+PageNum PF_AllocBitmap::FirstFree() const
+{
+   for (size_t i = 0; i < words.size(); i++)
+      for (unsigned long long free = ~words[i]; free; free &= free - 1) {
+         PageNum pageNum = i * 64 + __builtin_ctzll(free);
+         if (pageNum >= numPages)
+            return (-1);
+         if (!IsReserved(pageNum))
+            return (pageNum);
+      }
+   return (-1);
+}
+
+//
+// Load
+//
+// Desc: Set the state of the first n pages from the header bytes
+// In:   bytes - the bitmap in the file header
+//       n - number of pages, at most the number of pages tracked
+//
+void PF_AllocBitmap::Load(const char *bytes, int n)
+{
+   for (PageNum pageNum = 0; pageNum < n; pageNum++)
+      if ((bytes[pageNum / 8] >> (pageNum % 8)) & 1)
+         SetUsed(pageNum);
+      else
+         SetFree(pageNum);
+}
+
+//
+// Store
+//
+// Desc: Write the state of the first n pages to the header bytes.  The
+//       bits past them are cleared.
+// In:   n - number of pages, at most the number of pages tracked
+// Out:  bytes - the bitmap in the file header
+//
+void PF_AllocBitmap::Store(char *bytes, int n) const
+{
+   memset(bytes, 0, (n + 7) / 8);
+   for (PageNum pageNum = 0; pageNum < n; pageNum++)
+      if (IsUsed(pageNum))
+         bytes[pageNum / 8] |= 1 << (pageNum % 8);
+}
+
+//
+// LoadRun
+//
+// Desc: Set the state of the pages of a run from its bitmap page.  The
+//       run is no longer stale.
+// In:   i - bitmap page number, below NumBitmapPages
+//       bytes - the data of the bitmap page
+//
+void PF_AllocBitmap::LoadRun(int i, const char *bytes)
+{
+   PageNum start = BitmapPage(i);
+   PageNum end = start + stride < numPages ? start + stride : numPages;
+   for (PageNum pageNum = start; pageNum < end; pageNum++)
+      if ((bytes[(pageNum - start) / 8] >> ((pageNum - start) % 8)) & 1)
+         SetUsed(pageNum);
+      else
+         SetFree(pageNum);
+   stale[i] = FALSE;
+}
+
+//
+// StoreRun
+//
+// Desc: Write the state of the pages of a run to its bitmap page.  The
+//       bits past the last page are cleared, and the run is no longer
+//       stale.
+// In:   i - bitmap page number, below NumBitmapPages
+// Out:  bytes - stride / 8 bytes of the bitmap page
+//
+void PF_AllocBitmap::StoreRun(int i, char *bytes)
+{
+   PageNum start = BitmapPage(i);
+   PageNum end = start + stride < numPages ? start + stride : numPages;
+   memset(bytes, 0, stride / 8);
+   for (PageNum pageNum = start; pageNum < end; pageNum++)
+      if (IsUsed(pageNum))
+         bytes[(pageNum - start) / 8] |= 1 << ((pageNum - start) % 8);
+   stale[i] = FALSE;
+}
@@ -0,0 +1,80 @@
+//
+// File:        pf_allocbitmap.h
+// Description: PF_AllocBitmap interface, the page allocation bitmap of a
+//              PF file
+//
+// Bit p is set when page p of the file is in use.  The bitmap of the
+// first PF_HDR_BITMAP_PAGES pages is stored in the file header page,
+// right after the PF_FileHdr.  Past them, the first page of every run of
+// PF_BitmapPageBits pages is a bitmap page that holds the bits of its
+// run; bitmap pages are never in use and never handed out.  Scans and
+// page allocation look at the bitmap instead of reading pages to find out
+// whether they are free.
+//
+// Files made before the bitmap pages only record the state of the pages
+// past the header bitmap in their page headers, and it is collected when
+// the file is opened.
+//
+
+#ifndef PF_ALLOCBITMAP_H
+#define PF_ALLOCBITMAP_H
+
+#include <vector>
+#include "pf_internal.h"
+
+//
+// PF_AllocBitmap - one bit per page of a file
+//
+class PF_AllocBitmap {
+public:
+    PF_AllocBitmap () : numPages(0), first(0), stride(0) {}
+
+    // Track numPages pages.  The new pages are free.
+    void Resize   (int numPages);
+
+    // Keep the first page of every run of stride pages from page first
+    // for the bitmap pages
+    void Reserve  (PageNum first, int stride);
+    int  IsReserved (PageNum pageNum) const;  // TRUE for a bitmap page
+
+    int  IsUsed   (PageNum pageNum) const;    // TRUE if the page is in use
+    void SetUsed  (PageNum pageNum);
+    void SetFree  (PageNum pageNum);
+
+    // First page in use after pageNum, last one before pageNum, and first
+    // free page, or -1 if there is none
+    PageNum NextUsed  (PageNum pageNum) const;
+    PageNum PrevUsed  (PageNum pageNum) const;
+    PageNum FirstFree () const;
+
+    // Copy the bits of the first n pages from or to the bytes of the
+    // header, page p in bit p % 8 of byte p / 8
+    void Load     (const char *bytes, int n);
+    void Store    (char *bytes, int n) const;
+
+    // # of bitmap pages, and the page number of bitmap page i
+    int  NumBitmapPages () const;
+    PageNum BitmapPage (int i) const { return (first + i * stride); }
+
+    // TRUE if the bits of the run of bitmap page i changed since they
+    // were last loaded or stored
+    int  IsStale  (int i) const { return (stale[i]); }
+
+    // Copy the bits of the run of bitmap page i from or to the bytes of
+    // the page, page p in bit (p - BitmapPage(i)) % 8 of byte
+    // (p - BitmapPage(i)) / 8
+    void LoadRun  (int i, const char *bytes);
+    void StoreRun (int i, char *bytes);
+
+private:
+    void MarkStale (PageNum pageNum);
+
+    std::vector<unsigned long long> words;   // 64 pages per word
+    int numPages;                            // # of pages tracked
+    PageNum first;                           // first bitmap page
+    int stride;                              // # of pages per bitmap
+                                             // page, 0 for none
+    std::vector<char> stale;                 // per bitmap page
+};
+
+#endif
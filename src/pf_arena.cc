@@ -0,0 +1,74 @@
+//
+// File:        pf_arena.cc
+// Description: PF_FrameArena class implementation
+//
+
+#include <sys/mman.h>
+#include <new>
+#include "pf_arena.h"
+
+//
+// PF_FrameArena
+//
+// Desc: Constructor.  Map the frames.  An arena of at least one huge page
+//       is rounded up to whole huge pages and taken from the reserved
+//       huge pages if possible, from base pages marked for transparent
+//       huge pages otherwise.  Nothing is touched here.
+// In:   numFrames - number of frames
+//       frameSize - bytes per frame, a multiple of the memory page size
+//
+PF_FrameArena::PF_FrameArena(int _numFrames, int _frameSize)
+{
+   numFrames = _numFrames;
+   frameSize = _frameSize;
+   length = (size_t)numFrames * frameSize;
+   backing = PF_SMALL_PAGES;
+
+   void *p = MAP_FAILED;
+   if (length >= PF_HUGE_PAGE_SIZE) {
+      length = (length + PF_HUGE_PAGE_SIZE - 1) &
+         ~(size_t)(PF_HUGE_PAGE_SIZE - 1);
+#ifdef MAP_HUGETLB
+      p = mmap(NULL, length, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (p != MAP_FAILED)
+         backing = PF_HUGETLB_PAGES;
+#endif
+   }
+
+   if (p == MAP_FAILED) {
+      p = mmap(NULL, length, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (p == MAP_FAILED)
+         throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+      if (length >= PF_HUGE_PAGE_SIZE && !madvise(p, length, MADV_HUGEPAGE))
+         backing = PF_TRANSPARENT_HUGE_PAGES;
+#endif
+   }
+
+   base = (char *)p;
+}
+
+//
+// ~PF_FrameArena
+//
+// Desc: Destructor.  Unmap the frames.
+//
+PF_FrameArena::~PF_FrameArena()
+{
+   munmap(base, length);
+}
+
+//
+// Contains
+//
+// Desc: Tell whether p is the start of a frame of the arena
+// In:   p - pointer to test, may be NULL
+// Ret:  TRUE or FALSE
+//
+int PF_FrameArena::Contains(const char *p) const
+{
+   return (p >= base && p < base + (long)numFrames * frameSize &&
+         (p - base) % frameSize == 0);
+}
@@ -0,0 +1,52 @@
+//
+// File:        pf_arena.h
+// Description: PF_FrameArena interface, the memory that holds the page
+//              frames of PF_BufferMgr
+//
+// The frames are carved out of one page-aligned anonymous mapping, apart
+// from the buffer table, so that walking the descriptors does not drag
+// page contents through the cache.  A large arena is backed by huge pages
+// when the system has some reserved (MAP_HUGETLB), or else is marked for
+// transparent huge pages, which cuts TLB misses over the whole pool.  The
+// kernel only supplies a frame's memory when it is first written, so a
+// big buffer costs nothing until it fills up.
+//
+
+#ifndef PF_ARENA_H
+#define PF_ARENA_H
+
+#include <cstddef>
+#include "pf_internal.h"
+
+// How the memory of a PF_FrameArena is backed
+enum PF_ArenaBacking {
+   PF_SMALL_PAGES,            // base pages only
+   PF_TRANSPARENT_HUGE_PAGES, // the kernel may use huge pages
+   PF_HUGETLB_PAGES           // reserved huge pages
+};
+
+//
+// PF_FrameArena - numFrames page frames of frameSize bytes
+//
+class PF_FrameArena {
+public:
+    PF_FrameArena  (int numFrames, int frameSize);  // Throws bad_alloc
+    ~PF_FrameArena ();
+
+    // Frame i, aligned on a memory page
+    char *Frame    (int i) const { return base + (long)i * frameSize; }
+
+    // TRUE if p is a frame of the arena
+    int  Contains  (const char *p) const;
+
+    PF_ArenaBacking Backing () const { return backing; }
+
+private:
+    char            *base;      // Start of the mapping
+    size_t          length;     // # of bytes mapped
+    int             numFrames;
+    int             frameSize;
+    PF_ArenaBacking backing;
+};
+
+#endif
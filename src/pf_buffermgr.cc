@@ -16,8 +16,14 @@
 //
 
 #include <cstdio>
+#include <cerrno>
 #include <unistd.h>
+#include <fcntl.h>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include "pf_buffermgr.h"
 
 using namespace std;
@@ -76,6 +82,9 @@ void WriteLog(const char *psMessage)
 #endif
 
 
+// Memory blocks are pages of this pseudo file descriptor
+#define MEMORY_FD -1
+
 //
 // PF_BufferMgr
 //
@@ -84,8 +93,12 @@ void WriteLog(const char *psMessage)
 //       it checks if it is in the buffer.  If so, it pins the page (pages
 //       can be pinned multiple times).  If not, it reads it from the file
 //       and pins it.  If the buffer is full and a new page needs to be
-//       inserted, an unpinned page is replaced according to an LRU
+//       inserted, an unpinned page is replaced according to the
+//       replacement policy (LRU unless asked otherwise).  The buffer is
+//       partitioned into shards of at least PF_SHARD_MIN_PAGES pages, see
+//       pf_buffermgr.h, so a small buffer has a single shard.
 // In:   numPages - the number of pages in the buffer
+//       policy - the replacement policy
 //
 // Note: The constructor will initialize the global pStatisticsMgr.  We
 //       make it global so that other components may use it and to allow
@@ -94,11 +107,11 @@ void WriteLog(const char *psMessage)
 // Aut2003
 // numPages changed to _numPages for to eliminate CC warnings
 
-PF_BufferMgr::PF_BufferMgr(int _numPages) : hashTable(PF_HASH_TBL_SIZE)
+PF_BufferMgr::PF_BufferMgr(int _numPages, PF_ReplacementPolicy _policy)
 {
    // Initialize local variables
    this->numPages = _numPages;
-   pageSize = PF_PAGE_SIZE + sizeof(PF_PageHdr);
+   this->policy = _policy;
 
 #ifdef PF_STATS
    // Initialize the global variable for the statistics manager
@@ -107,23 +120,27 @@ PF_BufferMgr::PF_BufferMgr(int _numPages) : hashTable(PF_HASH_TBL_SIZE)
 
 #ifdef PF_LOG
    char psMessage[100];
-   sprintf (psMessage, "Creating buffer manager. %d pages of size %d.\n",
-         numPages, PF_PAGE_SIZE+sizeof(PF_PageHdr));
+   sprintf (psMessage, "Creating buffer manager. %d pages.\n", numPages);
    WriteLog(psMessage);
 #endif
 
-   // Allocate memory for buffer page description table
-   bufTable = new PF_BufPageDesc[numPages]();
+   // Allocate the buffer page description table and the shards.  The
+   // memory of the pages is allocated when a slot is first used.
+   MakeShards();
 
-   // Initialize the buffer table and allocate memory for buffer pages.
-   // Initially, the free list contains all pages
-   for (int i = 0; i < numPages; i++) {
-      bufTable[i].prev = i - 1;
-      bufTable[i].next = i + 1;
-   }
-   bufTable[0].prev = bufTable[numPages - 1].next = INVALID_SLOT;
-   free = 0;
-   first = last = INVALID_SLOT;
+   // Read-ahead is off until SetReadAhead is called
+   pReadAhead = new PF_ReadAhead([this](int slot, int numBytes) {
+      FinishRead(slot, numBytes);
+   });
+   readAheadWindow = 0;
+
+   pGroupCommit = new PF_GroupCommit();
+   pLog = new PF_Log();
+
+   // So is the background writer
+   bStopWriter = FALSE;
+   cleanTarget = 0;
+   checkpointInterval = 0;
 
 #ifdef PF_LOG
    WriteLog("Succesfully created the buffer manager.\n");
@@ -137,7 +154,13 @@ PF_BufferMgr::PF_BufferMgr(int _numPages) : hashTable(PF_HASH_TBL_SIZE)
 //
 PF_BufferMgr::~PF_BufferMgr()
 {
-   delete [] bufTable;
+   // Let the background writes and the pending reads finish before their
+   // frames go away
+   StopWriter();
+   delete pReadAhead;
+   delete pGroupCommit;
+   delete pLog;
+   FreeShards();
 
 #ifdef PF_STATS
    // Destroy the global statistics manager
@@ -156,16 +179,23 @@ PF_BufferMgr::~PF_BufferMgr()
 //       already in the buffer, (re)pin the page and return a pointer
 //       to it.  If the page is not in the buffer, read it from the file,
 //       pin it, and return a pointer to it.  If the buffer is full,
-//       replace an unpinned page.
+//       replace an unpinned page.  If the file is being read
+//       sequentially, the following pages are read ahead.
 // In:   fd - OS file descriptor of the file to read
 //       pageNum - number of the page to read
+//       pageSize - page size of the file
 //       bMultiplePins - if FALSE, it is an error to ask for a page that is
 //                       already pinned in the buffer.
+//       hint - SEQUENTIAL_SCAN reads a missing page into the scan ring,
+//              RANDOM_LOOKUP does not read ahead
+//       numFilePages - # of pages in the file, none past them is read
+//                      ahead
 // Out:  ppBuffer - set *ppBuffer to point to the page in the buffer
 // Ret:  PF return code
 //
-RC PF_BufferMgr::GetPage(int fd, PageNum pageNum, char **ppBuffer,
-      int bMultiplePins)
+RC PF_BufferMgr::GetPage(int fd, PageNum pageNum, int pageSize,
+      char **ppBuffer, int bMultiplePins, ClientHint hint,
+      int numFilePages)
 {
    RC  rc;     // return code
    int slot;   // buffer slot where page is located
@@ -179,36 +209,83 @@ RC PF_BufferMgr::GetPage(int fd, PageNum pageNum, char **ppBuffer,
 
 #ifdef PF_STATS
    pStatisticsMgr->Register(PF_GETPAGE, STAT_ADDONE);
+   StatTimer timer(pStatisticsMgr, PF_GETPAGE_LATENCY);
 #endif
 
-   // Search for page in buffer
-   if ((rc = hashTable.Find(fd, pageNum, slot)) &&
-         (rc != PF_HASHNOTFOUND))
+   PF_BufShard &shard = ShardOf(fd, pageNum);
+   unique_lock<mutex> lock(shard.latch);
+
+   // Search for page in buffer.  If the page is still being read ahead,
+   // or is in I/O for another request, wait for it.  The slot is freed if
+   // the read failed, and the page is then read below.  Getting a slot
+   // for a missing page may release the latch, so the page is looked for
+   // again once there is one.
+   int newSlot = INVALID_SLOT;
+   for (;;) {
+      while (!(rc = shard.pHashTable->Find(fd, pageNum, slot)) &&
+            (bufTable[slot].readAhead == RA_PENDING || bufTable[slot].bInIO))
+         shard.readDone.wait(lock);
+      if (rc != PF_HASHNOTFOUND || newSlot != INVALID_SLOT)
+         break;
+
+      // Allocate an empty page
+      if ((rc = InternalAlloc(shard, lock, newSlot, pageSize,
+            hint == SEQUENTIAL_SCAN)))
+         return (rc);
+   }
+
+   // The page came in while a slot was found for it
+   if (rc != PF_HASHNOTFOUND && newSlot != INVALID_SLOT) {
+      Unlink(shard, newSlot);
+      InsertFree(shard, newSlot);
+   }
+   if (rc && (rc != PF_HASHNOTFOUND))
       return (rc);                // unexpected error
 
+   int bMiss = (rc == PF_HASHNOTFOUND);
+
    // If page not in buffer...
-   if (rc == PF_HASHNOTFOUND) {
+   if (bMiss) {
 
 #ifdef PF_STATS
    pStatisticsMgr->Register(PF_PAGENOTFOUND, STAT_ADDONE);
 #endif
 
-      // Allocate an empty page, this will also promote the newly allocated
-      // page to the MRU slot
-      if ((rc = InternalAlloc(slot)))
+      // Insert the page into the hash table and read it, in I/O and
+      // without the latch, then initialize the page description entry
+      slot = newSlot;
+      bufTable[slot].fd        = fd;
+      bufTable[slot].pageNum   = pageNum;
+      bufTable[slot].bDirty    = FALSE;
+      bufTable[slot].bHole     = FALSE;
+      bufTable[slot].pinCount  = 0;
+      bufTable[slot].readAhead = RA_NONE;
+      if ((rc = shard.pHashTable->Insert(fd, pageNum, slot))) {
+         Unlink(shard, slot);
+         InsertFree(shard, slot);
          return (rc);
+      }
 
-      // read the page, insert it into the hash table,
-      // and initialize the page description entry
-      if ((rc = ReadPage(fd, pageNum, bufTable[slot].pData)) ||
-            (rc = hashTable.Insert(fd, pageNum, slot)) ||
-            (rc = InitPageDesc(fd, pageNum, slot))) {
+      StartIO(shard, slot);
+      lock.unlock();
+      rc = ReadPage(fd, pageNum, pageSize, bufTable[slot].pData);
+      lock.lock();
+      EndIO(shard, slot);
+
+      if (rc ||
+            (rc = TakeShadow(fd, slot, FALSE)) ||
+            (rc = InitPageDesc(shard, fd, pageNum, slot))) {
 
          // Put the slot back on the free list before returning the error
-         Unlink(slot);
-         InsertFree(slot);
+         shard.pHashTable->Delete(fd, pageNum);
+         Unlink(shard, slot);
+         InsertFree(shard, slot);
          return (rc);
       }
+
+      // A page read for a scan is recycled by the next ones
+      if (hint == SEQUENTIAL_SCAN)
+         JoinRing(shard, slot);
 #ifdef PF_LOG
    WriteLog("Page not found in buffer. Loaded.\n");
 #endif
@@ -223,22 +300,37 @@ RC PF_BufferMgr::GetPage(int fd, PageNum pageNum, char **ppBuffer,
       if (!bMultiplePins && bufTable[slot].pinCount > 0)
          return (PF_PAGEPINNED);
 
+      // First request for a page that was read ahead
+      if (bufTable[slot].readAhead == RA_UNUSED) {
+         bufTable[slot].readAhead = RA_NONE;
+#ifdef PF_STATS
+         pStatisticsMgr->Register(PF_READAHEADHIT, STAT_ADDONE);
+#endif
+      }
+
+      // A scan page that is wanted for something else stays around
+      if (hint != SEQUENTIAL_SCAN)
+         bufTable[slot].bInRing = FALSE;
+
       // Page is alredy in memory, just increment pin count
       bufTable[slot].pinCount++;
 #ifdef PF_LOG
       sprintf (psMessage, "Page found in buffer.  %d pin count.\n",
-            bufTable[slot].pinCount);
+            (int)bufTable[slot].pinCount);
       WriteLog(psMessage);
 #endif
 
-      // Make this page the most recently used page
-      if ((rc = Unlink(slot)) ||
-            (rc = LinkHead (slot)))
-         return (rc);
+      // Tell the replacement policy about the hit
+      shard.pReplacer->Access(slot - shard.base);
    }
 
    // Point ppBuffer to page
    *ppBuffer = bufTable[slot].pData;
+   lock.unlock();
+
+   // Read the next pages if the file is read sequentially
+   if (hint != RANDOM_LOOKUP)
+      Prefetch(fd, pageNum, pageSize, numFilePages, bMiss);
 
    // Return ok
    return (0);
@@ -250,10 +342,12 @@ RC PF_BufferMgr::GetPage(int fd, PageNum pageNum, char **ppBuffer,
 // Desc: Allocate a new page in the buffer and return a pointer to it.
 // In:   fd - OS file descriptor of the file associated with the new page
 //       pageNum - number of the new page
+//       pageSize - page size of the file
 // Out:  ppBuffer - set *ppBuffer to point to the page in the buffer
 // Ret:  PF return code
 //
-RC PF_BufferMgr::AllocatePage(int fd, PageNum pageNum, char **ppBuffer)
+RC PF_BufferMgr::AllocatePage(int fd, PageNum pageNum, int pageSize,
+      char **ppBuffer)
 {
    RC  rc;     // return code
    int slot;   // buffer slot where page is located
@@ -264,24 +358,50 @@ RC PF_BufferMgr::AllocatePage(int fd, PageNum pageNum, char **ppBuffer)
    WriteLog(psMessage);
 #endif
 
-   // If page is already in buffer, return an error
-   if (!(rc = hashTable.Find(fd, pageNum, slot)))
-      return (PF_PAGEINBUF);
-   else if (rc != PF_HASHNOTFOUND)
-      return (rc);              // unexpected error
+   PF_BufShard &shard = ShardOf(fd, pageNum);
+   unique_lock<mutex> lock(shard.latch);
+
+   // If page is already in buffer, return an error.  A page that was
+   // read ahead but never requested is simply thrown away, once its read
+   // is over.  Getting a slot may release the latch, so the page is
+   // looked for again once there is one.
+   int newSlot = INVALID_SLOT;
+   for (;;) {
+      while (!(rc = shard.pHashTable->Find(fd, pageNum, slot)) &&
+            (bufTable[slot].bInIO || bufTable[slot].readAhead != RA_NONE)) {
+         if (bufTable[slot].bInIO ||
+               bufTable[slot].readAhead == RA_PENDING)
+            shard.readDone.wait(lock);
+         else if ((rc = DropReadAhead(shard, slot)))
+            break;
+      }
+      if (!rc)
+         rc = PF_PAGEINBUF;
+      if (rc != PF_HASHNOTFOUND || newSlot != INVALID_SLOT)
+         break;
 
-   // Allocate an empty page
-   if ((rc = InternalAlloc(slot)))
+      // Allocate an empty page
+      if ((rc = InternalAlloc(shard, lock, newSlot, pageSize)))
+         return (rc);
+   }
+   if (rc != PF_HASHNOTFOUND) {
+      if (newSlot != INVALID_SLOT) {
+         Unlink(shard, newSlot);
+         InsertFree(shard, newSlot);
+      }
       return (rc);
+   }
+   slot = newSlot;
 
    // Insert the page into the hash table,
    // and initialize the page description entry
-   if ((rc = hashTable.Insert(fd, pageNum, slot)) ||
-         (rc = InitPageDesc(fd, pageNum, slot))) {
+   if ((rc = TakeShadow(fd, slot, TRUE)) ||
+         (rc = shard.pHashTable->Insert(fd, pageNum, slot)) ||
+         (rc = InitPageDesc(shard, fd, pageNum, slot))) {
 
       // Put the slot back on the free list before returning the error
-      Unlink(slot);
-      InsertFree(slot);
+      Unlink(shard, slot);
+      InsertFree(shard, slot);
       return (rc);
    }
 
@@ -316,8 +436,11 @@ RC PF_BufferMgr::MarkDirty(int fd, PageNum pageNum)
    WriteLog(psMessage);
 #endif
 
+   PF_BufShard &shard = ShardOf(fd, pageNum);
+   lock_guard<mutex> lock(shard.latch);
+
    // The page must be found and pinned in the buffer
-   if ((rc = hashTable.Find(fd, pageNum, slot))){
+   if ((rc = shard.pHashTable->Find(fd, pageNum, slot))){
       if ((rc == PF_HASHNOTFOUND))
          return (PF_PAGENOTINBUF);
       else
@@ -327,13 +450,47 @@ RC PF_BufferMgr::MarkDirty(int fd, PageNum pageNum)
    if (bufTable[slot].pinCount == 0)
       return (PF_PAGEUNPINNED);
 
-   // Mark this page dirty
+   // Mark this page dirty.  A disposed page being reused is written again.
    bufTable[slot].bDirty = TRUE;
+   bufTable[slot].bHole = FALSE;
 
-   // Make this page the most recently used page
-   if ((rc = Unlink(slot)) ||
-         (rc = LinkHead (slot)))
-      return (rc);
+   // Return ok
+   return (0);
+}
+
+//
+// DisposePage
+//
+// Desc: Zero a page that is being disposed of, and mark it dirty so that
+//       it is punched out of the file, rather than written, when it is
+//       written back.  A free page then reads as zeros.  MarkDirty, when
+//       the page is reused, has it written again.
+// In:   fd - OS file descriptor of the file associated with the page
+//       pageNum - number of the page, which must be pinned
+// Ret:  PF return code
+//
+RC PF_BufferMgr::DisposePage(int fd, PageNum pageNum)
+{
+   RC  rc;       // return code
+   int slot;     // buffer slot where page is located
+
+   PF_BufShard &shard = ShardOf(fd, pageNum);
+   lock_guard<mutex> lock(shard.latch);
+
+   // The page must be found and pinned in the buffer
+   if ((rc = shard.pHashTable->Find(fd, pageNum, slot))){
+      if ((rc == PF_HASHNOTFOUND))
+         return (PF_PAGENOTINBUF);
+      else
+         return (rc);              // unexpected error
+   }
+
+   if (bufTable[slot].pinCount == 0)
+      return (PF_PAGEUNPINNED);
+
+   memset(bufTable[slot].pData, 0, bufTable[slot].size);
+   bufTable[slot].bDirty = TRUE;
+   bufTable[slot].bHole = TRUE;
 
    // Return ok
    return (0);
@@ -352,8 +509,11 @@ RC PF_BufferMgr::UnpinPage(int fd, PageNum pageNum)
    RC  rc;       // return code
    int slot;     // buffer slot where page is located
 
+   PF_BufShard &shard = ShardOf(fd, pageNum);
+   lock_guard<mutex> lock(shard.latch);
+
    // The page must be found and pinned in the buffer
-   if ((rc = hashTable.Find(fd, pageNum, slot))){
+   if ((rc = shard.pHashTable->Find(fd, pageNum, slot))){
       if ((rc == PF_HASHNOTFOUND))
          return (PF_PAGENOTINBUF);
       else
@@ -370,12 +530,9 @@ RC PF_BufferMgr::UnpinPage(int fd, PageNum pageNum)
    WriteLog(psMessage);
 #endif
 
-   // If unpinning the last pin, make it the most recently used page
-   if (--(bufTable[slot].pinCount) == 0) {
-      if ((rc = Unlink(slot)) ||
-            (rc = LinkHead (slot)))
-         return (rc);
-   }
+   // If unpinning the last pin, the page becomes a replacement candidate
+   if (--(bufTable[slot].pinCount) == 0)
+      shard.pReplacer->Unpin(slot - shard.base);
 
    // Return ok
    return (0);
@@ -405,45 +562,61 @@ RC PF_BufferMgr::FlushPages(int fd)
    pStatisticsMgr->Register(PF_FLUSHPAGES, STAT_ADDONE);
 #endif
 
+   // No read may still be filling a slot that is released below, and the
+   // descriptor may be reused by another file
+   pReadAhead->Drain();
+   {
+      lock_guard<mutex> streamsLock(streamsMutex);
+      streams.erase(fd);
+   }
+
+   LockAll();
+
+   // Write the dirty unpinned pages of the file back in page order
+   rc = WriteBack(fd, ALL_PAGES, FALSE);
+
    // Do a linear scan of the buffer to find pages belonging to the file
-   int slot = first;
-   while (slot != INVALID_SLOT) {
+   for (int s = 0; s < numShards && !rc; s++) {
+      PF_BufShard &shard = shards[s];
+      int slot = shard.first;
+      while (slot != INVALID_SLOT) {
 
-      int next = bufTable[slot].next;
+         int next = bufTable[slot].next;
 
-      // If the page belongs to the passed-in file descriptor
-      if (bufTable[slot].fd == fd) {
+         // If the page belongs to the passed-in file descriptor
+         if (bufTable[slot].fd == fd) {
 
 #ifdef PF_LOG
  sprintf (psMessage, "Page (%d) is in buffer manager.\n", bufTable[slot].pageNum);
  WriteLog(psMessage);
 #endif
-         // Ensure the page is not pinned
-         if (bufTable[slot].pinCount) {
-            rcWarn = PF_PAGEPINNED;
-         }
-         else {
-            // Write the page if dirty
-            if (bufTable[slot].bDirty) {
-#ifdef PF_LOG
- sprintf (psMessage, "Page (%d) is dirty\n",bufTable[slot].pageNum);
- WriteLog(psMessage);
-#endif
-               if ((rc = WritePage(fd, bufTable[slot].pageNum, bufTable[slot].pData)))
-                  return (rc);
-               bufTable[slot].bDirty = FALSE;
+            // Ensure the page is not pinned
+            if (bufTable[slot].pinCount) {
+               rcWarn = PF_PAGEPINNED;
+            }
+            else if (bufTable[slot].readAhead != RA_PENDING) {
+               // Remove page from the hash table and add the slot to the
+               // free list
+               if ((rc = shard.pHashTable->Delete(fd, bufTable[slot].pageNum)) ||
+                     (rc = Unlink(shard, slot)) ||
+                     (rc = InsertFree(shard, slot)))
+                  break;
+               shard.pReplacer->Remove(slot - shard.base);
             }
-
-            // Remove page from the hash table and add the slot to the free list
-            if ((rc = hashTable.Delete(fd, bufTable[slot].pageNum)) ||
-                  (rc = Unlink(slot)) ||
-                  (rc = InsertFree(slot)))
-               return (rc);
          }
+         slot = next;
       }
-      slot = next;
    }
 
+   UnlockAll();
+   if (rc)
+      return (rc);
+
+   // The file is being closed, sync what was forced before its descriptor
+   // goes away
+   if ((rc = pGroupCommit->Release(fd)))
+      return (rc);
+
 #ifdef PF_LOG
    WriteLog("All necessary pages flushed.\n");
 #endif
@@ -452,6 +625,61 @@ RC PF_BufferMgr::FlushPages(int fd)
    return (rcWarn);
 }
 
+//
+// DropPages
+//
+// Desc: Remove the pages of a file from pageNum on from the buffer without
+//       writing them, before the file is truncated.  The pages must be
+//       free.  What changed in those of a logged file is logged first, so
+//       that the log stays ahead of the truncation.
+// In:   fd - file descriptor
+//       pageNum - first page to drop
+// Ret:  PF_PAGEPINNED if one of the pages is pinned, and nothing is
+//       dropped, or other PF return code
+//
+RC PF_BufferMgr::DropPages(int fd, PageNum pageNum)
+{
+   RC rc = 0;  // return code
+
+   // No read may still be filling one of the slots
+   pReadAhead->Drain();
+   {
+      lock_guard<mutex> streamsLock(streamsMutex);
+      streams.erase(fd);
+   }
+
+   LockAll();
+
+   vector<int> slots;
+   for (int s = 0; s < numShards; s++)
+      for (int slot = shards[s].first; slot != INVALID_SLOT;
+            slot = bufTable[slot].next)
+         if (bufTable[slot].fd == fd && bufTable[slot].pageNum >= pageNum &&
+               bufTable[slot].readAhead != RA_PENDING) {
+            if (bufTable[slot].pinCount)
+               rc = PF_PAGEPINNED;
+            slots.push_back(slot);
+         }
+
+   if (!rc)
+      rc = LogSlots(slots);
+
+   for (size_t i = 0; i < slots.size() && !rc; i++) {
+      int slot = slots[i];
+      PF_BufShard &shard = ShardOfSlot(slot);
+      if ((rc = shard.pHashTable->Delete(fd, bufTable[slot].pageNum)) ||
+            (rc = Unlink(shard, slot)) ||
+            (rc = InsertFree(shard, slot)))
+         break;
+      shard.pReplacer->Remove(slot - shard.base);
+      bufTable[slot].bDirty = FALSE;
+      bufTable[slot].readAhead = RA_NONE;
+   }
+
+   UnlockAll();
+   return (rc);
+}
+
 //
 // ForcePages
 //
@@ -464,269 +692,1068 @@ RC PF_BufferMgr::FlushPages(int fd)
 //
 RC PF_BufferMgr::ForcePages(int fd, PageNum pageNum)
 {
-   RC rc;  // return codes
-
 #ifdef PF_LOG
    char psMessage[100];
    sprintf (psMessage, "Forcing page %d for (%d).\n", pageNum, fd);
    WriteLog(psMessage);
 #endif
 
-   // Do a linear scan of the buffer to find the page for the file
-   int slot = first;
-   while (slot != INVALID_SLOT) {
+   // I don't care if the pages are pinned or not, just write them if
+   // they are dirty.
+   LockAll();
+   RC rc = WriteBack(fd, pageNum, TRUE);
+   UnlockAll();
 
-      int next = bufTable[slot].next;
+   // Make the pages durable at the next Commit
+   if (!rc)
+      pGroupCommit->Forced(fd);
+   return (rc);
+}
 
-      // If the page belongs to the passed-in file descriptor
-      if (bufTable[slot].fd == fd &&
-            (pageNum==ALL_PAGES || bufTable[slot].pageNum == pageNum)) {
+//
+// Commit
+//
+// Desc: Make the pages forced so far durable, as the durability mode
+//       says.  Called at the end of a statement.  While a log is open,
+//       the changes to the dirty logged pages are logged instead, and a
+//       COMMIT record ends them; the log is then synced like a forced
+//       file.  No page may be changed meanwhile.
+// Ret:  PF_UNIX if a sync failed
+//
+RC PF_BufferMgr::Commit()
+{
+   RC   rc;
+   long lsn;
+
+   if (!pLog->IsOpen())
+      return (pGroupCommit->Commit());
+
+   vector<int> slots;
+   LockAll();
+   for (int s = 0; s < numShards; s++)
+      for (int slot = shards[s].first; slot != INVALID_SLOT;
+            slot = bufTable[slot].next)
+         if (bufTable[slot].pShadow && bufTable[slot].bDirty &&
+               bufTable[slot].readAhead != RA_PENDING)
+            slots.push_back(slot);
+   rc = LogSlots(slots, FALSE);
+   UnlockAll();
+
+   if (rc || (rc = pLog->Commit(lsn)) || (rc = pLog->Write(lsn)))
+      return (rc);
 
-#ifdef PF_LOG
- sprintf (psMessage, "Page (%d) is in buffer pool.\n", bufTable[slot].pageNum);
- WriteLog(psMessage);
-#endif
-         // I don't care if the page is pinned or not, just write it if
-         // it is dirty.
-         if (bufTable[slot].bDirty) {
-#ifdef PF_LOG
-sprintf (psMessage, "Page (%d) is dirty\n",bufTable[slot].pageNum);
-WriteLog(psMessage);
-#endif
-            if ((rc = WritePage(fd, bufTable[slot].pageNum, bufTable[slot].pData)))
-               return (rc);
-            bufTable[slot].bDirty = FALSE;
-         }
-      }
-      slot = next;
-   }
+   pGroupCommit->Forced(pLog->GetFd());
+   if ((rc = pGroupCommit->Commit()))
+      return (rc);
+   if (pGroupCommit->IsDurable())
+      pLog->Synced(lsn);
 
-   return 0;
+   // Return ok
+   return (0);
 }
 
+//
+// SetDurability
+//
+// Desc: Choose what Commit does
+// In:   mode - PF_DURABLE_NONE, PF_DURABLE_STATEMENT or PF_DURABLE_GROUP
+// Ret:  Always returns 0
+//
+RC PF_BufferMgr::SetDurability(PF_Durability mode)
+{
+   pGroupCommit->SetDurability(mode);
+   return (0);
+}
 
 //
-// PrintBuffer
+// SetGroupCommitWindow
 //
-// Desc: Display all of the pages within the buffer.
-//       This routine will be called via the system command.
-// In:   Nothing
-// Out:  Nothing
+// Desc: Choose how long the leader of a group commit waits for the group
+//       to fill up
+// In:   msecs - max wait, 0 for none
 // Ret:  Always returns 0
 //
-RC PF_BufferMgr::PrintBuffer()
+RC PF_BufferMgr::SetGroupCommitWindow(int msecs)
 {
-   cout << "Buffer contains " << numPages << " pages of size "
-      << pageSize <<".\n";
-   cout << "Contents in order from most recently used to "
-      << "least recently used.\n";
+   pGroupCommit->SetWindow(msecs);
+   return (0);
+}
 
-   int slot, next;
-   slot = first;
-   while (slot != INVALID_SLOT) {
-      next = bufTable[slot].next;
-      cout << slot << " :: \n";
-      cout << "  fd = " << bufTable[slot].fd << "\n";
-      cout << "  pageNum = " << bufTable[slot].pageNum << "\n";
-      cout << "  bDirty = " << bufTable[slot].bDirty << "\n";
-      cout << "  pinCount = " << bufTable[slot].pinCount << "\n";
-      slot = next;
-   }
+//
+// SetGroupCommitSize
+//
+// Desc: Choose how many Commits fill a group commit up
+// In:   maxGroup - # of Commits
+// Ret:  Always returns 0
+//
+RC PF_BufferMgr::SetGroupCommitSize(int maxGroup)
+{
+   pGroupCommit->SetGroupSize(maxGroup);
+   return (0);
+}
 
-   if (first==INVALID_SLOT)
-      cout << "Buffer is empty!\n";
+//
+// SetPageMap
+//
+// Desc: Have the pages of a compressed file read and written through its
+//       page map, from when it is opened until it is closed
+// In:   fd - file descriptor
+//       pPageMap - map of the file, NULL when it is closed
+//
+void PF_BufferMgr::SetPageMap(int fd, PF_PageMap *pPageMap)
+{
+   lock_guard<mutex> lock(pageMapsMutex);
+   if (pPageMap)
+      pageMaps[fd] = pPageMap;
    else
-      cout << "All remaining slots are free.\n";
-
-   return 0;
+      pageMaps.erase(fd);
 }
 
-
 //
-// ClearBuffer
+// CheckpointLog
 //
-// Desc: Remove all entries from the buffer manager.
-//       This routine will be called via the system command and is only
-//       really useful if the user wants to run some performance
-//       comparison starting with an clean buffer.
-// In:   Nothing
-// Out:  Nothing
-// Ret:  Will return an error if a page is pinned and the Clear routine
-//       is called.
-RC PF_BufferMgr::ClearBuffer()
+// Desc: Write every dirty logged page back, sync the files the log covers,
+//       and truncate the log.  Called between statements, once the files
+//       written since the last checkpoint are closed, or forced so that
+//       their headers are written too.  Does nothing if no log is open.
+// Ret:  PF return code
+//
+RC PF_BufferMgr::CheckpointLog()
 {
    RC rc;
 
-   int slot, next;
-   slot = first;
-   while (slot != INVALID_SLOT) {
-      next = bufTable[slot].next;
-      if (bufTable[slot].pinCount == 0)
-         if ((rc = hashTable.Delete(bufTable[slot].fd,
-               bufTable[slot].pageNum)) ||
-            (rc = Unlink(slot)) ||
-            (rc = InsertFree(slot)))
-         return (rc);
-      slot = next;
+   if (!pLog->IsOpen())
+      return (0);
+
+#ifdef PF_STATS
+   pStatisticsMgr->Register(PF_CHECKPOINT, STAT_ADDONE);
+#endif
+
+   // The pages are logged as they are written
+   vector<int> slots;
+   LockAll();
+   for (int s = 0; s < numShards; s++)
+      for (int slot = shards[s].first; slot != INVALID_SLOT;
+            slot = bufTable[slot].next)
+         if (bufTable[slot].pShadow && bufTable[slot].bDirty &&
+               bufTable[slot].readAhead != RA_PENDING)
+            slots.push_back(slot);
+   rc = WriteSlots(slots);
+   UnlockAll();
+   if (rc)
+      return (rc);
+
+   // Sync every file, open or closed, that the log has records about
+   vector<string> names;
+   pLog->GetFileNames(names);
+   for (size_t i = 0; i < names.size(); i++) {
+      int fd = open(names[i].c_str(), O_RDONLY);
+      if (fd < 0) {
+         if (errno == ENOENT)
+            continue;
+         return (PF_UNIX);
+      }
+#ifdef PF_STATS
+      pStatisticsMgr->Register(PF_SYNC, STAT_ADDONE);
+#endif
+      int err = fdatasync(fd);
+      close(fd);
+      if (err < 0)
+         return (PF_UNIX);
    }
 
-   return 0;
+   return (pLog->Truncate());
 }
 
 //
-// ResizeBuffer
-//
-// Desc: Resizes the buffer manager to the size passed in.
-//       This routine will be called via the system command.
-// In:   The new buffer size
-// Out:  Nothing
-// Ret:  0 for success or,
-//       Some other PF error (probably PF_NOBUF)
+// CloseLog
 //
-// Notes: This method attempts to copy all the old pages which I am
-// unable to kick out of the old buffer manager into the new buffer
-// manager.  This obviously cannot always be successfull!
+// Desc: Take a last checkpoint and stop logging
+// Ret:  PF return code
 //
-RC PF_BufferMgr::ResizeBuffer(int iNewSize)
+RC PF_BufferMgr::CloseLog()
 {
-   int i;
    RC rc;
 
-   // First try and clear out the old buffer!
-   ClearBuffer();
-
-   // Allocate memory for a new buffer table
-   PF_BufPageDesc *pNewBufTable = new PF_BufPageDesc[iNewSize]();
+   if (!pLog->IsOpen())
+      return (0);
+   if ((rc = CheckpointLog()) ||
+         (rc = pGroupCommit->Release(pLog->GetFd())))
+      return (rc);
+   return (pLog->Close());
+}
 
-   // Initialize the new buffer table and allocate memory for buffer
-   // pages.  Initially, the free list contains all pages
-   for (i = 0; i < iNewSize; i++) {
-      pNewBufTable[i].prev = i - 1;
-      pNewBufTable[i].next = i + 1;
-   }
-   pNewBufTable[0].prev = pNewBufTable[iNewSize - 1].next = INVALID_SLOT;
+//
+// PageMapOf
+//
+// Desc: Internal.  Look up the page map of a file
+// In:   fd - file descriptor
+// Ret:  the map, or NULL if the pages of the file are stored in place
+//
+PF_PageMap *PF_BufferMgr::PageMapOf(int fd)
+{
+   lock_guard<mutex> lock(pageMapsMutex);
+   if (pageMaps.empty())
+      return (NULL);
+   unordered_map<int, PF_PageMap *>::iterator it = pageMaps.find(fd);
+   return (it == pageMaps.end() ? NULL : it->second);
+}
 
-   // Now we must remember the old first and last slots and (of course)
-   // the buffer table itself.  Then we use insert methods to insert
-   // each of the entries into the new buffertable
-   int oldFirst = first;
-   PF_BufPageDesc *pOldBufTable = bufTable;
+//
+// WriteBack
+//
+// Desc: Internal.  Write the dirty pages of a file to disk and mark them
+//       clean.  The pages are sorted by page number and every run of
+//       adjacent pages goes out with a single pwritev.  A pinned page is
+//       latched shared while it is written; if a client holds it
+//       exclusive, it is changing the page, which stays dirty.  Every
+//       shard must be latched by the caller.
+// In:   fd - file descriptor
+//       pageNum - page to write, or ALL_PAGES
+//       bPinned - TRUE if pinned pages are written too
+// Ret:  PF return code
+//
+RC PF_BufferMgr::WriteBack(int fd, PageNum pageNum, int bPinned)
+{
+   RC rc;      // return code
+
+   // Collect the slots of the pages to write
+   vector<int> slots, latched;
+   for (int s = 0; s < numShards; s++)
+      for (int slot = shards[s].first; slot != INVALID_SLOT;
+            slot = bufTable[slot].next)
+         if (bufTable[slot].fd == fd && bufTable[slot].bDirty &&
+               (pageNum == ALL_PAGES || bufTable[slot].pageNum == pageNum) &&
+               (bPinned || bufTable[slot].pinCount == 0)) {
+            if (bufTable[slot].pinCount > 0) {
+               if (pthread_rwlock_tryrdlock(&latches[slot]))
+                  continue;
+               latched.push_back(slot);
+            }
+            slots.push_back(slot);
+         }
 
-   // Setup the new number of pages,  first, last and free
-   numPages = iNewSize;
-   first = last = INVALID_SLOT;
-   free = 0;
+   rc = WriteSlots(slots);
 
-   // Setup the new buffer table
-   bufTable = pNewBufTable;
+   for (size_t k = 0; k < latched.size(); k++)
+      pthread_rwlock_unlock(&latches[latched[k]]);
 
-   // We must first remove from the hashtable any possible entries
-   int slot, next, newSlot;
-   slot = oldFirst;
-   while (slot != INVALID_SLOT) {
-      next = pOldBufTable[slot].next;
+   // Return ok or the write error
+   return (rc);
+}
 
-      // Must remove the entry from the hashtable from the
-      if ((rc=hashTable.Delete(pOldBufTable[slot].fd, pOldBufTable[slot].pageNum)))
-         return (rc);
-      slot = next;
-   }
+//
+// WriteSlots
+//
+// Desc: Internal.  Write the pages held by slots and mark them clean.
+//       The pages are sorted by file and page number and every run of
+//       adjacent pages goes out with a single pwritev, or a single punch
+//       for a run of disposed pages.  The shards of the
+//       slots must be latched by the caller, and the pages must not be
+//       changed while they are written.
+// In:   slots - slots of dirty pages, sorted on return
+// Ret:  PF return code, the pages that were not written stay dirty
+//
+RC PF_BufferMgr::WriteSlots(vector<int> &slots)
+{
+   RC rc = 0;  // return code
 
-   // Now we traverse through the old buffer table and copy any old
-   // entries into the new one
-   slot = oldFirst;
-   while (slot != INVALID_SLOT) {
+#ifdef PF_LOG
+   char psMessage[100];
+#endif
 
-      next = pOldBufTable[slot].next;
-      // Allocate a new slot for the old page
-      if ((rc = InternalAlloc(newSlot)))
-         return (rc);
+   sort(slots.begin(), slots.end(), [this](int a, int b) {
+      return (bufTable[a].fd < bufTable[b].fd ||
+            (bufTable[a].fd == bufTable[b].fd &&
+             bufTable[a].pageNum < bufTable[b].pageNum));
+   });
 
-      // Insert the page into the hash table,
-      // and initialize the page description entry
-      if ((rc = hashTable.Insert(pOldBufTable[slot].fd,
-            pOldBufTable[slot].pageNum, newSlot)) ||
-            (rc = InitPageDesc(pOldBufTable[slot].fd,
-            pOldBufTable[slot].pageNum, newSlot)))
-         return (rc);
+   // Write ahead of the pages what they change
+   if ((rc = LogSlots(slots)))
+      return (rc);
 
-      // Put the slot back on the free list before returning the error
-      Unlink(newSlot);
-      InsertFree(newSlot);
+   struct iovec iov[PF_MAX_WRITEV];
+   size_t i = 0;
+   while (i < slots.size()) {
+
+      // Extend the run while the next page follows the previous one, and
+      // is disposed of as well or not either
+      int fd = bufTable[slots[i]].fd;
+      PageNum start = bufTable[slots[i]].pageNum;
+      int bHole = bufTable[slots[i]].bHole;
+      int n = 0;
+      while (i + n < slots.size() && n < PF_MAX_WRITEV &&
+            bufTable[slots[i + n]].fd == fd &&
+            bufTable[slots[i + n]].pageNum == start + n &&
+            bufTable[slots[i + n]].bHole == bHole) {
+#ifdef PF_LOG
+ sprintf (psMessage, "Page (%d) is dirty\n", start + n);
+ WriteLog(psMessage);
+#endif
+         iov[n].iov_base = bufTable[slots[i + n]].pData;
+         iov[n].iov_len  = bufTable[slots[i + n]].size;
+         n++;
+      }
 
-      slot = next;
+      if ((rc = bHole ? PunchPages(fd, start, iov, n) :
+            WritePages(fd, start, iov, n)))
+         break;
+      for (int k = 0; k < n; k++) {
+         bufTable[slots[i + k]].bDirty = FALSE;
+         bufTable[slots[i + k]].bHole = FALSE;
+      }
+      i += n;
    }
 
-   // Finally, delete the old buffer table
-   delete [] pOldBufTable;
-
-   return 0;
+   // Return ok or the write error
+   return (rc);
 }
 
-
 //
-// InsertFree
+// LatchPage
 //
-// Desc: Internal.  Insert a slot at the head of the free list
-// In:   slot - slot number to insert
+// Desc: Latch the contents of a page for a client that shares the page
+//       with other threads: shared to read it, exclusive to change it.
+//       The page must be pinned, and stay pinned until it is unlatched.
+//       The shard is not held while waiting for the latch.
+// In:   fd - OS file descriptor of the file associated with the page
+//       pageNum - number of the page to latch
+//       bExclusive - TRUE to latch the page exclusive
 // Ret:  PF return code
 //
-RC PF_BufferMgr::InsertFree(int slot)
+RC PF_BufferMgr::LatchPage(int fd, PageNum pageNum, int bExclusive)
 {
-   bufTable[slot].next = free;
-   free = slot;
+   RC  rc;       // return code
+   int slot;     // buffer slot where page is located
+
+   {
+      PF_BufShard &shard = ShardOf(fd, pageNum);
+      lock_guard<mutex> lock(shard.latch);
+
+      // The page must be found and pinned in the buffer
+      if ((rc = shard.pHashTable->Find(fd, pageNum, slot))) {
+         if ((rc == PF_HASHNOTFOUND))
+            return (PF_PAGENOTINBUF);
+         else
+            return (rc);              // unexpected error
+      }
+
+      if (bufTable[slot].pinCount == 0)
+         return (PF_PAGEUNPINNED);
+   }
+
+   // The pin keeps the page in slot
+   int err = bExclusive ? pthread_rwlock_wrlock(&latches[slot]) :
+      pthread_rwlock_rdlock(&latches[slot]);
+   if (err) {
+      errno = err;
+      return (PF_UNIX);
+   }
 
    // Return ok
    return (0);
 }
 
 //
-// LinkHead
+// UnlatchPage
 //
-// Desc: Internal.  Insert a slot at the head of the used list, making
-//       it the most-recently used slot.
-// In:   slot - slot number to insert
+// Desc: Release the latch taken by LatchPage
+// In:   fd - OS file descriptor of the file associated with the page
+//       pageNum - number of the page to unlatch
 // Ret:  PF return code
 //
-RC PF_BufferMgr::LinkHead(int slot)
+RC PF_BufferMgr::UnlatchPage(int fd, PageNum pageNum)
 {
-   // Set next and prev pointers of slot entry
-   bufTable[slot].next = first;
-   bufTable[slot].prev = INVALID_SLOT;
+   RC  rc;       // return code
+   int slot;     // buffer slot where page is located
 
-   // If list isn't empty, point old first back to slot
-   if (first != INVALID_SLOT)
-      bufTable[first].prev = slot;
+   PF_BufShard &shard = ShardOf(fd, pageNum);
+   lock_guard<mutex> lock(shard.latch);
+
+   // The page must be found and pinned in the buffer
+   if ((rc = shard.pHashTable->Find(fd, pageNum, slot))) {
+      if ((rc == PF_HASHNOTFOUND))
+         return (PF_PAGENOTINBUF);
+      else
+         return (rc);              // unexpected error
+   }
 
-   first = slot;
+   if (bufTable[slot].pinCount == 0)
+      return (PF_PAGEUNPINNED);
 
-   // if list was empty, set last to slot
-   if (last == INVALID_SLOT)
-      last = first;
+   int err = pthread_rwlock_unlock(&latches[slot]);
+   if (err) {
+      errno = err;
+      return (PF_UNIX);
+   }
 
    // Return ok
    return (0);
 }
 
+
 //
-// Unlink
+// PrintBuffer
 //
-// Desc: Internal.  Unlink the slot from the used list.  Assume that
-//       slot is valid.  Set prev and next pointers to INVALID_SLOT.
-//       The caller is responsible to either place the unlinked page into
-//       the free list or the used list.
-// In:   slot - slot number to unlink
-// Ret:  PF return code
+// Desc: Display all of the pages within the buffer.
+//       This routine will be called via the system command.
+// In:   Nothing
+// Out:  Nothing
+// Ret:  Always returns 0
+//
+RC PF_BufferMgr::PrintBuffer()
+{
+   cout << "Buffer contains " << numPages << " pages";
+   if (numShards > 1)
+      cout << " in " << numShards << " shards";
+   cout << ".\n";
+   cout << "Replacement policy is " << shards[0].pReplacer->Name() << ".\n";
+   switch (pArena->Backing()) {
+      case PF_HUGETLB_PAGES:
+         cout << "Frames are on huge pages.\n"; break;
+      case PF_TRANSPARENT_HUGE_PAGES:
+         cout << "Frames are on transparent huge pages.\n"; break;
+      default:
+         break;
+   }
+   cout << "Contents in order from most recently loaded to "
+      << "least recently loaded, shard by shard.\n";
+
+   LockAll();
+
+   int bEmpty = TRUE;
+   for (int s = 0; s < numShards; s++) {
+      int slot, next;
+      slot = shards[s].first;
+      while (slot != INVALID_SLOT) {
+         next = bufTable[slot].next;
+         cout << slot << " :: \n";
+         cout << "  fd = " << bufTable[slot].fd << "\n";
+         cout << "  pageNum = " << bufTable[slot].pageNum << "\n";
+         cout << "  size = " << bufTable[slot].size << "\n";
+         cout << "  bDirty = " << bufTable[slot].bDirty << "\n";
+         cout << "  pinCount = " << bufTable[slot].pinCount << "\n";
+         slot = next;
+         bEmpty = FALSE;
+      }
+   }
+
+   UnlockAll();
+
+   if (bEmpty)
+      cout << "Buffer is empty!\n";
+   else
+      cout << "All remaining slots are free.\n";
+
+   return 0;
+}
+
+
+//
+// ClearBuffer
+//
+// Desc: Remove all entries from the buffer manager.
+//       This routine will be called via the system command and is only
+//       really useful if the user wants to run some performance
+//       comparison starting with an clean buffer.
+// In:   Nothing
+// Out:  Nothing
+// Ret:  Will return an error if a page is pinned and the Clear routine
+//       is called.
+RC PF_BufferMgr::ClearBuffer()
+{
+   RC rc = 0;
+
+   pReadAhead->Drain();
+   {
+      lock_guard<mutex> streamsLock(streamsMutex);
+      streams.clear();
+   }
+
+   LockAll();
+
+   for (int s = 0; s < numShards && !rc; s++) {
+      PF_BufShard &shard = shards[s];
+      int slot, next;
+      slot = shard.first;
+      while (slot != INVALID_SLOT) {
+         next = bufTable[slot].next;
+         if (bufTable[slot].pinCount == 0 &&
+               bufTable[slot].readAhead != RA_PENDING) {
+            if ((rc = shard.pHashTable->Delete(bufTable[slot].fd,
+                  bufTable[slot].pageNum)) ||
+               (rc = Unlink(shard, slot)) ||
+               (rc = InsertFree(shard, slot)))
+               break;
+            shard.pReplacer->Remove(slot - shard.base);
+         }
+         slot = next;
+      }
+   }
+
+   UnlockAll();
+   return (rc);
+}
+
+//
+// ResizeBuffer
+//
+// Desc: Resizes the buffer manager to the size passed in.
+//       This routine will be called via the system command.  The new
+//       buffer is partitioned into shards according to its size, so
+//       every page moves.  The dirty pages are written back first, and
+//       the buffer is then emptied.  No other call may be in progress.
+// In:   The new buffer size
+// Out:  Nothing
+// Ret:  0 for success or,
+//       PF_PAGEPINNED if a page is pinned: its frame is in use and cannot
+//       go away, so the buffer is left as it is.  Some other PF error
+//       if a page cannot be written.
+//
+RC PF_BufferMgr::ResizeBuffer(int iNewSize)
+{
+   RC rc = 0;
+
+   // The pages being read ahead land in the old buffer first
+   StopWriter();
+   pReadAhead->Drain();
+
+   LockAll();
+   vector<int> slots;
+   for (int s = 0; s < numShards && !rc; s++)
+      for (int slot = shards[s].first; slot != INVALID_SLOT;
+            slot = bufTable[slot].next)
+         if (bufTable[slot].pinCount > 0) {
+            rc = PF_PAGEPINNED;
+            break;
+         }
+         else if (bufTable[slot].bDirty)
+            slots.push_back(slot);
+   if (!rc)
+      rc = WriteSlots(slots);
+   UnlockAll();
+
+   if (!rc)
+      rc = ClearBuffer();
+   if (rc) {
+      UpdateWriter();
+      return (rc);
+   }
+
+   // Then replace the buffer table and the shards
+   FreeShards();
+   numPages = iNewSize;
+   MakeShards();
+   UpdateWriter();
+
+   return 0;
+}
+
 //
-RC PF_BufferMgr::Unlink(int slot)
+// SetReplacementPolicy
+//
+// Desc: Switch to another replacement policy.  The pages in the buffer
+//       are handed to the new policy as if they had just been loaded, in
+//       used-list order so that the most recently loaded page is also the
+//       most recent one for the new policy.
+// In:   policy - the new replacement policy
+// Ret:  PF return code
+//
+RC PF_BufferMgr::SetReplacementPolicy(PF_ReplacementPolicy policy)
+{
+   // Pages being read ahead are not known to any policy yet
+   pReadAhead->Drain();
+
+   LockAll();
+
+   this->policy = policy;
+   for (int s = 0; s < numShards; s++) {
+      PF_BufShard &shard = shards[s];
+      delete shard.pReplacer;
+      shard.pReplacer = PF_NewReplacer(policy, shard.numPages);
+
+      // Sequential scans share PF_SCAN_RING_PAGES slots, but a scan needs
+      // two per shard, and must leave most of a small buffer alone
+      shard.ringSize = PF_SCAN_RING_PAGES / numShards;
+      if (shard.ringSize < 2)
+         shard.ringSize = 2;
+      if (shard.ringSize > shard.numPages / 4)
+         shard.ringSize = shard.numPages / 4;
+      if (shard.ringSize < 1)
+         shard.ringSize = 1;
+
+      for (int slot = shard.last; slot != INVALID_SLOT;
+            slot = bufTable[slot].prev) {
+         if (bufTable[slot].readAhead == RA_PENDING)
+            continue;
+         shard.pReplacer->Insert(slot - shard.base, bufTable[slot].fd,
+               bufTable[slot].pageNum);
+         if (bufTable[slot].pinCount == 0)
+            shard.pReplacer->Unpin(slot - shard.base);
+      }
+   }
+
+   UnlockAll();
+   return (0);
+}
+
+//
+// SetReadAhead
+//
+// Desc: Set the read-ahead window.  Once a file is read sequentially,
+//       up to numPages pages that follow the last page requested are read
+//       ahead, and never more than half of the buffer.
+// In:   numPages - size of the window, 0 disables read-ahead
+// Ret:  PF return code
+//
+RC PF_BufferMgr::SetReadAhead(int numPages)
+{
+   lock_guard<mutex> streamsLock(streamsMutex);
+   readAheadWindow = numPages > 0 ? numPages : 0;
+   streams.clear();
+
+   // Return ok
+   return (0);
+}
+
+//
+// SetBackgroundWriter
+//
+// Desc: Set the number of pages the background writer keeps clean at the
+//       cold end of the buffer, spread over the shards.
+// In:   numPages - number of pages, 0 to stop cleaning
+// Ret:  PF return code
+//
+RC PF_BufferMgr::SetBackgroundWriter(int numPages)
+{
+   {
+      lock_guard<mutex> lock(writerMutex);
+      cleanTarget = numPages > 0 ? numPages : 0;
+   }
+   UpdateWriter();
+
+   // Return ok
+   return (0);
+}
+
+//
+// SetCheckpointInterval
+//
+// Desc: Set the time between two checkpoints of the background writer
+// In:   msecs - milliseconds, 0 to stop checkpointing
+// Ret:  PF return code
+//
+RC PF_BufferMgr::SetCheckpointInterval(int msecs)
+{
+   {
+      lock_guard<mutex> lock(writerMutex);
+      checkpointInterval = msecs > 0 ? msecs : 0;
+   }
+   UpdateWriter();
+
+   // Return ok
+   return (0);
+}
+
+//
+// UpdateWriter
+//
+// Desc: Internal.  Start the background writer if it has something to do
+//       and is not running, stop it if it has nothing to do, and wake it
+//       up otherwise so that it sees its new settings.  Like the other
+//       settings, it must not be called concurrently with itself.
+//
+void PF_BufferMgr::UpdateWriter()
+{
+   int bNeeded;
+   {
+      lock_guard<mutex> lock(writerMutex);
+      bNeeded = cleanTarget > 0 || checkpointInterval > 0;
+   }
+
+   if (bNeeded && !writer.joinable())
+      writer = thread(&PF_BufferMgr::RunWriter, this);
+   else if (!bNeeded)
+      StopWriter();
+   else
+      writerCond.notify_all();
+}
+
+//
+// StopWriter
+//
+// Desc: Internal.  Stop the background writer, if it runs, once it has
+//       finished its current batch of writes.
+//
+void PF_BufferMgr::StopWriter()
+{
+   if (!writer.joinable())
+      return;
+
+   {
+      lock_guard<mutex> lock(writerMutex);
+      bStopWriter = TRUE;
+   }
+   writerCond.notify_all();
+   writer.join();
+   bStopWriter = FALSE;
+}
+
+//
+// RunWriter
+//
+// Desc: Internal.  Body of the background writer: every PF_WRITER_WAKEUP
+//       milliseconds, clean the cold end of every shard, and take a
+//       checkpoint when one is due.
+//
+void PF_BufferMgr::RunWriter()
+{
+   typedef chrono::steady_clock Clock;
+   Clock::time_point lastCheckpoint = Clock::now();
+
+   unique_lock<mutex> lock(writerMutex);
+   while (!bStopWriter) {
+      int target = cleanTarget;
+      int interval = checkpointInterval;
+      lock.unlock();
+
+      // Each shard keeps its share of the clean pages
+      if (target > 0)
+         for (int s = 0; s < numShards && !bStopWriter; s++) {
+            long share = (long)target * shards[s].numPages / numPages;
+            CleanShard(shards[s], share > 0 ? share : 1);
+         }
+
+      if (interval > 0 && Clock::now() - lastCheckpoint >=
+            chrono::milliseconds(interval)) {
+         Checkpoint();
+         lastCheckpoint = Clock::now();
+      }
+
+      lock.lock();
+      if (!bStopWriter)
+         writerCond.wait_for(lock, chrono::milliseconds(PF_WRITER_WAKEUP));
+   }
+}
+
+//
+// CleanShard
+//
+// Desc: Internal.  Write the dirty pages among the pages a shard would
+//       evict next.  They are unpinned, so nobody changes them while
+//       they are written under the shard latch.
+// In:   shard - the shard
+//       numPages - number of cold pages to look at
+//
+void PF_BufferMgr::CleanShard(PF_BufShard &shard, int numPages)
+{
+   lock_guard<mutex> lock(shard.latch);
+
+   vector<int> cold(numPages);
+   int n = shard.pReplacer->Coldest(bufTable + shard.base, &cold[0],
+         numPages);
+
+   vector<int> slots;
+   for (int i = 0; i < n; i++) {
+      int slot = shard.base + cold[i];
+      if (bufTable[slot].bDirty && bufTable[slot].fd != MEMORY_FD)
+         slots.push_back(slot);
+   }
+   if (slots.empty())
+      return;
+
+   WriteSlots(slots);
+
+#ifdef PF_STATS
+   int numWritten = slots.size();
+   pStatisticsMgr->Register(PF_BGWRITE, STAT_ADDVALUE, &numWritten);
+#endif
+}
+
+//
+// Checkpoint
+//
+// Desc: Internal.  Write every page that is dirty when the checkpoint
+//       starts, in file and page order.  The pages are written in batches
+//       of PF_MAX_WRITEV pages and the shards are only latched during a
+//       batch, so the foreground is never held up for long.  Pinned pages
+//       are skipped, since their clients may still be changing them
+//       without having marked them dirty again; the next checkpoint gets
+//       them.
+//
+void PF_BufferMgr::Checkpoint()
+{
+   // Take the list of the dirty pages
+   vector<pair<int, PageNum> > pages;
+   for (int s = 0; s < numShards; s++) {
+      lock_guard<mutex> lock(shards[s].latch);
+      for (int slot = shards[s].first; slot != INVALID_SLOT;
+            slot = bufTable[slot].next)
+         if (bufTable[slot].bDirty && bufTable[slot].fd != MEMORY_FD)
+            pages.push_back(make_pair(bufTable[slot].fd,
+                                      bufTable[slot].pageNum));
+   }
+   sort(pages.begin(), pages.end());
+
+#ifdef PF_STATS
+   pStatisticsMgr->Register(PF_CHECKPOINT, STAT_ADDONE);
+#endif
+
+   for (size_t i = 0; i < pages.size() && !bStopWriter;
+         i += PF_MAX_WRITEV) {
+      vector<int> slots;
+
+      LockAll();
+
+      // The pages that are still in the buffer, dirty and unpinned
+      for (size_t k = i; k < pages.size() && k < i + PF_MAX_WRITEV; k++) {
+         int slot;
+         if (!ShardOf(pages[k].first, pages[k].second).pHashTable->Find(
+               pages[k].first, pages[k].second, slot) &&
+               bufTable[slot].bDirty && bufTable[slot].pinCount == 0)
+            slots.push_back(slot);
+      }
+
+      WriteSlots(slots);
+      UnlockAll();
+
+#ifdef PF_STATS
+      int numWritten = slots.size();
+      pStatisticsMgr->Register(PF_BGWRITE, STAT_ADDVALUE, &numWritten);
+#endif
+   }
+}
+
+
+//
+// MakeShards
+//
+// Desc: Internal.  Allocate the buffer table and the frame arena for
+//       numPages pages and partition them into shards of at least
+//       PF_SHARD_MIN_PAGES pages, and at most PF_MAX_SHARDS shards.
+//       Initially, the free list of every shard contains all of its pages.
+//
+void PF_BufferMgr::MakeShards()
+{
+   bufTable = new PF_BufPageDesc[numPages]();
+   pArena = new PF_FrameArena(numPages, MEMORY_PAGE_SIZE);
+   latches = new pthread_rwlock_t[numPages];
+   for (int i = 0; i < numPages; i++)
+      pthread_rwlock_init(&latches[i], NULL);
+
+   numShards = numPages / PF_SHARD_MIN_PAGES;
+   if (numShards > PF_MAX_SHARDS)
+      numShards = PF_MAX_SHARDS;
+   if (numShards < 1)
+      numShards = 1;
+
+   shards = new PF_BufShard[numShards];
+   for (int s = 0; s < numShards; s++) {
+      PF_BufShard &shard = shards[s];
+      shard.base = (long)numPages * s / numShards;
+      shard.numPages = (long)numPages * (s + 1) / numShards - shard.base;
+      shard.pHashTable = new PF_HashTable(shard.numPages);
+      shard.pReplacer = PF_NewReplacer(policy, shard.numPages);
+
+      for (int i = shard.base; i < shard.base + shard.numPages; i++) {
+         bufTable[i].prev = i - 1;
+         bufTable[i].next = i + 1;
+      }
+      bufTable[shard.base].prev = INVALID_SLOT;
+      bufTable[shard.base + shard.numPages - 1].next = INVALID_SLOT;
+      shard.free = shard.base;
+      shard.first = shard.last = INVALID_SLOT;
+      shard.numInIO = 0;
+   }
+}
+
+//
+// FreeShards
+//
+// Desc: Internal.  Free what MakeShards allocated, and the pages.
+//
+void PF_BufferMgr::FreeShards()
+{
+   for (int s = 0; s < numShards; s++) {
+      delete shards[s].pHashTable;
+      delete shards[s].pReplacer;
+   }
+   delete [] shards;
+
+   for (int i = 0; i < numPages; i++) {
+      if (!pArena->Contains(bufTable[i].pData))
+         free(bufTable[i].pData);
+      free(bufTable[i].pShadow);
+      pthread_rwlock_destroy(&latches[i]);
+   }
+   delete [] latches;
+   delete pArena;
+   delete [] bufTable;
+}
+
+//
+// ShardOf
+//
+// Desc: Internal.  Return the shard of a page.  fd and pageNum are mixed
+//       like in PF_HashTable, so that consecutive pages of a file spread
+//       over the shards.  Memory blocks all live in the first shard.
+//
+PF_BufShard &PF_BufferMgr::ShardOf(int fd, PageNum pageNum) const
+{
+   if (fd == MEMORY_FD)
+      return (shards[0]);
+
+   unsigned long long h = ((unsigned long long)(unsigned int)fd << 32) |
+      (unsigned int)pageNum;
+   h ^= h >> 33;
+   h *= 0xff51afd7ed558ccdULL;
+   h ^= h >> 33;
+   return (shards[h % numShards]);
+}
+
+//
+// ShardOfSlot
+//
+// Desc: Internal.  Return the shard that owns slot
+//
+PF_BufShard &PF_BufferMgr::ShardOfSlot(int slot) const
+{
+   int s = (long)slot * numShards / numPages;
+   while (slot < shards[s].base)
+      s--;
+   while (slot >= shards[s].base + shards[s].numPages)
+      s++;
+   return (shards[s]);
+}
+
+//
+// LockAll
+//
+// Desc: Internal.  Latch every shard.  The shards are always latched in
+//       order, and no thread latches a shard while it holds another one
+//       otherwise.
+//
+void PF_BufferMgr::LockAll()
+{
+   // A slot in I/O is on its way in or out of the shard, and is waited
+   // for.  Its I/O only needs the latch of its own shard to finish.
+   for (int s = 0; s < numShards; s++) {
+      unique_lock<mutex> lock(shards[s].latch);
+      while (shards[s].numInIO > 0)
+         shards[s].readDone.wait(lock);
+      lock.release();
+   }
+}
+
+//
+// UnlockAll
+//
+// Desc: Internal.  Release the latches taken by LockAll
+//
+void PF_BufferMgr::UnlockAll()
+{
+   for (int s = numShards - 1; s >= 0; s--)
+      shards[s].latch.unlock();
+}
+
+//
+// StartIO
+//
+// Desc: Internal.  Mark a slot in I/O, before the latch of its shard is
+//       released to read or write its page.  The slot must be in the
+//       hash table and out of the replacement policy and the scan ring:
+//       a request for its page waits, whole-buffer operations wait, and
+//       nothing else looks at an unpinned slot.
+// In:   shard - shard of the slot, latched by the caller
+//       slot - slot whose page is read or written
+//
+void PF_BufferMgr::StartIO(PF_BufShard &shard, int slot)
+{
+   bufTable[slot].bInIO = TRUE;
+   shard.numInIO++;
+}
+
+//
+// EndIO
+//
+// Desc: Internal.  Mark a slot out of I/O, once the latch of its shard
+//       is taken again, and wake up the threads waiting for it.
+// In:   shard - shard of the slot, latched by the caller
+//       slot - slot whose page was read or written
+//
+void PF_BufferMgr::EndIO(PF_BufShard &shard, int slot)
+{
+   bufTable[slot].bInIO = FALSE;
+   shard.numInIO--;
+   shard.readDone.notify_all();
+}
+
+//
+// InsertFree
+//
+// Desc: Internal.  Insert a slot at the head of the free list
+// In:   shard - shard of the slot
+//       slot - slot number to insert
+// Ret:  PF return code
+//
+RC PF_BufferMgr::InsertFree(PF_BufShard &shard, int slot)
+{
+   bufTable[slot].bInRing = FALSE;
+   bufTable[slot].next = shard.free;
+   shard.free = slot;
+
+   // Return ok
+   return (0);
+}
+
+//
+// LinkHead
+//
+// Desc: Internal.  Insert a slot at the head of the used list.
+// In:   shard - shard of the slot
+//       slot - slot number to insert
+// Ret:  PF return code
+//
+RC PF_BufferMgr::LinkHead(PF_BufShard &shard, int slot)
+{
+   // Set next and prev pointers of slot entry
+   bufTable[slot].next = shard.first;
+   bufTable[slot].prev = INVALID_SLOT;
+
+   // If list isn't empty, point old first back to slot
+   if (shard.first != INVALID_SLOT)
+      bufTable[shard.first].prev = slot;
+
+   shard.first = slot;
+
+   // if list was empty, set last to slot
+   if (shard.last == INVALID_SLOT)
+      shard.last = shard.first;
+
+   // Return ok
+   return (0);
+}
+
+//
+// Unlink
+//
+// Desc: Internal.  Unlink the slot from the used list.  Assume that
+//       slot is valid.  Set prev and next pointers to INVALID_SLOT.
+//       The caller is responsible to either place the unlinked page into
+//       the free list or the used list.
+// In:   shard - shard of the slot
+//       slot - slot number to unlink
+// Ret:  PF return code
+//
+RC PF_BufferMgr::Unlink(PF_BufShard &shard, int slot)
 {
    // If slot is at head of list, set first to next element
-   if (first == slot)
-      first = bufTable[slot].next;
+   if (shard.first == slot)
+      shard.first = bufTable[slot].next;
 
    // If slot is at end of list, set last to previous element
-   if (last == slot)
-      last = bufTable[slot].prev;
+   if (shard.last == slot)
+      shard.last = bufTable[slot].prev;
 
    // If slot not at end of list, point next back to previous
    if (bufTable[slot].next != INVALID_SLOT)
@@ -746,58 +1773,176 @@ RC PF_BufferMgr::Unlink(int slot)
 //
 // InternalAlloc
 //
-// Desc: Internal.  Allocate a buffer slot.  The slot is inserted at the
-//       head of the used list.  Here's how it chooses which slot to use:
+// Desc: Internal.  Allocate a buffer slot of a shard.  The slot is
+//       inserted at the head of the used list.  Here's how it chooses
+//       which slot to use:
+//       For a scan, if the scan ring is full, then recycle its oldest
+//       unpinned slot.
 //       If there is something on the free list, then use it.
-//       Otherwise, choose a victim to replace.  If a victim cannot be
-//       chosen (because all the pages are pinned), then return an error.
+//       Otherwise, ask the replacement policy for a victim.  If a victim
+//       cannot be chosen (because all the pages are pinned), then return
+//       an error.  The slot gets its frame of the arena for a page of
+//       MEMORY_PAGE_SIZE bytes, and a page-aligned frame of its own for a
+//       page of another size, kept while the slot holds pages of that
+//       size.
+//       The latch of the shard is released while the page of a victim
+//       is written out, so the caller must look for its page again.
+// In:   shard - shard to take the slot from, latched by the caller
+//       lock - holds the latch of the shard
+//       size - size of the page that will be put in the slot
+//       bScan - TRUE if the slot is for a page read by a sequential scan
 // Out:  slot - set to newly-allocated slot
-// Ret:  PF_NOBUF if all pages are pinned, other PF return code otherwise
+// Ret:  PF_NOBUF if all pages are pinned, PF_NOMEM if no frame can be
+//       allocated, other PF return code otherwise
 //
-RC PF_BufferMgr::InternalAlloc(int &slot)
+RC PF_BufferMgr::InternalAlloc(PF_BufShard &shard, unique_lock<mutex> &lock,
+      int &slot, int size, int bScan)
 {
    RC  rc;       // return code
+   int bVictim;  // TRUE if the slot holds a page to throw away
 
+   // A scan takes the oldest slot of its ring first
+   if (bScan && !RingVictim(shard, slot)) {
+      bVictim = TRUE;
+#ifdef PF_STATS
+      pStatisticsMgr->Register(PF_SCANRING, STAT_ADDONE);
+#endif
+   }
    // If the free list is not empty, choose a slot from the free list
-   if (free != INVALID_SLOT) {
-      slot = free;
-      free = bufTable[slot].next;
+   else if (shard.free != INVALID_SLOT) {
+      slot = shard.free;
+      shard.free = bufTable[slot].next;
+      bVictim = FALSE;
    }
    else {
 
-      // Choose the least-recently used page that is unpinned
-      for (slot = last; slot != INVALID_SLOT; slot = bufTable[slot].prev) {
-         if (bufTable[slot].pinCount == 0)
-            break;
-      }
+      // Choose an unpinned page, or return error if all buffers were pinned
+      int victim;
+      if ((rc = shard.pReplacer->Victim(bufTable + shard.base, victim)))
+         return (rc);
+      slot = shard.base + victim;
+      bVictim = TRUE;
+   }
 
-      // Return error if all buffers were pinned
-      if (slot == INVALID_SLOT)
-         return (PF_NOBUF);
+   if (bVictim) {
+      int victim = slot - shard.base;
+      bufTable[slot].bInRing = FALSE;
 
-      // Write out the page if it is dirty
+      // Write out the page if it is dirty, logged first, or punch it out
+      // of the file if it was disposed of.  The page is in I/O meanwhile,
+      // and the shard is not latched.
       if (bufTable[slot].bDirty) {
-         if ((rc = WritePage(bufTable[slot].fd, bufTable[slot].pageNum,
-               bufTable[slot].pData)))
+         struct iovec iov;
+         iov.iov_base = bufTable[slot].pData;
+         iov.iov_len  = bufTable[slot].size;
+         StartIO(shard, slot);
+         lock.unlock();
+         if (!(rc = LogSlots(vector<int>(1, slot))))
+            rc = bufTable[slot].bHole ?
+               PunchPages(bufTable[slot].fd, bufTable[slot].pageNum,
+               &iov, 1) :
+               WritePage(bufTable[slot].fd, bufTable[slot].pageNum,
+               bufTable[slot].size, bufTable[slot].pData);
+         lock.lock();
+         EndIO(shard, slot);
+         if (rc) {
+            // Keep the page and give it back to the replacement policy
+            shard.pReplacer->Insert(victim, bufTable[slot].fd,
+                  bufTable[slot].pageNum);
+            shard.pReplacer->Unpin(victim);
             return (rc);
+         }
 
          bufTable[slot].bDirty = FALSE;
+         bufTable[slot].bHole = FALSE;
       }
 
       // Remove page from the hash table and slot from the used buffer list
-      if ((rc = hashTable.Delete(bufTable[slot].fd, bufTable[slot].pageNum)) ||
-            (rc = Unlink(slot)))
+      if ((rc = shard.pHashTable->Delete(bufTable[slot].fd,
+            bufTable[slot].pageNum)) ||
+            (rc = Unlink(shard, slot)))
          return (rc);
    }
 
-   // Link slot at the head of the used list
-   if ((rc = LinkHead(slot)))
+   // Give the slot the memory for a page of this size
+   if (bufTable[slot].size != size) {
+      if (!pArena->Contains(bufTable[slot].pData))
+         free(bufTable[slot].pData);
+      bufTable[slot].pData = NULL;
+      bufTable[slot].size = 0;
+
+      void *frame;
+      if (size == MEMORY_PAGE_SIZE)
+         frame = pArena->Frame(slot);
+      else if (posix_memalign(&frame, MEMORY_PAGE_SIZE, size)) {
+         InsertFree(shard, slot);
+         return (PF_NOMEM);
+      }
+      bufTable[slot].pData = (char *)frame;
+      bufTable[slot].size = size;
+   }
+
+   // Link slot at the head of the used list, out of the scan ring until
+   // the caller puts it there
+   bufTable[slot].bInRing = FALSE;
+   if ((rc = LinkHead(shard, slot)))
       return (rc);
 
    // Return ok
    return (0);
 }
 
+//
+// RingVictim
+//
+// Desc: Internal.  If the scan ring of a shard is full, take its oldest
+//       unpinned slot out of the ring and out of the replacement policy.
+//       The slot still holds its page.  The slots that left the ring
+//       since they joined it are forgotten on the way.
+// In:   shard - shard of the ring, latched by the caller
+// Out:  slot - set to the slot to recycle
+// Ret:  PF_NOBUF if the ring is not full or all its pages are pinned
+//
+RC PF_BufferMgr::RingVictim(PF_BufShard &shard, int &slot)
+{
+   deque<int> &ring = shard.ring;
+   ring.erase(remove_if(ring.begin(), ring.end(), [this](int s) {
+         return !bufTable[s].bInRing;
+      }), ring.end());
+
+   if ((int)ring.size() < shard.ringSize)
+      return (PF_NOBUF);
+
+   for (deque<int>::iterator it = ring.begin(); it != ring.end(); ++it)
+      if (bufTable[*it].pinCount == 0) {
+         slot = *it;
+         ring.erase(it);
+         bufTable[slot].bInRing = FALSE;
+         shard.pReplacer->Remove(slot - shard.base);
+         return (0);
+      }
+
+   return (PF_NOBUF);
+}
+
+//
+// JoinRing
+//
+// Desc: Internal.  Make a slot the newest of the scan ring of its shard
+// In:   shard - shard of the slot, latched by the caller
+//       slot - slot that was just filled by a scan
+//
+void PF_BufferMgr::JoinRing(PF_BufShard &shard, int slot)
+{
+   deque<int> &ring = shard.ring;
+   ring.erase(remove_if(ring.begin(), ring.end(), [this, slot](int s) {
+         return s == slot || !bufTable[s].bInRing;
+      }), ring.end());
+
+   ring.push_back(slot);
+   bufTable[slot].bInRing = TRUE;
+}
+
 //
 // ReadPage
 //
@@ -805,11 +1950,12 @@ RC PF_BufferMgr::InternalAlloc(int &slot)
 //
 // In:   fd - OS file descriptor
 //       pageNum - number of page to read
+//       pageSize - page size of the file
 //       dest - pointer to buffer in which to read page
 // Out:  dest - buffer contains page contents
 // Ret:  PF return code
 //
-RC PF_BufferMgr::ReadPage(int fd, PageNum pageNum, char *dest)
+RC PF_BufferMgr::ReadPage(int fd, PageNum pageNum, int pageSize, char *dest)
 {
 
 #ifdef PF_LOG
@@ -820,15 +1966,17 @@ RC PF_BufferMgr::ReadPage(int fd, PageNum pageNum, char *dest)
 
 #ifdef PF_STATS
    pStatisticsMgr->Register(PF_READPAGE, STAT_ADDONE);
+   StatTimer timer(pStatisticsMgr, PF_READPAGE_LATENCY);
 #endif
 
-   // seek to the appropriate place (cast to long for PC's)
-   long offset = pageNum * (long)pageSize + PF_FILE_HDR_SIZE;
-   if (lseek(fd, offset, L_SET) < 0)
-      return (PF_UNIX);
+   // The pages of a compressed file are wherever its map says
+   PF_PageMap *pPageMap = PageMapOf(fd);
+   if (pPageMap)
+      return (pPageMap->ReadPage(pageNum, dest));
 
-   // Read the data
-   int numBytes = read(fd, dest, pageSize);
+   // Read the data at the page offset (cast to long for PC's)
+   long offset = pageNum * (long)pageSize + PF_FILE_HDR_SIZE;
+   int numBytes = pread(fd, dest, pageSize, offset);
    if (numBytes < 0)
       return (PF_UNIX);
    else if (numBytes != pageSize)
@@ -844,53 +1992,476 @@ RC PF_BufferMgr::ReadPage(int fd, PageNum pageNum, char *dest)
 //
 // In:   fd - OS file descriptor
 //       pageNum - number of page to write
+//       pageSize - page size of the file
 //       dest - pointer to buffer containing page contents
 // Ret:  PF return code
 //
-RC PF_BufferMgr::WritePage(int fd, PageNum pageNum, char *source)
+RC PF_BufferMgr::WritePage(int fd, PageNum pageNum, int pageSize,
+                           char *source)
+{
+   struct iovec iov;
+   iov.iov_base = source;
+   iov.iov_len  = pageSize;
+   return (WritePages(fd, pageNum, &iov, 1));
+}
+
+//
+// WritePages
+//
+// Desc: Write adjacent pages to disk with one system call
+//
+// In:   fd - OS file descriptor
+//       pageNum - number of the first page to write
+//       iov - contents of the pages, one entry per page, each as long
+//             as the page size of the file
+//       numIov - number of pages, at most PF_MAX_WRITEV
+// Ret:  PF return code
+//
+RC PF_BufferMgr::WritePages(int fd, PageNum pageNum,
+                            const struct iovec *iov, int numIov)
 {
 
 #ifdef PF_LOG
    char psMessage[100];
-   sprintf (psMessage, "Writing (%d,%d).\n", fd, pageNum);
+   sprintf (psMessage, "Writing (%d,%d-%d).\n", fd, pageNum,
+            pageNum + numIov - 1);
    WriteLog(psMessage);
 #endif
 
 #ifdef PF_STATS
-   pStatisticsMgr->Register(PF_WRITEPAGE, STAT_ADDONE);
+   pStatisticsMgr->Register(PF_WRITEPAGE, STAT_ADDVALUE, &numIov);
+   pStatisticsMgr->Register(PF_WRITEV, STAT_ADDONE);
+   StatTimer timer(pStatisticsMgr, PF_WRITEPAGE_LATENCY);
 #endif
 
-   // seek to the appropriate place (cast to long for PC's)
-   long offset = pageNum * (long)pageSize + PF_FILE_HDR_SIZE;
-   if (lseek(fd, offset, L_SET) < 0)
-      return (PF_UNIX);
+   // The pages of a compressed file are compressed one by one
+   PF_PageMap *pPageMap = PageMapOf(fd);
+   if (pPageMap) {
+      RC rc;
+      for (int i = 0; i < numIov; i++)
+         if ((rc = pPageMap->WritePage(pageNum + i,
+               (const char *)iov[i].iov_base)))
+            return (rc);
+      return (0);
+   }
 
-   // Read the data
-   int numBytes = write(fd, source, pageSize);
+   // Write the data at the offset of the first page (cast to long for PC's)
+   long pageSize = iov[0].iov_len;
+   long offset = pageNum * pageSize + PF_FILE_HDR_SIZE;
+   ssize_t numBytes = pwritev(fd, iov, numIov, offset);
    if (numBytes < 0)
       return (PF_UNIX);
-   else if (numBytes != pageSize)
+   else if (numBytes != numIov * pageSize)
       return (PF_INCOMPLETEWRITE);
    else
       return (0);
 }
 
+//
+// PunchPages
+//
+// Desc: Punch adjacent pages that were disposed of out of the file, so
+//       that they take no disk space and read as zeros.  The sectors of
+//       the pages of a compressed file are given back to its map.  Where
+//       holes cannot be punched, the zeros are written instead.
+//
+// In:   fd - OS file descriptor
+//       pageNum - number of the first page
+//       iov - contents of the pages, zeros, as for WritePages
+//       numIov - number of pages
+// Ret:  PF return code
+//
+RC PF_BufferMgr::PunchPages(int fd, PageNum pageNum,
+                            const struct iovec *iov, int numIov)
+{
+#ifdef PF_STATS
+   pStatisticsMgr->Register(PF_PUNCHPAGE, STAT_ADDVALUE, &numIov);
+#endif
+
+   PF_PageMap *pPageMap = PageMapOf(fd);
+   if (pPageMap) {
+      RC rc;
+      for (int i = 0; i < numIov; i++)
+         if ((rc = pPageMap->FreePage(pageNum + i)))
+            return (rc);
+      return (0);
+   }
+
+   long pageSize = iov[0].iov_len;
+   long offset = pageNum * pageSize + PF_FILE_HDR_SIZE;
+   int err = PF_PunchHole(fd, offset, numIov * pageSize);
+   if (err == EOPNOTSUPP || err == ENOSYS)
+      return (WritePages(fd, pageNum, iov, numIov));
+   if (err) {
+      errno = err;
+      return (PF_UNIX);
+   }
+
+   // Return ok
+   return (0);
+}
+
 //
 // InitPageDesc
 //
 // Desc: Internal.  Initialize PF_BufPageDesc to a newly-pinned page
 //       for a newly pinned page
-// In:   fd - file descriptor
+// In:   shard - shard of the slot
+//       fd - file descriptor
 //       pageNum - page number
 // Ret:  PF return code
 //
-RC PF_BufferMgr::InitPageDesc(int fd, PageNum pageNum, int slot)
+RC PF_BufferMgr::InitPageDesc(PF_BufShard &shard, int fd, PageNum pageNum,
+      int slot)
 {
    // set the slot to refer to a newly-pinned page
    bufTable[slot].fd       = fd;
    bufTable[slot].pageNum  = pageNum;
    bufTable[slot].bDirty   = FALSE;
+   bufTable[slot].bHole    = FALSE;
    bufTable[slot].pinCount = 1;
+   bufTable[slot].readAhead = RA_NONE;
+
+   // The replacement policy starts tracking the page
+   shard.pReplacer->Insert(slot - shard.base, fd, pageNum);
+
+   // Return ok
+   return (0);
+}
+
+//
+// TakeShadow
+//
+// Desc: Internal.  Called when a page is put in a slot.  If the file of
+//       the page is logged, copy the page to the shadow of the slot,
+//       allocated if need be, or zero it for a new page; otherwise free
+//       the shadow.  The shard of the slot must be latched.
+// In:   fd - file descriptor of the page
+//       slot - slot of the page, pData holds it
+//       bZero - TRUE if the page is new
+// Ret:  PF_NOMEM or 0
+//
+RC PF_BufferMgr::TakeShadow(int fd, int slot, int bZero)
+{
+   PF_BufPageDesc &desc = bufTable[slot];
+
+   desc.pageLSN = 0;
+   if (fd == MEMORY_FD || !pLog->IsLogged(fd)) {
+      free(desc.pShadow);
+      desc.pShadow = NULL;
+      desc.shadowSize = 0;
+      return (0);
+   }
+
+   if (desc.shadowSize != desc.size) {
+      free(desc.pShadow);
+      desc.shadowSize = 0;
+      if (!(desc.pShadow = (char *)malloc(desc.size)))
+         return (PF_NOMEM);
+      desc.shadowSize = desc.size;
+   }
+
+   if (bZero)
+      memset(desc.pShadow, 0, desc.size);
+   else
+      memcpy(desc.pShadow, desc.pData, desc.size);
+
+   // Return ok
+   return (0);
+}
+
+//
+// LogSlots
+//
+// Desc: Internal.  Log the changes made to the pages of slots since they
+//       were last logged, and, so that they can be written, make the log
+//       durable up to the last record of any of them.  The pages of the
+//       files that are not logged are left alone.  The shards of the
+//       slots must be latched by the caller.
+// In:   slots - slots of the pages
+//       bFlush - FALSE to leave the records in the log buffer
+// Ret:  PF return code
+//
+RC PF_BufferMgr::LogSlots(const vector<int> &slots, int bFlush)
+{
+   RC   rc;
+   long lsn = 0;
+
+   for (size_t i = 0; i < slots.size(); i++) {
+      PF_BufPageDesc &desc = bufTable[slots[i]];
+      if (!desc.pShadow)
+         continue;
+      if ((rc = pLog->LogPage(desc.fd, desc.pageNum, desc.pShadow,
+            desc.pData, desc.size, desc.pageLSN)))
+         return (rc);
+      if (desc.pageLSN > lsn)
+         lsn = desc.pageLSN;
+   }
+
+   if (bFlush && lsn > 0)
+      return (pLog->Flush(lsn));
+
+   // Return ok
+   return (0);
+}
+
+//
+// Prefetch
+//
+// Desc: Internal.  Called after pageNum of fd was requested, without any
+//       shard latched.  If the request continues a sequence, read ahead
+//       the pages that follow it into slots taken from the free list of
+//       their shard, or from its replacement policy when there is none.
+//       The reads are done by pReadAhead; until they finish the slots are
+//       in the hash table but unknown to the replacement policy, so they
+//       cannot be chosen as victims.
+// In:   fd - file descriptor
+//       pageNum - page that was just requested
+//       pageSize - page size of the file
+//       numFilePages - # of pages in the file, the window stops there
+//       bMiss - TRUE if the page had to be read
+//
+void PF_BufferMgr::Prefetch(int fd, PageNum pageNum, int pageSize,
+      int numFilePages, int bMiss)
+{
+   if (readAheadWindow == 0)
+      return;
+
+   lock_guard<mutex> streamsLock(streamsMutex);
+
+   // A request that does not continue the sequence starts a new one
+   unordered_map<int, PF_ReadAheadStream>::iterator it = streams.find(fd);
+   if (it == streams.end() || it->second.next != pageNum) {
+      PF_ReadAheadStream stream = { pageNum + 1, pageNum };
+      streams[fd] = stream;
+      return;
+   }
+
+#ifdef PF_STATS
+   if (bMiss)
+      pStatisticsMgr->Register(PF_READAHEADMISS, STAT_ADDONE);
+#endif
+
+   PF_ReadAheadStream &stream = it->second;
+   stream.next = pageNum + 1;
+   if (stream.issued < pageNum)
+      stream.issued = pageNum;
+
+   // Keep the window full, but leave most of the buffer to the others,
+   // and do not read past the end of the file: the extent preallocated
+   // there reads as zeros
+   int window = readAheadWindow;
+   if (window > numPages / 2)
+      window = numPages / 2;
+   if (pageNum + window >= numFilePages)
+      window = numFilePages - 1 - pageNum;
+   while (stream.issued < pageNum + window) {
+      PageNum next = stream.issued + 1;
+
+      // Give up quietly if every page is pinned
+      if (StartRead(fd, next, pageSize))
+         return;
+      stream.issued = next;
+   }
+}
+
+//
+// StartRead
+//
+// Desc: Internal.  Unless it is in the buffer already, read a page in the
+//       background into a slot taken from the free list of its shard, or
+//       from its replacement policy when there is none.  Until the read
+//       finishes the slot is in the hash table but unknown to the
+//       replacement policy, so it cannot be chosen as a victim.  No shard
+//       may be latched by the caller.
+// In:   fd - file descriptor
+//       pageNum - page to read
+//       pageSize - page size of the file
+// Ret:  PF_NOBUF if all pages are pinned, other PF return code otherwise
+//
+RC PF_BufferMgr::StartRead(int fd, PageNum pageNum, int pageSize)
+{
+   RC  rc;
+   int slot;
+   PF_BufShard &shard = ShardOf(fd, pageNum);
+
+   // The image of a compressed page is read as it is stored, and
+   // decompressed by FinishRead.  A page never written is not worth it.
+   long offset = pageNum * (long)pageSize + PF_FILE_HDR_SIZE;
+   int  length = pageSize;
+   PF_PageMap *pPageMap = PageMapOf(fd);
+   if (pPageMap && pPageMap->Locate(pageNum, offset, length))
+      return (0);
+
+   unique_lock<mutex> lock(shard.latch);
+   if (shard.pHashTable->Find(fd, pageNum, slot) != PF_HASHNOTFOUND)
+      return (0);
+
+   // The latch may have been released to get a slot, and the page read
+   // meanwhile
+   if ((rc = InternalAlloc(shard, lock, slot, pageSize)))
+      return (rc);
+   int other;
+   if (shard.pHashTable->Find(fd, pageNum, other) != PF_HASHNOTFOUND) {
+      Unlink(shard, slot);
+      InsertFree(shard, slot);
+      return (0);
+   }
+   if ((rc = shard.pHashTable->Insert(fd, pageNum, slot))) {
+      Unlink(shard, slot);
+      InsertFree(shard, slot);
+      return (rc);
+   }
+
+   bufTable[slot].fd        = fd;
+   bufTable[slot].pageNum   = pageNum;
+   bufTable[slot].bDirty    = FALSE;
+   bufTable[slot].bHole     = FALSE;
+   bufTable[slot].pinCount  = 0;
+   bufTable[slot].readAhead = RA_PENDING;
+   lock.unlock();
+
+   // Nobody touches a pending slot but the helper thread
+   pReadAhead->Submit(slot, fd, offset, bufTable[slot].pData, length);
+
+#ifdef PF_STATS
+   pStatisticsMgr->Register(PF_READAHEAD, STAT_ADDONE);
+#endif
+
+   // Return ok
+   return (0);
+}
+
+//
+// PrefetchPages
+//
+// Desc: Read pages of a file into the buffer in the background, in the
+//       order given.  Used to warm the buffer up with the pages that were
+//       resident before a restart.  Stops quietly when every page of a
+//       shard is pinned.
+// In:   fd - file descriptor
+//       pages - pages to read, which must exist in the file
+//       pageSize - page size of the file
+// Ret:  PF return code
+//
+RC PF_BufferMgr::PrefetchPages(int fd, const vector<PageNum> &pages,
+      int pageSize)
+{
+   for (size_t i = 0; i < pages.size(); i++)
+      if (StartRead(fd, pages[i], pageSize))
+         break;
+
+   // Return ok
+   return (0);
+}
+
+//
+// GetResidentPages
+//
+// Desc: List the pages of a file that are in the buffer, hottest first:
+//       the pinned pages, then the others in the reverse of the order
+//       the replacement policies would evict them.  The policy of each
+//       shard only orders its own pages, so the shards are merged by the
+//       rank of the pages among the pages of their shard.  Pages still
+//       being read ahead are left out.
+// In:   fd - file descriptor
+// Out:  pages - the resident pages
+// Ret:  PF return code
+//
+RC PF_BufferMgr::GetResidentPages(int fd, vector<PageNum> &pages)
+{
+   // Hotness of each page, between 0 and 1, 2 for pinned pages
+   vector<pair<double, PageNum> > ranked;
+
+   for (int s = 0; s < numShards; s++) {
+      PF_BufShard &shard = shards[s];
+      lock_guard<mutex> lock(shard.latch);
+
+      for (int slot = shard.first; slot != INVALID_SLOT;
+            slot = bufTable[slot].next)
+         if (bufTable[slot].fd == fd && bufTable[slot].pinCount > 0)
+            ranked.push_back(make_pair(2.0, bufTable[slot].pageNum));
+
+      vector<int> cold(shard.numPages);
+      int n = shard.pReplacer->Coldest(bufTable + shard.base, &cold[0],
+            shard.numPages);
+      for (int i = 0; i < n; i++) {
+         int slot = shard.base + cold[i];
+         if (bufTable[slot].fd == fd)
+            ranked.push_back(make_pair((i + 1.0) / (n + 1.0),
+                                       bufTable[slot].pageNum));
+      }
+   }
+
+   sort(ranked.begin(), ranked.end(),
+        greater<pair<double, PageNum> >());
+   pages.clear();
+   for (size_t i = 0; i < ranked.size(); i++)
+      pages.push_back(ranked[i].second);
+
+   // Return ok
+   return (0);
+}
+
+//
+// FinishRead
+//
+// Desc: Internal.  Called on the helper thread when a read ahead into
+//       slot has finished.  A complete page is handed to the replacement
+//       policy, unpinned.  Otherwise (past the end of the file, or an
+//       error) the slot goes back to the free list.  The threads waiting
+//       for the page are woken up either way.  The image of a page of a
+//       compressed file is decompressed first.
+// In:   slot - slot of the read
+//       numBytes - result of the read
+//
+void PF_BufferMgr::FinishRead(int slot, int numBytes)
+{
+   PF_BufShard &shard = ShardOfSlot(slot);
+
+   // Nobody else touches the slot until it is installed
+   PF_PageMap *pPageMap = PageMapOf(bufTable[slot].fd);
+   if (pPageMap)
+      numBytes = pPageMap->Inflate(bufTable[slot].pageNum,
+            bufTable[slot].pData, numBytes);
+   lock_guard<mutex> lock(shard.latch);
+
+   if (numBytes == bufTable[slot].size &&
+         !TakeShadow(bufTable[slot].fd, slot, FALSE)) {
+      bufTable[slot].readAhead = RA_UNUSED;
+      shard.pReplacer->Insert(slot - shard.base, bufTable[slot].fd,
+            bufTable[slot].pageNum);
+      shard.pReplacer->Unpin(slot - shard.base);
+   }
+   else {
+      bufTable[slot].readAhead = RA_NONE;
+      shard.pHashTable->Delete(bufTable[slot].fd, bufTable[slot].pageNum);
+      Unlink(shard, slot);
+      InsertFree(shard, slot);
+   }
+   shard.readDone.notify_all();
+}
+
+//
+// DropReadAhead
+//
+// Desc: Internal.  Remove from the buffer a page that was read ahead and
+//       has not been requested.  Its read must be over.
+// In:   shard - shard of the slot, latched by the caller
+//       slot - slot of the page
+// Ret:  PF return code
+//
+RC PF_BufferMgr::DropReadAhead(PF_BufShard &shard, int slot)
+{
+   RC rc;
+
+   bufTable[slot].readAhead = RA_NONE;
+   shard.pReplacer->Remove(slot - shard.base);
+   if ((rc = shard.pHashTable->Delete(bufTable[slot].fd,
+         bufTable[slot].pageNum)) ||
+         (rc = Unlink(shard, slot)) ||
+         (rc = InsertFree(shard, slot)))
+      return (rc);
 
    // Return ok
    return (0);
@@ -900,18 +2471,16 @@ RC PF_BufferMgr::InitPageDesc(int fd, PageNum pageNum, int slot)
 // Methods for manipulating raw memory buffers
 //------------------------------------------------------------------------------
 
-#define MEMORY_FD -1
-
 //
 // GetBlockSize
 //
 // Return the size of the block that can be allocated.  This is simply
-// just the size of the page since a block will take up a page in the
-// buffer pool.
+// just the size of a default page since a block will take up a page in
+// the buffer pool.
 //
 RC PF_BufferMgr::GetBlockSize(int &length) const
 {
-   length = pageSize;
+   length = MEMORY_PAGE_SIZE;
    return OK_RC;
 }
 
@@ -921,26 +2490,29 @@ RC PF_BufferMgr::GetBlockSize(int &length) const
 //
 // Allocates a page in the buffer pool that is not associated with a
 // particular file and returns the pointer to the data area back to the
-// user.
+// user.  Blocks are taken from the first shard.
 //
 RC PF_BufferMgr::AllocateBlock(char *&buffer)
 {
    RC rc = OK_RC;
+   PF_BufShard &shard = shards[0];
+   unique_lock<mutex> lock(shard.latch);
 
    // Get an empty slot from the buffer pool
    int slot;
-   if ((rc = InternalAlloc(slot)) != OK_RC)
+   if ((rc = InternalAlloc(shard, lock, slot, MEMORY_PAGE_SIZE)) != OK_RC)
       return rc;
 
    // Create artificial page number (just needs to be unique for hash table)
    PageNum pageNum = bufTable[slot].pData - (char*)0;
+   TakeShadow(MEMORY_FD, slot, FALSE);
 
    // Insert the page into the hash table, and initialize the page description entry
-   if ((rc = hashTable.Insert(MEMORY_FD, pageNum, slot) != OK_RC) ||
-         (rc = InitPageDesc(MEMORY_FD, pageNum, slot)) != OK_RC) {
+   if ((rc = shard.pHashTable->Insert(MEMORY_FD, pageNum, slot) != OK_RC) ||
+         (rc = InitPageDesc(shard, MEMORY_FD, pageNum, slot)) != OK_RC) {
       // Put the slot back on the free list before returning the error
-      Unlink(slot);
-      InsertFree(slot);
+      Unlink(shard, slot);
+      InsertFree(shard, slot);
       return rc;
    }
 
@@ -10,13 +10,89 @@
 // 1998: Allow chunks from the buffer manager to not be associated with
 // a particular file.  Allows students to use main memory chunks that
 // are associated with (and limited by) the buffer.
+// The choice of the page to replace is delegated to a PF_Replacer, so the
+// used list only records which slots are resident, not their recency.
+// Dirty pages are written back in page order, adjacent pages with a
+// single pwritev, and pages are read with pread so there are no seeks.
+// When a file is read sequentially the next pages are read ahead into
+// free slots by a PF_ReadAhead helper thread.
+// Files may have different page sizes.  A frame is allocated with the
+// size of the page it holds, and reallocated when a slot is reused for a
+// page of another size.
+// The frames of MEMORY_PAGE_SIZE bytes are carved out of a PF_FrameArena,
+// possibly on huge pages, apart from the buffer table; frames of other
+// sizes are allocated one by one.  The buffer table only holds the page
+// descriptors, so walking it stays cheap.
+//
+// The buffer manager may be used by several threads.  The slots are
+// partitioned into shards, and a page always lives in the shard its
+// (fd, pageNum) hashes to.  Each shard has its own latch, page table,
+// used and free lists and replacement policy, so threads working on
+// pages of different shards do not wait for each other.  Operations that
+// concern a whole file (FlushPages, ForcePages, ClearBuffer) latch every
+// shard, in shard order.  ResizeBuffer must not run concurrently with any
+// other call.  Besides the pin count, every frame has a read/write latch
+// that the clients sharing a page take with LatchPage.
+//
+// A background writer thread can take dirty page writes off the
+// foreground.  It keeps the pages the replacement policies would evict
+// next clean, so that a miss seldom has to write its victim first, and
+// it takes incremental checkpoints: the dirty unpinned pages are written
+// in page order, a batch at a time, so that a later ForcePages or
+// FlushPages only waits for what is still outstanding.  Write errors in
+// the background are ignored; the page stays dirty and the error shows up
+// in the foreground.
+//
+// Pages requested with the SEQUENTIAL_SCAN hint are read into a small
+// ring of slots in each shard.  Once the ring is full, the slot of its
+// oldest unpinned page is recycled for the next page of a scan instead of
+// asking the replacement policy for a victim, so a full scan of a large
+// file only ever takes PF_SCAN_RING_PAGES slots and leaves the hot pages
+// alone.  A ring page that is requested without the hint leaves the ring
+// and is replaced like any other page.  RANDOM_LOOKUP requests are never
+// read ahead of.
+//
+// Writing pages does not make them durable.  ForcePages hands the file to
+// a PF_GroupCommit, and Commit syncs the forced files, once each, at the
+// end of a statement.
+//
+// The pages of a compressed file are read and written through the
+// PF_PageMap of the file, one at a time.  A page read ahead is read as it
+// is stored into its frame, and decompressed there when the read is over.
+//
+// A page disposed of is zeroed in the buffer, and punched out of its file
+// instead of being written back, so that free pages take no disk space.
+// The free pages at the end of a file can be dropped from the buffer
+// without being written, so that the file can be truncated.
+//
+// While a write-ahead log is open, every page of a logged file has a
+// shadow copy of itself as it was last logged.  The changes are logged
+// at a commit, and before the page is written back, and the log is made
+// durable up to the last record of the page first.  Commit then only
+// syncs the log.  CheckpointLog writes every logged page back, syncs the
+// files, and truncates the log.
 //
 
 #ifndef PF_BUFFERMGR_H
 #define PF_BUFFERMGR_H
 
+#include <sys/uio.h>
+#include <pthread.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <deque>
+#include <unordered_map>
 #include "pf_internal.h"
 #include "pf_hashtable.h"
+#include "pf_replacer.h"
+#include "pf_readahead.h"
+#include "pf_arena.h"
+#include "pf_groupcommit.h"
+#include "pf_pagemap.h"
+#include "pf_log.h"
 
 //
 // Defines
@@ -28,17 +104,62 @@
 // next.
 #define INVALID_SLOT  (-1)
 
+// Values of PF_BufPageDesc::readAhead
+#define RA_NONE       0   // page was requested since it was read
+#define RA_PENDING    1   // page is being read ahead
+#define RA_UNUSED     2   // page was read ahead and not requested yet
+
 //
 // PF_BufPageDesc - struct containing data about a page in the buffer
 //
+// All the fields but pinCount are protected by the latch of the shard the
+// slot belongs to.  pinCount is only changed under that latch too, but may
+// be read without it.
+//
 struct PF_BufPageDesc {
-    char       pData [MEMORY_PAGE_SIZE]; // page contents
-    int        next;        // next in the linked list of buffer pages
-    int        prev;        // prev in the linked list of buffer pages
+    char       *pData;      // page contents, NULL until the slot is used
+    int        size;        // # of bytes at pData
+    int        next;        // next in the used or free list
+    int        prev;        // prev in the used list
     int        bDirty;      // TRUE if page is dirty
-    short int  pinCount;    // pin count
+    std::atomic<short> pinCount;  // pin count
+    short int  readAhead;   // RA_NONE, RA_PENDING or RA_UNUSED
+    short int  bInRing;     // TRUE if the slot belongs to the scan ring
+    short int  bHole;       // TRUE if the page was disposed of: it is
+                            // zeros, and is punched out of the file
+                            // instead of written
+    short int  bInIO;       // TRUE while the page is read in or written
+                            // out without the latch of the shard
     PageNum    pageNum;     // page number for this page
     int        fd;          // OS file descriptor of this page
+    char       *pShadow;    // page as last logged, NULL if its file is
+                            // not logged
+    int        shadowSize;  // # of bytes at pShadow
+    long       pageLSN;     // LSN of the last log record of the page
+};
+
+//
+// PF_BufShard - a partition of the buffer
+//
+// The shard owns the slots base to base + numPages - 1.  Slots are
+// numbered over the whole buffer; the replacement policy of the shard
+// numbers them from 0.
+//
+struct PF_BufShard {
+    std::mutex     latch;                         // protects the shard
+    std::condition_variable readDone;             // a read ahead into the
+                                                  // shard, or a page I/O
+                                                  // of it, has finished
+    int            numInIO;                       // # of slots in I/O
+    PF_HashTable   *pHashTable;                   // pages of the shard
+    PF_Replacer    *pReplacer;                    // replacement policy
+    int            base;                          // first slot
+    int            numPages;                      // # of slots
+    int            first;                         // head of used list
+    int            last;                          // tail of used list
+    int            free;                          // head of free list
+    std::deque<int> ring;                         // scan ring, oldest first
+    int            ringSize;                      // # of slots of the ring
 };
 
 //
@@ -47,23 +168,55 @@ struct PF_BufPageDesc {
 class PF_BufferMgr {
 public:
 
-    PF_BufferMgr     (int numPages);             // Constructor - allocate
+    PF_BufferMgr     (int numPages,              // Constructor - allocate
+                      PF_ReplacementPolicy policy = PF_LRU);
                                                   // numPages buffer pages
     ~PF_BufferMgr    ();                         // Destructor
 
-    // Read pageNum into buffer, point *ppBuffer to location
-    RC  GetPage      (int fd, PageNum pageNum, char **ppBuffer,
-                      int bMultiplePins = TRUE);
+    // Read pageNum into buffer, point *ppBuffer to location.  pageSize
+    // is the page size of the file, PF_PageHdr included, and the file
+    // has numFilePages pages, 0 if nothing is to be read ahead.
+    RC  GetPage      (int fd, PageNum pageNum, int pageSize,
+                      char **ppBuffer, int bMultiplePins = TRUE,
+                      ClientHint hint = NO_HINT, int numFilePages = 0);
     // Allocate a new page in the buffer, point *ppBuffer to its location
-    RC  AllocatePage (int fd, PageNum pageNum, char **ppBuffer);
+    RC  AllocatePage (int fd, PageNum pageNum, int pageSize,
+                      char **ppBuffer);
 
     RC  MarkDirty    (int fd, PageNum pageNum);  // Mark page dirty
+
+    // Zero a pinned page that is disposed of, and have it punched out of
+    // the file instead of written back
+    RC  DisposePage  (int fd, PageNum pageNum);
+    // Throw the pages of fd from pageNum on away, without writing them,
+    // so that the file can be truncated.  They must be free.
+    RC  DropPages    (int fd, PageNum pageNum);
     RC  UnpinPage    (int fd, PageNum pageNum);  // Unpin page from the buffer
     RC  FlushPages   (int fd);                   // Flush pages for file
 
     // Force a page to the disk, but do not remove from the buffer pool
     RC ForcePages    (int fd, PageNum pageNum);
 
+    // Make the forced pages durable, and choose how
+    RC Commit        ();
+    RC SetDurability (PF_Durability mode);
+    RC SetGroupCommitWindow (int msecs);
+    RC SetGroupCommitSize   (int maxGroup);
+
+    // Read and write the pages of fd through pPageMap from now on, or
+    // again in place if it is NULL
+    void SetPageMap  (int fd, PF_PageMap *pPageMap);
+
+    // The write-ahead log, and how to write every logged page back and
+    // truncate it, or to stop logging
+    PF_Log *GetLog   () const { return pLog; }
+    RC CheckpointLog ();
+    RC CloseLog      ();
+
+    // Latch the contents of a pinned page, shared or exclusive, and
+    // release the latch
+    RC  LatchPage    (int fd, PageNum pageNum, int bExclusive);
+    RC  UnlatchPage  (int fd, PageNum pageNum);
 
     // Remove all entries from the Buffer Manager.
     RC  ClearBuffer  ();
@@ -72,6 +225,25 @@ public:
 
     // Attempts to resize the buffer to the new size
     RC ResizeBuffer  (int iNewSize);
+    // Number of pages in the buffer
+    int GetNumPages  () const { return numPages; }
+
+    // Replace the replacement policy
+    RC SetReplacementPolicy (PF_ReplacementPolicy policy);
+
+    // Read up to numPages pages ahead of sequential reads, 0 to disable
+    RC SetReadAhead  (int numPages);
+
+    // List the pages of a file in the buffer, hottest first, and read
+    // pages of a file into the buffer in the background, in that order
+    RC GetResidentPages (int fd, std::vector<PageNum> &pages);
+    RC PrefetchPages (int fd, const std::vector<PageNum> &pages,
+                      int pageSize);
+
+    // Keep numPages pages clean at the cold end of the buffer, and take a
+    // checkpoint every msecs milliseconds, in the background.  0 disables.
+    RC SetBackgroundWriter   (int numPages);
+    RC SetCheckpointInterval (int msecs);
 
     // Three Methods for manipulating raw memory buffers.  These memory
     // locations are handled by the buffer manager, but are not
@@ -87,27 +259,122 @@ public:
     RC DisposeBlock  (char *buffer);
 
 private:
-    RC  InsertFree   (int slot);                 // Insert slot at head of free
-    RC  LinkHead     (int slot);                 // Insert slot at head of used
-    RC  Unlink       (int slot);                 // Unlink slot
-    RC  InternalAlloc(int &slot);                // Get a slot to use
+    // Build the buffer table, the frame arena and the shards for numPages
+    // pages, and free them
+    void MakeShards  ();
+    void FreeShards  ();
+
+    // Shard of a page, and shard a slot belongs to
+    PF_BufShard &ShardOf     (int fd, PageNum pageNum) const;
+    PF_BufShard &ShardOfSlot (int slot) const;
+
+    void LockAll     ();                         // Latch every shard,
+                                                 // once its I/O is over
+    void UnlockAll   ();
+
+    RC  InsertFree   (PF_BufShard &shard, int slot);  // Insert slot at head
+                                                      // of free
+    RC  LinkHead     (PF_BufShard &shard, int slot);  // Insert slot at head
+                                                      // of used
+    RC  Unlink       (PF_BufShard &shard, int slot);  // Unlink slot
+    // Get a slot to use.  The latch held by lock is released while the
+    // page the slot held is written out.
+    RC  InternalAlloc(PF_BufShard &shard, std::unique_lock<std::mutex> &lock,
+                      int &slot, int size, int bScan = FALSE);
+
+    // Mark a slot in I/O before the latch of its shard is released, and
+    // not in I/O once it is taken again
+    void StartIO     (PF_BufShard &shard, int slot);
+    void EndIO       (PF_BufShard &shard, int slot);
+
+    // Take the oldest unpinned slot of the scan ring out of it, and add
+    // a slot to the ring
+    RC  RingVictim   (PF_BufShard &shard, int &slot);
+    void JoinRing    (PF_BufShard &shard, int slot);
+
+    // Page map of fd, NULL if its pages are stored in place
+    PF_PageMap *PageMapOf (int fd);
+
+    // Give slot the shadow copy of the page of fd just put in it, zeroed
+    // if the page is new, if fd is logged
+    RC  TakeShadow   (int fd, int slot, int bZero);
+    // Log the changes to the pages of slots, and make the log durable up
+    // to their last record so that they can be written.  Their shards
+    // must be latched.
+    RC  LogSlots     (const std::vector<int> &slots, int bFlush = TRUE);
 
     // Read a page
-    RC  ReadPage     (int fd, PageNum pageNum, char *dest);
+    RC  ReadPage     (int fd, PageNum pageNum, int pageSize, char *dest);
 
     // Write a page
-    RC  WritePage    (int fd, PageNum pageNum, char *source);
+    RC  WritePage    (int fd, PageNum pageNum, int pageSize, char *source);
+
+    // Write numIov adjacent pages starting at pageNum
+    RC  WritePages   (int fd, PageNum pageNum,
+                      const struct iovec *iov, int numIov);
+
+    // Punch numIov adjacent pages disposed of out of the file, or write
+    // their zeros where holes cannot be punched
+    RC  PunchPages   (int fd, PageNum pageNum,
+                      const struct iovec *iov, int numIov);
+
+    // Write the dirty pages of a file in page order, coalescing runs.
+    // Every shard must be latched.
+    RC  WriteBack    (int fd, PageNum pageNum, int bPinned);
+
+    // Write the pages of slots in page order, coalescing runs, and mark
+    // them clean.  Their shards must be latched.
+    RC  WriteSlots   (std::vector<int> &slots);
 
     // Init the page desc entry
-    RC  InitPageDesc (int fd, PageNum pageNum, int slot);
+    RC  InitPageDesc (PF_BufShard &shard, int fd, PageNum pageNum, int slot);
+
+    // Read ahead of a request for pageNum if fd is read sequentially
+    void Prefetch    (int fd, PageNum pageNum, int pageSize,
+                      int numFilePages, int bMiss);
+    // Read a page in the background unless it is in the buffer
+    RC   StartRead   (int fd, PageNum pageNum, int pageSize);
+    // Install or drop the page read ahead into slot, called by pReadAhead
+    void FinishRead  (int slot, int numBytes);
+    // Throw away an unused page that was read ahead
+    RC   DropReadAhead (PF_BufShard &shard, int slot);
+
+    // Start or stop the background writer as its settings require, and
+    // stop it for good
+    void UpdateWriter ();
+    void StopWriter  ();
+    void RunWriter   ();                         // Writer thread body
+    // Write the dirty pages among the numPages coldest ones of a shard
+    void CleanShard  (PF_BufShard &shard, int numPages);
+    void Checkpoint  ();                         // Write every dirty page
 
     PF_BufPageDesc *bufTable;                     // info on buffer pages
-    PF_HashTable   hashTable;                     // Hash table object
+    PF_FrameArena  *pArena;                       // MEMORY_PAGE_SIZE frames
+    pthread_rwlock_t *latches;                    // latch of each frame,
+                                                  // taken by the clients
+                                                  // reading or writing it
+    PF_BufShard    *shards;                       // partitions of bufTable
+    int            numShards;                     // # of shards
+    PF_ReplacementPolicy policy;                  // policy of every shard
+    PF_ReadAhead   *pReadAhead;                   // read-ahead I/O
+    PF_GroupCommit *pGroupCommit;                 // syncs the forced files
+    PF_Log         *pLog;                         // write-ahead log
+    std::atomic<int> readAheadWindow;             // # of pages read ahead
+    std::mutex     streamsMutex;                  // protects streams
+    std::unordered_map<int, PF_ReadAheadStream> streams;
+                                                  // per fd access state
+    std::mutex     pageMapsMutex;                 // protects pageMaps
+    std::unordered_map<int, PF_PageMap *> pageMaps;
+                                                  // of compressed files
     int            numPages;                      // # of pages in the buffer
-    int            pageSize;                      // Size of pages in the buffer
-    int            first;                         // MRU page slot
-    int            last;                          // LRU page slot
-    int            free;                          // head of free list
+
+    std::thread    writer;                        // background writer
+    std::mutex     writerMutex;                   // protects what follows
+    std::condition_variable writerCond;           // settings changed
+    std::atomic<int> bStopWriter;                 // ask the writer to exit
+    int            cleanTarget;                   // # of cold pages kept
+                                                  // clean, 0 for none
+    int            checkpointInterval;            // msecs, 0 for none
 };
 
 #endif
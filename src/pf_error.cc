@@ -25,7 +25,8 @@ static char *PF_WarnMsg[] = {
   (char*)"page already unpinned",
   (char*)"end of file",
   (char*)"attempting to resize the buffer too small",
-  (char*)"invalid filename"
+  (char*)"file is opened read only",
+  (char*)"invalid page size"
 };
 
 static char *PF_ErrorMsg[] = {
@@ -5,10 +5,18 @@
 //              Dallan Quass (quass@cs.stanford.edu)
 //
 
+#include <cerrno>
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include "pf_internal.h"
 #include "pf_buffermgr.h"
+#include "pf_allocbitmap.h"
+#include "pf_pagemap.h"
+#include "statistics.h"
+
+// This is defined within pf_buffermgr.cc
+extern StatisticsMgr *pStatisticsMgr;
 
 //
 // PF_FileHandle
@@ -22,12 +30,28 @@
 //       A file handle object contains a pointer to the file data stored
 //       in the file table managed by PF_Manager.  It passes the file's unix
 //       file descriptor to the buffer manager to access pages of the file.
+//       A file opened in PF_MMAP_READONLY mode does not use the buffer
+//       manager: its pages are handed out from a read-only mapping of the
+//       file, and the handle counts the pins itself.
+//       Which pages are in use is kept in an allocation bitmap, so that
+//       free pages are never read to find out that they are free.
+//       The file grows by extents of several pages, preallocated at once.
+//       The pages of a compressed file are found through its page map.
+//       A page disposed of is punched out of the file when it is written
+//       back, and a free page reads as zeros.  Shrink gives the free pages
+//       at the end of the file back to the file system.
 //
 PF_FileHandle::PF_FileHandle()
 {
    // Initialize local variables
    bFileOpen = FALSE;
    pBufferMgr = NULL;
+   pMap = NULL;
+   mapSize = 0;
+   pinCounts = NULL;
+   pAllocBitmap = NULL;
+   extentPages = 0;
+   pPageMap = NULL;
 }
 
 //
@@ -56,6 +80,12 @@ PF_FileHandle::PF_FileHandle(const PF_FileHandle &fileHandle)
    this->bFileOpen   = fileHandle.bFileOpen;
    this->bHdrChanged = fileHandle.bHdrChanged;
    this->unixfd      = fileHandle.unixfd;
+   this->pMap        = fileHandle.pMap;
+   this->mapSize     = fileHandle.mapSize;
+   this->pinCounts   = fileHandle.pinCounts;
+   this->pAllocBitmap = fileHandle.pAllocBitmap;
+   this->extentPages = fileHandle.extentPages;
+   this->pPageMap    = fileHandle.pPageMap;
 }
 
 //
@@ -78,6 +108,12 @@ PF_FileHandle& PF_FileHandle::operator= (const PF_FileHandle &fileHandle)
       this->bFileOpen   = fileHandle.bFileOpen;
       this->bHdrChanged = fileHandle.bHdrChanged;
       this->unixfd      = fileHandle.unixfd;
+      this->pMap        = fileHandle.pMap;
+      this->mapSize     = fileHandle.mapSize;
+      this->pinCounts   = fileHandle.pinCounts;
+      this->pAllocBitmap = fileHandle.pAllocBitmap;
+      this->extentPages = fileHandle.extentPages;
+      this->pPageMap    = fileHandle.pPageMap;
    }
 
    // Return a reference to this
@@ -89,13 +125,15 @@ PF_FileHandle& PF_FileHandle::operator= (const PF_FileHandle &fileHandle)
 //
 // Desc: Get the first page in a file
 //       The file handle must refer to an open file
+// In:   hint - how the page is accessed, passed to the buffer manager
 // Out:  pageHandle - becomes a handle to the first page of the file
 //       The referenced page is pinned in the buffer pool.
 // Ret:  PF return code
 //
-RC PF_FileHandle::GetFirstPage(PF_PageHandle &pageHandle) const
+RC PF_FileHandle::GetFirstPage(PF_PageHandle &pageHandle,
+      ClientHint hint) const
 {
-   return (GetNextPage((PageNum)-1, pageHandle));
+   return (GetNextPage((PageNum)-1, pageHandle, hint));
 }
 
 //
@@ -119,14 +157,14 @@ RC PF_FileHandle::GetLastPage(PF_PageHandle &pageHandle) const
 //       The file handle must refer to an open file
 // In:   current - get the next valid page after this page number
 //       current can refer to a page that has been disposed
+//       hint - how the page is accessed, passed to the buffer manager
 // Out:  pageHandle - becomes a handle to the next page of the file
 //       The referenced page is pinned in the buffer pool.
 // Ret:  PF_EOF, or another PF return code
 //
-RC PF_FileHandle::GetNextPage(PageNum current, PF_PageHandle &pageHandle) const
+RC PF_FileHandle::GetNextPage(PageNum current, PF_PageHandle &pageHandle,
+      ClientHint hint) const
 {
-   int rc;               // return code
-
    // File must be open
    if (!bFileOpen)
       return (PF_CLOSEDFILE);
@@ -135,20 +173,11 @@ RC PF_FileHandle::GetNextPage(PageNum current, PF_PageHandle &pageHandle) const
    if (current != -1 &&  !IsValidPageNum(current))
       return (PF_INVALIDPAGE);
 
-   // Scan the file until a valid used page is found
-   for (current++; current < hdr.numPages; current++) {
-
-      // If this is a valid (used) page, we're done
-      if (!(rc = GetThisPage(current, pageHandle)))
-         return (0);
-
-      // If unexpected error, return it
-      if (rc != PF_INVALIDPAGE)
-         return (rc);
-   }
+   // Look up the next used page in the allocation bitmap
+   if ((current = pAllocBitmap->NextUsed(current)) < 0)
+      return (PF_EOF);
 
-   // No valid (used) page found
-   return (PF_EOF);
+   return (GetThisPage(current, pageHandle, hint));
 }
 
 //
@@ -164,8 +193,6 @@ RC PF_FileHandle::GetNextPage(PageNum current, PF_PageHandle &pageHandle) const
 //
 RC PF_FileHandle::GetPrevPage(PageNum current, PF_PageHandle &pageHandle) const
 {
-   int rc;               // return code
-
    // File must be open
    if (!bFileOpen)
       return (PF_CLOSEDFILE);
@@ -174,20 +201,11 @@ RC PF_FileHandle::GetPrevPage(PageNum current, PF_PageHandle &pageHandle) const
    if (current != hdr.numPages &&  !IsValidPageNum(current))
       return (PF_INVALIDPAGE);
 
-   // Scan the file until a valid used page is found
-   for (current--; current >= 0; current--) {
-
-      // If this is a valid (used) page, we're done
-      if (!(rc = GetThisPage(current, pageHandle)))
-         return (0);
+   // Look up the previous used page in the allocation bitmap
+   if ((current = pAllocBitmap->PrevUsed(current)) < 0)
+      return (PF_EOF);
 
-      // If unexpected error, return it
-      if (rc != PF_INVALIDPAGE)
-         return (rc);
-   }
-
-   // No valid (used) page found
-   return (PF_EOF);
+   return (GetThisPage(current, pageHandle));
 }
 
 //
@@ -196,12 +214,17 @@ RC PF_FileHandle::GetPrevPage(PageNum current, PF_PageHandle &pageHandle) const
 // Desc: Get a specific page in a file
 //       The file handle must refer to an open file
 // In:   pageNum - the number of the page to get
+//       hint - how the page is accessed: SEQUENTIAL_SCAN pages are kept
+//       from pushing other pages out of the buffer, RANDOM_LOOKUP pages
+//       are not read ahead of.  Ignored for a mapped file.
 // Out:  pageHandle - becomes a handle to the this page of the file
 //                    this function modifies local var's in pageHandle
-//       The referenced page is pinned in the buffer pool.
+//       The referenced page is pinned in the buffer pool, or in the
+//       mapping for a PF_MMAP_READONLY file.
 // Ret:  PF return code
 //
-RC PF_FileHandle::GetThisPage(PageNum pageNum, PF_PageHandle &pageHandle) const
+RC PF_FileHandle::GetThisPage(PageNum pageNum, PF_PageHandle &pageHandle,
+      ClientHint hint) const
 {
    int  rc;               // return code
    char *pPageBuf;        // address of page in buffer pool
@@ -210,12 +233,17 @@ RC PF_FileHandle::GetThisPage(PageNum pageNum, PF_PageHandle &pageHandle) const
    if (!bFileOpen)
       return (PF_CLOSEDFILE);
 
-   // Validate page number
-   if (!IsValidPageNum(pageNum))
+   // Validate page number, and do not bother reading a free page
+   if (!IsValidPageNum(pageNum) || !pAllocBitmap->IsUsed(pageNum))
       return (PF_INVALIDPAGE);
 
-   // Get this page from the buffer manager
-   if ((rc = pBufferMgr->GetPage(unixfd, pageNum, &pPageBuf)))
+   // Point into the mapping, or get this page from the buffer manager
+   if (pMap) {
+      pPageBuf = MappedPage(pageNum);
+      pinCounts[pageNum]++;
+   }
+   else if ((rc = pBufferMgr->GetPage(unixfd, pageNum, hdr.pageSize,
+         &pPageBuf, TRUE, hint, hdr.numPages)))
       return (rc);
 
    // If the page is valid, then set pageHandle to this page and return ok
@@ -224,6 +252,7 @@ RC PF_FileHandle::GetThisPage(PageNum pageNum, PF_PageHandle &pageHandle) const
       // Set the pageHandle local variables
       pageHandle.pageNum = pageNum;
       pageHandle.pPageData = pPageBuf + sizeof(PF_PageHdr);
+      pageHandle.pageSize = hdr.pageSize - sizeof(PF_PageHdr);
 
       // Return ok
       return (0);
@@ -256,42 +285,57 @@ RC PF_FileHandle::AllocatePage(PF_PageHandle &pageHandle)
    if (!bFileOpen)
       return (PF_CLOSEDFILE);
 
-   // If the free list isn't empty...
-   if (hdr.firstFree != PF_PAGE_LIST_END) {
-      pageNum = hdr.firstFree;
+   // A mapped file cannot be changed
+   if (pMap)
+      return (PF_READONLY);
 
-      // Get the first free page into the buffer
+   // If the file has a free page, reuse the first one
+   if ((pageNum = pAllocBitmap->FirstFree()) >= 0) {
+
+      // Get the free page into the buffer
       if ((rc = pBufferMgr->GetPage(unixfd,
             pageNum,
+            hdr.pageSize,
             &pPageBuf)))
          return (rc);
-
-      // Set the first free page to the next page on the free list
-      hdr.firstFree = ((PF_PageHdr*)pPageBuf)->nextFree;
    }
    else {
 
-      // The free list is empty...
+      // Every page is used...
       pageNum = hdr.numPages;
 
+      // ...and the next one may be a bitmap page, which only needs to be
+      // counted in the file
+      if (pAllocBitmap->IsReserved(pageNum))
+         pageNum++;
+
+      // Preallocate more pages once the tail of the file is used up
+      if (extentPages > 0 && pageNum >= hdr.numAllocated &&
+            (rc = Extend()))
+         return (rc);
+
       // Allocate a new page in the file
       if ((rc = pBufferMgr->AllocatePage(unixfd,
             pageNum,
+            hdr.pageSize,
             &pPageBuf)))
          return (rc);
 
       // Increment the number of pages for this file
-      hdr.numPages++;
+      hdr.numPages = pageNum + 1;
+      pAllocBitmap->Resize(hdr.numPages);
    }
 
-   // Mark the header as changed
+   // Mark the page used in the header
+   pAllocBitmap->SetUsed(pageNum);
    bHdrChanged = TRUE;
 
    // Mark this page as used
    ((PF_PageHdr *)pPageBuf)->nextFree = PF_PAGE_USED;
 
    // Zero out the page data
-   memset(pPageBuf + sizeof(PF_PageHdr), 0, PF_PAGE_SIZE);
+   memset(pPageBuf + sizeof(PF_PageHdr), 0,
+         hdr.pageSize - sizeof(PF_PageHdr));
 
    // Mark the page dirty because we changed the next pointer
    if ((rc = MarkDirty(pageNum)))
@@ -300,6 +344,7 @@ RC PF_FileHandle::AllocatePage(PF_PageHandle &pageHandle)
    // Set the pageHandle local variables
    pageHandle.pageNum = pageNum;
    pageHandle.pPageData = pPageBuf + sizeof(PF_PageHdr);
+   pageHandle.pageSize = hdr.pageSize - sizeof(PF_PageHdr);
 
    // Return ok
    return (0);
@@ -312,6 +357,8 @@ RC PF_FileHandle::AllocatePage(PF_PageHandle &pageHandle)
 //       The file handle must refer to an open file
 //       PF_PageHandle objects referring to this page should not be used
 //       after making this call.
+//       The page is zeroed, which marks it free in its header, and the
+//       buffer manager punches it out of the file instead of writing it.
 // In:   pageNum - number of page to dispose
 // Ret:  PF return code
 //
@@ -328,31 +375,30 @@ RC PF_FileHandle::DisposePage(PageNum pageNum)
    if (!IsValidPageNum(pageNum))
       return (PF_INVALIDPAGE);
 
+   // A mapped file cannot be changed
+   if (pMap)
+      return (PF_READONLY);
+
+   // Page must be valid (used)
+   if (!pAllocBitmap->IsUsed(pageNum))
+      return (PF_PAGEFREE);
+
    // Get the page (but don't re-pin it if it's already pinned)
    if ((rc = pBufferMgr->GetPage(unixfd,
          pageNum,
+         hdr.pageSize,
          &pPageBuf,
          FALSE)))
       return (rc);
 
-   // Page must be valid (used)
-   if (((PF_PageHdr *)pPageBuf)->nextFree != PF_PAGE_USED) {
-
-      // Unpin the page
-      if ((rc = UnpinPage(pageNum)))
-         return (rc);
-
-      // Return page already free
-      return (PF_PAGEFREE);
-   }
-
-   // Put this page onto the free list
-   ((PF_PageHdr *)pPageBuf)->nextFree = hdr.firstFree;
-   hdr.firstFree = pageNum;
+   // Mark this page free, in its header too for the pages that do not fit
+   // in the bitmap of the file header: a zero nextFree is not
+   // PF_PAGE_USED
+   pAllocBitmap->SetFree(pageNum);
    bHdrChanged = TRUE;
 
-   // Mark the page dirty because we changed the next pointer
-   if ((rc = MarkDirty(pageNum)))
+   // Zero the page and have it punched out of the file
+   if ((rc = pBufferMgr->DisposePage(unixfd, pageNum)))
       return (rc);
 
    // Unpin the page
@@ -363,6 +409,55 @@ RC PF_FileHandle::DisposePage(PageNum pageNum)
    return (0);
 }
 
+//
+// Shrink
+//
+// Desc: Give the free pages at the end of the file, and the extent
+//       preallocated past them, back to the file system.  The pages are
+//       dropped from the buffer without being written, the header is
+//       written with the new number of pages, and the file is truncated.
+//       Compacting a file first moves its used pages to the front.
+//       The file handle must refer to an open file
+// Ret:  PF_PAGEPINNED if one of the free pages is pinned, or other PF
+//       return code
+//
+RC PF_FileHandle::Shrink()
+{
+   RC rc;
+
+   // File must be open
+   if (!bFileOpen)
+      return (PF_CLOSEDFILE);
+
+   // A mapped file cannot be changed
+   if (pMap)
+      return (PF_READONLY);
+
+   // The file ends with its last used page
+   PageNum numPages = pAllocBitmap->PrevUsed(hdr.numPages) + 1;
+   long fileSize = PF_FILE_HDR_SIZE + numPages * (long)hdr.pageSize;
+
+   if ((rc = pBufferMgr->DropPages(unixfd, numPages)))
+      return (rc);
+   if (pPageMap)
+      pPageMap->Truncate(numPages, fileSize);
+
+   hdr.numPages = numPages;
+   if (hdr.numAllocated > numPages)
+      hdr.numAllocated = numPages;
+   pAllocBitmap->Resize(numPages);
+
+   // The header goes first, so that it never counts pages the file no
+   // longer has
+   if ((rc = WriteHdr()))
+      return (rc);
+   if (ftruncate(unixfd, fileSize) < 0)
+      return (PF_UNIX);
+
+   // Return ok
+   return (0);
+}
+
 //
 // MarkDirty
 //
@@ -383,6 +478,10 @@ RC PF_FileHandle::MarkDirty(PageNum pageNum) const
    if (!IsValidPageNum(pageNum))
       return (PF_INVALIDPAGE);
 
+   // A mapped file cannot be changed
+   if (pMap)
+      return (PF_READONLY);
+
    // Tell the buffer manager to mark the page dirty
    return (pBufferMgr->MarkDirty(unixfd, pageNum));
 }
@@ -408,10 +507,71 @@ RC PF_FileHandle::UnpinPage(PageNum pageNum) const
    if (!IsValidPageNum(pageNum))
       return (PF_INVALIDPAGE);
 
+   // Pins of a mapped page are only counted
+   if (pMap) {
+      if (pinCounts[pageNum] == 0)
+         return (PF_PAGEUNPINNED);
+      pinCounts[pageNum]--;
+      return (0);
+   }
+
    // Tell the buffer manager to unpin the page
    return (pBufferMgr->UnpinPage(unixfd, pageNum));
 }
 
+//
+// LatchPage
+//
+// Desc: Latch the contents of a pinned page.  Threads that share a page
+//       latch it shared to read it and exclusive to change it; the buffer
+//       manager latches it shared when it writes it back.
+// In:   pageNum - number of the page to latch
+//       bExclusive - TRUE to latch the page exclusive
+// Ret:  PF return code
+//
+RC PF_FileHandle::LatchPage(PageNum pageNum, int bExclusive) const
+{
+   // File must be open
+   if (!bFileOpen)
+      return (PF_CLOSEDFILE);
+
+   // Validate page number
+   if (!IsValidPageNum(pageNum))
+      return (PF_INVALIDPAGE);
+
+   // A mapped page is never changed, so readers need no latch
+   if (pMap) {
+      if (pinCounts[pageNum] == 0)
+         return (PF_PAGEUNPINNED);
+      return (bExclusive ? PF_READONLY : 0);
+   }
+
+   return (pBufferMgr->LatchPage(unixfd, pageNum, bExclusive));
+}
+
+//
+// UnlatchPage
+//
+// Desc: Release the latch taken by LatchPage
+// In:   pageNum - number of the page to unlatch
+// Ret:  PF return code
+//
+RC PF_FileHandle::UnlatchPage(PageNum pageNum) const
+{
+   // File must be open
+   if (!bFileOpen)
+      return (PF_CLOSEDFILE);
+
+   // Validate page number
+   if (!IsValidPageNum(pageNum))
+      return (PF_INVALIDPAGE);
+
+   if (pMap)
+      return (pinCounts[pageNum] == 0 ? PF_PAGEUNPINNED : 0);
+
+   return (pBufferMgr->UnlatchPage(unixfd, pageNum));
+}
+
 //
 // FlushPages
 //
@@ -422,32 +582,30 @@ RC PF_FileHandle::UnpinPage(PageNum pageNum) const
 //
 RC PF_FileHandle::FlushPages() const
 {
+   RC rc;
+
    // File must be open
    if (!bFileOpen)
       return (PF_CLOSEDFILE);
 
-   // If the file header has changed, write it back to the file
-   if (bHdrChanged) {
-
-      // First seek to the appropriate place
-      if (lseek(unixfd, 0, L_SET) < 0)
-         return (PF_UNIX);
-
-      // Write header
-      int numBytes = write(unixfd,
-            (char *)&hdr,
-            sizeof(PF_FileHdr));
-      if (numBytes < 0)
-         return (PF_UNIX);
-      if (numBytes != sizeof(PF_FileHdr))
-         return (PF_HDRWRITE);
-
-      // This function is declared const, but we need to change the
-      // bHdrChanged variable.  Cast away the constness
-      PF_FileHandle *dummy = (PF_FileHandle *)this;
-      dummy->bHdrChanged = FALSE;
+   // Nothing to write for a mapped file, only warn about pinned pages
+   if (pMap) {
+      for (PageNum pageNum = 0; pageNum < hdr.numPages; pageNum++)
+         if (pinCounts[pageNum])
+            return (PF_PAGEPINNED);
+      return (0);
    }
 
+   // Writing the pages of a compressed file may move them, so they are
+   // written before the header, which the map of where they are goes with
+   if (pPageMap && (rc = pBufferMgr->ForcePages(unixfd, ALL_PAGES)))
+      return (rc);
+
+   // If the file header has changed, write it back to the file
+   if ((bHdrChanged || (pPageMap && pPageMap->IsChanged())) &&
+         (rc = WriteHdr()))
+      return (rc);
+
    // Tell Buffer Manager to flush pages
    return (pBufferMgr->FlushPages(unixfd));
 }
@@ -464,36 +622,374 @@ RC PF_FileHandle::FlushPages() const
 //
 RC PF_FileHandle::ForcePages(PageNum pageNum) const
 {
+   RC rc;
+
    // File must be open
    if (!bFileOpen)
       return (PF_CLOSEDFILE);
 
+   // A mapped file is never dirty
+   if (pMap)
+      return (0);
+
+   // The pages of a compressed file go first, as in FlushPages
+   if (pPageMap && (rc = pBufferMgr->ForcePages(unixfd, pageNum)))
+      return (rc);
+
    // If the file header has changed, write it back to the file
-   if (bHdrChanged) {
-
-      // First seek to the appropriate place
-      if (lseek(unixfd, 0, L_SET) < 0)
-         return (PF_UNIX);
-
-      // Write header
-      int numBytes = write(unixfd,
-            (char *)&hdr,
-            sizeof(PF_FileHdr));
-      if (numBytes < 0)
-         return (PF_UNIX);
-      if (numBytes != sizeof(PF_FileHdr))
-         return (PF_HDRWRITE);
-
-      // This function is declared const, but we need to change the
-      // bHdrChanged variable.  Cast away the constness
-      PF_FileHandle *dummy = (PF_FileHandle *)this;
-      dummy->bHdrChanged = FALSE;
-   }
+   if ((bHdrChanged || (pPageMap && pPageMap->IsChanged())) &&
+         (rc = WriteHdr()))
+      return (rc);
+   if (pPageMap)
+      return (0);
 
    // Tell Buffer Manager to Force the page
    return (pBufferMgr->ForcePages(unixfd, pageNum));
 }
 
+//
+// WriteHdr
+//
+// Desc: Internal.  Write the file header at the start of the file, and
+//       mark it unchanged.  The header is followed by the allocation
+//       bitmap of the first PF_HDR_BITMAP_PAGES pages.  The bitmap pages
+//       that changed, and the page map of a compressed file, are written
+//       first.  The whole header page is written from an aligned buffer,
+//       as O_DIRECT requires.
+// Ret:  PF return code
+//
+RC PF_FileHandle::WriteHdr() const
+{
+   RC rc;
+   alignas(MEMORY_PAGE_SIZE) char hdrBuf[PF_FILE_HDR_SIZE];
+
+   // This function is declared const, but we need to change the
+   // bHdrChanged variable, and the location of the map.  Cast away the
+   // constness
+   PF_FileHandle *dummy = (PF_FileHandle *)this;
+
+   if ((rc = WriteBitmapPages()))
+      return (rc);
+   if (pPageMap && (rc = pPageMap->Store(dummy->hdr)))
+      return (rc);
+
+   memset(hdrBuf, 0, PF_FILE_HDR_SIZE);
+   memcpy(hdrBuf, &hdr, sizeof(PF_FileHdr));
+   pAllocBitmap->Store(hdrBuf + sizeof(PF_FileHdr),
+         hdr.numPages < PF_HDR_BITMAP_PAGES ?
+         hdr.numPages : PF_HDR_BITMAP_PAGES);
+
+   int numBytes = pwrite(unixfd, hdrBuf, PF_FILE_HDR_SIZE, 0);
+   if (numBytes < 0)
+      return (PF_UNIX);
+   if (numBytes != PF_FILE_HDR_SIZE)
+      return (PF_HDRWRITE);
+
+   dummy->bHdrChanged = FALSE;
+
+   // Return ok
+   return (0);
+}
+
+//
+// ReadAllocBitmap
+//
+// Desc: Internal.  Build the allocation bitmap of a file being opened.
+//       The state of the first pages comes from the header page, and that
+//       of the pages past PF_HDR_BITMAP_PAGES from the bitmap pages.  The
+//       pages of a file made before the bitmap, and those past the header
+//       bitmap in a file made before the bitmap pages, are read to look at
+//       their page header; the bitmap of such a file is written with the
+//       header when it is closed.  A file that has no page at the place
+//       of a bitmap page starts using bitmap pages.  The page map of a
+//       compressed file must be loaded.
+// In:   hdrBuf - the header page of the file, hdr is already set
+// Ret:  PF return code
+//
+RC PF_FileHandle::ReadAllocBitmap(const char *hdrBuf)
+{
+   RC rc;
+   PageNum pageNum = 0;   // first page not in the bitmap read
+
+   pAllocBitmap = new PF_AllocBitmap();
+   pAllocBitmap->Resize(hdr.numPages);
+   if (hdr.bHasBitmap) {
+      pageNum = hdr.numPages < PF_HDR_BITMAP_PAGES ?
+         hdr.numPages : PF_HDR_BITMAP_PAGES;
+      pAllocBitmap->Load(hdrBuf + sizeof(PF_FileHdr), pageNum);
+   }
+   else
+      hdr.bBitmapPages = FALSE;
+
+   // Read the bitmap pages, or the other pages, straight from the file:
+   // none of them can be in the buffer yet.  The buffer is aligned for
+   // O_DIRECT.
+   char *pPageBuf = NULL;
+   if (pageNum < hdr.numPages &&
+         posix_memalign((void **)&pPageBuf, MEMORY_PAGE_SIZE, hdr.pageSize))
+      return (PF_NOMEM);
+   if (hdr.bBitmapPages) {
+      pAllocBitmap->Reserve(PF_HDR_BITMAP_PAGES,
+            PF_BitmapPageBits(hdr.pageSize));
+      for (int i = 0; i < pAllocBitmap->NumBitmapPages(); i++) {
+         if ((rc = ReadRawPage(pAllocBitmap->BitmapPage(i), pPageBuf))) {
+            free(pPageBuf);
+            return (rc);
+         }
+         pAllocBitmap->LoadRun(i, pPageBuf + sizeof(PF_PageHdr));
+      }
+      pageNum = hdr.numPages;
+   }
+   for (; pageNum < hdr.numPages; pageNum++) {
+      if ((rc = ReadRawPage(pageNum, pPageBuf))) {
+         free(pPageBuf);
+         return (rc);
+      }
+      if (((PF_PageHdr *)pPageBuf)->nextFree == PF_PAGE_USED)
+         pAllocBitmap->SetUsed(pageNum);
+   }
+   free(pPageBuf);
+
+   // The free list of an older file is replaced by the bitmap
+   if (!hdr.bHasBitmap) {
+      hdr.firstFree = PF_PAGE_LIST_END;
+      hdr.bHasBitmap = TRUE;
+      bHdrChanged = !pMap;
+   }
+
+   // So are the page headers, as long as the first bitmap page would be
+   // past the end of the file
+   if (!hdr.bBitmapPages && hdr.numPages <= PF_HDR_BITMAP_PAGES) {
+      pAllocBitmap->Reserve(PF_HDR_BITMAP_PAGES,
+            PF_BitmapPageBits(hdr.pageSize));
+      hdr.bBitmapPages = TRUE;
+      bHdrChanged = !pMap;
+   }
+
+   // Return ok
+   return (0);
+}
+
+//
+// ReadRawPage
+//
+// Desc: Internal.  Read a page from the file, not through the buffer
+// In:   pageNum - page to read
+//       pPageBuf - page size bytes, aligned for O_DIRECT
+// Out:  pPageBuf - the page, PF_PageHdr included
+// Ret:  PF return code
+//
+RC PF_FileHandle::ReadRawPage(PageNum pageNum, char *pPageBuf) const
+{
+   if (pMap) {
+      memcpy(pPageBuf, MappedPage(pageNum), hdr.pageSize);
+      return (0);
+   }
+   if (pPageMap)
+      return (pPageMap->ReadPage(pageNum, pPageBuf));
+
+   int numBytes = pread(unixfd, pPageBuf, hdr.pageSize,
+         PF_FILE_HDR_SIZE + pageNum * (long)hdr.pageSize);
+   if (numBytes != hdr.pageSize)
+      return (numBytes < 0 ? PF_UNIX : PF_INCOMPLETEREAD);
+
+   // Return ok
+   return (0);
+}
+
+//
+// WriteRawPage
+//
+// Desc: Internal.  Write a page to the file, not through the buffer
+// In:   pageNum - page to write
+//       pPageBuf - the page, PF_PageHdr included, aligned for O_DIRECT
+// Ret:  PF return code
+//
+RC PF_FileHandle::WriteRawPage(PageNum pageNum, const char *pPageBuf) const
+{
+   if (pPageMap)
+      return (pPageMap->WritePage(pageNum, pPageBuf));
+
+   int numBytes = pwrite(unixfd, pPageBuf, hdr.pageSize,
+         PF_FILE_HDR_SIZE + pageNum * (long)hdr.pageSize);
+   if (numBytes != hdr.pageSize)
+      return (numBytes < 0 ? PF_UNIX : PF_INCOMPLETEWRITE);
+
+   // Return ok
+   return (0);
+}
+
+//
+// WriteBitmapPages
+//
+// Desc: Internal.  Write the bitmap pages whose runs changed since they
+//       were read or last written
+// Ret:  PF return code
+//
+RC PF_FileHandle::WriteBitmapPages() const
+{
+   RC rc = 0;
+   char *pPageBuf = NULL;
+
+   for (int i = 0; i < pAllocBitmap->NumBitmapPages() && !rc; i++) {
+      if (!pAllocBitmap->IsStale(i))
+         continue;
+      if (!pPageBuf) {
+         if (posix_memalign((void **)&pPageBuf, MEMORY_PAGE_SIZE,
+               hdr.pageSize))
+            return (PF_NOMEM);
+         memset(pPageBuf, 0, hdr.pageSize);
+         ((PF_PageHdr *)pPageBuf)->nextFree = PF_PAGE_BITMAP;
+      }
+      pAllocBitmap->StoreRun(i, pPageBuf + sizeof(PF_PageHdr));
+      rc = WriteRawPage(pAllocBitmap->BitmapPage(i), pPageBuf);
+#ifdef PF_STATS
+      if (!rc)
+         pStatisticsMgr->Register(PF_WRITEPAGE, STAT_ADDONE);
+#endif
+   }
+   free(pPageBuf);
+   return (rc);
+}
+
+//
+// Extend
+//
+// Desc: Internal.  Grow the file by extentPages pages with a single
+//       fallocate, so that its pages are laid out contiguously on disk and
+//       the file size is not updated at every page written past its end.
+//       The new pages are recorded as the unused tail of the file in the
+//       header.  A file system that cannot preallocate makes the file grow
+//       one page at a time, as if extentPages were 0.
+// Ret:  PF_UNIX or 0
+//
+RC PF_FileHandle::Extend()
+{
+   long offset = PF_FILE_HDR_SIZE + hdr.numPages * (long)hdr.pageSize;
+   long length = extentPages * (long)hdr.pageSize;
+
+#ifdef __linux__
+   int err = fallocate(unixfd, 0, offset, length) < 0 ? errno : 0;
+#else
+   int err = posix_fallocate(unixfd, offset, length);
+#endif
+   if (err == EOPNOTSUPP || err == ENOSYS || err == EINVAL) {
+      extentPages = 0;
+      return (0);
+   }
+   if (err) {
+      errno = err;
+      return (PF_UNIX);
+   }
+
+#ifdef PF_STATS
+   pStatisticsMgr->Register(PF_EXTEND, STAT_ADDONE);
+#endif
+
+   hdr.numAllocated = hdr.numPages + extentPages;
+   bHdrChanged = TRUE;
+
+   // Return ok
+   return (0);
+}
+
+//
+// RecoverPage
+//
+// Desc: Internal.  Called by PF_Manager to apply a write-ahead log record
+//       to the file: copy bytes into a page and mark it used or free as
+//       its PF_PageHdr then says.  A page past the end of the file grows
+//       the file, the pages in between being free.  A whole page is copied
+//       without reading it.
+// In:   pageNum - page to change
+//       offset - where in the page, PF_PageHdr included
+//       bytes - the new bytes
+//       numBytes - # of bytes
+// Ret:  PF_INVALIDPAGE or other PF return code
+//
+RC PF_FileHandle::RecoverPage(PageNum pageNum, int offset, const char *bytes,
+      int numBytes)
+{
+   RC   rc;                 // return code
+   char *pPageBuf;          // address of page in buffer pool
+
+   // File must be open
+   if (!bFileOpen)
+      return (PF_CLOSEDFILE);
+
+   if (pageNum < 0 || offset < 0 || numBytes < 0 ||
+         offset + numBytes > hdr.pageSize)
+      return (PF_INVALIDPAGE);
+
+   // Grow the file with free pages up to the page
+   if (pageNum >= hdr.numPages) {
+      PageNum first = hdr.numPages;
+      hdr.numPages = pageNum + 1;
+      pAllocBitmap->Resize(hdr.numPages);
+      bHdrChanged = TRUE;
+
+      for (PageNum p = first; p <= pageNum; p++) {
+         // A bitmap page is written with the header
+         if (pAllocBitmap->IsReserved(p))
+            continue;
+         if ((rc = pBufferMgr->AllocatePage(unixfd, p, hdr.pageSize,
+               &pPageBuf)))
+            return (rc);
+         memset(pPageBuf, 0, hdr.pageSize);
+         ((PF_PageHdr *)pPageBuf)->nextFree = PF_PAGE_LIST_END;
+         pAllocBitmap->SetFree(p);
+         if ((rc = pBufferMgr->MarkDirty(unixfd, p)) ||
+               (rc = pBufferMgr->UnpinPage(unixfd, p)))
+            return (rc);
+      }
+   }
+
+   if (offset == 0 && numBytes == hdr.pageSize) {
+      rc = pBufferMgr->AllocatePage(unixfd, pageNum, hdr.pageSize,
+            &pPageBuf);
+      if (rc == PF_PAGEINBUF)
+         rc = pBufferMgr->GetPage(unixfd, pageNum, hdr.pageSize, &pPageBuf);
+   }
+   else
+      rc = pBufferMgr->GetPage(unixfd, pageNum, hdr.pageSize, &pPageBuf);
+   if (rc)
+      return (rc);
+
+   memcpy(pPageBuf + offset, bytes, numBytes);
+   if (((PF_PageHdr *)pPageBuf)->nextFree == PF_PAGE_USED)
+      pAllocBitmap->SetUsed(pageNum);
+   else
+      pAllocBitmap->SetFree(pageNum);
+   bHdrChanged = TRUE;
+
+   if ((rc = pBufferMgr->MarkDirty(unixfd, pageNum)) ||
+         (rc = pBufferMgr->UnpinPage(unixfd, pageNum)))
+      return (rc);
+
+   // Return ok
+   return (0);
+}
+
+//
+// GetPageSize
+//
+// Desc: Return the size of the data of each page of the file, which is
+//       what PF_PageHandle::GetData points to
+// Out:  pageSize - # of bytes of data per page
+// Ret:  PF return code
+//
+RC PF_FileHandle::GetPageSize(int &pageSize) const
+{
+   // File must be open
+   if (!bFileOpen)
+      return (PF_CLOSEDFILE);
+
+   pageSize = hdr.pageSize - sizeof(PF_PageHdr);
+
+   // Return ok
+   return (0);
+}
+
 
 //
 // IsValidPageNum
@@ -510,3 +1006,16 @@ int PF_FileHandle::IsValidPageNum(PageNum pageNum) const
          pageNum < hdr.numPages);
 }
 
+//
+// MappedPage
+//
+// Desc: Internal.  Return the address of a page in the mapping of a
+//       PF_MMAP_READONLY file.  The page starts with its PF_PageHdr, like
+//       a page in the buffer pool.
+// In:   pageNum - a valid page number
+// Ret:  address of the page
+//
+char *PF_FileHandle::MappedPage(PageNum pageNum) const
+{
+   return (pMap + PF_FILE_HDR_SIZE + pageNum * (long)hdr.pageSize);
+}
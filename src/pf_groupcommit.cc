@@ -0,0 +1,204 @@
+//
+// File:        pf_groupcommit.cc
+// Description: PF_GroupCommit class implementation
+//
+
+#include <unistd.h>
+#include <chrono>
+#include "pf_groupcommit.h"
+#include "statistics.h"
+
+using namespace std;
+
+// This is defined within pf_buffermgr.cc
+extern StatisticsMgr *pStatisticsMgr;
+
+//
+// PF_GroupCommit
+//
+// Desc: Constructor.  Commits sync on their own until SetDurability says
+//       otherwise.
+//
+PF_GroupCommit::PF_GroupCommit()
+{
+   mode = PF_DURABLE_STATEMENT;
+   window = PF_GROUP_COMMIT_WINDOW;
+   maxGroup = PF_GROUP_COMMIT_SIZE;
+   group = 0;
+   lastSynced = -1;
+   numJoined = 0;
+   bLeading = FALSE;
+   syncError = 0;
+}
+
+//
+// Forced
+//
+// Desc: Remember that pages of a file were forced, so that the next
+//       Commit syncs the file
+// In:   fd - OS file descriptor
+//
+void PF_GroupCommit::Forced(int fd)
+{
+   lock_guard<mutex> lock(groupMutex);
+   if (mode != PF_DURABLE_NONE)
+      pending.insert(fd);
+}
+
+//
+// Release
+//
+// Desc: Called before a file is closed, since its descriptor may then be
+//       reused.  Waits for a leader syncing the file, and syncs the file if
+//       it was forced since.  The sync is done holding the lock, so that a
+//       Commit counting on it does not return before it is done; closing
+//       files is rare enough.
+// In:   fd - OS file descriptor
+// Ret:  PF_UNIX or 0
+//
+RC PF_GroupCommit::Release(int fd)
+{
+   unique_lock<mutex> lock(groupMutex);
+
+   while (syncing.count(fd))
+      synced.wait(lock);
+   if (!pending.erase(fd))
+      return (0);
+
+   RC rc = Sync(set<int>(&fd, &fd + 1));
+   if (rc && !syncError)
+      syncError = rc;
+   return (rc);
+}
+
+//
+// Commit
+//
+// Desc: Make the pages forced so far durable.  The caller joins the group
+//       being collected.  If no leader is at work, it leads the group: it
+//       waits for the group to fill up, in PF_DURABLE_GROUP mode, then
+//       syncs the files forced by the whole group.  Otherwise it waits for
+//       its group to be synced, leading the next one if the leader at work
+//       was syncing an earlier group.
+// Ret:  PF_UNIX if a sync ever failed, 0 otherwise
+//
+RC PF_GroupCommit::Commit()
+{
+   unique_lock<mutex> lock(groupMutex);
+
+   if (mode == PF_DURABLE_NONE || syncError)
+      return (syncError);
+
+#ifdef PF_STATS
+   pStatisticsMgr->Register(PF_COMMIT, STAT_ADDONE);
+#endif
+
+   long myGroup = group;
+   if (++numJoined >= maxGroup)
+      joined.notify_all();
+
+   while (lastSynced < myGroup) {
+      if (bLeading) {
+         synced.wait(lock);
+         continue;
+      }
+
+      // Lead the group
+      bLeading = TRUE;
+      if (mode == PF_DURABLE_GROUP && window > 0)
+         joined.wait_for(lock, chrono::milliseconds(window),
+                         [this] { return numJoined >= maxGroup; });
+
+      // Commits arriving from now on form the next group
+      syncing.swap(pending);
+      group++;
+      numJoined = 0;
+
+      lock.unlock();
+      RC rc = Sync(syncing);
+      lock.lock();
+
+      if (rc && !syncError)
+         syncError = rc;
+      syncing.clear();
+      lastSynced = myGroup;
+      bLeading = FALSE;
+      synced.notify_all();
+   }
+
+   return (syncError);
+}
+
+//
+// IsDurable
+//
+// Desc: Tell whether a Commit that succeeds has synced what was forced
+//       before it
+// Ret:  TRUE or FALSE
+//
+int PF_GroupCommit::IsDurable()
+{
+   lock_guard<mutex> lock(groupMutex);
+   return (mode != PF_DURABLE_NONE);
+}
+
+//
+// SetDurability
+//
+// Desc: Change the durability mode.  Files forced in another mode are
+//       still synced by the next Commit, or when they are closed.
+// In:   _mode - PF_DURABLE_NONE, PF_DURABLE_STATEMENT or PF_DURABLE_GROUP
+//
+void PF_GroupCommit::SetDurability(PF_Durability _mode)
+{
+   lock_guard<mutex> lock(groupMutex);
+   mode = _mode;
+}
+
+//
+// SetWindow
+//
+// Desc: Change how long a group leader waits for the group to fill up
+// In:   msecs - the new window, 0 for no wait
+//
+void PF_GroupCommit::SetWindow(int msecs)
+{
+   lock_guard<mutex> lock(groupMutex);
+   window = msecs > 0 ? msecs : 0;
+}
+
+//
+// SetGroupSize
+//
+// Desc: Change how many Commits fill a group up
+// In:   _maxGroup - # of Commits, at least 1
+//
+void PF_GroupCommit::SetGroupSize(int _maxGroup)
+{
+   lock_guard<mutex> lock(groupMutex);
+   maxGroup = _maxGroup > 1 ? _maxGroup : 1;
+   joined.notify_all();
+}
+
+//
+// Sync
+//
+// Desc: Internal.  fdatasync every file of a set.  All of them are synced
+//       even if one fails.
+// In:   fds - OS file descriptors
+// Ret:  PF_UNIX if a sync failed, 0 otherwise
+//
+RC PF_GroupCommit::Sync(const set<int> &fds)
+{
+   RC rc = 0;
+
+   for (set<int>::const_iterator it = fds.begin(); it != fds.end(); ++it) {
+#ifdef PF_STATS
+      pStatisticsMgr->Register(PF_SYNC, STAT_ADDONE);
+#endif
+      if (fdatasync(*it) < 0)
+         rc = PF_UNIX;
+   }
+
+   return (rc);
+}
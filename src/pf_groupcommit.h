@@ -0,0 +1,72 @@
+//
+// File:        pf_groupcommit.h
+// Description: PF_GroupCommit interface, the fdatasync batching used by
+//              PF_BufferMgr to make forced pages durable
+//
+// ForcePages only writes pages to the OS.  PF_GroupCommit remembers which
+// files had pages forced, and Commit, called at the end of a statement,
+// makes them durable with one fdatasync per file, however many pages and
+// however many ForcePages calls the statement made.
+//
+// In PF_DURABLE_GROUP mode the Commits of concurrent statements share
+// those fdatasyncs.  The first Commit to arrive leads a group: it waits up
+// to a window for maxGroup Commits in all to join, then syncs every file
+// forced by any of them while the others wait.  Commits arriving during
+// the sync form the next group.  PF_DURABLE_STATEMENT is the same with no
+// window, so a Commit never waits for others, but still never syncs a
+// file twice when several arrive at once.
+//
+// A failed fdatasync may have dropped the pages it was meant to make
+// durable, so the error sticks: every later Commit fails too.
+//
+
+#ifndef PF_GROUPCOMMIT_H
+#define PF_GROUPCOMMIT_H
+
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include "pf_internal.h"
+
+//
+// PF_GroupCommit - batched fdatasync of forced files
+//
+class PF_GroupCommit {
+public:
+    PF_GroupCommit  ();
+
+    // Pages of fd were forced, sync it at the next Commit
+    void Forced      (int fd);
+    // fd is about to be closed: sync it now if it was forced since the
+    // last Commit
+    RC   Release     (int fd);
+
+    // Make every page forced before the call durable
+    RC   Commit      ();
+    int  IsDurable   ();                    // TRUE unless Commit syncs
+                                            // nothing
+
+    void SetDurability (PF_Durability mode);
+    void SetWindow   (int msecs);           // max wait of a group leader
+    void SetGroupSize (int maxGroup);       // # of Commits that end the wait
+
+private:
+    // fdatasync the files of fds
+    RC   Sync        (const std::set<int> &fds);
+
+    std::mutex      groupMutex;             // protects all
+    std::condition_variable joined;         // a Commit joined the group
+    std::condition_variable synced;         // a group was synced
+    PF_Durability   mode;
+    int             window;                 // msecs
+    int             maxGroup;
+    std::set<int>   pending;                // forced since the group began
+    std::set<int>   syncing;                // being synced by the leader
+    long            group;                  // group being collected
+    long            lastSynced;             // last group synced
+    int             numJoined;              // Commits in the group
+    int             bLeading;               // TRUE if a leader is at work
+    RC              syncError;              // first fdatasync error, sticky
+};
+
+#endif
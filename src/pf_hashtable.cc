@@ -13,19 +13,13 @@
 //
 // Desc: Constructor for PF_HashTable object, which allows search, insert,
 //       and delete of hash table entries.
-// In:   numBuckets - number of hash table buckets
+// In:   numPages - number of pages in the buffer, the table has
+//       PF_HASH_ENTRIES_PER_PAGE entries for each of them
 //
-PF_HashTable::PF_HashTable(int _numBuckets)
+PF_HashTable::PF_HashTable(int numPages)
 {
-  // Initialize numBuckets local variable from parameter
-  this->numBuckets = _numBuckets;
-
-  // Allocate memory for hash table
-  hashTable = new PF_HashEntry* [numBuckets];
-
-  // Initialize all buckets to empty
-  for (int i = 0; i < numBuckets; i++)
-    hashTable[i] = NULL;
+  hashTable = NULL;
+  Allocate(numPages);
 }
 
 //
@@ -35,20 +29,75 @@ PF_HashTable::PF_HashTable(int _numBuckets)
 //
 PF_HashTable::~PF_HashTable()
 {
-  // Clear out all buckets
-  for (int i = 0; i < numBuckets; i++) {
-
-    // Delete all entries in the bucket
-    PF_HashEntry *entry = hashTable[i];
-    while (entry != NULL) {
-      PF_HashEntry *next = entry->next;
-      delete entry;
-      entry = next;
-    }
-  }
+  delete[] hashTable;
+}
+
+//
+// Allocate
+//
+// Desc: Internal.  Replace the table by an empty one big enough for
+//       numEntries entries.  The number of entries is a power of two so
+//       that Hash can mask instead of dividing.
+// In:   numEntries - number of entries the table must hold
+//
+void PF_HashTable::Allocate(int numEntries)
+{
+  unsigned int size = PF_HASH_MIN_SIZE;
+  while (size < (unsigned int)(numEntries * PF_HASH_ENTRIES_PER_PAGE))
+    size *= 2;
 
-  // Finally delete the hash table
   delete[] hashTable;
+  hashTable = new PF_HashEntry[size];
+  for (unsigned int i = 0; i < size; i++)
+    hashTable[i].slot = PF_HASH_EMPTY;
+
+  mask = size - 1;
+  numUsed = 0;
+}
+
+//
+// Resize
+//
+// Desc: Resize the table for a buffer of numPages pages.  All the
+//       entries are rehashed into the new table.
+// In:   numPages - new number of pages in the buffer
+// Ret:  PF return code
+//
+RC PF_HashTable::Resize(int numPages)
+{
+  PF_HashEntry *oldTable = hashTable;
+  unsigned int oldSize = mask + 1;
+
+  hashTable = NULL;
+  if (numPages < numUsed)
+    numPages = numUsed;
+  Allocate(numPages);
+
+  for (unsigned int i = 0; i < oldSize; i++)
+    if (oldTable[i].slot != PF_HASH_EMPTY)
+      Insert(oldTable[i].fd, oldTable[i].pageNum, oldTable[i].slot);
+
+  delete[] oldTable;
+
+  // Return ok
+  return (0);
+}
+
+//
+// Lookup
+//
+// Desc: Internal.  Probe for the entry of fd and pageNum
+// Ret:  index of the entry in hashTable, -1 if there is none
+//
+int PF_HashTable::Lookup(int fd, PageNum pageNum) const
+{
+  for (unsigned int i = Hash(fd, pageNum); ; i = (i + 1) & mask) {
+    const PF_HashEntry &entry = hashTable[i];
+    if (entry.slot == PF_HASH_EMPTY)
+      return (-1);
+    if (entry.fd == fd && entry.pageNum == pageNum)
+      return (i);
+  }
 }
 
 //
@@ -62,26 +111,15 @@ PF_HashTable::~PF_HashTable()
 //
 RC PF_HashTable::Find(int fd, PageNum pageNum, int &slot)
 {
-  // Get which bucket it should be in
-  int bucket = Hash(fd, pageNum);
-
-  if (bucket<0)
-     return (PF_HASHNOTFOUND);
-
-  // Go through the linked list of this bucket
-  for (PF_HashEntry *entry = hashTable[bucket];
-       entry != NULL;
-       entry = entry->next) {
-    if (entry->fd == fd && entry->pageNum == pageNum) {
-
-      // Found it
-      slot = entry->slot;
-      return (0);
-    }
-  }
+  int i = Lookup(fd, pageNum);
 
   // Didn't find it
-  return (PF_HASHNOTFOUND);
+  if (i < 0)
+    return (PF_HASHNOTFOUND);
+
+  // Found it
+  slot = hashTable[i].slot;
+  return (0);
 }
 
 //
@@ -95,31 +133,24 @@ RC PF_HashTable::Find(int fd, PageNum pageNum, int &slot)
 //
 RC PF_HashTable::Insert(int fd, PageNum pageNum, int slot)
 {
-  // Get which bucket it should be in
-  int bucket = Hash(fd, pageNum);
-
-  // Check entry doesn't already exist in the bucket
-  PF_HashEntry *entry;
-  for (entry = hashTable[bucket];
-       entry != NULL;
-       entry = entry->next) {
-    if (entry->fd == fd && entry->pageNum == pageNum)
-      return (PF_HASHPAGEEXIST);
-  }
+  // Check entry doesn't already exist
+  if (Lookup(fd, pageNum) >= 0)
+    return (PF_HASHPAGEEXIST);
 
-  // Allocate memory for new hash entry
-  if ((entry = new PF_HashEntry) == NULL)
-    return (PF_NOMEM);
+  // The buffer never holds more pages than it was sized for, but keep
+  // probe sequences short if it ever does
+  if ((unsigned int)((numUsed + 1) * PF_HASH_ENTRIES_PER_PAGE) > mask + 1)
+    Resize(2 * (numUsed + 1));
 
-  // Insert entry at head of list for this bucket
-  entry->fd = fd;
-  entry->pageNum = pageNum;
-  entry->slot = slot;
-  entry->next = hashTable[bucket];
-  entry->prev = NULL;
-  if (hashTable[bucket] != NULL)
-    hashTable[bucket]->prev = entry;
-  hashTable[bucket] = entry;
+  // Take the first empty entry of the probe sequence
+  unsigned int i = Hash(fd, pageNum);
+  while (hashTable[i].slot != PF_HASH_EMPTY)
+    i = (i + 1) & mask;
+
+  hashTable[i].fd = fd;
+  hashTable[i].pageNum = pageNum;
+  hashTable[i].slot = slot;
+  numUsed++;
 
   // Return ok
   return (0);
@@ -128,40 +159,39 @@ RC PF_HashTable::Insert(int fd, PageNum pageNum, int slot)
 //
 // Delete
 //
-// Desc: Delete a hash table entry
+// Desc: Delete a hash table entry.  The entries that follow it in the
+//       same cluster are shifted back so that no probe sequence is
+//       broken, which avoids tombstones.
 // In:   fd - file descriptor
 //       pagenum - page number
 // Ret:  PF return code
 //
 RC PF_HashTable::Delete(int fd, PageNum pageNum)
 {
-  // Get which bucket it should be in
-  int bucket = Hash(fd, pageNum);
-
-  // Find the entry is in this bucket
-  PF_HashEntry *entry;
-  for (entry = hashTable[bucket];
-       entry != NULL;
-       entry = entry->next) {
-    if (entry->fd == fd && entry->pageNum == pageNum)
-      break;
-  }
+  int found = Lookup(fd, pageNum);
 
   // Did we find hash entry?
-  if (entry == NULL)
+  if (found < 0)
     return (PF_HASHNOTFOUND);
 
-  // Remove this entry
-  if (entry == hashTable[bucket])
-    hashTable[bucket] = entry->next;
-  if (entry->prev != NULL)
-    entry->prev->next = entry->next;
-  if (entry->next != NULL)
-    entry->next->prev = entry->prev;
-  delete entry;
+  // hole is the entry being emptied; look for an entry after it that
+  // could have been placed there
+  unsigned int hole = found;
+  for (unsigned int i = (hole + 1) & mask;
+       hashTable[i].slot != PF_HASH_EMPTY;
+       i = (i + 1) & mask) {
+    unsigned int home = Hash(hashTable[i].fd, hashTable[i].pageNum);
 
-  // Return ook
-  return (0);
-}
+    // The entry stays if its home lies cyclically in (hole, i]
+    if (hole <= i ? (hole < home && home <= i) : (hole < home || home <= i))
+      continue;
 
+    hashTable[hole] = hashTable[i];
+    hole = i;
+  }
+  hashTable[hole].slot = PF_HASH_EMPTY;
+  numUsed--;
 
+  // Return ok
+  return (0);
+}
@@ -4,6 +4,11 @@
 // Authors:     Hugo Rivero (rivero@cs.stanford.edu)
 //              Dallan Quass (quass@cs.stanford.edu)
 //
+// The table maps (fd, pageNum) to a buffer slot.  It uses open addressing
+// with linear probing over a flat array of entries, so a lookup touches
+// one or two cache lines and inserting never allocates.  The array is
+// sized from the number of buffer pages and regrown with the buffer.
+//
 
 #ifndef PF_HASHTABLE_H
 #define PF_HASHTABLE_H
@@ -11,22 +16,23 @@
 #include "pf_internal.h"
 
 //
-// HashEntry - Hash table bucket entries
+// HashEntry - Hash table entries
 //
 struct PF_HashEntry {
-    PF_HashEntry *next;   // next hash table element or NULL
-    PF_HashEntry *prev;   // prev hash table element or NULL
     int          fd;      // file descriptor
     PageNum      pageNum; // page number
-    int          slot;    // slot of this page in the buffer
+    int          slot;    // slot of this page in the buffer or
+                          // PF_HASH_EMPTY if the entry is not used
 };
 
+#define PF_HASH_EMPTY  (-1)
+
 //
 // PF_HashTable - allow search, insertion, and deletion of hash table entries
 //
 class PF_HashTable {
 public:
-    PF_HashTable (int numBuckets);           // Constructor
+    PF_HashTable (int numPages);             // Constructor
     ~PF_HashTable();                         // Destructor
     RC  Find     (int fd, PageNum pageNum, int &slot);
                                              // Set slot to the hash table
@@ -35,11 +41,30 @@ public:
                                              // Insert a hash table entry
     RC  Delete   (int fd, PageNum pageNum);  // Delete a hash table entry
 
+    // Size the table for a buffer of numPages pages, keeping the entries
+    RC  Resize   (int numPages);
+
 private:
-    int Hash     (int fd, PageNum pageNum) const
-      { return ((fd + pageNum) % numBuckets); }   // Hash function
-    int numBuckets;                               // Number of hash table buckets
-    PF_HashEntry **hashTable;                     // Hash table
+    // Hash function: a 64-bit finalizer (from MurmurHash3) over fd and
+    // pageNum, so that consecutive pages of a file spread over the table
+    unsigned int Hash (int fd, PageNum pageNum) const
+    {
+      unsigned long long h = ((unsigned long long)(unsigned int)fd << 32) |
+         (unsigned int)pageNum;
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return (unsigned int)h & mask;
+    }
+
+    int  Lookup   (int fd, PageNum pageNum) const; // index of entry or -1
+    void Allocate (int numEntries);
+
+    unsigned int mask;                            // # of entries - 1
+    int numUsed;                                  // # of used entries
+    PF_HashEntry *hashTable;                      // Hash table
 };
 
 #endif
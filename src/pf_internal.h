@@ -11,17 +11,36 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <cerrno>
+#include <fcntl.h>
 #include "pf.h"
 
 //
 // Constants and defines
 //
 const int PF_BUFFER_SIZE = 40;     // Number of pages in the buffer
-const int PF_HASH_TBL_SIZE = 20;   // Size of hash table
+const int PF_HASH_MIN_SIZE = 16;   // Minimum # of hash table entries
+const int PF_HASH_ENTRIES_PER_PAGE = 2;  // Hash table entries per buffer
+                                         // page, keeps probes short
+const int PF_LRUK_K = 2;           // K of the LRU-K replacement policy
+const int PF_MAX_WRITEV = 64;      // Max # of pages written by one pwritev
+const int PF_MAX_SHARDS = 16;      // Max # of latch partitions of the buffer
+const int PF_SHARD_MIN_PAGES = 64; // Min # of buffer pages per partition
+const int PF_WRITER_WAKEUP = 10;   // msecs between background writer runs
+const int PF_SCAN_RING_PAGES = 8;  // # of slots recycled by sequential scans
+const int PF_EXTENT_PAGES = 16;    // # of pages a file is grown by at once
+const int PF_GROUP_COMMIT_WINDOW = 2;  // msecs a group commit leader waits
+const int PF_GROUP_COMMIT_SIZE = 8;    // # of Commits that fill a group
+const int PF_SECTOR_SIZE = 512;    // Unit of space of compressed pages
+const int PF_LOG_BUFFER_SIZE = 1 << 20;  // Bytes of log records written at
+                                         // once
+const size_t PF_HUGE_PAGE_SIZE = 2 << 20;  // Huge page size of the frame
+                                           // arena
 
 #define CREATION_MASK      0600    // r/w privileges to owner only
 #define PF_PAGE_LIST_END  -1       // end of list of free pages
 #define PF_PAGE_USED      -2       // page is being used
+#define PF_PAGE_BITMAP    -3       // page holds allocation bits
 
 // L_SET is used to indicate the "whence" argument of the lseek call
 // defined in "/usr/include/unistd.h".  A value of 0 indicates to
@@ -38,9 +57,43 @@ struct PF_PageHdr {
                         //  - the number of the next free page
                         //  - PF_PAGE_LIST_END if this is last free page
                         //  - PF_PAGE_USED if the page is not free
+                        //  - PF_PAGE_BITMAP if it is a bitmap page
 };
 
 // Justify the file header to the length of one page
 const int PF_FILE_HDR_SIZE = PF_PAGE_SIZE + sizeof(PF_PageHdr);
 
+// # of pages whose allocation bit fits in the file header, after the
+// PF_FileHdr
+const int PF_HDR_BITMAP_PAGES = (PF_FILE_HDR_SIZE - sizeof(PF_FileHdr)) * 8;
+
+// # of pages whose allocation bit fits in a bitmap page, for pages of
+// pageSize bytes.  This is also the distance between bitmap pages.
+inline int PF_BitmapPageBits(int pageSize)
+{
+   return ((pageSize - (int)sizeof(PF_PageHdr)) * 8);
+}
+
+// TRUE if pageSize is a page size a file can be created with
+inline int PF_ValidPageSize(int pageSize)
+{
+   return (pageSize >= MEMORY_PAGE_SIZE && pageSize <= PF_MAX_PAGE_SIZE &&
+         (pageSize & (pageSize - 1)) == 0);
+}
+
+// Punch length bytes at offset out of a file, so that they read as zeros
+// and take no disk space.  Returns 0, or the errno of the failure, which
+// is EOPNOTSUPP or ENOSYS where the file system or the OS cannot do it.
+inline int PF_PunchHole(int fd, long offset, long length)
+{
+#ifdef FALLOC_FL_PUNCH_HOLE
+   if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+         offset, length) < 0)
+      return (errno);
+   return (0);
+#else
+   return (EOPNOTSUPP);
+#endif
+}
+
 #endif
@@ -0,0 +1,600 @@
+//
+// File:        pf_log.cc
+// Description: PF_Log class implementation
+//
+
+#include <cerrno>
+#include <cstddef>
+#include <ctime>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#include "pf_log.h"
+#include "statistics.h"
+
+using namespace std;
+
+// This is defined within pf_buffermgr.cc
+extern StatisticsMgr *pStatisticsMgr;
+
+//
+// PF_Log
+//
+// Desc: Constructor.  Nothing is logged until Open is called.
+//
+PF_Log::PF_Log()
+{
+   fd = -1;
+   baseLSN = 0;
+   writtenLSN = 0;
+   syncedLSN = 0;
+   epoch = 0;
+   nextFileNo = 0;
+}
+
+//
+// ~PF_Log
+//
+// Desc: Destructor.  The records that were not written are lost, as in a
+//       crash: Close should have been called.
+//
+PF_Log::~PF_Log()
+{
+   if (fd >= 0)
+      close(fd);
+}
+
+//
+// Open
+//
+// Desc: Start logging, into an empty log.  Whatever the log held must
+//       have been recovered first.
+// In:   logName - name of the log file, created if need be
+// Ret:  PF_FILEOPEN if a log is open, PF_UNIX or 0
+//
+RC PF_Log::Open(const char *logName)
+{
+   lock_guard<mutex> lock(logMutex);
+
+   if (fd >= 0)
+      return (PF_FILEOPEN);
+
+   if ((fd = open(logName,
+#ifdef PC
+         O_BINARY |
+#endif
+         O_CREAT | O_RDWR, CREATION_MASK)) < 0)
+      return (PF_UNIX);
+   if (ftruncate(fd, 0) < 0) {
+      close(fd);
+      fd = -1;
+      return (PF_UNIX);
+   }
+
+   buffer.clear();
+   syncedLSN = writtenLSN = baseLSN;
+   epoch = (int)time(NULL) ^ ((int)getpid() << 16);
+   fileNos.clear();
+   openNames.clear();
+   imaged.clear();
+   fileNames.clear();
+
+   // Return ok
+   return (0);
+}
+
+//
+// Close
+//
+// Desc: Write what is left of the log and stop logging.  The log is not
+//       synced: the buffer manager checkpoints it first.
+// Ret:  PF_UNIX, PF_INCOMPLETEWRITE or 0
+//
+RC PF_Log::Close()
+{
+   lock_guard<mutex> lock(logMutex);
+
+   if (fd < 0)
+      return (0);
+
+   RC rc = WriteBuffer();
+   if (close(fd) < 0 && !rc)
+      rc = PF_UNIX;
+   fd = -1;
+   fileNos.clear();
+   openNames.clear();
+   return (rc);
+}
+
+//
+// IsOpen
+//
+// Desc: Tell whether changes are being logged
+// Ret:  TRUE or FALSE
+//
+int PF_Log::IsOpen()
+{
+   lock_guard<mutex> lock(logMutex);
+   return (fd >= 0);
+}
+
+//
+// Size
+//
+// Desc: # of bytes logged since the log was opened or truncated
+//
+long PF_Log::Size()
+{
+   lock_guard<mutex> lock(logMutex);
+   return (writtenLSN + buffer.size() - baseLSN);
+}
+
+//
+// Created
+//
+// Desc: Log that a file was created, so that what is logged about the
+//       files of that name before is not applied to it.  The record is
+//       made durable right away.
+// In:   fileName - name of the file
+// Ret:  PF return code
+//
+RC PF_Log::Created(const char *fileName)
+{
+   long lsn;
+   RC rc;
+   if ((rc = LogName(PF_LOG_CREATE, fileName, lsn)))
+      return (rc);
+   return (Flush(lsn));
+}
+
+//
+// Destroyed
+//
+// Desc: Log that a file was destroyed, durably, like Created
+// In:   fileName - name of the file
+// Ret:  PF return code
+//
+RC PF_Log::Destroyed(const char *fileName)
+{
+   long lsn;
+   RC rc;
+   if ((rc = LogName(PF_LOG_DESTROY, fileName, lsn)))
+      return (rc);
+   return (Flush(lsn));
+}
+
+//
+// Opened
+//
+// Desc: Give a file opened for writing a number, and log its name, so
+//       that its pages are logged until it is closed
+// In:   fileName - name of the file
+//       _fd - OS file descriptor of the file
+// Ret:  PF return code
+//
+RC PF_Log::Opened(const char *fileName, int _fd)
+{
+   lock_guard<mutex> lock(logMutex);
+
+   if (fd < 0)
+      return (0);
+
+   int fileNo = nextFileNo++;
+   fileNos[_fd] = fileNo;
+   openNames[_fd] = fileName;
+   fileNames.insert(fileName);
+
+   PF_LogRecHdr rec;
+   memset(&rec, 0, sizeof(rec));
+   rec.type = PF_LOG_FILE;
+   rec.fileNo = fileNo;
+   rec.numBytes = strlen(fileName);
+   long lsn;
+   return (Append(rec, fileName, rec.numBytes, NULL, 0, lsn));
+}
+
+//
+// Closed
+//
+// Desc: Stop logging the pages of a file, once they have been flushed
+// In:   _fd - OS file descriptor of the file
+//
+void PF_Log::Closed(int _fd)
+{
+   lock_guard<mutex> lock(logMutex);
+   fileNos.erase(_fd);
+   openNames.erase(_fd);
+}
+
+//
+// IsLogged
+//
+// Desc: Tell whether the pages of a file are logged
+// In:   _fd - OS file descriptor of the file
+// Ret:  TRUE or FALSE
+//
+int PF_Log::IsLogged(int _fd)
+{
+   lock_guard<mutex> lock(logMutex);
+   return (fd >= 0 && fileNos.count(_fd) > 0);
+}
+
+//
+// LogPage
+//
+// Desc: Log the changes made to a page since it was last logged.  Every
+//       range of changed bytes gets an UPDATE record; ranges closer than
+//       the size of a record header share one.  The first time the page is
+//       logged since the last truncation, the whole page as it was goes
+//       first in an IMAGE record.
+// In:   _fd - OS file descriptor of the file
+//       pageNum - the page
+//       pShadow - the page as last logged
+//       pData - the page now
+//       pageSize - # of bytes of the page, PF_PageHdr included
+// Out:  pShadow - same as pData
+//       lsn - LSN of the last record, unchanged if nothing was logged
+// Ret:  PF return code
+//
+RC PF_Log::LogPage(int _fd, PageNum pageNum, char *pShadow,
+      const char *pData, int pageSize, long &lsn)
+{
+   RC rc;
+   lock_guard<mutex> lock(logMutex);
+
+   unordered_map<int, int>::iterator it = fileNos.find(_fd);
+   if (fd < 0 || it == fileNos.end() || !memcmp(pShadow, pData, pageSize))
+      return (0);
+
+   PF_LogRecHdr rec;
+   memset(&rec, 0, sizeof(rec));
+   rec.fileNo = it->second;
+   rec.pageNum = pageNum;
+
+   if (imaged.insert(make_pair(rec.fileNo, pageNum)).second) {
+      rec.type = PF_LOG_IMAGE;
+      rec.numBytes = pageSize;
+      if ((rc = Append(rec, pShadow, pageSize, NULL, 0, lsn)))
+         return (rc);
+   }
+
+   const int gap = sizeof(PF_LogRecHdr);
+   int i = 0;
+   while (i < pageSize) {
+
+      // Skip what did not change, a cache line at a time first
+      while (i + 64 <= pageSize && !memcmp(pShadow + i, pData + i, 64))
+         i += 64;
+      while (i < pageSize && pShadow[i] == pData[i])
+         i++;
+      if (i == pageSize)
+         break;
+
+      // Extend the range until the changes are gap bytes apart
+      int start = i;
+      int end = ++i;
+      while (i < pageSize && i - end < gap) {
+         if (pShadow[i] != pData[i])
+            end = i + 1;
+         i++;
+      }
+
+      rec.type = PF_LOG_UPDATE;
+      rec.offset = start;
+      rec.numBytes = end - start;
+      if ((rc = Append(rec, pShadow + start, end - start,
+            pData + start, end - start, lsn)))
+         return (rc);
+      memcpy(pShadow + start, pData + start, end - start);
+      i = end;
+   }
+
+   // Return ok
+   return (0);
+}
+
+//
+// Commit
+//
+// Desc: Append a COMMIT record: the records before it are committed once
+//       it is durable
+// Out:  lsn - LSN of the record
+// Ret:  PF return code
+//
+RC PF_Log::Commit(long &lsn)
+{
+   lock_guard<mutex> lock(logMutex);
+
+   if (fd < 0)
+      return (0);
+
+   PF_LogRecHdr rec;
+   memset(&rec, 0, sizeof(rec));
+   rec.type = PF_LOG_COMMIT;
+   return (Append(rec, NULL, 0, NULL, 0, lsn));
+}
+
+//
+// Write
+//
+// Desc: Write the log to the file, at least up to an LSN, without syncing
+// In:   lsn - LSN to reach
+// Ret:  PF_UNIX, PF_INCOMPLETEWRITE or 0
+//
+RC PF_Log::Write(long lsn)
+{
+   lock_guard<mutex> lock(logMutex);
+
+   if (fd < 0 || lsn <= writtenLSN)
+      return (0);
+   return (WriteBuffer());
+}
+
+//
+// Flush
+//
+// Desc: Make the log durable up to an LSN, before a page it covers is
+//       written
+// In:   lsn - LSN to reach
+// Ret:  PF_UNIX, PF_INCOMPLETEWRITE or 0
+//
+RC PF_Log::Flush(long lsn)
+{
+   RC rc;
+   lock_guard<mutex> lock(logMutex);
+
+   if (fd < 0 || lsn <= syncedLSN)
+      return (0);
+   if (lsn > writtenLSN && (rc = WriteBuffer()))
+      return (rc);
+
+#ifdef PF_STATS
+   pStatisticsMgr->Register(PF_SYNC, STAT_ADDONE);
+#endif
+   if (fdatasync(fd) < 0)
+      return (PF_UNIX);
+   syncedLSN = writtenLSN;
+
+   // Return ok
+   return (0);
+}
+
+//
+// Synced
+//
+// Desc: The log file was synced, by a group commit, after the records up
+//       to an LSN were written
+// In:   lsn - LSN the log is durable up to
+//
+void PF_Log::Synced(long lsn)
+{
+   lock_guard<mutex> lock(logMutex);
+   if (lsn > syncedLSN && lsn <= writtenLSN)
+      syncedLSN = lsn;
+}
+
+//
+// GetFd
+//
+// Desc: OS file descriptor of the log file, -1 if no log is open
+//
+int PF_Log::GetFd()
+{
+   lock_guard<mutex> lock(logMutex);
+   return (fd);
+}
+
+//
+// GetFileNames
+//
+// Desc: List the files whose pages were logged since the last truncation,
+//       which must be synced before the log is truncated again
+// Out:  names - the names of the files
+//
+void PF_Log::GetFileNames(vector<string> &names)
+{
+   lock_guard<mutex> lock(logMutex);
+   names.assign(fileNames.begin(), fileNames.end());
+}
+
+//
+// Truncate
+//
+// Desc: Start the log over, once every page it covers is durable.  The
+//       files that are open are named again at the start of the log.
+//       LSNs keep growing, and the records get a new epoch, so that what
+//       is left of the old log past the end of the new one, if the
+//       truncation does not reach the disk, is not taken for new records.
+// Ret:  PF return code
+//
+RC PF_Log::Truncate()
+{
+   lock_guard<mutex> lock(logMutex);
+
+   if (fd < 0)
+      return (0);
+   if (ftruncate(fd, 0) < 0)
+      return (PF_UNIX);
+
+   baseLSN = syncedLSN = writtenLSN = writtenLSN + buffer.size();
+   buffer.clear();
+   epoch++;
+   imaged.clear();
+   fileNames.clear();
+
+   for (unordered_map<int, string>::iterator it = openNames.begin();
+         it != openNames.end(); ++it) {
+      PF_LogRecHdr rec;
+      memset(&rec, 0, sizeof(rec));
+      rec.type = PF_LOG_FILE;
+      rec.fileNo = fileNos[it->first];
+      rec.numBytes = it->second.size();
+      fileNames.insert(it->second);
+
+      long lsn;
+      RC rc;
+      if ((rc = Append(rec, it->second.c_str(), rec.numBytes, NULL, 0, lsn)))
+         return (rc);
+   }
+
+   // Return ok
+   return (0);
+}
+
+//
+// Read
+//
+// Desc: Read the records of a log, up to the first one a crash left
+//       incomplete: cut short, with a bad CRC, or from an older epoch
+// In:   logName - name of the log file
+// Out:  records - the records, one after the other, empty if there is
+//       no log
+// Ret:  PF_UNIX, PF_INCOMPLETEREAD or 0
+//
+RC PF_Log::Read(const char *logName, vector<char> &records)
+{
+   records.clear();
+
+   int logFd = open(logName,
+#ifdef PC
+         O_BINARY |
+#endif
+         O_RDONLY);
+   if (logFd < 0)
+      return (errno == ENOENT ? 0 : PF_UNIX);
+
+   struct stat st;
+   if (fstat(logFd, &st) < 0) {
+      close(logFd);
+      return (PF_UNIX);
+   }
+   records.resize(st.st_size);
+   long n = st.st_size ? pread(logFd, &records[0], st.st_size, 0) : 0;
+   close(logFd);
+   if (n < 0)
+      return (PF_UNIX);
+   if (n != st.st_size)
+      return (PF_INCOMPLETEREAD);
+
+   long offset = 0;
+   int firstEpoch = 0;
+   while (offset + (long)sizeof(PF_LogRecHdr) <= n) {
+      PF_LogRecHdr rec;
+      memcpy(&rec, &records[offset], sizeof(rec));
+      if (rec.length < (int)sizeof(rec) || rec.length % sizeof(int) ||
+            offset + rec.length > n ||
+            (offset > 0 && rec.epoch != firstEpoch))
+         break;
+
+      unsigned int crc = rec.crc;
+      memset(&records[offset] + offsetof(PF_LogRecHdr, crc), 0,
+            sizeof(rec.crc));
+      if (crc32(0L, (const Bytef *)&records[offset], rec.length) != crc)
+         break;
+
+      firstEpoch = rec.epoch;
+      offset += rec.length;
+   }
+   records.resize(offset);
+
+   // Return ok
+   return (0);
+}
+
+//
+// Append
+//
+// Desc: Internal.  Append a record to the buffer, and write the buffer
+//       once it holds PF_LOG_BUFFER_SIZE bytes.  logMutex must be held.
+// In:   rec - header of the record, type and fields set
+//       p1, n1 - first piece of data, NULL if none
+//       p2, n2 - second piece of data, NULL if none
+// Out:  lsn - LSN of the record
+// Ret:  PF return code
+//
+RC PF_Log::Append(PF_LogRecHdr &rec, const char *p1, int n1,
+      const char *p2, int n2, long &lsn)
+{
+   int length = sizeof(rec) + n1 + n2;
+   rec.length = (length + sizeof(int) - 1) / sizeof(int) * sizeof(int);
+   rec.epoch = epoch;
+   rec.crc = 0;
+
+   size_t start = buffer.size();
+   buffer.resize(start + rec.length, 0);
+   char *p = &buffer[start];
+   memcpy(p, &rec, sizeof(rec));
+   if (n1 > 0)
+      memcpy(p + sizeof(rec), p1, n1);
+   if (n2 > 0)
+      memcpy(p + sizeof(rec) + n1, p2, n2);
+   rec.crc = crc32(0L, (const Bytef *)p, rec.length);
+   memcpy(p + offsetof(PF_LogRecHdr, crc), &rec.crc, sizeof(rec.crc));
+
+   lsn = writtenLSN + buffer.size();
+
+#ifdef PF_STATS
+   pStatisticsMgr->Register(PF_LOGRECORD, STAT_ADDONE);
+#endif
+
+   if (buffer.size() >= (size_t)PF_LOG_BUFFER_SIZE)
+      return (WriteBuffer());
+
+   // Return ok
+   return (0);
+}
+
+//
+// LogName
+//
+// Desc: Internal.  Append a CREATE or DESTROY record
+// In:   type - PF_LOG_CREATE or PF_LOG_DESTROY
+//       fileName - name of the file
+// Out:  lsn - LSN of the record, 0 if no log is open
+// Ret:  PF return code
+//
+RC PF_Log::LogName(int type, const char *fileName, long &lsn)
+{
+   lock_guard<mutex> lock(logMutex);
+
+   lsn = 0;
+   if (fd < 0)
+      return (0);
+
+   PF_LogRecHdr rec;
+   memset(&rec, 0, sizeof(rec));
+   rec.type = type;
+   rec.fileNo = -1;
+   rec.numBytes = strlen(fileName);
+   return (Append(rec, fileName, rec.numBytes, NULL, 0, lsn));
+}
+
+//
+// WriteBuffer
+//
+// Desc: Internal.  Write the buffered records at the end of the log file.
+//       logMutex must be held.
+// Ret:  PF_UNIX, PF_INCOMPLETEWRITE or 0
+//
+RC PF_Log::WriteBuffer()
+{
+   if (buffer.empty())
+      return (0);
+
+#ifdef PF_STATS
+   pStatisticsMgr->Register(PF_LOGWRITE, STAT_ADDONE);
+#endif
+
+   long n = pwrite(fd, &buffer[0], buffer.size(), writtenLSN - baseLSN);
+   if (n < 0)
+      return (PF_UNIX);
+   if (n != (long)buffer.size())
+      return (PF_INCOMPLETEWRITE);
+
+   writtenLSN += buffer.size();
+   buffer.clear();
+
+   // Return ok
+   return (0);
+}
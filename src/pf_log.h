@@ -0,0 +1,142 @@
+//
+// File:        pf_log.h
+// Description: PF_Log interface, the write-ahead log of the PF layer
+//
+// While a log is open, the changes made to the pages of the files opened
+// for writing are logged before the pages are written back, so that a
+// statement only has to make its log records durable to commit: the
+// pages themselves are written whenever the buffer manager likes.
+//
+// The buffer manager keeps a shadow copy of every logged page, as it was
+// when last logged.  When a page is about to be written, or at a commit,
+// LogPage compares the page with its shadow and appends an UPDATE record
+// for every range of bytes that changed, with their before and after
+// images.  The first time a page is logged after the log was truncated,
+// its whole shadow goes first in an IMAGE record, so that a page torn by
+// a crash is rebuilt from scratch.  The LSN of a record is the offset of
+// its end in everything ever logged since the log was opened; the buffer
+// manager remembers the LSN of the last record of each page and flushes
+// the log up to it before writing the page.
+//
+// Records are appended to a buffer, written to the log file at a commit
+// or when a page needs them, and each carries a CRC of itself, so that
+// recovery stops at the first record a crash left incomplete.  The
+// records of a statement end with a COMMIT record; those logged after the
+// last COMMIT belong to a statement that never committed.  Statements are
+// expected to commit one at a time.
+//
+// The files are known in the log by a number given when they are opened,
+// named by a FILE record.  CREATE and DESTROY records, made durable right
+// away, tell recovery that the records of the files of that name logged
+// before them are about another file.
+//
+// The log only grows until it is truncated, by a checkpoint of the buffer
+// manager once every logged page has been written and synced.
+//
+
+#ifndef PF_LOG_H
+#define PF_LOG_H
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "pf_internal.h"
+
+//
+// PF_LogType - kinds of log records
+//
+enum PF_LogType {
+   PF_LOG_FILE = 1,     // fileNo names a file, followed by the name
+   PF_LOG_CREATE,       // a file was created, followed by the name
+   PF_LOG_DESTROY,      // a file was destroyed, followed by the name
+   PF_LOG_IMAGE,        // followed by the whole page before the changes
+   PF_LOG_UPDATE,       // followed by the before and after images of
+                        // numBytes bytes at offset in the page
+   PF_LOG_COMMIT        // the records before it are committed
+};
+
+//
+// PF_LogRecHdr - header of a log record
+//
+struct PF_LogRecHdr {
+    int     type;       // PF_LogType
+    int     length;     // # of bytes of the record, header included,
+                        // rounded up to a multiple of sizeof(int)
+    int     fileNo;     // file of the record
+    PageNum pageNum;    // page of an IMAGE or an UPDATE
+    int     offset;     // first byte changed, PF_PageHdr included
+    int     numBytes;   // # of bytes of each image, or of the name
+    int     epoch;      // changes every time the log is truncated
+    unsigned int crc;   // of the whole record with crc set to 0
+};
+
+//
+// PF_Log - append log records, flush them, and read them back
+//
+class PF_Log {
+public:
+    PF_Log        ();
+    ~PF_Log       ();
+
+    // Start an empty log in logName, and close it
+    RC   Open      (const char *logName);
+    RC   Close     ();
+    int  IsOpen    ();
+    long Size      ();                      // # of bytes logged
+
+    // A file was created or destroyed: made durable at once
+    RC   Created   (const char *fileName);
+    RC   Destroyed (const char *fileName);
+
+    // A file was opened for writing as fd, and closed.  Only the pages
+    // of the files opened while the log is open are logged.
+    RC   Opened    (const char *fileName, int fd);
+    void Closed    (int fd);
+    int  IsLogged  (int fd);
+
+    // Log how pData differs from pShadow, and copy it to pShadow.  lsn
+    // is set to the LSN of the last record, and left alone if the page
+    // did not change or its file is not logged.
+    RC   LogPage   (int fd, PageNum pageNum, char *pShadow,
+                    const char *pData, int pageSize, long &lsn);
+
+    // Append a COMMIT record, write the log up to an LSN to the file, and
+    // make it durable too
+    RC   Commit    (long &lsn);
+    RC   Write     (long lsn);
+    RC   Flush     (long lsn);
+    void Synced    (long lsn);              // someone else synced it
+    int  GetFd     ();                      // of the log file
+
+    // Names of the files logged since the last Truncate, and start over
+    void GetFileNames (std::vector<std::string> &names);
+    RC   Truncate  ();
+
+    // Read the complete records of a log, none if there is no log
+    static RC Read (const char *logName, std::vector<char> &records);
+
+private:
+    // Append a record made of rec and up to two pieces of data
+    RC   Append    (PF_LogRecHdr &rec, const char *p1, int n1,
+                    const char *p2, int n2, long &lsn);
+    RC   LogName   (int type, const char *fileName, long &lsn);
+    RC   WriteBuffer ();                    // logMutex must be held
+
+    std::mutex    logMutex;                  // protects what follows
+    int           fd;                        // log file, -1 if closed
+    std::vector<char> buffer;                // records not written yet
+    long          baseLSN;                   // LSN of the start of the file
+    long          writtenLSN;                // end of what was written
+    long          syncedLSN;                 // end of what was synced
+    int           epoch;                     // of the records
+    int           nextFileNo;
+    std::unordered_map<int, int> fileNos;    // fd -> fileNo
+    std::unordered_map<int, std::string> openNames;  // fd -> file name
+    std::set<std::pair<int, PageNum> > imaged;  // (fileNo, page) logged
+                                                // since the truncate
+    std::set<std::string> fileNames;         // logged since the truncate
+};
+
+#endif
@@ -6,12 +6,22 @@
 //
 
 #include <cstdio>
+#include <cerrno>
+#include <map>
+#include <string>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/mman.h>
 #include "pf_internal.h"
 #include "pf_buffermgr.h"
+#include "pf_allocbitmap.h"
+#include "pf_warmlist.h"
+#include "pf_pagemap.h"
+#include "pf_log.h"
+
+using namespace std;
 
 //
 // PF_Manager
@@ -20,11 +30,15 @@
 //       Handles creation, deletion, opening and closing of files.
 //       It is associated with a PF_BufferMgr that manages the page
 //       buffer and executes the page replacement policies.
+// In:   policy - the buffer replacement policy
 //
-PF_Manager::PF_Manager()
+PF_Manager::PF_Manager(PF_ReplacementPolicy policy)
 {
    // Create Buffer Manager
-   pBufferMgr = new PF_BufferMgr(PF_BUFFER_SIZE);
+   pBufferMgr = new PF_BufferMgr(PF_BUFFER_SIZE, policy);
+   bDirectIO = FALSE;
+   extentPages = PF_EXTENT_PAGES;
+   pWarmList = new PF_WarmList();
 }
 
 //
@@ -38,6 +52,7 @@ PF_Manager::~PF_Manager()
 {
    // Destroy the buffer manager objects
    delete pBufferMgr;
+   delete pWarmList;
 }
 
 //
@@ -45,13 +60,21 @@ PF_Manager::~PF_Manager()
 //
 // Desc: Create a new PF file named fileName
 // In:   fileName - name of file to create
-// Ret:  PF return code
+//       pageSize - bytes per page, a power of two from MEMORY_PAGE_SIZE
+//                  to PF_MAX_PAGE_SIZE
+//       bCompressed - TRUE to store the pages compressed, for files that
+//                  are mostly scanned
+// Ret:  PF_BADPAGESIZE or other PF return code
 //
-RC PF_Manager::CreateFile (const char *fileName)
+RC PF_Manager::CreateFile (const char *fileName, int pageSize,
+                           int bCompressed)
 {
    int fd;		// unix file descriptor
    int numBytes;		// return code form write syscall
 
+   if (!PF_ValidPageSize(pageSize))
+      return (PF_BADPAGESIZE);
+
    // Create file for exclusive use
    if ((fd = open(fileName,
 #ifdef PC
@@ -71,6 +94,13 @@ RC PF_Manager::CreateFile (const char *fileName)
    PF_FileHdr *hdr = (PF_FileHdr*)hdrBuf;
    hdr->firstFree = PF_PAGE_LIST_END;
    hdr->numPages = 0;
+   hdr->pageSize = pageSize;
+   hdr->bHasBitmap = TRUE;
+   hdr->bBitmapPages = TRUE;
+   hdr->numAllocated = 0;
+   hdr->bCompressed = bCompressed ? TRUE : FALSE;
+   hdr->mapSector = 0;
+   hdr->mapPages = 0;
 
    // Write header to file
    if((numBytes = write(fd, hdrBuf, PF_FILE_HDR_SIZE))
@@ -91,8 +121,8 @@ RC PF_Manager::CreateFile (const char *fileName)
    if(close(fd) < 0)
       return (PF_UNIX);
 
-   // Return ok
-   return (0);
+   // Nothing logged about an older file of that name applies to it
+   return (pBufferMgr->GetLog()->Created(fileName));
 }
 
 //
@@ -108,8 +138,11 @@ RC PF_Manager::DestroyFile (const char *fileName)
    if (unlink(fileName) < 0)
       return (PF_UNIX);
 
-   // Return ok
-   return (0);
+   // Its pages are not worth reading any more
+   pWarmList->Destroyed(fileName);
+
+   // Nor worth recovering
+   return (pBufferMgr->GetLog()->Destroyed(fileName));
 }
 
 //
@@ -122,51 +155,177 @@ RC PF_Manager::DestroyFile (const char *fileName)
 //       circumstances, crash the PF layer. Note that even if only one instance
 //       of a file is for writing, problems may occur because some writes may
 //       not be seen by a reader of another instance of the file.
+//       In PF_MMAP_READONLY mode the file is mapped read only and its
+//       pages are not copied into the buffer pool.  Pages that other
+//       handles have not written back yet are not seen.
+//       In PF_DIRECT mode, pages are transferred between the file and the
+//       buffer pool with O_DIRECT, so they are not cached twice.  The
+//       frames, the page offsets and the header are all aligned on
+//       MEMORY_PAGE_SIZE for that.  If the file system does not support
+//       O_DIRECT, the file is opened as in PF_READWRITE mode.
+//       The pages of a compressed file are neither where a mapping nor
+//       O_DIRECT expect them: it is always opened in PF_READWRITE mode,
+//       and its pages go through its page map.
 // In:   fileName - name of file to open
+//       mode - PF_READWRITE, PF_MMAP_READONLY or PF_DIRECT
 // Out:  fileHandle - refer to the open file
 //                    this function modifies local var's in fileHandle
 //       to point to the file data in the file table, and to point to the
 //       buffer manager object
 // Ret:  PF_FILEOPEN or other PF return code
 //
-RC PF_Manager::OpenFile (const char *fileName, PF_FileHandle &fileHandle)
+RC PF_Manager::OpenFile (const char *fileName, PF_FileHandle &fileHandle,
+                         PF_OpenMode mode)
 {
    int rc;                   // return code
 
+   // The header page, aligned for O_DIRECT
+   alignas(MEMORY_PAGE_SIZE) char hdrBuf[PF_FILE_HDR_SIZE];
+
    // Ensure file is not already open
    if (fileHandle.bFileOpen)
       return (PF_FILEOPEN);
 
+   if (mode == PF_READWRITE && bDirectIO)
+      mode = PF_DIRECT;
+
    // Open the file
-   if ((fileHandle.unixfd = open(fileName,
+   {
+      int flags = (mode == PF_MMAP_READONLY ? O_RDONLY : O_RDWR);
 #ifdef PC
-         O_BINARY |
+      flags |= O_BINARY;
 #endif
-         O_RDWR)) < 0)
-      return (PF_UNIX);
+      fileHandle.unixfd = -1;
+#ifdef O_DIRECT
+      // Fall back on buffered I/O where O_DIRECT is not supported
+      if (mode == PF_DIRECT)
+         fileHandle.unixfd = open(fileName, flags | O_DIRECT);
+#endif
+      if (fileHandle.unixfd < 0 &&
+            (fileHandle.unixfd = open(fileName, flags)) < 0)
+         return (PF_UNIX);
+   }
 
-   // Read the file header
+   // Read the file header.  The whole header page is read, as O_DIRECT
+   // requires.
    {
-      int numBytes = read(fileHandle.unixfd, (char *)&fileHandle.hdr,
-            sizeof(PF_FileHdr));
-      if (numBytes != sizeof(PF_FileHdr)) {
+      int numBytes = pread(fileHandle.unixfd, hdrBuf, PF_FILE_HDR_SIZE, 0);
+      if (numBytes < (int)sizeof(PF_FileHdr)) {
          rc = (numBytes < 0) ? PF_UNIX : PF_HDRREAD;
          goto err;
       }
+      memcpy(&fileHandle.hdr, hdrBuf, sizeof(PF_FileHdr));
+   }
+
+   // Open a compressed file again in PF_READWRITE mode if need be
+   fileHandle.pPageMap = NULL;
+   if (fileHandle.hdr.bCompressed && mode != PF_READWRITE) {
+      close(fileHandle.unixfd);
+      mode = PF_READWRITE;
+      if ((fileHandle.unixfd = open(fileName,
+#ifdef PC
+            O_BINARY |
+#endif
+            O_RDWR)) < 0)
+         return (PF_UNIX);
+   }
+
+   // Older files do not record their page size
+   if (fileHandle.hdr.pageSize == 0)
+      fileHandle.hdr.pageSize = MEMORY_PAGE_SIZE;
+   if (!PF_ValidPageSize(fileHandle.hdr.pageSize)) {
+      rc = PF_BADPAGESIZE;
+      goto err;
+   }
+
+   // Map the whole file, which must hold all of its pages
+   fileHandle.pMap = NULL;
+   fileHandle.pinCounts = NULL;
+   if (mode == PF_MMAP_READONLY) {
+      struct stat st;
+      if (fstat(fileHandle.unixfd, &st) < 0) {
+         rc = PF_UNIX;
+         goto err;
+      }
+      fileHandle.mapSize = st.st_size;
+      if (fileHandle.mapSize < PF_FILE_HDR_SIZE + fileHandle.hdr.numPages *
+            (long)fileHandle.hdr.pageSize) {
+         rc = PF_INCOMPLETEREAD;
+         goto err;
+      }
+
+      void *pMap = mmap(NULL, fileHandle.mapSize, PROT_READ, MAP_SHARED,
+            fileHandle.unixfd, 0);
+      if (pMap == MAP_FAILED) {
+         rc = PF_UNIX;
+         goto err;
+      }
+      fileHandle.pMap = (char *)pMap;
+      fileHandle.pinCounts = new short int[fileHandle.hdr.numPages]();
    }
 
    // Set file header to be not changed
    fileHandle.bHdrChanged = FALSE;
 
+   // Find out where the pages of a compressed file are, and have the
+   // buffer manager read and write them through the map
+   if (fileHandle.hdr.bCompressed) {
+      fileHandle.pPageMap = new PF_PageMap(fileHandle.unixfd,
+            fileHandle.hdr.pageSize);
+      if ((rc = fileHandle.pPageMap->Load(fileHandle.hdr)))
+         goto err;
+      pBufferMgr->SetPageMap(fileHandle.unixfd, fileHandle.pPageMap);
+   }
+
+   // Find out which pages are in use
+   if ((rc = fileHandle.ReadAllocBitmap(hdrBuf)))
+      goto err;
+
+   // Log the changes to the file if a log is open
+   if (mode != PF_MMAP_READONLY &&
+         (rc = pBufferMgr->GetLog()->Opened(fileName, fileHandle.unixfd)))
+      goto err;
+
    // Set local variables in file handle object to refer to open file
    fileHandle.pBufferMgr = pBufferMgr;
+   fileHandle.extentPages = fileHandle.pPageMap ? 0 : extentPages;
    fileHandle.bFileOpen = TRUE;
 
+   // Read the pages of the file that were resident before a restart, in
+   // the background.  A page may have been disposed of meanwhile.
+   {
+      vector<PageNum> warmPages;
+      pWarmList->Opened(fileName, fileHandle.unixfd, warmPages);
+      if (!fileHandle.pMap && !warmPages.empty()) {
+         size_t n = 0;
+         for (size_t i = 0; i < warmPages.size(); i++)
+            if (fileHandle.IsValidPageNum(warmPages[i]) &&
+                  fileHandle.pAllocBitmap->IsUsed(warmPages[i]))
+               warmPages[n++] = warmPages[i];
+         warmPages.resize(n);
+         pBufferMgr->PrefetchPages(fileHandle.unixfd, warmPages,
+               fileHandle.hdr.pageSize);
+      }
+   }
+
    // Return ok
    return 0;
 
 err:
-   // Close file
+   // Undo the mapping and close file
+   if (fileHandle.pMap) {
+      munmap(fileHandle.pMap, fileHandle.mapSize);
+      delete [] fileHandle.pinCounts;
+      fileHandle.pMap = NULL;
+      fileHandle.pinCounts = NULL;
+   }
+   delete fileHandle.pAllocBitmap;
+   fileHandle.pAllocBitmap = NULL;
+   if (fileHandle.pPageMap) {
+      pBufferMgr->SetPageMap(fileHandle.unixfd, NULL);
+      delete fileHandle.pPageMap;
+      fileHandle.pPageMap = NULL;
+   }
    close(fileHandle.unixfd);
    fileHandle.bFileOpen = FALSE;
 
@@ -194,11 +353,38 @@ RC PF_Manager::CloseFile(PF_FileHandle &fileHandle)
    if (!fileHandle.bFileOpen)
       return (PF_CLOSEDFILE);
 
+   // Remember which pages were resident, before they are flushed
+   {
+      vector<PageNum> pages;
+      if ((rc = pBufferMgr->GetResidentPages(fileHandle.unixfd, pages)))
+         return (rc);
+      pWarmList->Record(fileHandle.unixfd, pages);
+   }
+
    // Flush all buffers for this file and write out the header
    if ((rc = fileHandle.FlushPages()))
       return (rc);
+   pBufferMgr->GetLog()->Closed(fileHandle.unixfd);
+
+   // Drop the mapping of a PF_MMAP_READONLY file
+   if (fileHandle.pMap) {
+      if (munmap(fileHandle.pMap, fileHandle.mapSize) < 0)
+         return (PF_UNIX);
+      delete [] fileHandle.pinCounts;
+      fileHandle.pMap = NULL;
+      fileHandle.pinCounts = NULL;
+   }
+
+   delete fileHandle.pAllocBitmap;
+   fileHandle.pAllocBitmap = NULL;
+   if (fileHandle.pPageMap) {
+      pBufferMgr->SetPageMap(fileHandle.unixfd, NULL);
+      delete fileHandle.pPageMap;
+      fileHandle.pPageMap = NULL;
+   }
 
    // Close the file
+   pWarmList->Closed(fileHandle.unixfd);
    if (close(fileHandle.unixfd) < 0)
       return (PF_UNIX);
    fileHandle.bFileOpen = FALSE;
@@ -258,6 +444,349 @@ RC PF_Manager::ResizeBuffer(int iNewSize)
    return pBufferMgr->ResizeBuffer(iNewSize);
 }
 
+//
+// SetReplacementPolicy
+//
+// Desc: Changes the page replacement policy of the buffer manager.
+//       This routine will be called via the set command.
+// In:   policy - the new replacement policy
+// Ret:  Returns the result of PF_BufferMgr::SetReplacementPolicy
+//
+RC PF_Manager::SetReplacementPolicy(PF_ReplacementPolicy policy)
+{
+   return pBufferMgr->SetReplacementPolicy(policy);
+}
+
+//
+// SetReadAhead
+//
+// Desc: Changes the read-ahead window of the buffer manager.
+//       This routine will be called via the set command.
+// In:   numPages - the new window, 0 disables read-ahead
+// Ret:  Returns the result of PF_BufferMgr::SetReadAhead
+//
+RC PF_Manager::SetReadAhead(int numPages)
+{
+   return pBufferMgr->SetReadAhead(numPages);
+}
+
+//
+// SetBackgroundWriter
+//
+// Desc: Changes the number of pages the background writer of the buffer
+//       manager keeps clean.
+//       This routine will be called via the set command.
+// In:   numPages - the new number, 0 stops cleaning
+// Ret:  Returns the result of PF_BufferMgr::SetBackgroundWriter
+//
+RC PF_Manager::SetBackgroundWriter(int numPages)
+{
+   return pBufferMgr->SetBackgroundWriter(numPages);
+}
+
+//
+// SetCheckpointInterval
+//
+// Desc: Changes the time between the checkpoints of the buffer manager.
+//       This routine will be called via the set command.
+// In:   msecs - the new interval in milliseconds, 0 stops checkpointing
+// Ret:  Returns the result of PF_BufferMgr::SetCheckpointInterval
+//
+RC PF_Manager::SetCheckpointInterval(int msecs)
+{
+   return pBufferMgr->SetCheckpointInterval(msecs);
+}
+
+//
+// SetDirectIO
+//
+// Desc: Choose whether the files opened in PF_READWRITE mode are opened
+//       in PF_DIRECT mode instead.  Files already open are not affected.
+//       This routine will be called via the set command.
+// In:   bDirect - TRUE to use O_DIRECT
+// Ret:  Always returns 0
+//
+RC PF_Manager::SetDirectIO(int bDirect)
+{
+   bDirectIO = bDirect;
+   return (0);
+}
+
+//
+// SetExtentPages
+//
+// Desc: Choose by how many pages the files opened from now on grow when
+//       a page is allocated past their end.  Files already open are not
+//       affected.  This routine will be called via the set command.
+// In:   numPages - # of pages, 0 to grow the files one page at a time
+// Ret:  Always returns 0
+//
+RC PF_Manager::SetExtentPages(int numPages)
+{
+   extentPages = numPages > 0 ? numPages : 0;
+   return (0);
+}
+
+//
+// Commit
+//
+// Desc: Make the pages forced since the last Commit durable.  Called at
+//       the end of every statement.
+// Ret:  Returns the result of PF_BufferMgr::Commit
+//
+RC PF_Manager::Commit()
+{
+   return pBufferMgr->Commit();
+}
+
+//
+// SetDurability
+//
+// Desc: Choose what Commit does: nothing, sync the forced files, or sync
+//       them with the files forced by the statements committing at the
+//       same time.  This routine will be called via the set command.
+// In:   mode - PF_DURABLE_NONE, PF_DURABLE_STATEMENT or PF_DURABLE_GROUP
+// Ret:  Returns the result of PF_BufferMgr::SetDurability
+//
+RC PF_Manager::SetDurability(PF_Durability mode)
+{
+   return pBufferMgr->SetDurability(mode);
+}
+
+//
+// SetGroupCommitWindow
+//
+// Desc: Changes how long the first Commit of a group waits for the others
+//       in PF_DURABLE_GROUP mode.  This routine will be called via the set
+//       command.
+// In:   msecs - the new window in milliseconds
+// Ret:  Returns the result of PF_BufferMgr::SetGroupCommitWindow
+//
+RC PF_Manager::SetGroupCommitWindow(int msecs)
+{
+   return pBufferMgr->SetGroupCommitWindow(msecs);
+}
+
+//
+// SetGroupCommitSize
+//
+// Desc: Changes how many Commits end the wait of a group in
+//       PF_DURABLE_GROUP mode.  This routine will be called via the set
+//       command.
+// In:   maxGroup - # of Commits
+// Ret:  Returns the result of PF_BufferMgr::SetGroupCommitSize
+//
+RC PF_Manager::SetGroupCommitSize(int maxGroup)
+{
+   return pBufferMgr->SetGroupCommitSize(maxGroup);
+}
+
+//
+// OpenLog
+//
+// Desc: Recover the files from the write-ahead log an earlier run left,
+//       if any, then log the changes to the files opened for writing from
+//       now on, so that Commit only has to sync the log.  Called when a
+//       database is opened, before its files are.
+// In:   logName - name of the log
+// Ret:  PF_FILEOPEN if a log is open, or other PF return code
+//
+RC PF_Manager::OpenLog(const char *logName)
+{
+   RC rc;
+
+   if (pBufferMgr->GetLog()->IsOpen())
+      return (PF_FILEOPEN);
+   if ((rc = Recover(logName)))
+      return (rc);
+   return pBufferMgr->GetLog()->Open(logName);
+}
+
+//
+// CloseLog
+//
+// Desc: Write every logged page back, and stop logging.  Called when a
+//       database is closed, after its files are.
+// Ret:  Returns the result of PF_BufferMgr::CloseLog
+//
+RC PF_Manager::CloseLog()
+{
+   return pBufferMgr->CloseLog();
+}
+
+//
+// CheckpointLog
+//
+// Desc: Write every logged page back, sync the files, and start the log
+//       over.  Called between statements once the log is
+//       PF_LOG_CHECKPOINT_SIZE bytes long, after forcing the files that
+//       stay open.
+// Ret:  Returns the result of PF_BufferMgr::CheckpointLog
+//
+RC PF_Manager::CheckpointLog()
+{
+   return pBufferMgr->CheckpointLog();
+}
+
+//
+// GetLogSize
+//
+// Desc: Tell how much was logged since the last checkpoint
+// Out:  size - # of bytes, 0 if no log is open
+// Ret:  Always returns 0
+//
+RC PF_Manager::GetLogSize(long &size)
+{
+   size = pBufferMgr->GetLog()->Size();
+   return (0);
+}
+
+//
+// Recover
+//
+// Desc: Internal.  Bring the files a log has records about back to what
+//       the last COMMIT record of the log says: apply every IMAGE and
+//       UPDATE record in order, then undo the UPDATE records that follow
+//       the last COMMIT, in reverse order, with their before images.  The
+//       records about a file of a name that was created or destroyed
+//       later, and about files that no longer exist, are skipped.  The
+//       files are then forced and synced.  Applying a log twice gives the
+//       same files, so a crash during recovery is harmless.
+// In:   logName - name of the log
+// Ret:  PF return code, 0 if there is no log
+//
+RC PF_Manager::Recover(const char *logName)
+{
+   RC rc = 0;
+   vector<char> log;
+
+   if ((rc = PF_Log::Read(logName, log)))
+      return (rc);
+
+   // Index the records: where each starts, how many are committed, the
+   // file each file number names and where, and where each name was last
+   // created or destroyed
+   vector<long> recs;
+   size_t numCommitted = 0;
+   map<int, pair<string, size_t> > files;
+   map<string, size_t> fences;
+   for (long offset = 0; offset < (long)log.size(); ) {
+      PF_LogRecHdr rec;
+      memcpy(&rec, &log[offset], sizeof(rec));
+      string name(&log[offset] + sizeof(rec),
+            rec.type == PF_LOG_FILE || rec.type == PF_LOG_CREATE ||
+            rec.type == PF_LOG_DESTROY ? rec.numBytes : 0);
+
+      if (rec.type == PF_LOG_FILE)
+         files[rec.fileNo] = make_pair(name, recs.size());
+      else if (rec.type == PF_LOG_CREATE || rec.type == PF_LOG_DESTROY)
+         fences[name] = recs.size();
+      else if (rec.type == PF_LOG_COMMIT)
+         numCommitted = recs.size() + 1;
+
+      recs.push_back(offset);
+      offset += rec.length;
+   }
+
+   // The files are opened as their records come, once per name
+   map<string, PF_FileHandle> handles;
+   auto apply = [&](size_t i, int bUndo) -> RC {
+      PF_LogRecHdr rec;
+      memcpy(&rec, &log[recs[i]], sizeof(rec));
+      const char *data = &log[recs[i]] + sizeof(rec);
+      if (rec.type != PF_LOG_UPDATE && (bUndo || rec.type != PF_LOG_IMAGE))
+         return (0);
+
+      map<int, pair<string, size_t> >::iterator file = files.find(rec.fileNo);
+      if (file == files.end())
+         return (0);
+      const string &name = file->second.first;
+      map<string, size_t>::iterator fence = fences.find(name);
+      if (fence != fences.end() && fence->second > file->second.second)
+         return (0);
+
+      if (!handles.count(name)) {
+         RC rc = OpenFile(name.c_str(), handles[name]);
+         if (rc == PF_UNIX && errno == ENOENT)
+            return (0);
+         if (rc)
+            return (rc);
+      }
+      PF_FileHandle &fileHandle = handles[name];
+      if (!fileHandle.bFileOpen)
+         return (0);
+
+      if (rec.type == PF_LOG_IMAGE)
+         return (fileHandle.RecoverPage(rec.pageNum, 0, data, rec.numBytes));
+      return (fileHandle.RecoverPage(rec.pageNum, rec.offset,
+            bUndo ? data : data + rec.numBytes, rec.numBytes));
+   };
+
+   for (size_t i = 0; i < recs.size() && !rc; i++)
+      rc = apply(i, FALSE);
+   for (size_t i = recs.size(); i > numCommitted && !rc; i--)
+      rc = apply(i - 1, TRUE);
+
+   // Make the files durable before the log goes away
+   for (map<string, PF_FileHandle>::iterator it = handles.begin();
+         it != handles.end(); ++it) {
+      PF_FileHandle &fileHandle = it->second;
+      if (!fileHandle.bFileOpen)
+         continue;
+      if (!rc && !(rc = fileHandle.ForcePages()) &&
+            fdatasync(fileHandle.unixfd) < 0)
+         rc = PF_UNIX;
+      RC rcClose = CloseFile(fileHandle);
+      if (!rc)
+         rc = rcClose;
+   }
+
+   // Return ok or the first error
+   return (rc);
+}
+
+//
+// SaveWarmPages
+//
+// Desc: Write a manifest of the pages resident in the buffer: those of the
+//       open files, and those the files closed last had when they were
+//       closed, hottest first, up to the size of the buffer.  Called when
+//       a database is closed.
+// In:   manifestName - name of the manifest
+// Ret:  PF return code
+//
+RC PF_Manager::SaveWarmPages(const char *manifestName)
+{
+   RC rc;
+   vector<int> fds;
+
+   // Record the files that are still open as the most recent ones
+   pWarmList->OpenFds(fds);
+   for (size_t i = 0; i < fds.size(); i++) {
+      vector<PageNum> pages;
+      if ((rc = pBufferMgr->GetResidentPages(fds[i], pages)))
+         return (rc);
+      pWarmList->Record(fds[i], pages);
+   }
+
+   return pWarmList->Save(manifestName, pBufferMgr->GetNumPages());
+}
+
+//
+// LoadWarmPages
+//
+// Desc: Read a manifest written by SaveWarmPages.  The OS starts reading
+//       the pages it lists right away, and they are read into the buffer
+//       in the background when their file is opened.  Called when a
+//       database is opened.
+// In:   manifestName - name of the manifest
+// Ret:  PF return code, 0 if there is no manifest
+//
+RC PF_Manager::LoadWarmPages(const char *manifestName)
+{
+   return pWarmList->Load(manifestName, pBufferMgr->GetNumPages());
+}
+
 //------------------------------------------------------------------------------
 // Three Methods for manipulating raw memory buffers.  These memory
 // locations are handled by the buffer manager, but are not
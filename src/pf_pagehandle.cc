@@ -27,6 +27,7 @@ PF_PageHandle::PF_PageHandle()
 {
   pageNum = INVALID_PAGE;
   pPageData = NULL;
+  pageSize = 0;
 }
 
 //
@@ -55,6 +56,7 @@ PF_PageHandle::PF_PageHandle(const PF_PageHandle &pageHandle)
   // allocation involved
   this->pageNum = pageHandle.pageNum;
   this->pPageData = pageHandle.pPageData;
+  this->pageSize = pageHandle.pageSize;
 }
 
 //
@@ -75,6 +77,7 @@ PF_PageHandle& PF_PageHandle::operator= (const PF_PageHandle &pageHandle)
     // allocation involved
     this->pageNum = pageHandle.pageNum;
     this->pPageData = pageHandle.pPageData;
+    this->pageSize = pageHandle.pageSize;
   }
 
   // Return a reference to this
@@ -123,3 +126,26 @@ RC PF_PageHandle::GetPageNum(PageNum &_pageNum) const
   // Return ok
   return (0);
 }
+
+//
+// GetPageSize
+//
+// Desc: Access the size of the page data, which depends on the page size
+//       the file was created with.  The page handle object must refer to
+//       a pinned page.
+// Out:  pageSize - # of bytes at the address returned by GetData
+// Ret:  PF return code
+//
+RC PF_PageHandle::GetPageSize(int &_pageSize) const
+{
+
+  // Page must refer to a pinned page
+  if (pPageData == NULL)
+    return (PF_PAGEUNPINNED);
+
+  // Set page size
+  _pageSize = this->pageSize;
+
+  // Return ok
+  return (0);
+}
@@ -0,0 +1,422 @@
+//
+// File:        pf_pagemap.cc
+// Description: PF_PageMap class implementation
+//
+
+#include <unistd.h>
+#include <algorithm>
+#include <zlib.h>
+#include "pf_pagemap.h"
+
+using namespace std;
+
+//
+// PF_PageMap
+//
+// Desc: Constructor.  The map is empty until Load is called.
+// In:   _fd - OS file descriptor of the file
+//       _pageSize - page size of the file, PF_PageHdr included
+//
+PF_PageMap::PF_PageMap(int _fd, int _pageSize)
+{
+   fd = _fd;
+   pageSize = _pageSize;
+   endSector = 0;
+   mapSector = 0;
+   mapSectors = 0;
+   bChanged = FALSE;
+}
+
+//
+// Load
+//
+// Desc: Read the map of the file, and find the free runs of sectors
+//       between the images it lists
+// In:   hdr - header of the file
+// Ret:  PF_UNIX, PF_INCOMPLETEREAD or 0
+//
+RC PF_PageMap::Load(const PF_FileHdr &hdr)
+{
+   lock_guard<std::mutex> lock(mapMutex);
+
+   locs.assign(hdr.mapPages, PF_PageLoc());
+   freeRuns.clear();
+   endSector = 0;
+   mapSector = hdr.mapSector;
+   mapSectors = Sectors(hdr.mapPages * sizeof(PF_PageLoc));
+   bChanged = FALSE;
+
+   if (hdr.mapPages > 0) {
+      long numBytes = hdr.mapPages * (long)sizeof(PF_PageLoc);
+      long n = pread(fd, &locs[0], numBytes, Offset(mapSector));
+      if (n < 0)
+         return (PF_UNIX);
+      if (n != numBytes)
+         return (PF_INCOMPLETEREAD);
+   }
+
+   // The sectors in use, in file order
+   vector<pair<int, int> > used;
+   if (mapSectors > 0)
+      used.push_back(make_pair(mapSector, mapSectors));
+   for (size_t i = 0; i < locs.size(); i++)
+      if (locs[i].length > 0)
+         used.push_back(make_pair(locs[i].sector, Sectors(locs[i].length)));
+   sort(used.begin(), used.end());
+
+   for (size_t i = 0; i < used.size(); i++) {
+      if (used[i].first > endSector)
+         freeRuns[endSector] = used[i].first - endSector;
+      endSector = max(endSector, used[i].first + used[i].second);
+   }
+
+   // Return ok
+   return (0);
+}
+
+//
+// Store
+//
+// Desc: Write the map into the file, in place if it still fits in its
+//       sectors, and record where it is in the header to be written
+// In:   hdr - header of the file
+// Out:  hdr - mapSector and mapPages are set
+// Ret:  PF_UNIX, PF_INCOMPLETEWRITE or 0
+//
+RC PF_PageMap::Store(PF_FileHdr &hdr)
+{
+   lock_guard<std::mutex> lock(mapMutex);
+
+   if (bChanged) {
+      long numBytes = locs.size() * (long)sizeof(PF_PageLoc);
+      int numSectors = Sectors(numBytes);
+      if (numSectors > mapSectors) {
+         if (mapSectors > 0)
+            Free(mapSector, mapSectors);
+         mapSector = Allocate(numSectors);
+         mapSectors = numSectors;
+      }
+
+      long n = numBytes ? pwrite(fd, &locs[0], numBytes, Offset(mapSector))
+                        : 0;
+      if (n < 0)
+         return (PF_UNIX);
+      if (n != numBytes)
+         return (PF_INCOMPLETEWRITE);
+      bChanged = FALSE;
+   }
+
+   hdr.mapSector = mapSector;
+   hdr.mapPages = locs.size();
+
+   // Return ok
+   return (0);
+}
+
+//
+// IsChanged
+//
+// Desc: Tell whether pages moved since the map was last stored
+// Ret:  TRUE or FALSE
+//
+int PF_PageMap::IsChanged()
+{
+   lock_guard<std::mutex> lock(mapMutex);
+   return (bChanged);
+}
+
+//
+// ReadPage
+//
+// Desc: Read the image of a page and decompress it.  A page that was
+//       never written reads as zeros, like a hole in a file.
+// In:   pageNum - page to read
+//       dest - page size bytes
+// Out:  dest - contents of the page
+// Ret:  PF_UNIX, PF_INCOMPLETEREAD or 0
+//
+RC PF_PageMap::ReadPage(PageNum pageNum, char *dest)
+{
+   PF_PageLoc loc = { 0, 0 };
+   {
+      lock_guard<std::mutex> lock(mapMutex);
+      if (pageNum < (int)locs.size())
+         loc = locs[pageNum];
+   }
+
+   if (loc.length == 0) {
+      memset(dest, 0, pageSize);
+      return (0);
+   }
+
+   // A page stored as is is read in place
+   if (loc.length == pageSize) {
+      long n = pread(fd, dest, pageSize, Offset(loc.sector));
+      if (n < 0)
+         return (PF_UNIX);
+      return (n == pageSize ? 0 : PF_INCOMPLETEREAD);
+   }
+
+   vector<char> image(loc.length);
+   long n = pread(fd, &image[0], loc.length, Offset(loc.sector));
+   if (n < 0)
+      return (PF_UNIX);
+   if (n != loc.length)
+      return (PF_INCOMPLETEREAD);
+   return (Expand(&image[0], loc.length, dest));
+}
+
+//
+// WritePage
+//
+// Desc: Compress a page and write its image, where it was if it fits,
+//       somewhere else otherwise
+// In:   pageNum - page to write
+//       source - contents of the page
+// Ret:  PF_UNIX, PF_INCOMPLETEWRITE or 0
+//
+RC PF_PageMap::WritePage(PageNum pageNum, const char *source)
+{
+   // Only keep the compressed image if it saves a sector
+   vector<char> image(pageSize);
+   uLongf length = pageSize - PF_SECTOR_SIZE;
+   const char *pImage = &image[0];
+   if (compress2((Bytef *)&image[0], &length, (const Bytef *)source,
+         pageSize, Z_BEST_SPEED) != Z_OK) {
+      length = pageSize;
+      pImage = source;
+   }
+
+   PF_PageLoc loc;
+   {
+      lock_guard<std::mutex> lock(mapMutex);
+
+      if (pageNum >= (int)locs.size())
+         locs.resize(pageNum + 1, PF_PageLoc());
+      loc = locs[pageNum];
+
+      int numSectors = Sectors(length);
+      int oldSectors = loc.length ? Sectors(loc.length) : 0;
+      if (numSectors > oldSectors) {
+         if (oldSectors > 0)
+            Free(loc.sector, oldSectors);
+         loc.sector = Allocate(numSectors);
+      }
+      else if (numSectors < oldSectors)
+         Free(loc.sector + numSectors, oldSectors - numSectors);
+      loc.length = length;
+
+      locs[pageNum] = loc;
+      bChanged = TRUE;
+   }
+
+   long n = pwrite(fd, pImage, length, Offset(loc.sector));
+   if (n < 0)
+      return (PF_UNIX);
+   return (n == (long)length ? 0 : PF_INCOMPLETEWRITE);
+}
+
+//
+// Locate
+//
+// Desc: Tell where the image of a page is, so that a read ahead reads it
+//       into a frame, which Inflate then turns into the page
+// In:   pageNum - page to read
+// Out:  offset - file offset of the image
+//       length - # of bytes to read, at most the page size
+// Ret:  PF_INVALIDPAGE if the page was never written, or 0
+//
+RC PF_PageMap::Locate(PageNum pageNum, long &offset, int &length)
+{
+   lock_guard<std::mutex> lock(mapMutex);
+
+   if (pageNum >= (int)locs.size() || locs[pageNum].length == 0)
+      return (PF_INVALIDPAGE);
+
+   offset = Offset(locs[pageNum].sector);
+   length = locs[pageNum].length;
+
+   // Return ok
+   return (0);
+}
+
+//
+// Inflate
+//
+// Desc: Decompress, in place, the image of a page that a read ahead read
+//       into a frame.  The page is not written while it is read ahead, so
+//       its image has not moved since Locate.
+// In:   pageNum - page read
+//       dest - the frame, page size bytes
+//       numBytes - # of bytes read, -1 on error
+// Out:  dest - contents of the page
+// Ret:  the page size, or -1 if the image could not be read or expanded
+//
+int PF_PageMap::Inflate(PageNum pageNum, char *dest, int numBytes)
+{
+   long offset;
+   int  length;
+   if (numBytes < 0 || Locate(pageNum, offset, length) || numBytes != length)
+      return (-1);
+   if (length == pageSize)
+      return (pageSize);
+
+   vector<char> image(dest, dest + length);
+   return (Expand(&image[0], length, dest) ? -1 : pageSize);
+}
+
+//
+// FreePage
+//
+// Desc: Give back the sectors of a page that was disposed of, punched out
+//       of the file first so that they take no disk space until they are
+//       reused.  The page reads as zeros from now on.
+// In:   pageNum - page disposed of
+// Ret:  PF_UNIX or 0
+//
+RC PF_PageMap::FreePage(PageNum pageNum)
+{
+   lock_guard<std::mutex> lock(mapMutex);
+
+   if (pageNum >= (int)locs.size() || locs[pageNum].length == 0)
+      return (0);
+
+   // The sectors are punched while they are still the page's, so that no
+   // other page is written to them meanwhile
+   PF_PageLoc loc = locs[pageNum];
+   int numSectors = Sectors(loc.length);
+   int err = PF_PunchHole(fd, Offset(loc.sector),
+         numSectors * (long)PF_SECTOR_SIZE);
+   if (err && err != EOPNOTSUPP && err != ENOSYS) {
+      errno = err;
+      return (PF_UNIX);
+   }
+
+   Free(loc.sector, numSectors);
+   locs[pageNum] = PF_PageLoc();
+   bChanged = TRUE;
+
+   // Return ok
+   return (0);
+}
+
+//
+// Truncate
+//
+// Desc: Forget the pages from numPages on, and give their sectors back
+// In:   numPages - new number of pages
+// Out:  fileSize - # of bytes of the file the pages and the map still use
+//
+void PF_PageMap::Truncate(PageNum numPages, long &fileSize)
+{
+   lock_guard<std::mutex> lock(mapMutex);
+
+   for (int i = numPages; i < (int)locs.size(); i++)
+      if (locs[i].length > 0)
+         Free(locs[i].sector, Sectors(locs[i].length));
+   if (numPages < (int)locs.size()) {
+      locs.resize(numPages);
+      bChanged = TRUE;
+   }
+
+   fileSize = Offset(endSector);
+}
+
+//
+// Sectors
+//
+// Desc: Internal.  # of sectors an image of length bytes takes
+//
+int PF_PageMap::Sectors(int length)
+{
+   return ((length + PF_SECTOR_SIZE - 1) / PF_SECTOR_SIZE);
+}
+
+//
+// Offset
+//
+// Desc: Internal.  File offset of a sector, past the file header
+//
+long PF_PageMap::Offset(int sector)
+{
+   return (PF_FILE_HDR_SIZE + sector * (long)PF_SECTOR_SIZE);
+}
+
+//
+// Expand
+//
+// Desc: Internal.  Decompress the image of a page
+// In:   image - the compressed image
+//       length - # of bytes of the image
+//       dest - page size bytes
+// Out:  dest - contents of the page
+// Ret:  PF_INCOMPLETEREAD if the image is damaged, or 0
+//
+RC PF_PageMap::Expand(const char *image, int length, char *dest) const
+{
+   uLongf destLen = pageSize;
+   if (uncompress((Bytef *)dest, &destLen, (const Bytef *)image,
+         length) != Z_OK || destLen != (uLongf)pageSize)
+      return (PF_INCOMPLETEREAD);
+
+   // Return ok
+   return (0);
+}
+
+//
+// Allocate
+//
+// Desc: Internal.  Take the first free run of at least numSectors
+//       sectors, or grow the file
+// In:   numSectors - # of sectors needed
+// Ret:  first sector of the run
+//
+int PF_PageMap::Allocate(int numSectors)
+{
+   for (map<int, int>::iterator it = freeRuns.begin();
+         it != freeRuns.end(); ++it)
+      if (it->second >= numSectors) {
+         int sector = it->first;
+         int left = it->second - numSectors;
+         freeRuns.erase(it);
+         if (left > 0)
+            freeRuns[sector + numSectors] = left;
+         return (sector);
+      }
+
+   int sector = endSector;
+   endSector += numSectors;
+   return (sector);
+}
+
+//
+// Free
+//
+// Desc: Internal.  Give a run of sectors back, merging it with the free
+//       runs around it.  A run at the end of the file is given back to
+//       the end.
+// In:   sector - first sector of the run
+//       numSectors - # of sectors of the run
+//
+void PF_PageMap::Free(int sector, int numSectors)
+{
+   map<int, int>::iterator next = freeRuns.lower_bound(sector);
+   if (next != freeRuns.end() && sector + numSectors == next->first) {
+      numSectors += next->second;
+      next = freeRuns.erase(next);
+   }
+   if (next != freeRuns.begin()) {
+      map<int, int>::iterator prev = next;
+      --prev;
+      if (prev->first + prev->second == sector) {
+         sector = prev->first;
+         numSectors += prev->second;
+         freeRuns.erase(prev);
+      }
+   }
+
+   if (sector + numSectors == endSector)
+      endSector = sector;
+   else
+      freeRuns[sector] = numSectors;
+}
@@ -0,0 +1,98 @@
+//
+// File:        pf_pagemap.h
+// Description: PF_PageMap interface, the page-offset map of a compressed
+//              PF file
+//
+// The pages of a file created compressed are compressed with zlib at its
+// fastest level when they are written back, and decompressed when they
+// are read.  A compressed page takes a whole number of PF_SECTOR_SIZE
+// byte sectors, so pages no longer sit at pageNum * pageSize: the map
+// records, for each page, the first sector of its image and its length.
+// A page that does not shrink by at least one sector is stored as is,
+// with the length of a page.
+//
+// A page rewritten into no more sectors than it had stays in place.
+// Otherwise it moves to the first run of free sectors large enough, or to
+// the end of the file, and its old sectors become free.  The free runs
+// are the gaps between the images, found again when the map is loaded.
+//
+// The sectors of a page disposed of are given back and punched out of the
+// file, and the page reads as zeros again, as if it were never written.
+//
+// The map itself is stored in sectors of the file too, found through the
+// file header, and is written with the header.  Like the allocation
+// bitmap of the header, it is only current on disk once the pages have
+// been forced or flushed.
+//
+
+#ifndef PF_PAGEMAP_H
+#define PF_PAGEMAP_H
+
+#include <mutex>
+#include <map>
+#include <vector>
+#include "pf_internal.h"
+
+//
+// PF_PageLoc - where the image of a page is
+//
+struct PF_PageLoc {
+    int sector;         // first sector, counted from the end of the header
+    int length;         // # of bytes of the image, the page size if the
+                        // page is stored as is, 0 if it was never written
+};
+
+//
+// PF_PageMap - where the pages of a compressed file are
+//
+class PF_PageMap {
+public:
+    PF_PageMap    (int fd, int pageSize);
+
+    // Read the map the file header points to, and write it back with the
+    // header if it changed.  Store sets mapSector and mapPages in hdr.
+    RC   Load     (const PF_FileHdr &hdr);
+    RC   Store    (PF_FileHdr &hdr);
+    int  IsChanged ();                      // TRUE if Store has work to do
+
+    // Read and decompress a page, compress and write a page
+    RC   ReadPage (PageNum pageNum, char *dest);
+    RC   WritePage (PageNum pageNum, const char *source);
+
+    // Where to read the image of a page from in the background, and turn
+    // the numBytes read into dest into the page.  Locate fails on a page
+    // that was never written.
+    RC   Locate   (PageNum pageNum, long &offset, int &length);
+    int  Inflate  (PageNum pageNum, char *dest, int numBytes);
+
+    // Give back the sectors of a page disposed of, and forget the pages
+    // from numPages on.  Truncate sets fileSize to the # of bytes the file
+    // still needs.
+    RC   FreePage (PageNum pageNum);
+    void Truncate (PageNum numPages, long &fileSize);
+
+private:
+    // # of sectors of an image of length bytes, and its file offset
+    static int  Sectors (int length);
+    static long Offset  (int sector);
+
+    // Decompress an image, of length bytes, into dest
+    RC   Expand   (const char *image, int length, char *dest) const;
+
+    // Take a run of numSectors sectors, and give one back.  mapMutex must
+    // be held.
+    int  Allocate (int numSectors);
+    void Free     (int sector, int numSectors);
+
+    std::mutex    mapMutex;                  // protects what follows
+    int           fd;                        // OS file descriptor
+    int           pageSize;                  // of the file
+    std::vector<PF_PageLoc> locs;            // by page number
+    std::map<int, int> freeRuns;             // first sector -> # of sectors
+    int           endSector;                 // first sector past the end
+    int           mapSector;                 // where the map is stored
+    int           mapSectors;                // # of sectors it has
+    int           bChanged;                  // TRUE if locs were changed
+};
+
+#endif
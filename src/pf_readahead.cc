@@ -0,0 +1,114 @@
+//
+// File:        pf_readahead.cc
+// Description: PF_ReadAhead class implementation
+//
+
+#include <unistd.h>
+#include "pf_readahead.h"
+
+using namespace std;
+
+//
+// PF_ReadAhead
+//
+// Desc: Constructor.  The helper thread is only started when the first
+//       read is submitted, so a buffer manager that never reads ahead
+//       does not have one.
+// In:   _done - completion function, called without any lock held
+//
+PF_ReadAhead::PF_ReadAhead(function<void (int slot, int numBytes)> _done)
+   : done(_done)
+{
+   bBusy = FALSE;
+   bStop = FALSE;
+}
+
+//
+// ~PF_ReadAhead
+//
+// Desc: Destructor.  Finishes the queued reads and stops the thread.
+//
+PF_ReadAhead::~PF_ReadAhead()
+{
+   if (!worker.joinable())
+      return;
+
+   {
+      unique_lock<mutex> lock(queueMutex);
+      bStop = TRUE;
+   }
+   queueCond.notify_all();
+   worker.join();
+}
+
+//
+// Submit
+//
+// Desc: Queue a read.  dest must stay valid until the completion function
+//       is called for the read.
+// In:   slot - buffer slot the read fills, identifies the read
+//       fd - OS file descriptor
+//       offset - offset of the page in the file
+//       dest - where to read the page
+//       length - number of bytes to read
+//
+void PF_ReadAhead::Submit(int slot, int fd, long offset, char *dest,
+                          int length)
+{
+   Request request = { slot, fd, offset, dest, length };
+
+   {
+      // The thread is started under the lock, so that two callers do not
+      // both start it
+      unique_lock<mutex> lock(queueMutex);
+      pending.push_back(request);
+      if (!worker.joinable())
+         worker = thread(&PF_ReadAhead::Run, this);
+   }
+   queueCond.notify_all();
+}
+
+//
+// Drain
+//
+// Desc: Wait until the helper thread has no read queued or in progress.
+//       The caller must not hold a lock that the completion function
+//       takes.
+//
+void PF_ReadAhead::Drain()
+{
+   unique_lock<mutex> lock(queueMutex);
+   while (!pending.empty() || bBusy)
+      queueCond.wait(lock);
+}
+
+//
+// Run
+//
+// Desc: Internal.  Body of the helper thread: perform the queued reads in
+//       order, and report each of them, until asked to stop.
+//
+void PF_ReadAhead::Run()
+{
+   unique_lock<mutex> lock(queueMutex);
+   for (;;) {
+      while (pending.empty() && !bStop)
+         queueCond.wait(lock);
+      if (pending.empty())
+         return;
+
+      Request request = pending.front();
+      pending.pop_front();
+      bBusy = TRUE;
+
+      // Read and report without holding the lock
+      lock.unlock();
+      int numBytes = pread(request.fd, request.dest, request.length,
+                           request.offset);
+      done(request.slot, numBytes);
+      lock.lock();
+
+      bBusy = FALSE;
+      queueCond.notify_all();
+   }
+}
@@ -0,0 +1,70 @@
+//
+// File:        pf_readahead.h
+// Description: PF_ReadAhead interface, the I/O helper used by PF_BufferMgr
+//              to read pages ahead of a sequential scan
+//
+// The buffer manager decides which pages to read ahead and into which
+// slots.  PF_ReadAhead only performs the reads, on a helper thread, so
+// that the caller keeps working on the pages it already has.  A read is
+// identified by the slot it fills.  The helper thread never looks at the
+// buffer table: it writes into the frame it was given and passes the
+// number of bytes read to the completion function of the buffer manager,
+// which installs the page.
+//
+
+#ifndef PF_READAHEAD_H
+#define PF_READAHEAD_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include "pf_internal.h"
+
+//
+// PF_ReadAhead - asynchronous page reads
+//
+class PF_ReadAhead {
+public:
+    // done is called on the helper thread when a read has finished,
+    // with the slot and the number of bytes read, or -1 on error
+    PF_ReadAhead  (std::function<void (int slot, int numBytes)> done);
+    ~PF_ReadAhead ();                            // Waits for all the reads
+
+    // Queue a read of length bytes at offset of fd into dest
+    void Submit   (int slot, int fd, long offset, char *dest, int length);
+
+    // Wait until every queued read has finished and its completion
+    // function has returned
+    void Drain    ();
+
+private:
+    struct Request {
+        int   slot;
+        int   fd;
+        long  offset;
+        char  *dest;
+        int   length;
+    };
+
+    void Run      ();                            // Helper thread body
+
+    std::thread              worker;             // Started by the 1st Submit
+    std::mutex               queueMutex;         // Protects what follows
+    std::condition_variable  queueCond;
+    std::deque<Request>      pending;            // Reads not started yet
+    std::function<void (int, int)> done;         // Completion function
+    int                      bBusy;              // A read is in progress
+    int                      bStop;              // Ask the thread to exit
+};
+
+//
+// PF_ReadAheadStream - sequential access state of one file
+//
+struct PF_ReadAheadStream {
+    PageNum next;       // page that continues the sequence
+    PageNum issued;     // last page read ahead
+};
+
+#endif
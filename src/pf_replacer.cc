@@ -0,0 +1,657 @@
+//
+// File:        pf_replacer.cc
+// Description: Buffer replacement policies for PF_BufferMgr
+//
+
+#include <vector>
+#include <algorithm>
+#include "pf_buffermgr.h"
+
+//
+// PF_NewReplacer
+//
+// Desc: Create the replacer implementing a replacement policy
+// In:   policy - one of the PF_ReplacementPolicy values
+//       numPages - number of slots in the buffer
+// Ret:  new replacer, owned by the caller
+//
+PF_Replacer *PF_NewReplacer(PF_ReplacementPolicy policy, int numPages)
+{
+   switch (policy) {
+      case PF_CLOCK: return new PF_ClockReplacer(numPages);
+      case PF_2Q:    return new PF_TwoQReplacer(numPages);
+      case PF_LRUK:  return new PF_LRUKReplacer(numPages);
+      case PF_LRU:
+      default:       return new PF_LRUReplacer(numPages);
+   }
+}
+
+//------------------------------------------------------------------------------
+// PF_LRUReplacer
+//------------------------------------------------------------------------------
+
+PF_LRUReplacer::PF_LRUReplacer(int _numPages)
+{
+   next = prev = NULL;
+   bLinked = NULL;
+   Reset(_numPages);
+}
+
+PF_LRUReplacer::~PF_LRUReplacer()
+{
+   delete [] next;
+   delete [] prev;
+   delete [] bLinked;
+}
+
+void PF_LRUReplacer::Reset(int _numPages)
+{
+   delete [] next;
+   delete [] prev;
+   delete [] bLinked;
+
+   numPages = _numPages;
+   next = new int[numPages];
+   prev = new int[numPages];
+   bLinked = new char[numPages]();
+   first = last = INVALID_SLOT;
+}
+
+void PF_LRUReplacer::Insert(int slot, int fd, PageNum pageNum)
+{
+   LinkHead(slot);
+}
+
+void PF_LRUReplacer::Access(int slot)
+{
+   // Make this page the most recently used page
+   Unlink(slot);
+   LinkHead(slot);
+}
+
+void PF_LRUReplacer::Unpin(int slot)
+{
+   // Unpinning the last pin makes it the most recently used page
+   Unlink(slot);
+   LinkHead(slot);
+}
+
+void PF_LRUReplacer::Remove(int slot)
+{
+   Unlink(slot);
+}
+
+//
+// Victim
+//
+// Desc: Choose the least-recently used page that is unpinned
+//
+RC PF_LRUReplacer::Victim(const PF_BufPageDesc *bufTable, int &slot)
+{
+   for (slot = last; slot != INVALID_SLOT; slot = prev[slot]) {
+      if (bufTable[slot].pinCount == 0)
+         break;
+   }
+
+   // Return error if all buffers were pinned
+   if (slot == INVALID_SLOT)
+      return (PF_NOBUF);
+
+   Unlink(slot);
+   return (0);
+}
+
+//
+// Coldest
+//
+// Desc: The unpinned pages from the least-recently used one
+//
+int PF_LRUReplacer::Coldest(const PF_BufPageDesc *bufTable, int *slots,
+      int max) const
+{
+   int n = 0;
+   for (int slot = last; slot != INVALID_SLOT && n < max; slot = prev[slot])
+      if (bufTable[slot].pinCount == 0)
+         slots[n++] = slot;
+   return (n);
+}
+
+void PF_LRUReplacer::LinkHead(int slot)
+{
+   next[slot] = first;
+   prev[slot] = INVALID_SLOT;
+   if (first != INVALID_SLOT)
+      prev[first] = slot;
+   first = slot;
+   if (last == INVALID_SLOT)
+      last = first;
+   bLinked[slot] = TRUE;
+}
+
+void PF_LRUReplacer::Unlink(int slot)
+{
+   if (!bLinked[slot])
+      return;
+   if (first == slot)
+      first = next[slot];
+   if (last == slot)
+      last = prev[slot];
+   if (next[slot] != INVALID_SLOT)
+      prev[next[slot]] = prev[slot];
+   if (prev[slot] != INVALID_SLOT)
+      next[prev[slot]] = next[slot];
+   next[slot] = prev[slot] = INVALID_SLOT;
+   bLinked[slot] = FALSE;
+}
+
+//------------------------------------------------------------------------------
+// PF_ClockReplacer
+//------------------------------------------------------------------------------
+
+PF_ClockReplacer::PF_ClockReplacer(int _numPages)
+{
+   bResident = bReferenced = NULL;
+   Reset(_numPages);
+}
+
+PF_ClockReplacer::~PF_ClockReplacer()
+{
+   delete [] bResident;
+   delete [] bReferenced;
+}
+
+void PF_ClockReplacer::Reset(int _numPages)
+{
+   delete [] bResident;
+   delete [] bReferenced;
+
+   numPages = _numPages;
+   bResident = new char[numPages]();
+   bReferenced = new char[numPages]();
+   hand = 0;
+}
+
+void PF_ClockReplacer::Insert(int slot, int fd, PageNum pageNum)
+{
+   bResident[slot] = TRUE;
+   bReferenced[slot] = TRUE;
+}
+
+void PF_ClockReplacer::Access(int slot)
+{
+   bReferenced[slot] = TRUE;
+}
+
+void PF_ClockReplacer::Unpin(int slot)
+{
+   // Nothing to do: the reference bit was set when the page was pinned
+}
+
+void PF_ClockReplacer::Remove(int slot)
+{
+   bResident[slot] = FALSE;
+   bReferenced[slot] = FALSE;
+}
+
+//
+// Victim
+//
+// Desc: Advance the hand, giving referenced pages a second chance.  Two
+//       full turns are enough: the first clears every reference bit.
+//
+RC PF_ClockReplacer::Victim(const PF_BufPageDesc *bufTable, int &slot)
+{
+   for (int i = 0; i < 2 * numPages; i++) {
+      slot = hand;
+      hand = (hand + 1) % numPages;
+
+      if (!bResident[slot] || bufTable[slot].pinCount > 0)
+         continue;
+      if (bReferenced[slot]) {
+         bReferenced[slot] = FALSE;
+         continue;
+      }
+
+      bResident[slot] = FALSE;
+      return (0);
+   }
+
+   slot = INVALID_SLOT;
+   return (PF_NOBUF);
+}
+
+//
+// Coldest
+//
+// Desc: The unpinned pages the hand would take on its first sweep, then
+//       the referenced ones it would take on the second
+//
+int PF_ClockReplacer::Coldest(const PF_BufPageDesc *bufTable, int *slots,
+      int max) const
+{
+   int n = 0;
+   for (int i = 0; i < 2 * numPages && n < max; i++) {
+      int slot = (hand + i) % numPages;
+      if (bResident[slot] && bufTable[slot].pinCount == 0 &&
+            bReferenced[slot] == (i >= numPages))
+         slots[n++] = slot;
+   }
+   return (n);
+}
+
+//------------------------------------------------------------------------------
+// PF_GhostList
+//------------------------------------------------------------------------------
+
+PF_GhostList::PF_GhostList()
+{
+   keys = words = NULL;
+   Reset(1, 0);
+}
+
+PF_GhostList::~PF_GhostList()
+{
+   delete [] keys;
+   delete [] words;
+}
+
+void PF_GhostList::Reset(int _capacity, int _width)
+{
+   delete [] keys;
+   delete [] words;
+
+   capacity = _capacity;
+   width = _width;
+   keys = new long long[capacity];
+   words = new long long[capacity * width];
+   added = 0;
+   count = 0;
+   live.clear();
+}
+
+//
+// Remember
+//
+// Desc: Add a page to the tail of the ring.  When the ring is full its
+//       oldest entry is dropped, and the page it names is forgotten
+//       unless it was forgotten already or remembered again since.
+// In:   fd, pageNum - the page
+//       values - width words to keep with it
+//
+void PF_GhostList::Remember(int fd, PageNum pageNum, const long long *values)
+{
+   if (count == capacity) {
+      long long oldest = added - count;
+      std::unordered_map<long long, long long>::iterator it =
+         live.find(keys[oldest % capacity]);
+      if (it != live.end() && it->second == oldest)
+         live.erase(it);
+      count--;
+   }
+
+   long long key = Key(fd, pageNum);
+   int pos = (int)(added % capacity);
+   keys[pos] = key;
+   for (int i = 0; i < width; i++)
+      words[pos * width + i] = values[i];
+   live[key] = added;
+   added++;
+   count++;
+}
+
+//
+// Forget
+//
+// Desc: Take a page out of the list.  Its ring entry becomes dead and
+//       ages out with the others.
+// In:   fd, pageNum - the page
+// Out:  values - the width words remembered with it, if it was found
+// Ret:  TRUE if the page was remembered
+//
+int PF_GhostList::Forget(int fd, PageNum pageNum, long long *values)
+{
+   std::unordered_map<long long, long long>::iterator it =
+      live.find(Key(fd, pageNum));
+   if (it == live.end())
+      return (FALSE);
+   int pos = (int)(it->second % capacity);
+   for (int i = 0; i < width; i++)
+      values[i] = words[pos * width + i];
+   live.erase(it);
+   return (TRUE);
+}
+
+//------------------------------------------------------------------------------
+// PF_TwoQReplacer
+//------------------------------------------------------------------------------
+
+PF_TwoQReplacer::PF_TwoQReplacer(int _numPages)
+{
+   next = prev = NULL;
+   queue = NULL;
+   slotFd = NULL;
+   slotPageNum = NULL;
+   Reset(_numPages);
+}
+
+PF_TwoQReplacer::~PF_TwoQReplacer()
+{
+   delete [] next;
+   delete [] prev;
+   delete [] queue;
+   delete [] slotFd;
+   delete [] slotPageNum;
+}
+
+void PF_TwoQReplacer::Reset(int _numPages)
+{
+   delete [] next;
+   delete [] prev;
+   delete [] queue;
+   delete [] slotFd;
+   delete [] slotPageNum;
+
+   numPages = _numPages;
+   next = new int[numPages];
+   prev = new int[numPages];
+   queue = new char[numPages]();
+   slotFd = new int[numPages];
+   slotPageNum = new PageNum[numPages];
+
+   // The sizes suggested in the 2Q paper: A1in holds a quarter of the
+   // buffer, A1out remembers as many pages as half the buffer holds
+   kIn = numPages / 4 > 0 ? numPages / 4 : 1;
+   kOut = numPages / 2 > 0 ? numPages / 2 : 1;
+   a1out.Reset(kOut, 0);
+
+   for (int q = 0; q < 3; q++) {
+      head[q] = tail[q] = INVALID_SLOT;
+      length[q] = 0;
+   }
+}
+
+void PF_TwoQReplacer::Insert(int slot, int fd, PageNum pageNum)
+{
+   slotFd[slot] = fd;
+   slotPageNum[slot] = pageNum;
+
+   // A page that was replaced out of A1in recently is hot: promote it
+   LinkHead(slot, a1out.Forget(fd, pageNum) ? IN_AM : IN_A1IN);
+}
+
+void PF_TwoQReplacer::Access(int slot)
+{
+   // Re-references while on A1in are considered correlated and ignored
+   if (queue[slot] == IN_AM) {
+      Unlink(slot);
+      LinkHead(slot, IN_AM);
+   }
+}
+
+void PF_TwoQReplacer::Unpin(int slot)
+{
+   // Unpinning is not a reference
+}
+
+void PF_TwoQReplacer::Remove(int slot)
+{
+   Unlink(slot);
+}
+
+//
+// Victim
+//
+// Desc: Replace from the tail of A1in while it is over its target size,
+//       remembering the page in A1out, otherwise from the tail of Am.
+//       Either queue is used if the other one only holds pinned pages.
+//
+RC PF_TwoQReplacer::Victim(const PF_BufPageDesc *bufTable, int &slot)
+{
+   int preferred = (length[IN_A1IN] > kIn || length[IN_AM] == 0) ?
+      IN_A1IN : IN_AM;
+   int other = (preferred == IN_A1IN) ? IN_AM : IN_A1IN;
+
+   if (VictimFrom(bufTable, preferred, slot) &&
+         VictimFrom(bufTable, other, slot))
+      return (PF_NOBUF);
+
+   if (queue[slot] == IN_A1IN)
+      a1out.Remember(slotFd[slot], slotPageNum[slot]);
+   Unlink(slot);
+   return (0);
+}
+
+//
+// Coldest
+//
+// Desc: The unpinned pages from the tail of the queue Victim prefers, then
+//       from the tail of the other one
+//
+int PF_TwoQReplacer::Coldest(const PF_BufPageDesc *bufTable, int *slots,
+      int max) const
+{
+   int preferred = (length[IN_A1IN] > kIn || length[IN_AM] == 0) ?
+      IN_A1IN : IN_AM;
+   int queues[2] = { preferred, preferred == IN_A1IN ? IN_AM : IN_A1IN };
+
+   int n = 0;
+   for (int q = 0; q < 2; q++)
+      for (int slot = tail[queues[q]]; slot != INVALID_SLOT && n < max;
+            slot = prev[slot])
+         if (bufTable[slot].pinCount == 0)
+            slots[n++] = slot;
+   return (n);
+}
+
+RC PF_TwoQReplacer::VictimFrom(const PF_BufPageDesc *bufTable, int q,
+      int &slot)
+{
+   for (slot = tail[q]; slot != INVALID_SLOT; slot = prev[slot]) {
+      if (bufTable[slot].pinCount == 0)
+         return (0);
+   }
+   return (PF_NOBUF);
+}
+
+void PF_TwoQReplacer::LinkHead(int slot, int q)
+{
+   next[slot] = head[q];
+   prev[slot] = INVALID_SLOT;
+   if (head[q] != INVALID_SLOT)
+      prev[head[q]] = slot;
+   head[q] = slot;
+   if (tail[q] == INVALID_SLOT)
+      tail[q] = slot;
+   queue[slot] = q;
+   length[q]++;
+}
+
+void PF_TwoQReplacer::Unlink(int slot)
+{
+   int q = queue[slot];
+   if (q == NOT_QUEUED)
+      return;
+   if (head[q] == slot)
+      head[q] = next[slot];
+   if (tail[q] == slot)
+      tail[q] = prev[slot];
+   if (next[slot] != INVALID_SLOT)
+      prev[next[slot]] = prev[slot];
+   if (prev[slot] != INVALID_SLOT)
+      next[prev[slot]] = next[slot];
+   next[slot] = prev[slot] = INVALID_SLOT;
+   queue[slot] = NOT_QUEUED;
+   length[q]--;
+}
+
+//------------------------------------------------------------------------------
+// PF_LRUKReplacer
+//------------------------------------------------------------------------------
+
+PF_LRUKReplacer::PF_LRUKReplacer(int _numPages)
+{
+   history = NULL;
+   bResident = NULL;
+   bCorrelated = NULL;
+   bCandidate = NULL;
+   slotFd = NULL;
+   slotPageNum = NULL;
+   Reset(_numPages);
+}
+
+PF_LRUKReplacer::~PF_LRUKReplacer()
+{
+   delete [] history;
+   delete [] bResident;
+   delete [] bCorrelated;
+   delete [] bCandidate;
+   delete [] slotFd;
+   delete [] slotPageNum;
+}
+
+void PF_LRUKReplacer::Reset(int _numPages)
+{
+   delete [] history;
+   delete [] bResident;
+   delete [] bCorrelated;
+   delete [] bCandidate;
+   delete [] slotFd;
+   delete [] slotPageNum;
+
+   numPages = _numPages;
+   history = new long long[numPages * PF_LRUK_K]();
+   bResident = new char[numPages]();
+   bCorrelated = new char[numPages]();
+   bCandidate = new char[numPages]();
+   slotFd = new int[numPages];
+   slotPageNum = new PageNum[numPages];
+   candidates.clear();
+   retained.Reset(numPages > 0 ? numPages : 1, PF_LRUK_K);
+   clock = 0;
+}
+
+void PF_LRUKReplacer::Insert(int slot, int fd, PageNum pageNum)
+{
+   // A page replaced recently picks up the references it had
+   long long *h = history + slot * PF_LRUK_K;
+   Leave(slot);
+   if (!retained.Forget(fd, pageNum, h))
+      for (int k = 0; k < PF_LRUK_K; k++)
+         h[k] = 0;
+   slotFd[slot] = fd;
+   slotPageNum[slot] = pageNum;
+   bResident[slot] = TRUE;
+   bCorrelated[slot] = FALSE;
+   Touch(slot);
+}
+
+void PF_LRUKReplacer::Access(int slot)
+{
+   // The page is pinned again, and its references change
+   Leave(slot);
+   Touch(slot);
+}
+
+void PF_LRUKReplacer::Unpin(int slot)
+{
+   // Unpinning is not a reference, but ends the correlated period
+   bCorrelated[slot] = FALSE;
+
+   // The page can be replaced from now on
+   if (bResident[slot] && !bCandidate[slot]) {
+      candidates.insert(Key(slot));
+      bCandidate[slot] = TRUE;
+   }
+}
+
+void PF_LRUKReplacer::Remove(int slot)
+{
+   Leave(slot);
+   bResident[slot] = FALSE;
+}
+
+//
+// Victim
+//
+// Desc: A history entry of 0 means "no such reference", so ordering
+//       the candidates on their K-th entries ranks pages with fewer than
+//       K references first.  Ties are broken on the most recent
+//       reference.
+//
+RC PF_LRUKReplacer::Victim(const PF_BufPageDesc *bufTable, int &slot)
+{
+   slot = INVALID_SLOT;
+   for (auto it = candidates.begin(); it != candidates.end(); ++it)
+      if (bufTable[std::get<2>(*it)].pinCount == 0) {
+         slot = std::get<2>(*it);
+         break;
+      }
+
+   if (slot == INVALID_SLOT)
+      return (PF_NOBUF);
+
+   Leave(slot);
+   retained.Remember(slotFd[slot], slotPageNum[slot],
+         history + slot * PF_LRUK_K);
+   bResident[slot] = FALSE;
+   return (0);
+}
+
+//
+// Coldest
+//
+// Desc: The unpinned pages by increasing K-th most recent reference
+//
+int PF_LRUKReplacer::Coldest(const PF_BufPageDesc *bufTable, int *slots,
+      int max) const
+{
+   int n = 0;
+   for (auto it = candidates.begin(); it != candidates.end() && n < max;
+         ++it)
+      if (bufTable[std::get<2>(*it)].pinCount == 0)
+         slots[n++] = std::get<2>(*it);
+   return (n);
+}
+
+//
+// Key
+//
+// Desc: Where the page in slot goes among the candidates
+//
+PF_LRUKReplacer::Candidate PF_LRUKReplacer::Key(int slot) const
+{
+   long long *h = history + slot * PF_LRUK_K;
+   return (Candidate(h[PF_LRUK_K - 1], h[0], slot));
+}
+
+//
+// Leave
+//
+// Desc: Take the page in slot out of the candidates, if it is one.  It
+//       must be before its references change.
+//
+void PF_LRUKReplacer::Leave(int slot)
+{
+   if (bCandidate[slot]) {
+      candidates.erase(Key(slot));
+      bCandidate[slot] = FALSE;
+   }
+}
+
+//
+// Touch
+//
+// Desc: Record a reference to the page in slot.  A reference made while
+//       the page is still pinned from the previous one is correlated
+//       with it: it only moves the time of the last reference.
+//
+void PF_LRUKReplacer::Touch(int slot)
+{
+   long long *h = history + slot * PF_LRUK_K;
+   if (!bCorrelated[slot]) {
+      for (int k = PF_LRUK_K - 1; k > 0; k--)
+         h[k] = h[k - 1];
+      bCorrelated[slot] = TRUE;
+   }
+   h[0] = ++clock;
+}
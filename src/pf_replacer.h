@@ -0,0 +1,240 @@
+//
+// File:        pf_replacer.h
+// Description: PF_Replacer interface and the buffer replacement policies
+//              (LRU, CLOCK, 2Q and LRU-K) used by PF_BufferMgr
+//
+// The buffer manager owns the frames, the page table and the pin counts.
+// A replacer only tracks the slots that currently hold a page and decides
+// which of them to give up when the buffer is full.  The buffer manager
+// tells the replacer when a slot receives a page (Insert), when a resident
+// page is pinned again (Access), when its last pin is released (Unpin) and
+// when the slot is emptied for any reason other than eviction (Remove).
+//
+
+#ifndef PF_REPLACER_H
+#define PF_REPLACER_H
+
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include "pf_internal.h"
+
+struct PF_BufPageDesc;
+
+//
+// PF_Replacer - abstract buffer replacement policy
+//
+class PF_Replacer {
+public:
+    virtual ~PF_Replacer () {}
+
+    // Forget everything and track a buffer of numPages slots
+    virtual void Reset   (int numPages) = 0;
+
+    // slot now holds (fd, pageNum) and is pinned
+    virtual void Insert  (int slot, int fd, PageNum pageNum) = 0;
+    // The page in slot was found in the buffer and pinned again
+    virtual void Access  (int slot) = 0;
+    // The last pin on the page in slot was released
+    virtual void Unpin   (int slot) = 0;
+    // slot no longer holds a page (flushed, cleared, ...)
+    virtual void Remove  (int slot) = 0;
+
+    // Choose an unpinned slot to replace and stop tracking it.
+    // Returns PF_NOBUF if every resident page is pinned.
+    virtual RC   Victim  (const PF_BufPageDesc *bufTable, int &slot) = 0;
+
+    // Fill slots with up to max unpinned slots, in the order they would
+    // be chosen as victims, without changing anything.  Returns the
+    // number of slots.  Used by the background writer.
+    virtual int  Coldest (const PF_BufPageDesc *bufTable, int *slots,
+                          int max) const = 0;
+
+    // Name of the policy, used by PrintBuffer
+    virtual const char *Name () const = 0;
+};
+
+// Create the replacer implementing policy for a buffer of numPages slots
+PF_Replacer *PF_NewReplacer(PF_ReplacementPolicy policy, int numPages);
+
+//
+// PF_LRUReplacer - least recently unpinned page is replaced first.
+// This is the historical RedBase behaviour.
+//
+class PF_LRUReplacer : public PF_Replacer {
+public:
+    PF_LRUReplacer  (int numPages);
+    ~PF_LRUReplacer ();
+
+    void Reset   (int numPages);
+    void Insert  (int slot, int fd, PageNum pageNum);
+    void Access  (int slot);
+    void Unpin   (int slot);
+    void Remove  (int slot);
+    RC   Victim  (const PF_BufPageDesc *bufTable, int &slot);
+    int  Coldest (const PF_BufPageDesc *bufTable, int *slots, int max) const;
+    const char *Name () const { return "LRU"; }
+
+private:
+    void LinkHead (int slot);
+    void Unlink   (int slot);
+
+    int  *next;                                   // towards the LRU end
+    int  *prev;                                   // towards the MRU end
+    char *bLinked;                                // slot is on the list
+    int  first;                                   // MRU slot
+    int  last;                                    // LRU slot
+    int  numPages;
+};
+
+//
+// PF_ClockReplacer - second chance.  A hit only sets the reference bit of
+// the slot; the clock hand clears reference bits until it finds an
+// unpinned slot whose bit is already clear.
+//
+class PF_ClockReplacer : public PF_Replacer {
+public:
+    PF_ClockReplacer  (int numPages);
+    ~PF_ClockReplacer ();
+
+    void Reset   (int numPages);
+    void Insert  (int slot, int fd, PageNum pageNum);
+    void Access  (int slot);
+    void Unpin   (int slot);
+    void Remove  (int slot);
+    RC   Victim  (const PF_BufPageDesc *bufTable, int &slot);
+    int  Coldest (const PF_BufPageDesc *bufTable, int *slots, int max) const;
+    const char *Name () const { return "CLOCK"; }
+
+private:
+    char *bResident;                              // slot holds a page
+    char *bReferenced;                            // reference bit
+    int  hand;                                    // clock hand
+    int  numPages;
+};
+
+//
+// PF_GhostList - the pages a replacer gave up most recently, in a FIFO
+// ring of bounded size, each with width words of the replacer's own
+// history.  A page taken back out with Forget leaves a dead entry in the
+// ring that is skipped when it ages out.
+//
+class PF_GhostList {
+public:
+    PF_GhostList  ();
+    ~PF_GhostList ();
+
+    // Forget everything and remember up to capacity pages
+    void Reset    (int capacity, int width);
+    // Add a page, dropping the oldest one when the list is full
+    void Remember (int fd, PageNum pageNum, const long long *values = NULL);
+    // If the page is remembered, copy its words into values, drop it and
+    // return TRUE
+    int  Forget   (int fd, PageNum pageNum, long long *values = NULL);
+
+private:
+    static long long Key (int fd, PageNum pageNum)
+      { return ((long long)fd << 32) | (unsigned int)pageNum; }
+
+    long long *keys;                              // the ring
+    long long *words;                             // width words per entry
+    long long added;                              // entries ever added
+    int  count;                                   // entries in the ring
+    int  capacity;
+    int  width;
+    std::unordered_map<long long, long long> live; // key -> its entry
+};
+
+//
+// PF_TwoQReplacer - full 2Q (Johnson and Shasha).  Pages referenced once
+// go through a FIFO queue (A1in); only pages referenced again after they
+// left A1in, which is remembered in the ghost queue A1out, are promoted
+// to the LRU queue Am.  A sequential scan therefore only cycles through
+// A1in and does not push hot pages out of Am.
+//
+class PF_TwoQReplacer : public PF_Replacer {
+public:
+    PF_TwoQReplacer  (int numPages);
+    ~PF_TwoQReplacer ();
+
+    void Reset   (int numPages);
+    void Insert  (int slot, int fd, PageNum pageNum);
+    void Access  (int slot);
+    void Unpin   (int slot);
+    void Remove  (int slot);
+    RC   Victim  (const PF_BufPageDesc *bufTable, int &slot);
+    int  Coldest (const PF_BufPageDesc *bufTable, int *slots, int max) const;
+    const char *Name () const { return "2Q"; }
+
+private:
+    enum { NOT_QUEUED, IN_A1IN, IN_AM };
+
+    void LinkHead (int slot, int queue);
+    void Unlink   (int slot);
+    RC   VictimFrom (const PF_BufPageDesc *bufTable, int queue, int &slot);
+
+    int  *next;                                   // towards the queue tail
+    int  *prev;                                   // towards the queue head
+    char *queue;                                  // queue the slot is on
+    int  head[3], tail[3], length[3];             // indexed by queue
+    int  kIn;                                     // target size of A1in
+    int  kOut;                                    // capacity of A1out
+    PF_GhostList a1out;                           // A1out, the ghost queue
+
+    int  *slotFd;                                 // page held by each slot
+    PageNum *slotPageNum;
+    int  numPages;
+};
+
+//
+// PF_LRUKReplacer - LRU-K with K = PF_LRUK_K.  The victim is the unpinned
+// page whose K-th most recent reference is the oldest.  Pages with fewer
+// than K references have an infinite backward K-distance and go first,
+// least recently used among them, so pages touched once by a scan are
+// replaced before pages that were referenced repeatedly.
+//
+// Pins taken while the page is already pinned are correlated with the
+// reference that pinned it first and do not count as a new reference.
+// The history of replaced pages is retained for as many pages as the
+// buffer holds, so a page that comes back soon keeps its references.
+//
+// The unpinned pages are kept ordered by their K-th and last reference,
+// so that choosing a victim does not look at every slot.
+//
+class PF_LRUKReplacer : public PF_Replacer {
+public:
+    PF_LRUKReplacer  (int numPages);
+    ~PF_LRUKReplacer ();
+
+    void Reset   (int numPages);
+    void Insert  (int slot, int fd, PageNum pageNum);
+    void Access  (int slot);
+    void Unpin   (int slot);
+    void Remove  (int slot);
+    RC   Victim  (const PF_BufPageDesc *bufTable, int &slot);
+    int  Coldest (const PF_BufPageDesc *bufTable, int *slots, int max) const;
+    const char *Name () const { return "LRU-K"; }
+
+private:
+    typedef std::tuple<long long, long long, int> Candidate;
+
+    void Touch    (int slot);
+    Candidate Key (int slot) const;
+    void Leave    (int slot);
+
+    long long *history;                           // K times per slot,
+                                                  // most recent first
+    char *bResident;
+    char *bCorrelated;                            // pinned since last ref
+    char *bCandidate;                             // in candidates
+    std::set<Candidate> candidates;               // unpinned pages, by
+                                                  // K-th and last ref
+    int  *slotFd;                                 // page held by each slot
+    PageNum *slotPageNum;
+    PF_GhostList retained;                        // history of replaced
+                                                  // pages
+    long long clock;                              // logical time
+    int  numPages;
+};
+
+#endif
@@ -30,6 +30,18 @@ void PF_Statistics()
    int *piRP = pStatisticsMgr->Get(PF_READPAGE);
    int *piWP = pStatisticsMgr->Get(PF_WRITEPAGE);
    int *piFP = pStatisticsMgr->Get(PF_FLUSHPAGES);
+   int *piRA = pStatisticsMgr->Get(PF_READAHEAD);
+   int *piRAH = pStatisticsMgr->Get(PF_READAHEADHIT);
+   int *piRAM = pStatisticsMgr->Get(PF_READAHEADMISS);
+   int *piBW = pStatisticsMgr->Get(PF_BGWRITE);
+   int *piCP = pStatisticsMgr->Get(PF_CHECKPOINT);
+   int *piSR = pStatisticsMgr->Get(PF_SCANRING);
+   int *piEX = pStatisticsMgr->Get(PF_EXTEND);
+   int *piCM = pStatisticsMgr->Get(PF_COMMIT);
+   int *piSY = pStatisticsMgr->Get(PF_SYNC);
+   int *piLR = pStatisticsMgr->Get(PF_LOGRECORD);
+   int *piLW = pStatisticsMgr->Get(PF_LOGWRITE);
+   int *piPP = pStatisticsMgr->Get(PF_PUNCHPAGE);
 
    cout << "PF Layer Statistics\n";
    cout << "-------------------\n";
@@ -50,6 +62,36 @@ void PF_Statistics()
    cout << "Number of flushes: ";
    if (piFP) cout << *piFP; else cout << "None";
    cout << "\n-------------------\n";
+   cout << "Number of pages read ahead: ";
+   if (piRA) cout << *piRA; else cout << "None";
+   cout << "\n  Number requested later: ";
+   if (piRAH) cout << *piRAH; else cout << "None";
+   cout << "\n  Sequential requests not read ahead: ";
+   if (piRAM) cout << *piRAM; else cout << "None";
+   cout << "\n-------------------\n";
+   cout << "Number of pages written in the background: ";
+   if (piBW) cout << *piBW; else cout << "None";
+   cout << "\nNumber of checkpoints: ";
+   if (piCP) cout << *piCP; else cout << "None";
+   cout << "\nNumber of slots recycled by sequential scans: ";
+   if (piSR) cout << *piSR; else cout << "None";
+   cout << "\nNumber of extents preallocated: ";
+   if (piEX) cout << *piEX; else cout << "None";
+   cout << "\nNumber of disposed pages punched out: ";
+   if (piPP) cout << *piPP; else cout << "None";
+   cout << "\n-------------------\n";
+   cout << "Number of commits: ";
+   if (piCM) cout << *piCM; else cout << "None";
+   cout << "\n  Number of syncs: ";
+   if (piSY) cout << *piSY; else cout << "None";
+   cout << "\nNumber of log records: ";
+   if (piLR) cout << *piLR; else cout << "None";
+   cout << "\n  Number of log writes: ";
+   if (piLW) cout << *piLW; else cout << "None";
+   cout << "\n-------------------\n";
+   for (int i = 0; i < STAT_NUM_LATENCIES; i++)
+      pStatisticsMgr->Print((Stat_Latency)i);
+   cout << "-------------------\n";
 
    // Must delete the memory returned from StatisticsMgr::Get
    delete piGP;
@@ -58,6 +100,18 @@ void PF_Statistics()
    delete piRP;
    delete piWP;
    delete piFP;
+   delete piRA;
+   delete piRAH;
+   delete piRAM;
+   delete piBW;
+   delete piCP;
+   delete piSR;
+   delete piEX;
+   delete piCM;
+   delete piSY;
+   delete piLR;
+   delete piLW;
+   delete piPP;
 }
 
 #endif
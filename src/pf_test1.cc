@@ -468,7 +468,7 @@ printf("get bock size returned %d\n",len);
 
 RC TestHash()
 {
-   PF_HashTable ht(PF_HASH_TBL_SIZE);
+   PF_HashTable ht(PF_BUFFER_SIZE);
    RC           rc;
    int          i, s;
    PageNum      p;
@@ -0,0 +1,283 @@
+//
+// File:        pf_warmlist.cc
+// Description: PF_WarmList class implementation
+//
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "pf_warmlist.h"
+
+using namespace std;
+
+//
+// Opened
+//
+// Desc: Remember the name of a file that was just opened, and hand out
+//       the pages of it that the last manifest loaded lists
+// In:   fileName - name the file was opened with
+//       fd - its descriptor
+// Out:  warmPages - the pages, in page order, empty if there is none
+//
+void PF_WarmList::Opened(const char *fileName, int fd,
+      vector<PageNum> &warmPages)
+{
+   lock_guard<std::mutex> lock(listMutex);
+
+   names[fd] = fileName;
+   warmPages.clear();
+
+   unordered_map<string, vector<PageNum> >::iterator it =
+      pending.find(fileName);
+   if (it != pending.end()) {
+      warmPages.swap(it->second);
+      pending.erase(it);
+   }
+}
+
+//
+// Record
+//
+// Desc: Remember the pages of an open file that are resident now.  They
+//       replace those recorded earlier for the file, and are the most
+//       recent ones.
+// In:   fd - descriptor of the file
+//       pages - the resident pages, hottest first
+//
+void PF_WarmList::Record(int fd, const vector<PageNum> &pages)
+{
+   lock_guard<std::mutex> lock(listMutex);
+
+   unordered_map<int, string>::iterator it = names.find(fd);
+   if (it == names.end())
+      return;
+
+   if (pages.empty())
+      resident.erase(it->second);
+   else {
+      Resident &r = resident[it->second];
+      r.seq = ++seq;
+      r.pages = pages;
+   }
+}
+
+//
+// Closed
+//
+// Desc: Forget the name of a file that was closed
+// In:   fd - descriptor the file had
+//
+void PF_WarmList::Closed(int fd)
+{
+   lock_guard<std::mutex> lock(listMutex);
+   names.erase(fd);
+}
+
+//
+// Destroyed
+//
+// Desc: Forget all the pages of a file that was destroyed
+// In:   fileName - name of the file
+//
+void PF_WarmList::Destroyed(const char *fileName)
+{
+   lock_guard<std::mutex> lock(listMutex);
+   resident.erase(fileName);
+   pending.erase(fileName);
+}
+
+//
+// OpenFds
+//
+// Desc: List the descriptors of the open files
+// Out:  fds - the descriptors
+//
+void PF_WarmList::OpenFds(vector<int> &fds)
+{
+   lock_guard<std::mutex> lock(listMutex);
+
+   fds.clear();
+   for (unordered_map<int, string>::iterator it = names.begin();
+         it != names.end(); ++it)
+      fds.push_back(it->first);
+}
+
+//
+// Save
+//
+// Desc: Write the manifest: the files in the order they were recorded,
+//       most recent first, until maxPages pages are listed.  The manifest
+//       is written to a temporary file first and renamed, so that a
+//       crash never leaves half of one.
+// In:   manifestName - name of the manifest
+//       maxPages - max # of pages listed, normally the buffer size
+// Ret:  PF_UNIX, PF_INCOMPLETEWRITE or 0
+//
+RC PF_WarmList::Save(const char *manifestName, int maxPages)
+{
+   vector<int> data;
+   {
+      lock_guard<std::mutex> lock(listMutex);
+
+      vector<pair<long, const string *> > files;
+      for (unordered_map<string, Resident>::iterator it = resident.begin();
+            it != resident.end(); ++it)
+         files.push_back(make_pair(it->second.seq, &it->first));
+      sort(files.begin(), files.end(),
+           greater<pair<long, const string *> >());
+
+      data.push_back(PF_WARM_MAGIC);
+      data.push_back(0);
+      for (size_t i = 0; i < files.size() && maxPages > 0; i++) {
+         const string &name = *files[i].second;
+         const vector<PageNum> &pages = resident[name].pages;
+         int n = min((int)pages.size(), maxPages);
+
+         // The name is padded to a whole number of ints
+         data.push_back(name.size());
+         size_t at = data.size();
+         data.resize(at + (name.size() + sizeof(int) - 1) / sizeof(int), 0);
+         memcpy(&data[at], name.data(), name.size());
+
+         data.push_back(n);
+         data.insert(data.end(), pages.begin(), pages.begin() + n);
+         data[1]++;
+         maxPages -= n;
+      }
+   }
+
+   string tmpName = string(manifestName) + ".tmp";
+   int fd = open(tmpName.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+   if (fd < 0)
+      return (PF_UNIX);
+
+   long numBytes = data.size() * sizeof(int);
+   long written = write(fd, &data[0], numBytes);
+   if (close(fd) < 0 || written < 0) {
+      unlink(tmpName.c_str());
+      return (PF_UNIX);
+   }
+   if (written != numBytes) {
+      unlink(tmpName.c_str());
+      return (PF_INCOMPLETEWRITE);
+   }
+
+   if (rename(tmpName.c_str(), manifestName) < 0)
+      return (PF_UNIX);
+
+   // Return ok
+   return (0);
+}
+
+//
+// Load
+//
+// Desc: Read a manifest.  The pages it lists are kept, by file, until the
+//       file is opened, and the OS is asked to start reading them now.  A
+//       missing or damaged manifest just means that there is nothing to
+//       warm the buffer up with.
+// In:   manifestName - name of the manifest
+//       maxPages - max # of pages kept, normally the buffer size
+// Ret:  PF_UNIX if the manifest exists but cannot be read, or 0
+//
+RC PF_WarmList::Load(const char *manifestName, int maxPages)
+{
+   int fd = open(manifestName, O_RDONLY);
+   if (fd < 0)
+      return (errno == ENOENT ? 0 : PF_UNIX);
+
+   struct stat st;
+   vector<int> data;
+   if (fstat(fd, &st) < 0) {
+      close(fd);
+      return (PF_UNIX);
+   }
+   data.resize(st.st_size / sizeof(int) + 1);
+   long numBytes = pread(fd, &data[0], st.st_size, 0);
+   close(fd);
+   if (numBytes < 0)
+      return (PF_UNIX);
+
+   // Walk the manifest, and stop at the first thing out of place
+   size_t size = numBytes / sizeof(int);
+   if (size < 2 || data[0] != PF_WARM_MAGIC)
+      return (0);
+
+   unordered_map<string, vector<PageNum> > loaded;
+   size_t at = 2;
+   for (int f = 0; f < data[1] && maxPages > 0; f++) {
+      if (at >= size || data[at] <= 0 || data[at] > PATH_MAX)
+         break;
+      size_t nameLen = data[at++];
+      size_t nameInts = (nameLen + sizeof(int) - 1) / sizeof(int);
+      if (at + nameInts >= size)
+         break;
+      string name((const char *)&data[at], nameLen);
+      at += nameInts;
+
+      int count = data[at++];
+      if (count < 0 || at + count > size)
+         break;
+      int n = min(count, maxPages);
+
+      vector<PageNum> &pages = loaded[name];
+      for (int i = 0; i < n; i++)
+         if (data[at + i] >= 0)
+            pages.push_back(data[at + i]);
+      at += count;
+      maxPages -= n;
+
+      sort(pages.begin(), pages.end());
+      pages.erase(unique(pages.begin(), pages.end()), pages.end());
+   }
+
+   for (unordered_map<string, vector<PageNum> >::iterator it =
+         loaded.begin(); it != loaded.end(); ++it)
+      Advise(it->first.c_str(), it->second);
+
+   lock_guard<std::mutex> lock(listMutex);
+   for (unordered_map<string, vector<PageNum> >::iterator it =
+         loaded.begin(); it != loaded.end(); ++it)
+      pending[it->first].swap(it->second);
+
+   // Return ok
+   return (0);
+}
+
+//
+// Advise
+//
+// Desc: Internal.  Ask the OS to read pages of a file into its cache, so
+//       that reading them into the buffer later is fast.  Runs of
+//       adjacent pages are asked for at once.  Errors are ignored.
+// In:   fileName - name of the file
+//       pages - pages of the file, in page order
+//
+void PF_WarmList::Advise(const char *fileName, const vector<PageNum> &pages)
+{
+#ifdef POSIX_FADV_WILLNEED
+   int fd = open(fileName, O_RDONLY);
+   if (fd < 0)
+      return;
+
+   // The pages of a compressed file are not at their page offset
+   PF_FileHdr hdr;
+   if (pread(fd, &hdr, sizeof(hdr), 0) == sizeof(hdr) && !hdr.bCompressed) {
+      long pageSize = hdr.pageSize ? hdr.pageSize : MEMORY_PAGE_SIZE;
+      for (size_t i = 0; i < pages.size(); ) {
+         size_t n = 1;
+         while (i + n < pages.size() && pages[i + n] == pages[i] + (int)n)
+            n++;
+         posix_fadvise(fd, PF_FILE_HDR_SIZE + pages[i] * pageSize,
+                       n * pageSize, POSIX_FADV_WILLNEED);
+         i += n;
+      }
+   }
+   close(fd);
+#endif
+}
@@ -0,0 +1,75 @@
+//
+// File:        pf_warmlist.h
+// Description: PF_WarmList interface, the pages PF_Manager reads back into
+//              the buffer after a restart
+//
+// Pages are only in the buffer while their file is open: closing a file
+// flushes them.  So PF_Manager hands PF_WarmList the resident pages of
+// each file, hottest first, when it closes the file, and Save writes what
+// was resident most recently to a manifest, at most one buffer full.
+// Load reads the manifest back, asks the OS to start reading the pages
+// listed, in page order, and keeps them until their file is opened again:
+// Opened then returns them so that they are read into the buffer in the
+// background.
+//
+// The manifest is made of a header { PF_WARM_MAGIC, number of files },
+// then of { length of the name, name, number of pages, pages } for each
+// file.  Files come hottest first, and so do their pages.
+//
+
+#ifndef PF_WARMLIST_H
+#define PF_WARMLIST_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "pf_internal.h"
+
+const int PF_WARM_MAGIC = 0x50465731;   // "PFW1"
+
+//
+// PF_WarmList - pages to warm the buffer up with
+//
+class PF_WarmList {
+public:
+    PF_WarmList   () : seq(0) {}
+
+    // fileName was opened as fd.  Out: the pages of the file listed by
+    // the manifest last loaded, in page order, which are forgotten.
+    void Opened   (const char *fileName, int fd,
+                   std::vector<PageNum> &warmPages);
+    // Remember the resident pages of the open file fd, hottest first, as
+    // the most recent ones
+    void Record   (int fd, const std::vector<PageNum> &pages);
+    // fd was closed
+    void Closed   (int fd);
+    // fileName was destroyed
+    void Destroyed (const char *fileName);
+
+    // Descriptors of the open files
+    void OpenFds  (std::vector<int> &fds);
+
+    // Write the manifest with at most maxPages pages, and load it
+    RC   Save     (const char *manifestName, int maxPages);
+    RC   Load     (const char *manifestName, int maxPages);
+
+private:
+    struct Resident {
+        long                  seq;       // higher is more recent
+        std::vector<PageNum>  pages;     // hottest first
+    };
+
+    // Ask the OS to read pages of fileName, in page order
+    void Advise   (const char *fileName, const std::vector<PageNum> &pages);
+
+    std::mutex listMutex;                                // protects all
+    std::unordered_map<int, std::string> names;          // of open files
+    std::unordered_map<std::string, Resident> resident;  // by file name
+    std::unordered_map<std::string, std::vector<PageNum> > pending;
+                                                         // loaded, not
+                                                         // opened yet
+    long seq;                                            // last Record
+};
+
+#endif
@@ -68,7 +68,8 @@ RC QL_Manager::Select(int nSelAttrs, const RelAttr selAttrs[],
     source_relations.insert (relations [i]);
   }
   for (int i = 1; i < nRelations; ++i) {
-    Table* tbl = (Table *) this->smm->GetTableMetadata (relations [i-1]).data;
+    auto tbl_rec = this->smm->GetTableMetadata (relations [i-1]);
+    Table* tbl = (Table *) tbl_rec.data;
     table_attributes [relations [i-1]] =
       this->smm->GetAttributes (relations [i-1]);
     tuple_offsets [i] = tuple_offsets [i-1] + tbl->row_len;
@@ -129,10 +130,11 @@ RC QL_Manager::Select(int nSelAttrs, const RelAttr selAttrs[],
 
   DataAttrInfo attrs [sel_attrs.size()];
   for (unsigned int i = 0; i < sel_attrs.size(); ++i) {
-    Attribute* a = (Attribute*) this->smm->GetAttrMetadata (
+    auto a_rec = this->smm->GetAttrMetadata (
       sel_attrs [i].relName,
       sel_attrs [i].attrName
-    ).data;
+    );
+    Attribute* a = (Attribute *) a_rec.data;
     attributes [sel_attrs [i].relName] [sel_attrs [i].attrName] = *a;
 
     new (attrs + i) DataAttrInfo (*a);
@@ -159,17 +161,19 @@ RC QL_Manager::Select(int nSelAttrs, const RelAttr selAttrs[],
 
   for (int i = 0; i < nConditions; ++i) {
     Condition c = conditions [i];
-    Attribute* a = (Attribute*) this->smm->GetAttrMetadata (
+    auto a_rec = this->smm->GetAttrMetadata (
       c.lhsAttr.relName,
       c.lhsAttr.attrName
-    ).data;
+    );
+    Attribute* a = (Attribute *) a_rec.data;
     attributes [c.lhsAttr.relName] [c.lhsAttr.attrName] = *a;
 
     if (not c.bRhsIsAttr) continue;
-    a = (Attribute*) this->smm->GetAttrMetadata (
+    a_rec = this->smm->GetAttrMetadata (
       c.rhsAttr.relName,
       c.rhsAttr.attrName
-    ).data;
+    );
+    a = (Attribute *) a_rec.data;
     attributes [c.rhsAttr.relName] [c.rhsAttr.attrName] = *a;
   }
 
@@ -343,10 +347,11 @@ RC QL_Manager::Delete(const char *relName,
 
   DataAttrInfo attrs [sel_attrs.size()];
   for (unsigned int i = 0; i < sel_attrs.size(); ++i) {
-    Attribute* a = (Attribute*) this->smm->GetAttrMetadata (
+    auto a_rec = this->smm->GetAttrMetadata (
       sel_attrs [i].relName,
       sel_attrs [i].attrName
-    ).data;
+    );
+    Attribute* a = (Attribute *) a_rec.data;
     attributes [sel_attrs [i].relName] [sel_attrs [i].attrName] = *a;
 
     new (attrs + i) DataAttrInfo (*a);
@@ -359,17 +364,19 @@ RC QL_Manager::Delete(const char *relName,
 
   for (int i = 0; i < nConditions; ++i) {
     Condition c = conditions [i];
-    Attribute* a = (Attribute*) this->smm->GetAttrMetadata (
+    auto a_rec = this->smm->GetAttrMetadata (
       relName,
       c.lhsAttr.attrName
-    ).data;
+    );
+    Attribute* a = (Attribute *) a_rec.data;
     attributes [relName] [c.lhsAttr.attrName] = *a;
 
     if (not c.bRhsIsAttr) continue;
-    a = (Attribute*) this->smm->GetAttrMetadata (
+    a_rec = this->smm->GetAttrMetadata (
       relName,
       c.rhsAttr.attrName
-    ).data;
+    );
+    a = (Attribute *) a_rec.data;
     attributes [relName] [c.rhsAttr.attrName] = *a;
   }
 
@@ -487,10 +494,11 @@ RC QL_Manager::Update(const char *relName,
 
   DataAttrInfo attrs [sel_attrs.size()];
   for (unsigned int i = 0; i < sel_attrs.size(); ++i) {
-    Attribute* a = (Attribute*) this->smm->GetAttrMetadata (
+    auto a_rec = this->smm->GetAttrMetadata (
       sel_attrs [i].relName,
       sel_attrs [i].attrName
-    ).data;
+    );
+    Attribute* a = (Attribute *) a_rec.data;
     attributes [sel_attrs [i].relName] [sel_attrs [i].attrName] = *a;
 
     new (attrs + i) DataAttrInfo (*a);
@@ -503,17 +511,19 @@ RC QL_Manager::Update(const char *relName,
 
   for (int i = 0; i < nConditions; ++i) {
     Condition c = conditions [i];
-    Attribute* a = (Attribute*) this->smm->GetAttrMetadata (
+    auto a_rec = this->smm->GetAttrMetadata (
       relName,
       c.lhsAttr.attrName
-    ).data;
+    );
+    Attribute* a = (Attribute *) a_rec.data;
     attributes [relName] [c.lhsAttr.attrName] = *a;
 
     if (not c.bRhsIsAttr) continue;
-    a = (Attribute*) this->smm->GetAttrMetadata (
+    a_rec = this->smm->GetAttrMetadata (
       relName,
       c.rhsAttr.attrName
-    ).data;
+    );
+    a = (Attribute *) a_rec.data;
     attributes [relName] [c.rhsAttr.attrName] = *a;
   }
 
@@ -566,13 +576,15 @@ RC QL_Manager::Update(const char *relName,
   Printer printer (attrs, sel_attrs.size());
   printer.PrintHeader (cout);
 
-  Attribute* attr_to_update = (Attribute *) this->smm->GetAttrMetadata (
+  auto attr_to_update_rec = this->smm->GetAttrMetadata (
     relName,
     updAttr.attrName
-  ).data;
+  );
+  Attribute* attr_to_update = (Attribute *) attr_to_update_rec.data;
 
   char* rec;
-  vector <char*> recs_to_insert;
+  // The updated tuples are put back together once the scan is over.
+  vector <char> recs_to_insert;
 
   iter->open();
   while ((rec = iter->next()) != NULL) {
@@ -623,25 +635,27 @@ RC QL_Manager::Update(const char *relName,
       }
     }
     else {
-      Attribute* attr_to_copy = (Attribute *) this->smm->GetAttrMetadata (
+      auto attr_to_copy_rec = this->smm->GetAttrMetadata (
         relName,
         rhsRelAttr.attrName
-      ).data;
+      );
+      Attribute* attr_to_copy = (Attribute *) attr_to_copy_rec.data;
       memcpy (new_rec + attr_to_update->offset,
               new_rec + attr_to_copy->offset,
               attr_to_update->len);
     }
-    recs_to_insert.push_back (new_rec);
+    recs_to_insert.insert (recs_to_insert.end (),
+                           new_rec, new_rec + record_size);
 
     printer.Print (cout, new_rec);
+    delete [] new_rec;
     this->smm->Delete (relName, rec, iter->rid());
   }
   iter->close();
 
-  for (unsigned int i = 0; i < recs_to_insert.size (); ++i) {
-    this->smm->Insert (relName, recs_to_insert [i]);
-    delete [] recs_to_insert [i];
-  }
+  if (not recs_to_insert.empty ())
+    this->smm->Insert (relName, recs_to_insert.data (),
+                       recs_to_insert.size () / record_size);
 
   printer.PrintFooter (cout);
   delete iter;
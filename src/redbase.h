@@ -79,7 +79,12 @@ enum CompOp {
 // Pin Strategy Hint
 //
 enum ClientHint {
-    NO_HINT                                     // default value
+    NO_HINT,                                    // default value
+    SEQUENTIAL_SCAN,                            // each page is read once, in
+                                                // order: do not let it push
+                                                // other pages out
+    RANDOM_LOOKUP                               // isolated page, do not read
+                                                // ahead of it
 };
 
 //
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "rm.h"
 
 using namespace std;
@@ -34,6 +36,21 @@ RC RM_FileHandle::InsertRec (const char *pData, RID &rid)
   ERROR_WRAPPER (rid = this->handle.insert (pData));
 }
 
+RC RM_FileHandle::InsertRecs (const char *pData, int nRecs, RID *rids)
+{
+  if (rids == NULL) return -1;
+  vector<RID> inserted;
+  try {
+    inserted = this->handle.insert_batch (pData, nRecs);
+  }
+  catch (exception& e) {
+    cout << e.what () << endl;
+    return -1;
+  }
+  copy (inserted.begin (), inserted.end (), rids);
+  return 0;
+}
+
 RC RM_FileHandle::DeleteRec (const RID &rid)
 {
   ERROR_WRAPPER (this->handle.Delete (rid));
@@ -62,7 +79,8 @@ RC RM_FileScan::OpenScan  (const RM_FileHandle &fileHandle,
                                   attrLength,
                                   attrOffset,
                                   compOp,
-                                  value));
+                                  value,
+                                  pinHint));
 }
 
 RC RM_FileScan::GetNextRec(RM_Record &rec)
@@ -72,7 +90,7 @@ RC RM_FileScan::GetNextRec(RM_Record &rec)
     if (r == RM::Scan::end) {
       return RM_EOF; // EOF
     }
-    rec.record = r;
+    rec.record = std::move (r);
   }
   catch (exception& e) {
     cout << e.what () << endl;
@@ -66,6 +66,10 @@ public:
 
     RC InsertRec  (const char *pData, RID &rid);       // Insert a new record
 
+    // Insert nRecs records stored back to back at pData, filling the
+    // pages one after the other.  rids gets the RIDs of the nRecs records.
+    RC InsertRecs (const char *pData, int nRecs, RID *rids);
+
     RC DeleteRec  (const RID &rid);                    // Delete a record
     RC UpdateRec  (const RM_Record &rec);              // Update a record
 
@@ -102,6 +102,8 @@ static int get_id(char *s)
       return yylval.ival = RW_EXIT;
    if(!strcmp(string, "print"))
       return yylval.ival = RW_PRINT;
+   if(!strcmp(string, "compact"))
+      return yylval.ival = RW_COMPACT;
    if(!strcmp(string, "set"))
       return yylval.ival = RW_SET;
 
@@ -23,15 +23,36 @@
 using namespace std;
 
 //
-// Here are Statistics Keys utilized by the PF layer of the Redbase
-// project.
-//
-const char *PF_GETPAGE = "GETPAGE";
-const char *PF_PAGEFOUND = "PAGEFOUND";
-const char *PF_PAGENOTFOUND = "PAGENOTFOUND";
-const char *PF_READPAGE = "READPAGE";           // IO
-const char *PF_WRITEPAGE = "WRITEPAGE";         // IO
-const char *PF_FLUSHPAGES = "FLUSHPAGES";
+// Here are the names of the Statistics Keys utilized by the PF layer of
+// the Redbase project, in Stat_Counter order.
+//
+const char *const StatCounterName[STAT_NUM_COUNTERS] = {
+   "GETPAGE",
+   "PAGEFOUND",
+   "PAGENOTFOUND",
+   "READPAGE",                                  // IO
+   "WRITEPAGE",                                 // IO
+   "WRITEV",                                    // IO
+   "FLUSHPAGES",
+   "READAHEAD",                                 // IO
+   "READAHEADHIT",
+   "READAHEADMISS",
+   "BGWRITE",                                   // IO
+   "CHECKPOINT",
+   "SCANRING",
+   "EXTEND",                                    // IO
+   "COMMIT",
+   "SYNC",                                      // IO
+   "LOGRECORD",
+   "LOGWRITE",                                  // IO
+   "PUNCHPAGE"                                  // IO
+};
+
+const char *const StatLatencyName[STAT_NUM_LATENCIES] = {
+   "GETPAGE",
+   "READPAGE",
+   "WRITEPAGE"
+};
 
 //
 // Statistic class
@@ -107,9 +128,20 @@ Boolean Statistic::operator==(const char *psKey_) const
 //
 // StatisticMgr class
 //
-// This class will track a dynamic list of statistics.
+// This class will track a dynamic list of statistics, and the counters and
+// latency histograms of the PF layer.
 //
 
+//
+// Constructor
+//
+// All the counters and histograms start at 0.
+//
+StatisticsMgr::StatisticsMgr()
+{
+   Reset();
+}
+
 //
 // Register
 //
@@ -130,6 +162,12 @@ RC StatisticsMgr::Register (const char *psKey, const Stat_Operation op,
    if (psKey==NULL || (op != STAT_ADDONE && piValue == NULL))
       return STAT_INVALID_ARGS;
 
+   // The name of a counter registers the counter
+   if ((i = CounterOf(psKey)) >= 0)
+      return Register((Stat_Counter)i, op, piValue);
+
+   std::lock_guard<std::mutex> lock(statsMutex);
+
    iCount = llStats.GetLength();
 
    for (i=0; i < iCount; i++) {
@@ -213,6 +251,11 @@ int *StatisticsMgr::Get(const char *psKey)
    int i, iCount;
    Statistic *pStat = NULL;
 
+   if ((i = CounterOf(psKey)) >= 0)
+      return Get((Stat_Counter)i);
+
+   std::lock_guard<std::mutex> lock(statsMutex);
+
    iCount = llStats.GetLength();
 
    for (i=0; i < iCount; i++) {
@@ -231,13 +274,26 @@ int *StatisticsMgr::Get(const char *psKey)
 //
 // Print
 //
-// Print out all the statistics tracked
+// Print out all the statistics tracked: the counters that are not 0, the
+// histograms that are not empty, and the named statistics
 //
 void StatisticsMgr::Print()
 {
    int i, iCount;
    Statistic *pStat = NULL;
 
+   for (i=0; i < STAT_NUM_COUNTERS; i++) {
+      long lValue = Sum((Stat_Counter)i);
+      if (lValue)
+         cout << StatCounterName[i] << "::" << lValue << "\n";
+   }
+
+   for (i=0; i < STAT_NUM_LATENCIES; i++)
+      if (GetLatencyCount((Stat_Latency)i))
+         Print((Stat_Latency)i);
+
+   std::lock_guard<std::mutex> lock(statsMutex);
+
    iCount = llStats.GetLength();
 
    for (i=0; i < iCount; i++) {
@@ -260,6 +316,11 @@ RC StatisticsMgr::Reset(const char *psKey)
    if (psKey==NULL)
       return STAT_INVALID_ARGS;
 
+   if ((i = CounterOf(psKey)) >= 0)
+      return Reset((Stat_Counter)i);
+
+   std::lock_guard<std::mutex> lock(statsMutex);
+
    iCount = llStats.GetLength();
 
    for (i=0; i < iCount; i++) {
@@ -281,10 +342,279 @@ RC StatisticsMgr::Reset(const char *psKey)
 // Reset
 //
 // Reset all of the statistics.  The easiest way is to tell the linklist of
-// elements to Erase itself.
+// elements to Erase itself.  The counters and histograms are set to 0.
 //
 void StatisticsMgr::Reset()
 {
+   std::lock_guard<std::mutex> lock(statsMutex);
    llStats.Erase();
+
+   for (int s=0; s < STAT_STRIPES; s++) {
+      Stripe &stripe = stripes[s];
+      for (int i=0; i < STAT_NUM_COUNTERS; i++)
+         stripe.counters[i] = 0;
+      for (int i=0; i < STAT_NUM_LATENCIES; i++) {
+         for (int b=0; b < STAT_LATENCY_BUCKETS; b++)
+            stripe.buckets[i][b] = 0;
+         stripe.totalNanos[i] = 0;
+      }
+   }
+}
+
+//
+// Register
+//
+// Register a change to a counter.  Adding to or subtracting from it only
+// touches the stripe of the calling thread.  The other operations need the
+// value of the counter: the stripes are added up into the first one under
+// the lock, and an addition made meanwhile by another thread may be lost.
+//
+RC StatisticsMgr::Register(const Stat_Counter counter, const Stat_Operation op,
+      const int *const piValue)
+{
+   if (counter < 0 || counter >= STAT_NUM_COUNTERS ||
+         (op != STAT_ADDONE && piValue == NULL) ||
+         (op == STAT_DIVVALUE && *piValue == 0))
+      return STAT_INVALID_ARGS;
+
+   switch (op) {
+      case STAT_ADDONE:
+         MyStripe().counters[counter].fetch_add(1, memory_order_relaxed);
+         return 0;
+      case STAT_ADDVALUE:
+         MyStripe().counters[counter].fetch_add(*piValue,
+               memory_order_relaxed);
+         return 0;
+      case STAT_SUBVALUE:
+         MyStripe().counters[counter].fetch_sub(*piValue,
+               memory_order_relaxed);
+         return 0;
+      default:
+         break;
+   }
+
+   std::lock_guard<std::mutex> lock(statsMutex);
+   long lValue = 0;
+   for (int s=0; s < STAT_STRIPES; s++)
+      lValue += stripes[s].counters[counter].exchange(0);
+
+   switch (op) {
+      case STAT_SETVALUE:
+         lValue = *piValue;
+         break;
+      case STAT_MULTVALUE:
+         lValue *= *piValue;
+         break;
+      case STAT_DIVVALUE:
+         lValue /= *piValue;
+         break;
+      default:
+         break;
+   }
+   stripes[0].counters[counter].fetch_add(lValue);
+
+   return 0;
+}
+
+//
+// Get
+//
+// Return the value of a counter, in memory the caller must delete, or NULL
+// if it is 0.  The stripes are read while other threads may add to them.
+//
+int *StatisticsMgr::Get(const Stat_Counter counter)
+{
+   if (counter < 0 || counter >= STAT_NUM_COUNTERS)
+      return NULL;
+
+   long lValue = Sum(counter);
+   if (lValue == 0)
+      return NULL;
+
+   return new int(lValue);
+}
+
+//
+// Reset
+//
+// Set a counter to 0
+//
+RC StatisticsMgr::Reset(const Stat_Counter counter)
+{
+   if (counter < 0 || counter >= STAT_NUM_COUNTERS)
+      return STAT_INVALID_ARGS;
+
+   for (int s=0; s < STAT_STRIPES; s++)
+      stripes[s].counters[counter] = 0;
+
+   return 0;
+}
+
+//
+// RegisterLatency
+//
+// Add a latency to the histogram.  Its bucket is the position of the
+// highest bit set in nanos.
+//
+void StatisticsMgr::RegisterLatency(const Stat_Latency latency, long nanos)
+{
+   if (latency < 0 || latency >= STAT_NUM_LATENCIES)
+      return;
+   if (nanos < 1)
+      nanos = 1;
+
+   int bucket = 8 * sizeof(long) - 1 - __builtin_clzl(nanos);
+   if (bucket >= STAT_LATENCY_BUCKETS)
+      bucket = STAT_LATENCY_BUCKETS - 1;
+
+   Stripe &stripe = MyStripe();
+   stripe.buckets[latency][bucket].fetch_add(1, memory_order_relaxed);
+   stripe.totalNanos[latency].fetch_add(nanos, memory_order_relaxed);
+}
+
+//
+// GetLatencyCount
+//
+// Return the number of latencies registered in a histogram
+//
+long StatisticsMgr::GetLatencyCount(const Stat_Latency latency)
+{
+   long lCount = 0;
+   for (int b=0; b < STAT_LATENCY_BUCKETS; b++)
+      lCount += Bucket(latency, b);
+   return lCount;
+}
+
+//
+// GetLatencyMean
+//
+// Return the mean of the latencies of a histogram in nanoseconds, 0 if
+// there is none
+//
+long StatisticsMgr::GetLatencyMean(const Stat_Latency latency)
+{
+   long lCount = GetLatencyCount(latency);
+   if (lCount == 0)
+      return 0;
+
+   long lTotal = 0;
+   for (int s=0; s < STAT_STRIPES; s++)
+      lTotal += stripes[s].totalNanos[latency].load(memory_order_relaxed);
+   return lTotal / lCount;
+}
+
+//
+// GetLatencyPercentile
+//
+// Return the upper bound, in nanoseconds, of the bucket that holds the
+// percent-th percentile of the latencies of a histogram, 0 if there is
+// none.  The bound of the last bucket is the longest latency it can count
+// precisely.
+//
+long StatisticsMgr::GetLatencyPercentile(const Stat_Latency latency,
+      int percent)
+{
+   long lCount = GetLatencyCount(latency);
+   if (lCount == 0)
+      return 0;
+
+   // Rank of the percentile among the latencies, counting from 1
+   long lRank = (lCount * percent + 99) / 100;
+   if (lRank < 1)
+      lRank = 1;
+
+   long lSeen = 0;
+   int b;
+   for (b=0; b < STAT_LATENCY_BUCKETS - 1; b++)
+      if ((lSeen += Bucket(latency, b)) >= lRank)
+         break;
+   return 2L << b;
+}
+
+//
+// Print
+//
+// Print out a histogram: the number of latencies, their mean, a few
+// percentiles and the buckets that are not empty
+//
+RC StatisticsMgr::Print(const Stat_Latency latency)
+{
+   if (latency < 0 || latency >= STAT_NUM_LATENCIES)
+      return STAT_INVALID_ARGS;
+
+   cout << StatLatencyName[latency] << " latency (ns)::"
+        << GetLatencyCount(latency) << " calls, mean "
+        << GetLatencyMean(latency) << ", p50 < "
+        << GetLatencyPercentile(latency, 50) << ", p99 < "
+        << GetLatencyPercentile(latency, 99) << "\n";
+
+   for (int b=0; b < STAT_LATENCY_BUCKETS; b++) {
+      long lCount = Bucket(latency, b);
+      if (lCount == 0)
+         continue;
+      if (b == STAT_LATENCY_BUCKETS - 1)
+         cout << "  >= " << (1L << b);
+      else
+         cout << "  < " << (2L << b);
+      cout << "::" << lCount << "\n";
+   }
+
+   return 0;
+}
+
+//
+// MyStripe
+//
+// Return the stripe of the calling thread.  The threads are given the
+// stripes in turn, the first time they need one.
+//
+StatisticsMgr::Stripe &StatisticsMgr::MyStripe()
+{
+   static std::atomic<int> nextStripe(0);
+   static thread_local int iStripe =
+      nextStripe.fetch_add(1, memory_order_relaxed) % STAT_STRIPES;
+   return stripes[iStripe];
+}
+
+//
+// Sum
+//
+// Return the value of a counter, the sum of its stripes
+//
+long StatisticsMgr::Sum(const Stat_Counter counter)
+{
+   long lValue = 0;
+   for (int s=0; s < STAT_STRIPES; s++)
+      lValue += stripes[s].counters[counter].load(memory_order_relaxed);
+   return lValue;
+}
+
+//
+// Bucket
+//
+// Return the number of latencies in a bucket of a histogram
+//
+long StatisticsMgr::Bucket(const Stat_Latency latency, int bucket)
+{
+   long lCount = 0;
+   for (int s=0; s < STAT_STRIPES; s++)
+      lCount += stripes[s].buckets[latency][bucket].load(
+            memory_order_relaxed);
+   return lCount;
+}
+
+//
+// CounterOf
+//
+// Return the counter named psKey, or -1 if there is none
+//
+int StatisticsMgr::CounterOf(const char *psKey)
+{
+   if (psKey == NULL)
+      return -1;
+   for (int i=0; i < STAT_NUM_COUNTERS; i++)
+      if (strcmp(psKey, StatCounterName[i]) == 0)
+         return i;
+   return -1;
 }
 
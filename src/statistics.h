@@ -17,6 +17,15 @@
 // Andre Bergholz, who was the TA for the 2000 offering, has written
 // some (or probably all) of this code.
 
+// The statistics of the PF layer are registered on every page request and
+// I/O, by several threads, so they do not go through the list of named
+// statistics.  Their keys are the values of Stat_Counter, known at compile
+// time, and they are kept in striped atomic counters: each thread adds to
+// the counters of its own stripe, without any lock, and Get and Print add
+// up the stripes.  The latencies of page reads, writes and requests go to
+// histograms with one bucket per power of two nanoseconds, striped the same
+// way.  Names that are not Stat_Counter values still work as before.
+
 #ifndef STATISTICS_H
 #define STATISTICS_H
 
@@ -47,6 +56,57 @@ const int STAT_BASE = 9000;
 
 // This include must come after the common defines
 #include "linkedlist.h"    // Template class for the link list
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+//
+// The following are specifically for tracking the statistics in the PF
+// component of Redbase.  When statistics are utilized, these constants
+// will be used as the keys for the statistics manager.  StatCounterName
+// gives the name each of them is printed with.
+//
+enum Stat_Counter {
+    PF_GETPAGE,
+    PF_PAGEFOUND,
+    PF_PAGENOTFOUND,
+    PF_READPAGE,          // IO
+    PF_WRITEPAGE,         // IO
+    PF_WRITEV,            // IO, one per pwritev call
+    PF_FLUSHPAGES,
+    PF_READAHEAD,         // IO, pages read ahead
+    PF_READAHEADHIT,      // pages read ahead, then requested
+    PF_READAHEADMISS,     // sequential requests not read ahead
+    PF_BGWRITE,           // IO, pages written by the background writer
+    PF_CHECKPOINT,        // checkpoints taken
+    PF_SCANRING,          // slots recycled by sequential scans
+    PF_EXTEND,            // IO, extents preallocated
+    PF_COMMIT,            // commits that had to make pages durable
+    PF_SYNC,              // IO, one per fdatasync call
+    PF_LOGRECORD,         // write-ahead log records appended
+    PF_LOGWRITE,          // IO, writes of the write-ahead log
+    PF_PUNCHPAGE,         // IO, disposed pages punched out of their file
+    STAT_NUM_COUNTERS
+};
+extern const char *const StatCounterName[STAT_NUM_COUNTERS];
+
+//
+// Latency histograms
+//
+enum Stat_Latency {
+    PF_GETPAGE_LATENCY,   // PF_BufferMgr::GetPage, hit or miss
+    PF_READPAGE_LATENCY,  // one page read
+    PF_WRITEPAGE_LATENCY, // one pwritev of one or more pages
+    STAT_NUM_LATENCIES
+};
+extern const char *const StatLatencyName[STAT_NUM_LATENCIES];
+
+// Bucket b of a histogram counts the latencies of 2^b to 2^(b+1)-1 ns,
+// the last one everything longer
+const int STAT_LATENCY_BUCKETS = 40;
+
+// Number of stripes of the counters.  Threads are spread over them.
+const int STAT_STRIPES = 16;
 
 // A single statistic will be tracked by a Statistic class
 class Statistic {
@@ -89,7 +149,7 @@ enum Stat_Operation {
 class StatisticsMgr {
 
 public:
-    StatisticsMgr() {};
+    StatisticsMgr();
     ~StatisticsMgr() {};
 
     // Add a new statistic or register a change to an existing statistic.
@@ -115,27 +175,71 @@ public:
     // Reset all of the statistics
     void Reset();
 
+    // The same for the counters.  Register does not take a lock for
+    // STAT_ADDONE, STAT_ADDVALUE and STAT_SUBVALUE.  Get returns NULL for
+    // a counter that is 0.
+    RC Register(const Stat_Counter counter, const Stat_Operation op,
+                const int *const piValue = NULL);
+    int *Get(const Stat_Counter counter);
+    RC Reset(const Stat_Counter counter);
+
+    // Add a latency, in nanoseconds, to a histogram.  Never takes a lock.
+    void RegisterLatency(const Stat_Latency latency, long nanos);
+
+    // Number of latencies in a histogram, their mean, and the upper bound
+    // of the bucket holding the percent-th percentile, in nanoseconds
+    long GetLatencyCount(const Stat_Latency latency);
+    long GetLatencyMean(const Stat_Latency latency);
+    long GetLatencyPercentile(const Stat_Latency latency, int percent);
+
+    // Print out a histogram
+    RC Print(const Stat_Latency latency);
+
 private:
+    // The counters and histograms a group of threads adds to
+    struct Stripe {
+        std::atomic<long> counters[STAT_NUM_COUNTERS];
+        std::atomic<long> buckets[STAT_NUM_LATENCIES][STAT_LATENCY_BUCKETS];
+        std::atomic<long> totalNanos[STAT_NUM_LATENCIES];
+        char              pad[64];      // keep stripes on separate lines
+    };
+
+    Stripe &MyStripe();                 // Stripe of the calling thread
+    long Sum(const Stat_Counter counter);
+    long Bucket(const Stat_Latency latency, int bucket);
+    int  CounterOf(const char *psKey);  // -1 if psKey is no counter name
+
     LinkList<Statistic> llStats;
+    std::mutex statsMutex;  // Statistics are registered by several threads
+    Stripe stripes[STAT_STRIPES];
 };
 
 //
-// Return codes
+// StatTimer - adds the time from its construction to its destruction to
+// a latency histogram
 //
-const int STAT_INVALID_ARGS = STAT_BASE+1;  // Bad Args in call to method
-const int STAT_UNKNOWN_KEY  = STAT_BASE+2;  // No such Key being tracked
+class StatTimer {
+public:
+    StatTimer(StatisticsMgr *_pMgr, Stat_Latency _latency)
+        : pMgr(_pMgr), latency(_latency),
+          start(std::chrono::steady_clock::now()) {}
+    ~StatTimer() {
+        pMgr->RegisterLatency(latency,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    StatisticsMgr *pMgr;
+    Stat_Latency latency;
+    std::chrono::steady_clock::time_point start;
+};
 
 //
-// The following are specifically for tracking the statistics in the PF
-// component of Redbase.  When statistics are utilized, these constants
-// will be used as the keys for the statistics manager.
+// Return codes
 //
-extern const char *PF_GETPAGE;
-extern const char *PF_PAGEFOUND;
-extern const char *PF_PAGENOTFOUND;
-extern const char *PF_READPAGE;         // IO
-extern const char *PF_WRITEPAGE;        // IO
-extern const char *PF_FLUSHPAGES;
+const int STAT_INVALID_ARGS = STAT_BASE+1;  // Bad Args in call to method
+const int STAT_UNKNOWN_KEY  = STAT_BASE+2;  // No such Key being tracked
 
 #endif
 
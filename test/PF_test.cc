@@ -2,9 +2,21 @@
 #include "pf.h"
 #include "pf_internal.h"
 #include "pf_hashtable.h"
+#include "pf_buffermgr.h"
+#include "pf_arena.h"
+#include "pf_allocbitmap.h"
+#include "pf_groupcommit.h"
+#include "statistics.h"
 
 #include <cstdio>
 #include <fstream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "gtest/gtest.h"
 
@@ -83,3 +95,1548 @@ TEST (PF_Manager, AddPageToFile)
   mgr.CloseFile (handle);
   remove ("test_file");
 }
+
+TEST (PF_PinnedPage, UnpinsWhenDestroyed)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+  {
+    PF::PinnedPage page = handle.PinNewPage ();
+    EXPECT_TRUE (page.IsPinned ());
+    *(int*) page.GetData () = 42;
+    page.MarkDirty ();
+  }
+  // Unpinned, and written back when the file is closed.
+  EXPECT_NO_THROW (handle.DisposePage (0));
+  mgr.CloseFile (handle);
+
+  handle = mgr.OpenFile ("test_file");
+  {
+    PF::PinnedPage page = handle.PinNewPage ();
+    *(int*) page.GetData () = 7;
+    handle.DoneWritingTo (page);
+    EXPECT_FALSE (page.IsPinned ());
+  }
+  try {
+    PF::PinnedPage page = handle.PinPage (0);
+    EXPECT_EQ (7, *(int*) page.GetData ());
+    throw std::exception ();
+  }
+  catch (std::exception& e) {
+  }
+  EXPECT_NO_THROW (handle.DisposePage (0));
+
+  // Moving hands the pin over: only one unpin happens.
+  PF::PinnedPage first = handle.PinNewPage ();
+  PF::PinnedPage second (std::move (first));
+  EXPECT_FALSE (first.IsPinned ());
+  EXPECT_TRUE (second.IsPinned ());
+  first = std::move (second);
+  EXPECT_TRUE (first.IsPinned ());
+  handle.UnpinPage (first);
+  EXPECT_FALSE (first.IsPinned ());
+
+  mgr.CloseFile (handle);
+  remove ("test_file");
+}
+
+// Loads slots 0..n-1 with pages 0..n-1 of file 1, all unpinned.
+static void fill (PF_Replacer& replacer, PF_BufPageDesc* table, int n)
+{
+  for (int i = 0; i < n; ++i) {
+    table [i].pinCount = 0;
+    replacer.Insert (i, 1, i);
+    replacer.Unpin (i);
+  }
+}
+
+TEST (PF_Replacer, LRUVictimIsLeastRecentlyUsed)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [4] ();
+  PF_LRUReplacer lru (4);
+  fill (lru, table, 4);
+  lru.Access (0);
+  lru.Unpin (0);
+
+  int slot;
+  EXPECT_EQ (0, lru.Victim (table, slot));
+  EXPECT_EQ (1, slot);
+
+  table [2].pinCount = 1;
+  EXPECT_EQ (0, lru.Victim (table, slot));
+  EXPECT_EQ (3, slot);
+  delete [] table;
+}
+
+TEST (PF_Replacer, ClockGivesSecondChance)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [3] ();
+  PF_ClockReplacer clock (3);
+  fill (clock, table, 3);
+
+  // First sweep clears all the reference bits, slot 0 goes first.
+  int slot;
+  EXPECT_EQ (0, clock.Victim (table, slot));
+  EXPECT_EQ (0, slot);
+
+  // Slot 1 is referenced again and survives the next sweep.
+  clock.Access (1);
+  EXPECT_EQ (0, clock.Victim (table, slot));
+  EXPECT_EQ (2, slot);
+  delete [] table;
+}
+
+TEST (PF_Replacer, AllPinnedMeansNoBuffer)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [2] ();
+  for (int policy = PF_LRU; policy <= PF_LRUK; ++policy) {
+    PF_Replacer* replacer = PF_NewReplacer ((PF_ReplacementPolicy) policy, 2);
+    table [0].pinCount = table [1].pinCount = 1;
+    replacer->Insert (0, 1, 0);
+    replacer->Insert (1, 1, 1);
+    int slot;
+    EXPECT_EQ (PF_NOBUF, replacer->Victim (table, slot));
+    delete replacer;
+  }
+  delete [] table;
+}
+
+// The page in slot 0 is hot, every other slot holds a page that was
+// referenced once.  A long scan must never replace the hot page.
+TEST (PF_Replacer, ColdestComeInVictimOrder)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [4] ();
+  PF_LRUReplacer lru (4);
+  fill (lru, table, 4);
+  lru.Access (0);
+  lru.Unpin (0);
+  table [2].pinCount = 1;
+
+  // Pinned slots are left out, and the list stops at max.
+  int slots [4];
+  ASSERT_EQ (2, lru.Coldest (table, slots, 2));
+  EXPECT_EQ (1, slots [0]);
+  EXPECT_EQ (3, slots [1]);
+  ASSERT_EQ (3, lru.Coldest (table, slots, 4));
+  EXPECT_EQ (0, slots [2]);
+
+  // Coldest does not move the clock hand: the first victim is still the
+  // first coldest slot.
+  PF_ClockReplacer clock (4);
+  fill (clock, table, 4);
+  clock.Access (1);
+  ASSERT_EQ (4, clock.Coldest (table, slots, 4));
+  int slot;
+  EXPECT_EQ (0, clock.Victim (table, slot));
+  EXPECT_EQ (slots [0], slot);
+  delete [] table;
+}
+
+static void ExpectScanResistant (PF_Replacer& replacer, PF_BufPageDesc* table)
+{
+  int slot;
+  for (PageNum p = 100; p < 200; ++p) {
+    ASSERT_EQ (0, replacer.Victim (table, slot));
+    EXPECT_NE (0, slot);
+    replacer.Insert (slot, 1, p);
+    replacer.Unpin (slot);
+  }
+}
+
+TEST (PF_Replacer, TwoQIsScanResistant)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [8] ();
+  PF_TwoQReplacer twoq (8);
+  fill (twoq, table, 8);
+
+  // Page 0 leaves A1in and is referenced again: it is promoted to Am.
+  int slot;
+  EXPECT_EQ (0, twoq.Victim (table, slot));
+  EXPECT_EQ (0, slot);
+  twoq.Insert (0, 1, 0);
+  twoq.Unpin (0);
+
+  ExpectScanResistant (twoq, table);
+  delete [] table;
+}
+
+// Page 0 is referenced again after it left A1in, and its ghost is pushed
+// out of A1out later on.  When page 0 is replaced from Am and comes back,
+// it was not remembered and starts over on A1in.
+TEST (PF_Replacer, TwoQGhostAgesOutAfterPromotion)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [4] ();
+  PF_TwoQReplacer twoq (4);
+  fill (twoq, table, 4);
+
+  int slot;
+  ASSERT_EQ (0, twoq.Victim (table, slot));
+  ASSERT_EQ (0, slot);
+  twoq.Insert (0, 1, 0);
+  twoq.Unpin (0);
+
+  // Two more pages go through A1out, which holds two.
+  for (PageNum p = 10; p < 12; ++p) {
+    ASSERT_EQ (0, twoq.Victim (table, slot));
+    twoq.Insert (slot, 1, p);
+    twoq.Unpin (slot);
+  }
+
+  // Replace page 0 from Am by pinning everything on A1in.
+  table [1].pinCount = table [2].pinCount = table [3].pinCount = 1;
+  ASSERT_EQ (0, twoq.Victim (table, slot));
+  ASSERT_EQ (0, slot);
+  twoq.Insert (0, 1, 0);
+  twoq.Unpin (0);
+  table [1].pinCount = table [2].pinCount = table [3].pinCount = 0;
+
+  // Page 0 is the newest page on A1in, so it goes last.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ (0, twoq.Victim (table, slot));
+    EXPECT_NE (0, slot);
+  }
+  ASSERT_EQ (0, twoq.Victim (table, slot));
+  EXPECT_EQ (0, slot);
+  delete [] table;
+}
+
+TEST (PF_Replacer, LRUKIsScanResistant)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [8] ();
+  PF_LRUKReplacer lruk (8);
+  fill (lruk, table, 8);
+  lruk.Access (0);
+  lruk.Unpin (0);
+
+  ExpectScanResistant (lruk, table);
+  delete [] table;
+}
+
+TEST (PF_Replacer, LRUKIgnoresCorrelatedReferences)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [4] ();
+  PF_LRUKReplacer lruk (4);
+
+  // Page 0 is pinned three times before it is unpinned: one reference.
+  lruk.Insert (0, 1, 0);
+  lruk.Access (0);
+  lruk.Access (0);
+  lruk.Unpin (0);
+  for (int i = 1; i < 4; ++i) {
+    lruk.Insert (i, 1, i);
+    lruk.Unpin (i);
+  }
+
+  int slot;
+  EXPECT_EQ (0, lruk.Victim (table, slot));
+  EXPECT_EQ (0, slot);
+  delete [] table;
+}
+
+TEST (PF_Replacer, LRUKRetainsHistoryOfReplacedPages)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [8] ();
+  PF_LRUKReplacer lruk (8);
+  fill (lruk, table, 8);
+  lruk.Access (0);
+  lruk.Unpin (0);
+
+  // Page 0 is replaced while everything else is pinned, and read again.
+  for (int i = 1; i < 8; ++i)
+    table [i].pinCount = 1;
+  int slot;
+  ASSERT_EQ (0, lruk.Victim (table, slot));
+  ASSERT_EQ (0, slot);
+  lruk.Insert (0, 1, 0);
+  lruk.Unpin (0);
+  for (int i = 1; i < 8; ++i)
+    table [i].pinCount = 0;
+
+  ExpectScanResistant (lruk, table);
+  delete [] table;
+}
+
+// The candidates are kept in order as pages are pinned and unpinned.
+TEST (PF_Replacer, LRUKColdestComeInVictimOrder)
+{
+  PF_BufPageDesc* table = new PF_BufPageDesc [4] ();
+  PF_LRUKReplacer lruk (4);
+  fill (lruk, table, 4);
+  lruk.Access (0);
+  lruk.Unpin (0);
+  lruk.Access (2);
+  table [2].pinCount = 1;
+
+  int slots [4];
+  ASSERT_EQ (3, lruk.Coldest (table, slots, 4));
+  EXPECT_EQ (1, slots [0]);
+  EXPECT_EQ (3, slots [1]);
+  EXPECT_EQ (0, slots [2]);
+
+  int slot;
+  ASSERT_EQ (0, lruk.Victim (table, slot));
+  EXPECT_EQ (1, slot);
+  ASSERT_EQ (2, lruk.Coldest (table, slots, 4));
+  EXPECT_EQ (3, slots [0]);
+
+  // Slot 2 is unpinned with two references, as many as slot 0, but
+  // later ones.
+  table [2].pinCount = 0;
+  lruk.Unpin (2);
+  ASSERT_EQ (3, lruk.Coldest (table, slots, 4));
+  EXPECT_EQ (3, slots [0]);
+  EXPECT_EQ (0, slots [1]);
+  EXPECT_EQ (2, slots [2]);
+  delete [] table;
+}
+
+TEST (PF_Manager, AllReplacementPolicies)
+{
+  for (int policy = PF_LRU; policy <= PF_LRUK; ++policy) {
+    remove ("test_file");
+    PF_Manager _pfm ((PF_ReplacementPolicy) policy);
+    PF::Manager mgr (_pfm);
+    mgr.CreateFile ("test_file");
+    PF::FileHandle handle = mgr.OpenFile ("test_file");
+
+    // Many more pages than the buffer holds.
+    const int n = 200;
+    for (int i = 0; i < n; ++i) {
+      PF::PageHandle page = handle.AllocatePage ();
+      *(int*) page.GetData () = i;
+      handle.DoneWritingTo (page);
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+      for (int i = 0; i < n; ++i) {
+        PF::PageHandle page = handle.GetPage (i);
+        EXPECT_EQ (i, *(int*) page.GetData ());
+        handle.UnpinPage (page);
+      }
+      mgr.SetReplacementPolicy (PF_CLOCK);
+    }
+    mgr.CloseFile (handle);
+    remove ("test_file");
+  }
+}
+
+TEST (PF_HashTable, ManyEntriesAndDeletes)
+{
+  PF_HashTable ht (4);
+  int slot;
+
+  // Far more entries than the table was sized for, so it has to grow.
+  for (int fd = 3; fd < 8; ++fd)
+    for (PageNum p = 0; p < 200; ++p)
+      EXPECT_EQ (0, ht.Insert (fd, p, fd * 1000 + p));
+  EXPECT_EQ (PF_HASHPAGEEXIST, ht.Insert (5, 17, 0));
+
+  // Delete every other page, the rest must still be reachable.
+  for (int fd = 3; fd < 8; ++fd)
+    for (PageNum p = 0; p < 200; p += 2)
+      EXPECT_EQ (0, ht.Delete (fd, p));
+  ht.Resize (16);
+  for (int fd = 3; fd < 8; ++fd)
+    for (PageNum p = 0; p < 200; ++p) {
+      if (p % 2 == 0) {
+        EXPECT_EQ (PF_HASHNOTFOUND, ht.Find (fd, p, slot));
+      }
+      else {
+        EXPECT_EQ (0, ht.Find (fd, p, slot));
+        EXPECT_EQ (fd * 1000 + p, slot);
+      }
+    }
+}
+
+TEST (PF_FileHandle, ForcePagesWritesEveryDirtyPage)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+
+  const int n = 30;
+  for (int i = 0; i < n; ++i) {
+    PF::PageHandle page = handle.AllocatePage ();
+    handle.DoneWritingTo (page);
+  }
+  // Dirty the pages out of order, leaving a few gaps and one pinned.
+  PF::PageHandle pinned = handle.GetPage (7);
+  *(int*) pinned.GetData () = 7;
+  handle.MarkDirty (7);
+  for (int i = n - 1; i >= 0; --i) {
+    if (i % 5 == 3 || i == 7) continue;
+    PF::PageHandle page = handle.GetPage (i);
+    *(int*) page.GetData () = i;
+    handle.DoneWritingTo (page);
+  }
+  handle.ForcePages ();
+
+  ifstream file ("test_file", ios::binary);
+  for (int i = 0; i < n; ++i) {
+    int value;
+    file.seekg (PF_FILE_HDR_SIZE + (long) i * (PF_PAGE_SIZE + sizeof (PF_PageHdr))
+                + sizeof (PF_PageHdr));
+    file.read ((char*) &value, sizeof (value));
+    EXPECT_EQ (i % 5 == 3 && i != 7 ? 0 : i, value);
+  }
+  file.close ();
+
+  handle.UnpinPage (pinned);
+  mgr.CloseFile (handle);
+  remove ("test_file");
+}
+
+TEST (PF_Manager, BackgroundCheckpoint)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+
+  const int n = 30;
+  for (int i = 0; i < n; ++i) {
+    PF::PageHandle page = handle.AllocatePage ();
+    *(int*) page.GetData () = i;
+    handle.DoneWritingTo (page);
+  }
+  // A pinned page may still be changing, the checkpointer leaves it.
+  PF::PageHandle pinned = handle.GetPage (7);
+  *(int*) pinned.GetData () = -7;
+  handle.MarkDirty (7);
+
+  mgr.SetCheckpointInterval (1);
+  mgr.SetBackgroundWriter (10);
+  this_thread::sleep_for (chrono::milliseconds (100));
+  mgr.SetCheckpointInterval (0);
+
+  ifstream file ("test_file", ios::binary);
+  for (int i = 0; i < n; ++i) {
+    int value = -1;
+    file.seekg (PF_FILE_HDR_SIZE + (long) i * (PF_PAGE_SIZE + sizeof (PF_PageHdr))
+                + sizeof (PF_PageHdr));
+    file.read ((char*) &value, sizeof (value));
+    EXPECT_EQ (i == 7 ? 0 : i, value);
+  }
+  file.close ();
+
+  handle.UnpinPage (pinned);
+  mgr.CloseFile (handle);
+  mgr.SetBackgroundWriter (0);
+  remove ("test_file");
+}
+
+TEST (PF_Manager, ReadAheadScan)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.SetReadAhead (8);
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+
+  const int n = 100;
+  for (int i = 0; i < n; ++i) {
+    PF::PageHandle page = handle.AllocatePage ();
+    *(int*) page.GetData () = i;
+    handle.DoneWritingTo (page);
+  }
+  mgr.CloseFile (handle);
+
+  for (int pass = 0; pass < 2; ++pass) {
+    handle = mgr.OpenFile ("test_file");
+    PF::PageHandle page = handle.GetFirstPage ();
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ (i, page.GetPageNum ());
+      EXPECT_EQ (i, *(int*) page.GetData ());
+      handle.UnpinPage (page);
+      if (i + 1 < n) page = handle.GetNextPage (i);
+    }
+
+    // The pages read ahead past the end of the file must not get in the
+    // way of new pages.
+    PF::PageHandle last = handle.AllocatePage ();
+    EXPECT_EQ (n + pass, last.GetPageNum ());
+    *(int*) last.GetData () = -1;
+    handle.DoneWritingTo (last);
+    mgr.CloseFile (handle);
+  }
+  remove ("test_file");
+}
+
+// The extent preallocated past the last page reads as zeros, and must
+// not be read ahead as if it held pages.
+TEST (PF_BufferMgr, ReadAheadStopsAtTheEndOfTheFile)
+{
+  remove ("test_file");
+  const int n = 20;
+  {
+    MK_MGR ();
+    mgr.SetExtentPages (16);
+    mgr.CreateFile ("test_file");
+    PF::FileHandle handle = mgr.OpenFile ("test_file");
+    for (int i = 0; i < n; ++i) {
+      PF::PageHandle page = handle.AllocatePage ();
+      handle.DoneWritingTo (page);
+    }
+    mgr.CloseFile (handle);
+  }
+
+  int fd = open ("test_file", O_RDONLY);
+  ASSERT_LE (0, fd);
+  {
+    PF_BufferMgr buffer (40);
+    buffer.SetReadAhead (8);
+    const int pageSize = PF_PAGE_SIZE + sizeof (PF_PageHdr);
+    for (PageNum p = 0; p < n; ++p) {
+      char* data;
+      ASSERT_EQ (0, buffer.GetPage (fd, p, pageSize, &data, TRUE, NO_HINT,
+                                    n));
+      ASSERT_EQ (0, buffer.UnpinPage (fd, p));
+    }
+
+    // Switching the policy waits for the reads ahead.
+    ASSERT_EQ (0, buffer.SetReplacementPolicy (PF_LRU));
+    vector<PageNum> pages;
+    ASSERT_EQ (0, buffer.GetResidentPages (fd, pages));
+    EXPECT_EQ (n, (int) pages.size ());
+    for (size_t i = 0; i < pages.size (); ++i)
+      EXPECT_GT (n, pages [i]);
+  }
+  close (fd);
+  remove ("test_file");
+}
+
+TEST (PF_Manager, ScanLeavesHotPagesAlone)
+{
+  remove ("hot_file");
+  remove ("scan_file");
+  MK_MGR ();
+  mgr.CreateFile ("scan_file");
+  mgr.CreateFile ("hot_file");
+
+  const int n = 100;
+  PF::FileHandle scan = mgr.OpenFile ("scan_file");
+  for (int i = 0; i < n; ++i) {
+    PF::PageHandle page = scan.AllocatePage ();
+    *(int*) page.GetData () = i;
+    scan.DoneWritingTo (page);
+  }
+  mgr.CloseFile (scan);
+
+  const int numHot = 10;
+  PF::FileHandle hot = mgr.OpenFile ("hot_file");
+  for (int i = 0; i < numHot; ++i) {
+    PF::PageHandle page = hot.AllocatePage ();
+    *(int*) page.GetData () = i;
+    hot.DoneWritingTo (page);
+  }
+  hot.ForcePages ();
+
+  // Change the hot pages behind the back of the buffer manager, so that a
+  // page read again from the file shows up as -1.
+  fstream file ("hot_file", ios::binary | ios::in | ios::out);
+  for (int i = 0; i < numHot; ++i) {
+    int value = -1;
+    file.seekp (PF_FILE_HDR_SIZE + (long) i * (PF_PAGE_SIZE + sizeof (PF_PageHdr))
+                + sizeof (PF_PageHdr));
+    file.write ((char*) &value, sizeof (value));
+  }
+  file.close ();
+
+  for (int pass = 0; pass < 2; ++pass) {
+    ClientHint hint = pass == 0 ? SEQUENTIAL_SCAN : NO_HINT;
+    scan = mgr.OpenFile ("scan_file");
+    PF::PageHandle page = scan.GetFirstPage (hint);
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ (i, *(int*) page.GetData ());
+      scan.UnpinPage (page);
+      if (i + 1 < n) page = scan.GetNextPage (i, hint);
+    }
+    mgr.CloseFile (scan);
+
+    // The scan recycled a few slots, without the hint it took them all.
+    for (int i = 0; i < numHot; ++i) {
+      PF::PageHandle page = hot.GetPage (i, RANDOM_LOOKUP);
+      EXPECT_EQ (pass == 0 ? i : -1, *(int*) page.GetData ());
+      hot.UnpinPage (page);
+    }
+  }
+  mgr.CloseFile (hot);
+  remove ("hot_file");
+  remove ("scan_file");
+}
+
+TEST (PF_Manager, WarmRestart)
+{
+  remove ("warm_file");
+  remove ("warm_manifest");
+  const int n = 20;
+  const PageNum warm[] = { 2, 5, 9 };
+  {
+    MK_MGR ();
+    mgr.CreateFile ("warm_file");
+    PF::FileHandle fh = mgr.OpenFile ("warm_file");
+    for (int i = 0; i < n; ++i) {
+      PF::PageHandle page = fh.AllocatePage ();
+      *(int*) page.GetData () = i;
+      fh.DoneWritingTo (page);
+    }
+    mgr.CloseFile (fh);
+
+    fh = mgr.OpenFile ("warm_file");
+    for (PageNum p : warm) {
+      PF::PageHandle page = fh.GetPage (p);
+      fh.UnpinPage (page);
+    }
+    mgr.CloseFile (fh);
+    mgr.SaveWarmPages ("warm_manifest");
+  }
+
+  MK_MGR ();
+  mgr.LoadWarmPages ("warm_manifest");
+  PF::FileHandle fh = mgr.OpenFile ("warm_file");
+  // The warm pages are read in page order: once the last one is in, they
+  // all are.
+  PF::PageHandle page = fh.GetPage (warm[2]);
+  fh.UnpinPage (page);
+
+  // Change every page behind the back of the buffer manager, so that a
+  // page read from the file from now on shows up as -1.
+  fstream file ("warm_file", ios::binary | ios::in | ios::out);
+  for (int i = 0; i < n; ++i) {
+    int value = -1;
+    file.seekp (PF_FILE_HDR_SIZE + (long) i * (PF_PAGE_SIZE + sizeof (PF_PageHdr))
+                + sizeof (PF_PageHdr));
+    file.write ((char*) &value, sizeof (value));
+  }
+  file.close ();
+
+  for (PageNum p : warm) {
+    page = fh.GetPage (p);
+    EXPECT_EQ (p, *(int*) page.GetData ());
+    fh.UnpinPage (page);
+  }
+  page = fh.GetPage (3);
+  EXPECT_EQ (-1, *(int*) page.GetData ());
+  fh.UnpinPage (page);
+  mgr.CloseFile (fh);
+
+  // A missing manifest warms nothing up.
+  remove ("warm_manifest");
+  mgr.LoadWarmPages ("warm_manifest");
+  remove ("warm_file");
+}
+
+TEST (PF_Manager, MappedReadOnly)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+  const int n = 100;
+  for (int i = 0; i < n; ++i) {
+    PF::PageHandle page = handle.AllocatePage ();
+    *(int*) page.GetData () = i;
+    handle.DoneWritingTo (page);
+  }
+  handle.DisposePage (10);
+  mgr.CloseFile (handle);
+
+  handle = mgr.OpenFile ("test_file", PF_MMAP_READONLY);
+  int count = 0;
+  PF::PageHandle page = handle.GetFirstPage ();
+  for (;;) {
+    int pageNum = page.GetPageNum ();
+    EXPECT_NE (10, pageNum);
+    EXPECT_EQ (pageNum, *(int*) page.GetData ());
+    handle.UnpinPage (page);
+    ++count;
+    if (pageNum == n - 1) break;
+    page = handle.GetNextPage (pageNum);
+  }
+  EXPECT_EQ (n - 1, count);
+
+  // Pins are still counted, and the file cannot be changed.
+  EXPECT_THROW (handle.UnpinPage (page), PF::error::PageAlreadyPinned);
+  EXPECT_THROW (handle.AllocatePage (), PF::error::ReadOnlyFile);
+  EXPECT_THROW (handle.DisposePage (3), PF::error::ReadOnlyFile);
+  page = handle.GetPage (3);
+  EXPECT_THROW (handle.MarkDirty (3), PF::error::ReadOnlyFile);
+  EXPECT_THROW (mgr.CloseFile (handle), PF::error::PagePinned);
+  handle.UnpinPage (page);
+  mgr.CloseFile (handle);
+  remove ("test_file");
+}
+
+TEST (PF_Manager, PageSizes)
+{
+  const int sizes [] = { 4096, 16384, 65536 };
+  const char* names [] = { "test_4k", "test_16k", "test_64k" };
+  const int n = 30;
+  MK_MGR ();
+
+  // The three files share the buffer, which is smaller than all the
+  // pages, so frames are reused for pages of other sizes.
+  PF::FileHandle handles [3];
+  for (int f = 0; f < 3; ++f) {
+    remove (names [f]);
+    mgr.CreateFile (names [f], sizes [f]);
+    handles [f] = mgr.OpenFile (names [f]);
+    EXPECT_EQ (sizes [f] - (int) sizeof (int), handles [f].GetPageSize ());
+  }
+  for (int i = 0; i < n; ++i) {
+    for (int f = 0; f < 3; ++f) {
+      PF::PageHandle page = handles [f].AllocatePage ();
+      int size = page.GetPageSize ();
+      EXPECT_EQ (handles [f].GetPageSize (), size);
+      *(int*) page.GetData () = i;
+      *(int*) (page.GetData () + size - sizeof (int)) = f;
+      handles [f].DoneWritingTo (page);
+    }
+  }
+  for (int f = 0; f < 3; ++f)
+    mgr.CloseFile (handles [f]);
+
+  for (int f = 0; f < 3; ++f) {
+    ifstream file (names [f], ios::binary | ios::ate);
+    // The file grows by whole extents.
+    long numAllocated = (n + PF_EXTENT_PAGES - 1) / PF_EXTENT_PAGES
+                        * PF_EXTENT_PAGES;
+    EXPECT_EQ (MEMORY_PAGE_SIZE + numAllocated * sizes [f],
+               (long) file.tellg ());
+
+    handles [f] = mgr.OpenFile (names [f]);
+    for (int i = n - 1; i >= 0; --i) {
+      PF::PageHandle page = handles [f].GetPage (i);
+      int size = page.GetPageSize ();
+      EXPECT_EQ (i, *(int*) page.GetData ());
+      EXPECT_EQ (f, *(int*) (page.GetData () + size - sizeof (int)));
+      handles [f].UnpinPage (page);
+    }
+    mgr.CloseFile (handles [f]);
+
+    // Mapped pages are found at the same offsets.
+    handles [f] = mgr.OpenFile (names [f], PF_MMAP_READONLY);
+    PF::PageHandle page = handles [f].GetPage (n - 1);
+    EXPECT_EQ (n - 1, *(int*) page.GetData ());
+    handles [f].UnpinPage (page);
+    mgr.CloseFile (handles [f]);
+    remove (names [f]);
+  }
+}
+
+TEST (PF_Manager, BadPageSize)
+{
+  remove ("test_file");
+  MK_MGR ();
+  EXPECT_THROW (mgr.CreateFile ("test_file", 2048), PF::error::BadPageSize);
+  EXPECT_THROW (mgr.CreateFile ("test_file", 12288), PF::error::BadPageSize);
+  EXPECT_THROW (mgr.CreateFile ("test_file", 2 * PF_MAX_PAGE_SIZE),
+                PF::error::BadPageSize);
+  EXPECT_FALSE (exists ("test_file"));
+}
+
+TEST (PF_Manager, ResizeKeepsPinnedPagesAndDirtyPages)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+  const int n = 10;
+  for (int i = 0; i < n; ++i) {
+    PF::PageHandle page = handle.AllocatePage ();
+    *(int*) page.GetData () = i;
+    handle.DoneWritingTo (page);
+  }
+
+  // A pinned page cannot move: the buffer stays as it was.
+  PF::PageHandle pinned = handle.GetPage (3);
+  EXPECT_EQ (PF_PAGEPINNED, _pfm.ResizeBuffer (8));
+  EXPECT_EQ (3, *(int*) pinned.GetData ());
+  *(int*) pinned.GetData () = -3;
+  handle.DoneWritingTo (pinned);
+
+  // Once it is unpinned, the dirty pages are written before the buffer
+  // is replaced.
+  EXPECT_EQ (0, _pfm.ResizeBuffer (8));
+  for (int i = 0; i < n; ++i) {
+    PF::PageHandle page = handle.GetPage (i);
+    EXPECT_EQ (i == 3 ? -3 : i, *(int*) page.GetData ());
+    handle.UnpinPage (page);
+  }
+  mgr.CloseFile (handle);
+  remove ("test_file");
+}
+
+TEST (PF_Manager, ConcurrentReaders)
+{
+  remove ("test_file");
+  MK_MGR ();
+
+  // Big enough for several shards, smaller than the file so that the
+  // readers evict each other's pages.
+  _pfm.ResizeBuffer (256);
+  mgr.SetReadAhead (8);
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+
+  const int n = 600;
+  for (int i = 0; i < n; ++i) {
+    PF::PageHandle page = handle.AllocatePage ();
+    *(int*) page.GetData () = i;
+    handle.DoneWritingTo (page);
+  }
+  mgr.CloseFile (handle);
+  handle = mgr.OpenFile ("test_file");
+
+  // Half of the readers scan forward, the others jump around.
+  atomic<int> errors (0);
+  vector<thread> readers;
+  for (int t = 0; t < 4; ++t)
+    readers.push_back (thread ([&handle, &errors, t, n] () {
+      PF::FileHandle reader = handle;
+      for (int pass = 0; pass < 3; ++pass)
+        for (int i = 0; i < n; ++i) {
+          PageNum pageNum = t % 2 ? (i * 7 + t) % n : i;
+          PF::PageHandle page = reader.GetPage (pageNum);
+          reader.LatchPage (pageNum);
+          if (*(int*) page.GetData () != pageNum)
+            errors++;
+          reader.UnlatchPage (pageNum);
+          reader.UnpinPage (page);
+        }
+    }));
+  for (int t = 0; t < 4; ++t)
+    readers [t].join ();
+  EXPECT_EQ (0, errors.load ());
+
+  mgr.CloseFile (handle);
+  remove ("test_file");
+}
+
+TEST (PF_FileHandle, LatchedPageIsNotWrittenBack)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+  PF::PageHandle page = handle.AllocatePage ();
+  PageNum pageNum = page.GetPageNum ();
+
+  // A writer holds the page exclusive while it changes it.
+  handle.LatchPage (pageNum, true);
+  *(int*) page.GetData () = 42;
+  handle.MarkDirty (pageNum);
+  handle.ForcePages ();
+  int value = 0;
+  {
+    ifstream file ("test_file", ios::binary);
+    file.seekg (MEMORY_PAGE_SIZE + sizeof (int));
+    file.read ((char*) &value, sizeof (int));
+  }
+  EXPECT_NE (42, value);
+
+  handle.UnlatchPage (pageNum);
+  handle.ForcePages ();
+  {
+    ifstream file ("test_file", ios::binary);
+    file.seekg (MEMORY_PAGE_SIZE + sizeof (int));
+    file.read ((char*) &value, sizeof (int));
+  }
+  EXPECT_EQ (42, value);
+
+  handle.UnpinPage (page);
+  EXPECT_THROW (handle.LatchPage (pageNum), PF::error::PageAlreadyPinned);
+  mgr.CloseFile (handle);
+  remove ("test_file");
+}
+
+TEST (PF_FrameArena, AlignedZeroedFrames)
+{
+  // Large enough to be backed by huge pages when the system allows it.
+  const int n = 1024;
+  PF_FrameArena arena (n, MEMORY_PAGE_SIZE);
+  for (int i = 0; i < n; i += 97) {
+    char* frame = arena.Frame (i);
+    EXPECT_EQ (0, (frame - (char*) 0) % MEMORY_PAGE_SIZE);
+    EXPECT_TRUE (arena.Contains (frame));
+    EXPECT_EQ (0, frame [0]);
+    EXPECT_EQ (0, frame [MEMORY_PAGE_SIZE - 1]);
+    memset (frame, i & 0xff, MEMORY_PAGE_SIZE);
+  }
+  EXPECT_EQ (97, arena.Frame (97) [MEMORY_PAGE_SIZE - 1]);
+  EXPECT_EQ (arena.Frame (1), arena.Frame (0) + MEMORY_PAGE_SIZE);
+  EXPECT_FALSE (arena.Contains (arena.Frame (0) + 1));
+  EXPECT_FALSE (arena.Contains (arena.Frame (n)));
+  EXPECT_FALSE (arena.Contains (NULL));
+}
+
+TEST (PF_Manager, DirectIO)
+{
+  const int sizes [] = { MEMORY_PAGE_SIZE, 16384 };
+  const int n = 50;
+  MK_MGR ();
+  mgr.SetReadAhead (4);
+
+  for (int f = 0; f < 2; ++f) {
+    remove ("test_file");
+    mgr.CreateFile ("test_file", sizes [f]);
+
+    // Write through O_DIRECT, read back with buffered I/O, and the other
+    // way around.
+    mgr.SetDirectIO (true);
+    PF::FileHandle handle = mgr.OpenFile ("test_file");
+    for (int i = 0; i < n; ++i) {
+      PF::PageHandle page = handle.AllocatePage ();
+      *(int*) page.GetData () = i;
+      handle.DoneWritingTo (page);
+    }
+    mgr.CloseFile (handle);
+    mgr.SetDirectIO (false);
+
+    ifstream file ("test_file", ios::binary | ios::ate);
+    // The file grows by whole extents.
+    long numAllocated = (n + PF_EXTENT_PAGES - 1) / PF_EXTENT_PAGES
+                        * PF_EXTENT_PAGES;
+    EXPECT_EQ (MEMORY_PAGE_SIZE + numAllocated * sizes [f],
+               (long) file.tellg ());
+
+    handle = mgr.OpenFile ("test_file");
+    for (int i = 0; i < n; ++i) {
+      PF::PageHandle page = handle.GetPage (i);
+      EXPECT_EQ (i, *(int*) page.GetData ());
+      *(int*) page.GetData () = -i;
+      handle.DoneWritingTo (page);
+    }
+    mgr.CloseFile (handle);
+
+    handle = mgr.OpenFile ("test_file", PF_DIRECT);
+    PF::PageHandle page = handle.GetFirstPage ();
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ (-i, *(int*) page.GetData ());
+      handle.UnpinPage (page);
+      if (i + 1 < n) page = handle.GetNextPage (i);
+    }
+    mgr.CloseFile (handle);
+  }
+  remove ("test_file");
+}
+
+TEST (PF_AllocBitmap, FindsUsedAndFreePages)
+{
+  PF_AllocBitmap bitmap;
+  bitmap.Resize (200);
+  EXPECT_EQ (-1, bitmap.NextUsed (-1));
+  EXPECT_EQ (-1, bitmap.PrevUsed (200));
+  EXPECT_EQ (0, bitmap.FirstFree ());
+
+  bitmap.SetUsed (3);
+  bitmap.SetUsed (64);
+  bitmap.SetUsed (199);
+  EXPECT_EQ (3, bitmap.NextUsed (-1));
+  EXPECT_EQ (64, bitmap.NextUsed (3));
+  EXPECT_EQ (199, bitmap.NextUsed (64));
+  EXPECT_EQ (-1, bitmap.NextUsed (199));
+  EXPECT_EQ (64, bitmap.PrevUsed (199));
+  EXPECT_EQ (3, bitmap.PrevUsed (64));
+  EXPECT_EQ (-1, bitmap.PrevUsed (3));
+
+  for (int i = 0; i < 200; ++i)
+    bitmap.SetUsed (i);
+  EXPECT_EQ (-1, bitmap.FirstFree ());
+  bitmap.SetFree (130);
+  EXPECT_EQ (130, bitmap.FirstFree ());
+  EXPECT_FALSE (bitmap.IsUsed (130));
+
+  // Header bytes round trip, and shrinking forgets the pages past the end.
+  char bytes [25];
+  bitmap.Store (bytes, 200);
+  PF_AllocBitmap copy;
+  copy.Resize (200);
+  copy.Load (bytes, 200);
+  for (int i = 0; i < 200; ++i)
+    EXPECT_EQ (bitmap.IsUsed (i), copy.IsUsed (i));
+  copy.Resize (100);
+  copy.Resize (200);
+  EXPECT_EQ (99, copy.PrevUsed (200));
+  EXPECT_EQ (100, copy.FirstFree ());
+}
+
+TEST (PF_AllocBitmap, BitmapPagesHoldTheirRun)
+{
+  PF_AllocBitmap bitmap;
+  bitmap.Resize (100);
+  bitmap.Reserve (100, 64);
+  EXPECT_EQ (0, bitmap.NumBitmapPages ());
+
+  // Every 64th page from page 100 is a bitmap page, never handed out.
+  bitmap.Resize (300);
+  ASSERT_EQ (4, bitmap.NumBitmapPages ());
+  EXPECT_EQ (228, bitmap.BitmapPage (2));
+  EXPECT_TRUE (bitmap.IsReserved (164));
+  EXPECT_FALSE (bitmap.IsReserved (165));
+  for (int i = 0; i < 165; ++i)
+    if (!bitmap.IsReserved (i))
+      bitmap.SetUsed (i);
+  EXPECT_EQ (165, bitmap.FirstFree ());
+  for (int i = 165; i < 300; ++i)
+    if (!bitmap.IsReserved (i))
+      bitmap.SetUsed (i);
+  EXPECT_EQ (-1, bitmap.FirstFree ());
+  EXPECT_EQ (163, bitmap.PrevUsed (164));
+
+  // Runs round trip through their pages, and only changed runs are stale.
+  char bytes [4][8];
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE (bitmap.IsStale (i));
+    bitmap.StoreRun (i, bytes [i]);
+    EXPECT_FALSE (bitmap.IsStale (i));
+  }
+  bitmap.SetFree (230);
+  EXPECT_FALSE (bitmap.IsStale (1));
+  EXPECT_TRUE (bitmap.IsStale (2));
+  bitmap.StoreRun (2, bytes [2]);
+
+  PF_AllocBitmap copy;
+  copy.Resize (300);
+  copy.Reserve (100, 64);
+  for (int i = 0; i < 4; ++i)
+    copy.LoadRun (i, bytes [i]);
+  for (int i = 100; i < 300; ++i)
+    EXPECT_EQ (bitmap.IsUsed (i), copy.IsUsed (i));
+  EXPECT_FALSE (copy.IsStale (3));
+}
+
+TEST (PF_FileHandle, ScanAndAllocateSkipFreePages)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+  const int n = 100;
+  for (int i = 0; i < n; ++i) {
+    PF::PageHandle page = handle.AllocatePage ();
+    *(int*) page.GetData () = i;
+    handle.DoneWritingTo (page);
+  }
+  for (int i = 0; i < n; ++i)
+    if (i % 10)
+      handle.DisposePage (i);
+  EXPECT_THROW (handle.DisposePage (1), PF::error::PageAlreadyFree);
+  mgr.CloseFile (handle);
+
+  // The bitmap is saved with the header.
+  handle = mgr.OpenFile ("test_file");
+  int count = 0;
+  for (PF::PageHandle page = handle.GetFirstPage (); ;
+       page = handle.GetNextPage (page.GetPageNum ())) {
+    EXPECT_EQ (count * 10, page.GetPageNum ());
+    EXPECT_EQ (count * 10, *(int*) page.GetData ());
+    handle.UnpinPage (page);
+    if (++count == n / 10) break;
+  }
+  EXPECT_THROW (handle.GetNextPage (90), PF::error::Eof);
+  EXPECT_THROW (handle.GetPage (5), PF::error::InvalidPageNumber);
+  PF::PageHandle last = handle.GetLastPage ();
+  EXPECT_EQ (90, last.GetPageNum ());
+  handle.UnpinPage (last);
+
+  // New pages fill the lowest holes first.
+  PF::PageHandle page = handle.AllocatePage ();
+  EXPECT_EQ (1, page.GetPageNum ());
+  EXPECT_EQ (0, *(int*) page.GetData ());
+  handle.DoneWritingTo (page);
+  mgr.CloseFile (handle);
+  remove ("test_file");
+}
+
+TEST (PF_FileHandle, FreeListFileGetsABitmap)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.CreateFile ("test_file");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+  for (int i = 0; i < 20; ++i)
+    handle.DoneWritingTo (handle.AllocatePage ());
+  handle.DisposePage (4);
+  handle.DisposePage (7);
+  mgr.CloseFile (handle);
+
+  // Turn the file into one written before the bitmap: a header without
+  // bitmap.  The free pages are only marked free in their page header.
+  {
+    fstream file ("test_file", ios::binary | ios::in | ios::out);
+    char hdrBuf [PF_FILE_HDR_SIZE];
+    file.read (hdrBuf, PF_FILE_HDR_SIZE);
+    ((PF_FileHdr*) hdrBuf)->bHasBitmap = FALSE;
+    memset (hdrBuf + sizeof (PF_FileHdr), 0,
+            PF_FILE_HDR_SIZE - sizeof (PF_FileHdr));
+    file.seekp (0);
+    file.write (hdrBuf, PF_FILE_HDR_SIZE);
+  }
+
+  for (int pass = 0; pass < 2; ++pass) {
+    handle = mgr.OpenFile ("test_file", pass ? PF_READWRITE
+                                             : PF_MMAP_READONLY);
+    int count = 0;
+    for (PageNum p = -1; ; ++count) {
+      try {
+        PF::PageHandle page = handle.GetNextPage (p);
+        p = page.GetPageNum ();
+        EXPECT_NE (4, p);
+        EXPECT_NE (7, p);
+        handle.UnpinPage (page);
+      } catch (PF::error::Eof&) {
+        break;
+      }
+    }
+    EXPECT_EQ (18, count);
+    mgr.CloseFile (handle);
+  }
+
+  // The bitmap was written when the file was closed.
+  ifstream file ("test_file", ios::binary);
+  PF_FileHdr hdr;
+  file.read ((char*) &hdr, sizeof (hdr));
+  EXPECT_TRUE (hdr.bHasBitmap);
+  EXPECT_TRUE (hdr.bBitmapPages);
+  remove ("test_file");
+}
+
+TEST (PF_FileHandle, BitmapPagesPastTheHeader)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.CreateFile ("test_file");
+
+  // Give the file as many pages as the header bitmap holds, all in use,
+  // without writing them.
+  const PageNum first = PF_HDR_BITMAP_PAGES;
+  {
+    fstream file ("test_file", ios::binary | ios::in | ios::out);
+    char hdrBuf [PF_FILE_HDR_SIZE];
+    file.read (hdrBuf, PF_FILE_HDR_SIZE);
+    ((PF_FileHdr*) hdrBuf)->numPages = first;
+    memset (hdrBuf + sizeof (PF_FileHdr), 0xff, first / 8);
+    file.seekp (0);
+    file.write (hdrBuf, PF_FILE_HDR_SIZE);
+  }
+  ASSERT_EQ (0, truncate ("test_file",
+                          PF_FILE_HDR_SIZE + first * (long) MEMORY_PAGE_SIZE));
+
+  // The next page is the first bitmap page, and is skipped.
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+  const int n = 40;
+  for (int i = 1; i <= n; ++i) {
+    PF::PageHandle page = handle.AllocatePage ();
+    EXPECT_EQ (first + i, page.GetPageNum ());
+    *(int*) page.GetData () = i;
+    handle.DoneWritingTo (page);
+  }
+  EXPECT_THROW (handle.GetPage (first), PF::error::InvalidPageNumber);
+  handle.DisposePage (first + 5);
+  mgr.CloseFile (handle);
+
+  // The bitmap page is written with the header.  Mark the page disposed
+  // of used in its header: its state must come from the bitmap page, not
+  // from the page.
+  {
+    fstream file ("test_file", ios::binary | ios::in | ios::out);
+    vector<char> page (MEMORY_PAGE_SIZE);
+    file.seekg (PF_FILE_HDR_SIZE + first * (long) MEMORY_PAGE_SIZE);
+    file.read (page.data (), MEMORY_PAGE_SIZE);
+    EXPECT_EQ (PF_PAGE_BITMAP, ((PF_PageHdr*) page.data ())->nextFree);
+    PF_PageHdr used = { PF_PAGE_USED };
+    file.seekp (PF_FILE_HDR_SIZE + (first + 5) * (long) MEMORY_PAGE_SIZE);
+    file.write ((char*) &used, sizeof (used));
+  }
+
+  handle = mgr.OpenFile ("test_file");
+  int count = 0;
+  for (PageNum p = first - 1; ; ++count) {
+    try {
+      PF::PageHandle page = handle.GetNextPage (p);
+      p = page.GetPageNum ();
+      EXPECT_NE (first + 5, p);
+      EXPECT_EQ (p - first, *(int*) page.GetData ());
+      handle.UnpinPage (page);
+    } catch (PF::error::Eof&) {
+      break;
+    }
+  }
+  EXPECT_EQ (n - 1, count);
+  mgr.CloseFile (handle);
+  remove ("test_file");
+}
+
+static long file_size (const char* name)
+{
+  ifstream f (name, ios::binary | ios::ate);
+  return f.tellg ();
+}
+
+TEST (PF_FileHandle, ExtentPreallocation)
+{
+  remove ("test_file");
+  MK_MGR ();
+  const long pageBytes = PF_PAGE_SIZE + sizeof (PF_PageHdr);
+  mgr.SetExtentPages (8);
+  mgr.CreateFile ("test_file");
+
+  PF::FileHandle fh = mgr.OpenFile ("test_file");
+  for (int i = 0; i < 3; ++i) {
+    PF::PageHandle page = fh.AllocatePage ();
+    fh.DoneWritingTo (page);
+  }
+  // The first allocation made room for a whole extent.
+  EXPECT_EQ (PF_FILE_HDR_SIZE + 8 * pageBytes, file_size ("test_file"));
+  mgr.CloseFile (fh);
+
+  ifstream file ("test_file", ios::binary);
+  PF_FileHdr hdr;
+  file.read ((char*) &hdr, sizeof (hdr));
+  file.close ();
+  EXPECT_EQ (3, hdr.numPages);
+  EXPECT_EQ (8, hdr.numAllocated);
+
+  // The tail is used up before the file grows again.
+  fh = mgr.OpenFile ("test_file");
+  for (int i = 3; i < 9; ++i) {
+    PF::PageHandle page = fh.AllocatePage ();
+    EXPECT_EQ (i, page.GetPageNum ());
+    fh.DoneWritingTo (page);
+    EXPECT_EQ (PF_FILE_HDR_SIZE + (i < 8 ? 8 : 16) * pageBytes,
+               file_size ("test_file"));
+  }
+  mgr.CloseFile (fh);
+
+  // Without extents a file grows as its pages are written.
+  mgr.SetExtentPages (0);
+  fh = mgr.OpenFile ("test_file");
+  for (int i = 9; i < 17; ++i) {
+    PF::PageHandle page = fh.AllocatePage ();
+    fh.DoneWritingTo (page);
+  }
+  mgr.CloseFile (fh);
+  EXPECT_EQ (PF_FILE_HDR_SIZE + 17 * pageBytes, file_size ("test_file"));
+  remove ("test_file");
+}
+
+
+TEST (PF_FileHandle, DisposePunchesAndShrinkTruncates)
+{
+  remove ("test_file");
+  MK_MGR ();
+  const long pageBytes = PF_PAGE_SIZE + sizeof (PF_PageHdr);
+  const int n = 8;
+  mgr.SetExtentPages (0);
+  mgr.CreateFile ("test_file");
+  PF::FileHandle fh = mgr.OpenFile ("test_file");
+  for (int i = 0; i < n; ++i) {
+    PF::PinnedPage page = fh.PinNewPage ();
+    memset (page.GetData (), 'a' + i, PF_PAGE_SIZE);
+    page.MarkDirty ();
+  }
+  mgr.CloseFile (fh);
+  struct stat before, after;
+  ASSERT_EQ (0, stat ("test_file", &before));
+
+  // Disposed pages keep their place in the file but give back their
+  // blocks, and read as zeros.
+  fh = mgr.OpenFile ("test_file");
+  for (int i = 2; i < 6; ++i)
+    fh.DisposePage (i);
+  mgr.CloseFile (fh);
+  ASSERT_EQ (0, stat ("test_file", &after));
+  EXPECT_EQ (before.st_size, after.st_size);
+  EXPECT_LT (after.st_blocks, before.st_blocks);
+
+  char zeros [PF_PAGE_SIZE], data [PF_PAGE_SIZE];
+  memset (zeros, 0, PF_PAGE_SIZE);
+  ifstream file ("test_file", ios::binary);
+  file.seekg (PF_FILE_HDR_SIZE + 3 * pageBytes + sizeof (PF_PageHdr));
+  file.read (data, PF_PAGE_SIZE);
+  file.close ();
+  EXPECT_EQ (0, memcmp (zeros, data, PF_PAGE_SIZE));
+
+  // Shrinking cuts the file after its last used page.
+  fh = mgr.OpenFile ("test_file");
+  fh.DisposePage (6);
+  fh.DisposePage (7);
+  fh.Shrink ();
+  EXPECT_EQ (PF_FILE_HDR_SIZE + 2 * pageBytes, file_size ("test_file"));
+  {
+    PF::PinnedPage page = fh.PinNewPage ();
+    EXPECT_EQ (2, page.GetPageNum ());
+    memset (page.GetData (), 'z', PF_PAGE_SIZE);
+    page.MarkDirty ();
+  }
+  mgr.CloseFile (fh);
+
+  fh = mgr.OpenFile ("test_file");
+  {
+    PF::PinnedPage page = fh.PinFirstPage ();
+    EXPECT_EQ ('a', page.GetData () [0]);
+    page = fh.PinNextPage (0);
+    EXPECT_EQ ('b', page.GetData () [0]);
+    page = fh.PinNextPage (1);
+    EXPECT_EQ ('z', page.GetData () [0]);
+  }
+  EXPECT_THROW (fh.GetNextPage (2), PF::error::Eof);
+  mgr.CloseFile (fh);
+  EXPECT_EQ (PF_FILE_HDR_SIZE + 3 * pageBytes, file_size ("test_file"));
+  remove ("test_file");
+}
+
+
+// Fills a page with the kind of padded rows that compress well.
+static void fill_rows (char* data, int size, int seed)
+{
+  memset (data, ' ', size);
+  for (int off = 0; off + 64 <= size; off += 64)
+    snprintf (data + off, 64, "row %d-%d", seed, off);
+}
+
+TEST (PF_Manager, CompressedFile)
+{
+  remove ("test_file");
+  MK_MGR ();
+  mgr.SetReadAhead (8);
+  mgr.CreateFile ("test_file", MEMORY_PAGE_SIZE, true);
+
+  const int n = 64;
+  char expected [PF_PAGE_SIZE];
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+  for (int i = 0; i < n; ++i) {
+    PF::PinnedPage page = handle.PinNewPage ();
+    fill_rows (page.GetData (), PF_PAGE_SIZE, i);
+    page.MarkDirty ();
+  }
+  mgr.CloseFile (handle);
+  EXPECT_LT (file_size ("test_file"),
+             PF_FILE_HDR_SIZE + n * MEMORY_PAGE_SIZE / 4);
+
+  // A page that does not compress is stored as is, elsewhere, and one
+  // that compresses again shrinks in place.
+  unsigned int seed = 1;
+  handle = mgr.OpenFile ("test_file");
+  {
+    PF::PinnedPage page = handle.PinPage (5);
+    for (int k = 0; k < PF_PAGE_SIZE; ++k)
+      page.GetData () [k] = (char) (rand_r (&seed) >> 8);
+    handle.DoneWritingTo (page);
+  }
+  mgr.CloseFile (handle);
+  long grown = file_size ("test_file");
+  handle = mgr.OpenFile ("test_file");
+  {
+    PF::PinnedPage page = handle.PinPage (6);
+    fill_rows (page.GetData (), PF_PAGE_SIZE, -6);
+    handle.DoneWritingTo (page);
+  }
+  mgr.CloseFile (handle);
+  EXPECT_LE (file_size ("test_file"), grown);
+
+  // Read back in page order, through the read-ahead, and in a mapping,
+  // which a compressed file falls back from.
+  for (int pass = 0; pass < 2; ++pass) {
+    handle = mgr.OpenFile ("test_file",
+                           pass ? PF_MMAP_READONLY : PF_READWRITE);
+    PF::PinnedPage page = handle.PinFirstPage (SEQUENTIAL_SCAN);
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ (i, page.GetPageNum ());
+      if (i == 5) {
+        seed = 1;
+        for (int k = 0; k < PF_PAGE_SIZE; ++k)
+          expected [k] = (char) (rand_r (&seed) >> 8);
+      }
+      else
+        fill_rows (expected, PF_PAGE_SIZE, i == 6 ? -6 : i);
+      EXPECT_EQ (0, memcmp (expected, page.GetData (), PF_PAGE_SIZE));
+      if (i + 1 < n) page = handle.PinNextPage (i, SEQUENTIAL_SCAN);
+    }
+    handle.UnpinPage (page);
+    mgr.CloseFile (handle);
+  }
+  remove ("test_file");
+}
+TEST (PF_Manager, LogRecovery)
+{
+  remove ("test_file");
+  remove ("test_log");
+  const int n = 3;
+  char expected [PF_PAGE_SIZE];
+  {
+    // Commit n new pages, then change one and add another without
+    // committing, and crash once they are written.
+    PF_Manager* crashed = new PF_Manager ();
+    PF::Manager mgr (*crashed);
+    mgr.SetExtentPages (0);
+    mgr.CreateFile ("test_file");
+    mgr.OpenLog ("test_log");
+    PF::FileHandle handle = mgr.OpenFile ("test_file");
+    for (int i = 0; i < n; ++i) {
+      PF::PinnedPage page = handle.PinNewPage ();
+      memset (page.GetData (), 'a' + i, PF_PAGE_SIZE);
+      page.MarkDirty ();
+    }
+    mgr.Commit ();
+    EXPECT_EQ (PF_FILE_HDR_SIZE, file_size ("test_file"));
+    EXPECT_LT (0, mgr.GetLogSize ());
+    {
+      PF::PinnedPage page = handle.PinPage (1);
+      memset (page.GetData () + 100, 'x', 10);
+      page.MarkDirty ();
+    }
+    {
+      PF::PinnedPage page = handle.PinNewPage ();
+      memset (page.GetData (), 'y', PF_PAGE_SIZE);
+      page.MarkDirty ();
+    }
+    handle.ForcePages ();
+    delete crashed;
+  }
+
+  // The committed pages are redone, the others undone.
+  MK_MGR ();
+  mgr.OpenLog ("test_log");
+  PF::FileHandle handle = mgr.OpenFile ("test_file");
+  {
+    PF::PinnedPage page = handle.PinFirstPage ();
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ (i, page.GetPageNum ());
+      memset (expected, 'a' + i, PF_PAGE_SIZE);
+      EXPECT_EQ (0, memcmp (expected, page.GetData (), PF_PAGE_SIZE));
+      if (i + 1 < n) page = handle.PinNextPage (i);
+    }
+  }
+  EXPECT_THROW (handle.GetNextPage (n - 1), PF::error::Eof);
+  mgr.CloseFile (handle);
+
+  // Closing the log writes everything back and empties it.
+  mgr.CloseLog ();
+  EXPECT_EQ (0, file_size ("test_log"));
+  EXPECT_LE (PF_FILE_HDR_SIZE + n * MEMORY_PAGE_SIZE, file_size ("test_file"));
+  remove ("test_file");
+  remove ("test_log");
+}
+
+TEST (PF_GroupCommit, GroupsShareSyncs)
+{
+  remove ("test_file");
+  int fd = open ("test_file", O_CREAT | O_RDWR, 0600);
+  ASSERT_LE (0, fd);
+  PF_Manager pfm;  // the statistics belong to its buffer manager
+  PF_GroupCommit gc;
+  auto msecs_since = [] (chrono::steady_clock::time_point start) {
+    return chrono::duration_cast<chrono::milliseconds> (
+      chrono::steady_clock::now () - start).count ();
+  };
+
+  // A full group does not wait for the window to end.
+  gc.SetDurability (PF_DURABLE_GROUP);
+  gc.SetWindow (10000);
+  gc.SetGroupSize (4);
+  auto start = chrono::steady_clock::now ();
+  vector<thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.push_back (thread ([&gc, fd] {
+      gc.Forced (fd);
+      EXPECT_EQ (0, gc.Commit ());
+    }));
+  for (auto& t : threads) t.join ();
+  EXPECT_GT (5000, msecs_since (start));
+
+  // A lone Commit waits for the others that never come.
+  gc.SetWindow (50);
+  start = chrono::steady_clock::now ();
+  gc.Forced (fd);
+  EXPECT_EQ (0, gc.Commit ());
+  EXPECT_LE (50, msecs_since (start));
+
+  // A file forced since the last Commit is synced before it is closed.
+  gc.SetDurability (PF_DURABLE_STATEMENT);
+  gc.Forced (fd);
+  EXPECT_EQ (0, gc.Release (fd));
+  close (fd);
+  remove ("test_file");
+
+  // Nothing is synced without durability.
+  gc.SetDurability (PF_DURABLE_NONE);
+  gc.Forced (fd);
+  EXPECT_EQ (0, gc.Commit ());
+
+  // A failed sync fails every later Commit.
+  gc.SetDurability (PF_DURABLE_STATEMENT);
+  gc.Forced (fd);
+  EXPECT_EQ (PF_UNIX, gc.Commit ());
+  EXPECT_EQ (PF_UNIX, gc.Commit ());
+}
+
+TEST (StatisticsMgr, CountersAddUpOverThreads)
+{
+  StatisticsMgr stats;
+  vector<thread> threads;
+  for (int t = 0; t < 8; ++t)
+    threads.push_back (thread ([&stats] {
+      int two = 2;
+      for (int i = 0; i < 1000; ++i) {
+        stats.Register (PF_GETPAGE, STAT_ADDONE);
+        stats.Register (PF_WRITEPAGE, STAT_ADDVALUE, &two);
+      }
+    }));
+  for (auto& t : threads) t.join ();
+
+  int* value = stats.Get (PF_GETPAGE);
+  ASSERT_TRUE (value != NULL);
+  EXPECT_EQ (8000, *value);
+  delete value;
+  // The counters answer to their names too.
+  value = stats.Get ("WRITEPAGE");
+  ASSERT_TRUE (value != NULL);
+  EXPECT_EQ (16000, *value);
+  delete value;
+  EXPECT_TRUE (stats.Get (PF_READPAGE) == NULL);
+
+  int five = 5;
+  stats.Register (PF_GETPAGE, STAT_SETVALUE, &five);
+  value = stats.Get (PF_GETPAGE);
+  EXPECT_EQ (5, *value);
+  delete value;
+  EXPECT_EQ (0, stats.Reset ("GETPAGE"));
+  EXPECT_TRUE (stats.Get (PF_GETPAGE) == NULL);
+
+  // Other names still make statistics of their own.
+  stats.Register ("custom", STAT_ADDONE);
+  value = stats.Get ("custom");
+  ASSERT_TRUE (value != NULL);
+  EXPECT_EQ (1, *value);
+  delete value;
+
+  stats.Reset ();
+  EXPECT_TRUE (stats.Get ("custom") == NULL);
+  EXPECT_TRUE (stats.Get (PF_WRITEPAGE) == NULL);
+}
+
+TEST (StatisticsMgr, LatencyHistogram)
+{
+  StatisticsMgr stats;
+  EXPECT_EQ (0, stats.GetLatencyCount (PF_READPAGE_LATENCY));
+  EXPECT_EQ (0, stats.GetLatencyPercentile (PF_READPAGE_LATENCY, 50));
+
+  for (int i = 0; i < 100; ++i)
+    stats.RegisterLatency (PF_READPAGE_LATENCY, 100);
+  stats.RegisterLatency (PF_READPAGE_LATENCY, 5000);
+
+  EXPECT_EQ (101, stats.GetLatencyCount (PF_READPAGE_LATENCY));
+  EXPECT_EQ ((100 * 100 + 5000) / 101,
+             stats.GetLatencyMean (PF_READPAGE_LATENCY));
+  EXPECT_EQ (128, stats.GetLatencyPercentile (PF_READPAGE_LATENCY, 50));
+  EXPECT_EQ (128, stats.GetLatencyPercentile (PF_READPAGE_LATENCY, 99));
+  EXPECT_EQ (8192, stats.GetLatencyPercentile (PF_READPAGE_LATENCY, 100));
+  EXPECT_EQ (0, stats.GetLatencyCount (PF_WRITEPAGE_LATENCY));
+
+  stats.Reset ();
+  EXPECT_EQ (0, stats.GetLatencyCount (PF_READPAGE_LATENCY));
+}
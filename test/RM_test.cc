@@ -3,9 +3,11 @@
 
 #include "rm.h"
 #include "pf.h"
+#include "pf_internal.h"
 
 #include <fstream>
 #include <cstdio>
+#include <unistd.h>
 
 #include "gtest/gtest.h"
 
@@ -23,6 +25,12 @@ inline bool exists (const std::string& name)
   }   
 }
 
+static long file_size (const char* name)
+{
+  ifstream f (name, ios::binary | ios::ate);
+  return f.tellg ();
+}
+
 #define MGR() PF_Manager _pfm; PF::Manager pfm(_pfm); RM::Manager mgr(pfm);
 
 TEST (RM_Manager, init)
@@ -92,3 +100,408 @@ TEST (RM_Manager, InsertVerifyClose)
   EXPECT_TRUE (exists ("test"));
   remove ("test");
 }
+
+TEST (RM_Manager, ScanMappedFile)
+{
+  remove ("test");
+  MGR();
+  mgr.CreateFile ("test", 4);
+  RM::FileHandle handle = mgr.OpenFile ("test");
+  int NUM_RECS = 5000;
+  for (int i = 0; i < NUM_RECS; ++i) {
+    handle.insert ((char*)&i);
+  }
+  CLOSE ();
+
+  handle = mgr.OpenFile ("test", PF_MMAP_READONLY);
+  RM::Scan scan;
+  scan.open (handle, INT, 4, 0, NO_OP, NULL);
+  long sum = 0;
+  int count = 0;
+  for (RM::Record r = scan.next(); r != scan.end; r = scan.next()) {
+    sum += *(int*)r.data;
+    ++count;
+  }
+  scan.close ();
+  EXPECT_EQ (NUM_RECS, count);
+  EXPECT_EQ ((long)NUM_RECS * (NUM_RECS - 1) / 2, sum);
+  CLOSE ();
+  remove ("test");
+}
+
+TEST (RM_Manager, LargePages)
+{
+  remove ("test");
+  MGR();
+  mgr.CreateFile ("test", 4, 16384);
+  RM::FileHandle handle = mgr.OpenFile ("test");
+  int NUM_RECS = 5000;
+  PageNum last_page = 0;
+  for (int i = 0; i < NUM_RECS; ++i) {
+    RID rid = handle.insert ((char*)&i);
+    if (rid.page_num > last_page) last_page = rid.page_num;
+  }
+  // Four times fewer pages than with the default page size, plus the
+  // header page.
+  EXPECT_EQ (2, last_page);
+  CLOSE ();
+
+  handle = mgr.OpenFile ("test");
+  RM::Scan scan;
+  scan.open (handle, INT, 4, 0, NO_OP, NULL);
+  vector<bool> seen (NUM_RECS, false);
+  int count = 0;
+  for (RM::Record r = scan.next(); r != scan.end; r = scan.next(), ++count)
+    seen [*(int*)r.data] = true;
+  EXPECT_EQ (NUM_RECS, count);
+  for (int i = 0; i < NUM_RECS; ++i)
+    EXPECT_TRUE (seen [i]);
+  scan.close ();
+  CLOSE ();
+  remove ("test");
+}
+
+TEST (RM_Manager, CompactGivesPagesBack)
+{
+  remove ("test");
+  MGR();
+  mgr.CreateFile ("test", 4);
+  RM::FileHandle handle = mgr.OpenFile ("test");
+  int NUM_RECS = 5000;
+  vector<RID> rids;
+  for (int i = 0; i < NUM_RECS; ++i)
+    rids.push_back (handle.insert ((char*)&i));
+  for (int i = 0; i < NUM_RECS; ++i)
+    if (i % 10 != 0) handle.Delete (rids [i]);
+  CLOSE ();
+  long before = file_size ("test");
+
+  handle = mgr.OpenFile ("test");
+  EXPECT_LT (0, handle.Compact ());
+  CLOSE ();
+  EXPECT_LT (file_size ("test"), before);
+
+  // The records that were left are all still there, and the file takes
+  // new ones.
+  handle = mgr.OpenFile ("test");
+  int extra = NUM_RECS;
+  handle.insert ((char*)&extra);
+  RM::Scan scan;
+  scan.open (handle, INT, 4, 0, NO_OP, NULL);
+  vector<int> seen (NUM_RECS + 1, 0);
+  for (RM::Record r = scan.next(); r != scan.end; r = scan.next())
+    ++seen [*(int*)r.data];
+  scan.close ();
+  for (int i = 0; i <= NUM_RECS; ++i)
+    EXPECT_EQ (i % 10 == 0 || i == NUM_RECS ? 1 : 0, seen [i]);
+  CLOSE ();
+  remove ("test");
+}
+
+TEST (RM_Manager, CompactPastTheHeaderBitmap)
+{
+  remove ("test");
+  MGR();
+  const int RECORD_SIZE = 400;
+  mgr.CreateFile ("test", RECORD_SIZE);
+  RM::FileHandle handle = mgr.OpenFile ("test");
+  char rec [RECORD_SIZE];
+  memset (rec, 0, RECORD_SIZE);
+  handle.insert (rec);
+  CLOSE ();
+
+  // Give the file as many pages as the header bitmap holds, without
+  // writing them.  Those RM does not know of are in use, but for the
+  // last two, so that the data pages go on past the first bitmap page.
+  const PageNum first = PF_HDR_BITMAP_PAGES;
+  {
+    fstream file ("test", ios::binary | ios::in | ios::out);
+    char hdrBuf [PF_FILE_HDR_SIZE];
+    file.read (hdrBuf, PF_FILE_HDR_SIZE);
+    ((PF_FileHdr*) hdrBuf)->numPages = first;
+    char* bits = hdrBuf + sizeof (PF_FileHdr);
+    memset (bits, 0xff, first / 8);
+    bits [(first - 1) / 8] &= ~(1 << ((first - 1) % 8));
+    bits [(first - 2) / 8] &= ~(1 << ((first - 2) % 8));
+    file.seekp (0);
+    file.write (hdrBuf, PF_FILE_HDR_SIZE);
+  }
+  ASSERT_EQ (0, truncate ("test",
+                          PF_FILE_HDR_SIZE + first * (long) MEMORY_PAGE_SIZE));
+
+  handle = mgr.OpenFile ("test");
+  int NUM_RECS = 100;
+  vector<RID> rids;
+  PageNum last_page = 0;
+  for (int i = 1; i < NUM_RECS; ++i) {
+    *(int*)rec = i;
+    rids.push_back (handle.insert (rec));
+    last_page = max (last_page, rids.back ().page_num);
+    EXPECT_NE (first, rids.back ().page_num);
+  }
+  ASSERT_LT (first + 2, last_page);
+  for (int i = 1; i < NUM_RECS; ++i)
+    if (i % 2 != 0) handle.Delete (rids [i - 1]);
+  EXPECT_LT (0, handle.Compact ());
+  CLOSE ();
+
+  // The records left fill the pages from the first page of the file on,
+  // past the bitmap page.
+  handle = mgr.OpenFile ("test");
+  RM::Scan scan;
+  scan.open (handle, INT, 4, 0, NO_OP, NULL);
+  vector<int> seen (NUM_RECS, 0);
+  for (RM::Record r = scan.next(); r != scan.end; r = scan.next()) {
+    ++seen [*(int*)r.data];
+    EXPECT_NE (first, r.rid.page_num);
+    EXPECT_GT (last_page, r.rid.page_num);
+  }
+  scan.close ();
+  for (int i = 0; i < NUM_RECS; ++i)
+    EXPECT_EQ (i % 2 == 0 ? 1 : 0, seen [i]);
+  CLOSE ();
+  EXPECT_GT (PF_FILE_HDR_SIZE + (last_page + 1) * (long) MEMORY_PAGE_SIZE,
+             file_size ("test"));
+  remove ("test");
+}
+
+TEST (RM_Manager, RecordRefsAndSizedRecords)
+{
+  remove ("test");
+  MGR();
+  // Records can be as large as the page size lets them be.
+  EXPECT_THROW (mgr.CreateFile ("test", PF::kPageSize), RM::error::BadArgument);
+  const int REC_SIZE = 6000;
+  mgr.CreateFile ("test", REC_SIZE, 16384);
+  RM::FileHandle handle = mgr.OpenFile ("test");
+  int NUM_RECS = 10;
+  char buf [REC_SIZE];
+  vector<RID> rids;
+  for (int i = 0; i < NUM_RECS; ++i) {
+    memset (buf, 'a' + i, REC_SIZE);
+    *(int*)buf = i;
+    rids.push_back (handle.insert (buf));
+  }
+
+  RM::Record rec = handle.get (rids [3]);
+  EXPECT_EQ (REC_SIZE, rec.size ());
+  EXPECT_EQ (rids [3], rec.rid);
+  EXPECT_EQ ('a' + 3, rec.data [REC_SIZE - 1]);
+
+  // A RecordRef points into the pinned page; a Record made from it
+  // keeps its copy after the scan is over.
+  RM::Scan scan;
+  int key = 5;
+  scan.open (handle, INT, 4, 0, EQ_OP, &key);
+  RM::RecordRef ref = scan.next_ref ();
+  ASSERT_TRUE (ref.data != NULL);
+  EXPECT_EQ (REC_SIZE, ref.size);
+  EXPECT_EQ (rids [5], ref.rid);
+  RM::Record copy (ref);
+  EXPECT_TRUE (scan.next_ref ().data == NULL);
+  scan.close ();
+  memset (buf, 'a' + 5, REC_SIZE);
+  *(int*)buf = 5;
+  EXPECT_EQ (0, memcmp (buf, copy.data, REC_SIZE));
+
+  // Moving hands the bytes over.
+  RM::Record moved (std::move (copy));
+  EXPECT_TRUE (copy.data == NULL);
+  EXPECT_EQ (0, memcmp (buf, moved.data, REC_SIZE));
+  CLOSE ();
+  remove ("test");
+}
+
+TEST (RM_Manager, InsertBatch)
+{
+  remove ("test");
+  MGR();
+  mgr.CreateFile ("test", 4);
+  RM::FileHandle handle = mgr.OpenFile ("test");
+  int NUM_RECS = 5000;
+  vector<int> values (NUM_RECS);
+  for (int i = 0; i < NUM_RECS; ++i) values [i] = i;
+  handle.insert ((char*)&NUM_RECS);
+  vector<RID> rids = handle.insert_batch ((char*)values.data (), NUM_RECS);
+  ASSERT_EQ (NUM_RECS, (int) rids.size ());
+  EXPECT_TRUE (handle.insert_batch ((char*)values.data (), 0).empty ());
+  CLOSE ();
+
+  // The batch shares its first page with the record before it, and
+  // fills the pages after it in order.
+  handle = mgr.OpenFile ("test");
+  EXPECT_EQ (1, rids [0].page_num);
+  EXPECT_EQ (1, rids [0].slot_num);
+  for (int i = 1; i < NUM_RECS; ++i) {
+    EXPECT_LE (rids [i - 1].page_num, rids [i].page_num);
+    if (rids [i].page_num == rids [i - 1].page_num) {
+      EXPECT_EQ (rids [i - 1].slot_num + 1, rids [i].slot_num);
+    }
+  }
+  for (int i = 0; i < NUM_RECS; i += 97) {
+    RM::Record r = handle.get (rids [i]);
+    EXPECT_EQ (i, *(int*)r.data);
+  }
+  RM::Scan scan;
+  scan.open (handle, INT, 4, 0, NO_OP, NULL);
+  int count = 0;
+  for (RM::Record r = scan.next(); r != scan.end; r = scan.next())
+    ++count;
+  scan.close ();
+  EXPECT_EQ (NUM_RECS + 1, count);
+  CLOSE ();
+  remove ("test");
+}
+
+TEST (RM_Manager, InsertReusesFreedSlots)
+{
+  remove ("test");
+  MGR();
+  mgr.CreateFile ("test", 4);
+  RM::FileHandle handle = mgr.OpenFile ("test");
+  int NUM_RECS = 5000;
+  vector<RID> rids;
+  for (int i = 0; i < NUM_RECS; ++i)
+    rids.push_back (handle.insert ((char*)&i));
+  PageNum last_page = rids.back ().page_num;
+  PageNum full_page = rids [0].page_num;
+  ASSERT_NE (full_page, last_page);
+  CLOSE ();
+  long size = file_size ("test");
+
+  // Fill the last page up, then free slots on a full page.  The free
+  // list survives closing the file.
+  handle = mgr.OpenFile ("test");
+  RID rid;
+  while ((rid = handle.insert ((char*)&NUM_RECS)).page_num == last_page)
+    rids.push_back (rid);
+  handle.Delete (rid);
+  handle.Delete (rids [0]);
+  handle.Delete (rids [1]);
+  CLOSE ();
+
+  // New records go where slots were last freed, and the file does not
+  // grow.
+  handle = mgr.OpenFile ("test");
+  int value = -1;
+  RID first = handle.insert ((char*)&value);
+  RID second = handle.insert ((char*)&value);
+  EXPECT_EQ (full_page, first.page_num);
+  EXPECT_EQ (full_page, second.page_num);
+  EXPECT_TRUE (first == rids [0] || first == rids [1]);
+  EXPECT_TRUE (second == rids [0] || second == rids [1]);
+  EXPECT_EQ (rid, handle.insert ((char*)&value));
+  CLOSE ();
+  EXPECT_EQ (size, file_size ("test"));
+
+  handle = mgr.OpenFile ("test");
+  RM::Scan scan;
+  int count = 0;
+  scan.open (handle, INT, 4, 0, EQ_OP, &value);
+  for (RM::Record r = scan.next(); r != scan.end; r = scan.next())
+    ++count;
+  scan.close ();
+  EXPECT_EQ (3, count);
+  CLOSE ();
+  remove ("test");
+}
+
+TEST (RM_Manager, FileFromBeforeTheFreeList)
+{
+  remove ("test");
+  MGR();
+  mgr.CreateFile ("test", 4);
+  {
+    // Zero the fields the free list uses, as in older files.
+    PF::FileHandle pf_handle = pfm.OpenFile ("test");
+    PF::PinnedPage header = pf_handle.PinPage (0);
+    ((int*) header.GetData ()) [3] = 0;
+    header.MarkDirty ();
+    PF::PinnedPage first = pf_handle.PinPage (1);
+    ((RM::PageHdr*) first.GetData ())->next_free_page = 0;
+    first.MarkDirty ();
+    pf_handle.UnpinPage (header);
+    pf_handle.UnpinPage (first);
+    pfm.CloseFile (pf_handle);
+  }
+
+  RM::FileHandle handle = mgr.OpenFile ("test");
+  int NUM_RECS = 5000;
+  vector<RID> rids;
+  for (int i = 0; i < NUM_RECS; ++i)
+    rids.push_back (handle.insert ((char*)&i));
+  EXPECT_EQ (1, rids [0].page_num);
+  for (int i = 0; i < NUM_RECS; ++i)
+    EXPECT_NE (0, rids [i].page_num);
+  handle.Delete (rids [0]);
+  EXPECT_EQ (rids [0], handle.insert ((char*)&NUM_RECS));
+  CLOSE ();
+  remove ("test");
+}
+
+TEST (RM_Manager, ScanBatches)
+{
+  remove ("test");
+  MGR();
+  struct Row { int key; float value; char name [12]; };
+  mgr.CreateFile ("test", sizeof (Row));
+  RM::FileHandle handle = mgr.OpenFile ("test");
+  int NUM_RECS = 5000;
+  vector<RID> rids;
+  for (int i = 0; i < NUM_RECS; ++i) {
+    Row row;
+    memset (&row, 0, sizeof (row));
+    row.key = i;
+    row.value = i % 7;
+    snprintf (row.name, sizeof (row.name), "n%d", i % 10);
+    rids.push_back (handle.insert ((char*)&row));
+  }
+  for (int i = 0; i < NUM_RECS; i += 3) handle.Delete (rids [i]);
+
+  // A batch holds one page's qualifying records, in slot order, and
+  // they are those next returns.
+  int key = 4000;
+  float value = 3;
+  const char* name = "n5";
+  struct { AttrType type; int len; int offset; CompOp op; const void* value; }
+  conds [] = {
+    { INT, 4, 0, NO_OP, NULL },
+    { INT, 4, 0, LT_OP, &key },
+    { FLOAT, 4, 4, GE_OP, &value },
+    { STRING, 12, 8, EQ_OP, name },
+    { STRING, 12, 8, NE_OP, name },
+  };
+  for (auto& c : conds) {
+    RM::Scan scan;
+    vector<RID> expected;
+    scan.open (handle, c.type, c.len, c.offset, c.op, c.value);
+    for (RM::Record r = scan.next(); r != scan.end; r = scan.next())
+      expected.push_back (r.rid);
+    scan.close ();
+
+    vector<RID> got;
+    RM::RecordBatch batch;
+    scan.open (handle, c.type, c.len, c.offset, c.op, c.value);
+    while (scan.next_batch (batch)) {
+      ASSERT_LT (0, batch.size ());
+      for (int i = 0; i < batch.size (); ++i) {
+        if (i > 0) {
+          EXPECT_LT (batch.slots [i - 1], batch.slots [i]);
+        }
+        EXPECT_EQ (batch.page_num, batch.rid (i).page_num);
+        EXPECT_EQ (batch [i].rid, batch.rid (i));
+        EXPECT_EQ (((Row*) batch.data (i))->key,
+                   ((const Row*) batch [i].data)->key);
+        got.push_back (batch.rid (i));
+      }
+    }
+    EXPECT_EQ (0, batch.size ());
+    scan.close ();
+    ASSERT_EQ (expected.size (), got.size ());
+    for (size_t i = 0; i < got.size (); ++i) {
+      EXPECT_EQ (expected [i], got [i]);
+    }
+  }
+  CLOSE ();
+  remove ("test");
+}
@@ -1,4 +1,8 @@
 #include "bitmap.h"
+
+#include <cstdlib>
+#include <cstring>
+
 #include "gtest/gtest.h"
 
 TEST (Bitmap, init)
@@ -45,3 +49,52 @@ TEST (Bitmap, getFirstUnset)
   
   EXPECT_EQ (5, bitmap.getFirstUnset());
 }
+
+TEST (Bitmap, findNextAndCount)
+{
+  // Long enough for whole 256 bit chunks, with a ragged end.
+  const int num_bits = 2000 + 3;
+  unsigned char chars [(num_bits + 7) / 8];
+  Bitmap bitmap (num_bits, chars);
+  bitmap.clear_all ();
+  EXPECT_EQ (-1, bitmap.findNextSet (0));
+  EXPECT_EQ (0, bitmap.findNextUnset (0));
+  EXPECT_EQ (0, bitmap.count ());
+
+  int bits [] = {3, 64, 65, 511, 512, 1300, 2002};
+  for (int bit : bits) bitmap.set (bit);
+  EXPECT_EQ (7, bitmap.count ());
+  int i = 0;
+  for (int bit = bitmap.findNextSet (0);
+       bit != -1;
+       bit = bitmap.findNextSet (bit + 1))
+    EXPECT_EQ (bits [i++], bit);
+  EXPECT_EQ (7, i);
+  EXPECT_EQ (1300, bitmap.findNextSet (513));
+  EXPECT_EQ (-1, bitmap.findNextSet (num_bits));
+
+  // All set but a few: the unset ones are found, and the bits past the
+  // end of the map are not.
+  memset (chars, 0xff, sizeof (chars));
+  EXPECT_EQ (-1, bitmap.findNextUnset (0));
+  EXPECT_EQ (num_bits, bitmap.count ());
+  EXPECT_EQ (-1, bitmap.getFirstUnset ());
+  bitmap.clear (1777);
+  bitmap.clear (2001);
+  EXPECT_EQ (1777, bitmap.findNextUnset (5));
+  EXPECT_EQ (2001, bitmap.findNextUnset (1778));
+  EXPECT_EQ (num_bits - 2, bitmap.count ());
+
+  // Agrees with get on a random map.
+  unsigned int seed = 7;
+  for (int b = 0; b < num_bits; ++b)
+    if (rand_r (&seed) % 5 == 0) bitmap.set (b); else bitmap.clear (b);
+  int set = 0;
+  for (int b = 0; b < num_bits; ++b) {
+    if (bitmap.get (b)) ++set;
+    int next = b;
+    while (next < num_bits && not bitmap.get (next)) ++next;
+    EXPECT_EQ (next < num_bits ? next : -1, bitmap.findNextSet (b));
+  }
+  EXPECT_EQ (set, bitmap.count ());
+}